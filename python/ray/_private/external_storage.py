@@ -6,6 +6,7 @@ import shutil
 import time
 import urllib
 import uuid
+import zlib
 from collections import namedtuple
 from typing import IO, List, Optional, Tuple
 
@@ -14,6 +15,7 @@ from ray._private.ray_constants import DEFAULT_OBJECT_PREFIX
 from ray._raylet import ObjectRef
 
 ParsedURL = namedtuple("ParsedURL", "base_url, offset, size")
+SpillFileIndexEntry = namedtuple("SpillFileIndexEntry", "offset, size, checksum")
 logger = logging.getLogger(__name__)
 
 
@@ -86,6 +88,14 @@ class ExternalStorage(metaclass=abc.ABCMeta):
     """
 
     HEADER_LENGTH = 24
+    # Spill files start with this magic and end with an index of their records
+    # followed by a footer, see src/ray/object_manager/spill_file_index.h.
+    SPILL_FILE_MAGIC = b"RAYSPIL2"
+    # object id (28 bytes), record offset, record size, record crc32.
+    INDEX_ENTRY_LENGTH = 48
+    # index offset, number of objects, index crc32, reserved, magic.
+    FOOTER_LENGTH = 32
+    VERIFY_CHUNK_SIZE = 1024 * 1024
 
     def _get_objects_from_store(self, object_refs):
         worker = ray._private.worker.global_worker
@@ -122,7 +132,9 @@ class ExternalStorage(metaclass=abc.ABCMeta):
             with given object_refs.
         """
         keys = []
-        offset = 0
+        index = []
+        f.write(self.SPILL_FILE_MAGIC)
+        offset = len(self.SPILL_FILE_MAGIC)
         ray_object_pairs = self._get_objects_from_store(object_refs)
         for ref, (buf, metadata), owner_address in zip(
             object_refs, ray_object_pairs, owner_addresses
@@ -152,7 +164,22 @@ class ExternalStorage(metaclass=abc.ABCMeta):
                 url=url, offset=offset, size=written_bytes
             )
             keys.append(url_with_offset.encode())
+            index.append(
+                ref.binary()
+                + offset.to_bytes(8, byteorder="little")
+                + written_bytes.to_bytes(8, byteorder="little")
+                + zlib.crc32(payload).to_bytes(4, byteorder="little")
+            )
             offset += written_bytes
+        index = b"".join(index)
+        f.write(index)
+        f.write(
+            offset.to_bytes(8, byteorder="little")
+            + len(keys).to_bytes(8, byteorder="little")
+            + zlib.crc32(index).to_bytes(4, byteorder="little")
+            + bytes(4)
+            + self.SPILL_FILE_MAGIC
+        )
         # Necessary because pyarrow.io.NativeFile does not flush() on close().
         f.flush()
         return keys
@@ -181,6 +208,64 @@ class ExternalStorage(metaclass=abc.ABCMeta):
                 f"size of {obtained_data_size}."
             )
 
+    def _read_index(self, f) -> Optional[dict]:
+        """Read the index of a spill file.
+
+        Args:
+            f: Seekable file handle of the spill file.
+
+        Returns:
+            A dict from record offset to SpillFileIndexEntry, or None
+            if the file was written in the legacy format without an index.
+
+        Raises:
+            ValueError if the index is corrupted.
+        """
+        f.seek(0)
+        if f.read(len(self.SPILL_FILE_MAGIC)) != self.SPILL_FILE_MAGIC:
+            return None
+        f.seek(-self.FOOTER_LENGTH, os.SEEK_END)
+        footer = f.read(self.FOOTER_LENGTH)
+        index_offset = int.from_bytes(footer[0:8], byteorder="little")
+        num_objects = int.from_bytes(footer[8:16], byteorder="little")
+        index_checksum = int.from_bytes(footer[16:20], byteorder="little")
+        if footer[-len(self.SPILL_FILE_MAGIC) :] != self.SPILL_FILE_MAGIC:
+            raise ValueError("Spill file footer is corrupted.")
+        f.seek(index_offset)
+        index = f.read(num_objects * self.INDEX_ENTRY_LENGTH)
+        if zlib.crc32(index) != index_checksum:
+            raise ValueError("Spill file index is corrupted.")
+        entries = {}
+        for i in range(num_objects):
+            start = i * self.INDEX_ENTRY_LENGTH
+            entry = index[start : start + self.INDEX_ENTRY_LENGTH]
+            offset = int.from_bytes(entry[28:36], byteorder="little")
+            entries[offset] = SpillFileIndexEntry(
+                offset=offset,
+                size=int.from_bytes(entry[36:44], byteorder="little"),
+                checksum=int.from_bytes(entry[44:48], byteorder="little"),
+            )
+        return entries
+
+    def _verify_record(self, f, entry: SpillFileIndexEntry, url_with_offset: str):
+        """Check the record against its checksum before it is restored, so
+        corrupted data never reaches the object store.
+
+        Raises:
+            ValueError if the record doesn't match its checksum.
+        """
+        f.seek(entry.offset)
+        remaining = entry.size
+        checksum = 0
+        while remaining > 0:
+            chunk = f.read(min(remaining, self.VERIFY_CHUNK_SIZE))
+            if not chunk:
+                break
+            checksum = zlib.crc32(chunk, checksum)
+            remaining -= len(chunk)
+        if remaining != 0 or checksum != entry.checksum:
+            raise ValueError(f"Spilled object {url_with_offset} is corrupted.")
+
     @abc.abstractmethod
     def spill_objects(self, object_refs, owner_addresses) -> List[str]:
         """Spill objects to the external storage. Objects are specified
@@ -296,7 +381,10 @@ class FileSystemStorage(ExternalStorage):
         )
         directory_path = self._directory_paths[self._current_directory_index]
 
-        filename = _get_unique_spill_filename(object_refs)
+        # Prefix the file with the node id, so that a raylet restarted on this
+        # host can find and adopt the files of the dead raylet.
+        node_id = ray._private.worker.global_worker.core_worker.get_current_node_id()
+        filename = f"{node_id.hex()}-{_get_unique_spill_filename(object_refs)}"
         url = f"{os.path.join(directory_path, filename)}"
         with open(url, "wb", buffering=self._buffer_size) as f:
             return self._write_multiple_objects(f, object_refs, owner_addresses, url)
@@ -305,6 +393,8 @@ class FileSystemStorage(ExternalStorage):
         self, object_refs: List[ObjectRef], url_with_offset_list: List[str]
     ):
         total = 0
+        # Index of each file, read once per restore request.
+        indexes = {}
         for i in range(len(object_refs)):
             object_ref = object_refs[i]
             url_with_offset = url_with_offset_list[i].decode()
@@ -314,6 +404,16 @@ class FileSystemStorage(ExternalStorage):
             offset = parsed_result.offset
             # Read a part of the file and recover the object.
             with open(base_url, "rb") as f:
+                if base_url not in indexes:
+                    indexes[base_url] = self._read_index(f)
+                index = indexes[base_url]
+                if index is not None:
+                    entry = index.get(offset)
+                    if entry is None or entry.size != parsed_result.size:
+                        raise ValueError(
+                            f"Spilled object {url_with_offset} is not in the index."
+                        )
+                    self._verify_record(f, entry, url_with_offset)
                 f.seek(offset)
                 address_len = int.from_bytes(f.read(8), byteorder="little")
                 metadata_len = int.from_bytes(f.read(8), byteorder="little")
@@ -112,6 +112,9 @@ def issubclass_safe(obj: Any, cls_: type) -> bool:
 
 
 _task_only_options = {
+    # Let a worker run the task itself, instead of leasing another worker, if it
+    # is executing a task whose resources the task fits in.
+    "_allow_inline_execution": Option(bool, default_value=False),
     "max_calls": _counting_option("max_calls", False, default_value=0),
     # Normal tasks may be retried on failure this many times.
     # TODO(swang): Allow this to be set globally for an application.
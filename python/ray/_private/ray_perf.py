@@ -61,6 +61,11 @@ def small_value():
     return b"ok"
 
 
+@ray.remote(max_calls=1)
+def small_value_new_worker():
+    return b"ok"
+
+
 @ray.remote
 def small_value_batch(n):
     submitted = [small_value.remote() for _ in range(n)]
@@ -164,6 +169,11 @@ def main(results=None):
 
     results += timeit("single client tasks async", small_task_async, 1000)
 
+    def new_worker_tasks():
+        ray.get([small_value_new_worker.remote() for _ in range(10)])
+
+    results += timeit("single client tasks on new workers", new_worker_tasks, 10)
+
     n = 10000
     m = 4
     actors = [Actor.remote() for _ in range(m)]
@@ -0,0 +1,100 @@
+"""Fork server that starts Python workers on request from the raylet.
+
+The server imports the worker modules once, then forks a worker for every request it
+receives on its Unix domain socket, so that workers don't have to start a new
+interpreter and import Ray. A request is one line of JSON with the arguments of
+default_worker.py and the environment variables of the worker. The reply is the pid
+of the forked worker, or -1 if the fork failed.
+"""
+import argparse
+import json
+import logging
+import os
+import runpy
+import signal
+import socket
+import sys
+
+from ray._private.ray_constants import LOGGER_FORMAT, LOGGER_LEVEL
+from ray._private.ray_logging import setup_logger
+
+# Import what the workers import before serving, so that forked workers don't need to.
+import ray._private.workers.default_worker  # noqa: F401
+
+logger = logging.getLogger(__name__)
+
+parser = argparse.ArgumentParser(
+    description=("Fork Ray workers on request from the raylet.")
+)
+parser.add_argument(
+    "--socket-path",
+    required=True,
+    type=str,
+    help="the path of the Unix domain socket to listen on",
+)
+
+# How often to check whether the raylet is still alive, in seconds.
+PARENT_CHECK_INTERVAL_S = 1
+
+
+def run_worker(request):
+    """Run default_worker.py in a forked process."""
+    signal.signal(signal.SIGCHLD, signal.SIG_DFL)
+    os.environ.update(request["env"])
+    sys.argv = request["args"]
+    runpy.run_path(sys.argv[0], run_name="__main__")
+
+
+def send_reply(conn, reply):
+    """Send the reply to a fork request, returns whether the raylet got it."""
+    try:
+        conn.sendall(reply)
+        return True
+    except OSError as e:
+        logger.warning(f"Failed to reply to the raylet: {e}")
+        return False
+
+
+def serve(socket_path):
+    raylet_pid = os.getppid()
+    # Forked workers are reaped automatically.
+    signal.signal(signal.SIGCHLD, signal.SIG_IGN)
+    if os.path.exists(socket_path):
+        os.unlink(socket_path)
+    server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    server.bind(socket_path)
+    server.listen(128)
+    server.settimeout(PARENT_CHECK_INTERVAL_S)
+    logger.info(f"Worker fork server listening on {socket_path}")
+
+    while os.getppid() == raylet_pid:
+        try:
+            conn, _ = server.accept()
+        except socket.timeout:
+            continue
+        with conn:
+            conn.settimeout(None)
+            try:
+                request = json.loads(conn.makefile("r").readline())
+                pid = os.fork()
+            except Exception:
+                logger.exception("Failed to fork a worker.")
+                send_reply(conn, b"-1\n")
+                continue
+            if pid == 0:
+                server.close()
+                conn.close()
+                run_worker(request)
+                return
+            if not send_reply(conn, f"{pid}\n".encode()):
+                # The raylet gave up on the request and starts the worker without
+                # the fork server, so this one would run with the same startup token.
+                logger.warning(f"Killing worker {pid}, the raylet didn't wait for it.")
+                os.kill(pid, signal.SIGKILL)
+    logger.info("The raylet exited, stopping the worker fork server.")
+
+
+if __name__ == "__main__":
+    setup_logger(LOGGER_LEVEL, LOGGER_FORMAT)
+    args = parser.parse_args()
+    serve(args.socket_path)
@@ -633,16 +633,22 @@ cdef execute_task(
         c_name_of_concurrency_group_to_execute.decode("ascii")
     title = f"ray::{task_name}"
 
+    # A normal task runs off the main thread only if it runs inline, next to
+    # the task that submitted it. The process and its logs remain that task's.
+    is_inline = (<int>task_type == <int>TASK_TYPE_NORMAL_TASK and
+                 threading.current_thread() is not threading.main_thread())
+
     if <int>task_type == <int>TASK_TYPE_NORMAL_TASK:
         next_title = "ray::IDLE"
         function_executor = execution_info.function
-        # Record the task name via :task_name: magic token in the log file.
-        # This is used for the prefix in driver logs `(task_name pid=123) ...`
-        task_name_magic_token = "{}{}\n".format(
-            ray_constants.LOG_PREFIX_TASK_NAME, task_name.replace("()", ""))
-        # Print on both .out and .err
-        print(task_name_magic_token, end="")
-        print(task_name_magic_token, file=sys.stderr, end="")
+        if not is_inline:
+            # Record the task name via :task_name: magic token in the log file.
+            # This is used for the prefix in driver logs `(task_name pid=123) ...`
+            task_name_magic_token = "{}{}\n".format(
+                ray_constants.LOG_PREFIX_TASK_NAME, task_name.replace("()", ""))
+            # Print on both .out and .err
+            print(task_name_magic_token, end="")
+            print(task_name_magic_token, file=sys.stderr, end="")
     else:
         actor = worker.actors[core_worker.get_actor_id()]
         class_name = actor.__class__.__name__
@@ -730,6 +736,8 @@ cdef execute_task(
                     if is_exiting:
                         title = f"{title}::Exiting"
                         next_title = f"{next_title}::Exiting"
+                    if is_inline:
+                        title = next_title = setproctitle.getproctitle()
                     with ray._private.worker._changeproctitle(title, next_title):
                         if debugger_breakpoint != b"":
                             ray.util.pdb.set_trace(
@@ -1650,6 +1658,7 @@ cdef class CoreWorker:
                     scheduling_strategy,
                     c_string debugger_breakpoint,
                     c_string serialized_runtime_env_info,
+                    c_bool allow_inline_execution=False,
                     ):
         cdef:
             unordered_map[c_string, double] c_resources
@@ -1689,6 +1698,7 @@ cdef class CoreWorker:
                 name, num_returns, c_resources,
                 b"",
                 serialized_runtime_env_info)
+            task_options.allow_inline_execution = allow_inline_execution
 
             with nogil:
                 return_refs = CCoreWorkerProcess.GetCoreWorker().SubmitTask(
@@ -303,6 +303,7 @@ class RemoteFunction:
             num_returns = -1
         max_retries = task_options["max_retries"]
         retry_exceptions = task_options["retry_exceptions"]
+        allow_inline_execution = task_options["_allow_inline_execution"]
         if isinstance(retry_exceptions, (list, tuple)):
             retry_exception_allowlist = tuple(retry_exceptions)
             retry_exceptions = True
@@ -387,6 +388,7 @@ class RemoteFunction:
                 scheduling_strategy,
                 worker.debugger_breakpoint,
                 serialized_runtime_env_info or "{}",
+                allow_inline_execution,
             )
             # Reset worker's debug context from the last "remote" command
             # (which applies only to this .remote call).
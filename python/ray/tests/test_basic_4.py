@@ -1,5 +1,6 @@
 # coding: utf-8
 import logging
+import os
 import subprocess
 import sys
 import time
@@ -276,9 +277,57 @@ def test_fair_queueing(shutdown_only):
     assert len(ready) == 1000, len(ready)
 
 
-if __name__ == "__main__":
-    import os
+def test_inline_execution(shutdown_only):
+    ray.init(num_cpus=4)
+
+    @ray.remote(_allow_inline_execution=True)
+    def tiny(x):
+        return x + 1, os.getpid()
+
+    @ray.remote
+    def parent():
+        # Fits in the CPU of this task, so it runs in this worker.
+        value, pid = ray.get(tiny.remote(1))
+        assert value == 2
+        assert pid == os.getpid()
+        # Needs more CPUs than this task holds, so it gets a worker of its own.
+        value, pid = ray.get(tiny.options(num_cpus=2).remote(1))
+        assert value == 2
+        assert pid != os.getpid()
+        return ray.get([tiny.remote(i) for i in range(100)])
+
+    results = ray.get(parent.remote())
+    assert [value for value, _ in results] == list(range(1, 101))
+    # The driver holds no lease, so its tasks never run inline.
+    _, pid = ray.get(tiny.remote(1))
+    assert pid != os.getpid()
+
+
+def test_inline_execution_cancel(shutdown_only):
+    ray.init(num_cpus=2)
+
+    @ray.remote(_allow_inline_execution=True)
+    def slow():
+        time.sleep(1)
+        return os.getpid()
+
+    @ray.remote
+    def parent():
+        ref = slow.remote()
+        ray.cancel(ref)
+        try:
+            ray.get(ref)
+        except ray.exceptions.TaskCancelledError:
+            pass
+        else:
+            return False
+        # The cancelled task doesn't hold the inline slot any more.
+        return ray.get(slow.remote()) == os.getpid()
 
+    assert ray.get(parent.remote())
+
+
+if __name__ == "__main__":
     if os.environ.get("PARALLEL_CI"):
         sys.exit(pytest.main(["-n", "auto", "--boxed", "-vs", __file__]))
     else:
@@ -71,8 +71,7 @@ def assert_no_thrashing(address):
 def test_spill_file_uniqueness(shutdown_only):
     ray.init(num_cpus=0, object_store_memory=75 * 1024 * 1024)
     arr = np.random.rand(128 * 1024)  # 1 MB
-    refs = []
-    refs.append([ray.put(arr)])
+    refs = [ray.put(arr)]
 
     # for the same object_ref, generating spill urls 10 times yields
     # 10 different urls
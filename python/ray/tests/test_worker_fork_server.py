@@ -0,0 +1,35 @@
+import os
+import sys
+
+import psutil
+import pytest
+
+import ray
+from ray._private.test_utils import wait_for_condition
+
+
+def test_workers_forked_from_fork_server(shutdown_only):
+    ray.init(num_cpus=2, _system_config={"worker_fork_server_enabled": True})
+
+    @ray.remote(max_calls=1)
+    def get_worker_info():
+        return (
+            psutil.Process(os.getppid()).cmdline(),
+            os.environ.get("RAY_JOB_ID"),
+        )
+
+    # Workers are started without the fork server until it has imported Ray.
+    def forked_worker_started():
+        parent_cmdline, _ = ray.get(get_worker_info.remote())
+        return any("worker_fork_server.py" in arg for arg in parent_cmdline)
+
+    wait_for_condition(forked_worker_started, timeout=30)
+
+    # Every worker gets a fresh process with its own environment.
+    job_id = ray.get_runtime_context().get_job_id()
+    infos = ray.get([get_worker_info.remote() for _ in range(10)])
+    assert all(env_job_id == job_id for _, env_job_id in infos)
+
+
+if __name__ == "__main__":
+    sys.exit(pytest.main(["-sv", __file__]))
@@ -60,6 +60,7 @@ class MockTaskFinisherInterface : public TaskFinisherInterface {
   MOCK_METHOD(bool, RetryTaskIfPossible, (const TaskID &task_id), (override));
   MOCK_METHOD(void, MarkDependenciesResolved, (const TaskID &task_id), (override));
   MOCK_METHOD(void, MarkTaskWaitingForExecution, (const TaskID &task_id), (override));
+  MOCK_METHOD(void, MarkTaskNotExecuted, (const TaskID &task_id), (override));
 };
 
 }  // namespace core
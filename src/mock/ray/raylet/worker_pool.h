@@ -23,6 +23,10 @@ class MockWorkerPoolInterface : public WorkerPoolInterface {
                const PopWorkerCallback &callback,
                const std::string &allocated_instances_serialized_json),
               (override));
+  MOCK_METHOD(bool,
+              HasIdleWorker,
+              (const TaskSpecification &task_spec),
+              (const, override));
   MOCK_METHOD(void,
               PushWorker,
               (const std::shared_ptr<WorkerInterface> &worker),
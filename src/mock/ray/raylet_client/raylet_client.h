@@ -38,7 +38,8 @@ class MockWorkerLeaseInterface : public WorkerLeaseInterface {
        bool grant_or_reject,
        const ray::rpc::ClientCallback<ray::rpc::RequestWorkerLeaseReply> &callback,
        const int64_t backlog_size,
-       const bool is_selected_based_on_locality),
+       const bool is_selected_based_on_locality,
+       const int64_t max_leases),
       (override));
   MOCK_METHOD(ray::Status,
               ReturnWorker,
@@ -146,7 +147,8 @@ class MockRayletClientInterface : public RayletClientInterface {
        bool grant_or_reject,
        const ray::rpc::ClientCallback<ray::rpc::RequestWorkerLeaseReply> &callback,
        const int64_t backlog_size,
-       const bool is_selected_based_on_locality),
+       const bool is_selected_based_on_locality,
+       const int64_t max_leases),
       (override));
 
   MOCK_METHOD(ray::Status,
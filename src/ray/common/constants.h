@@ -51,5 +51,10 @@ constexpr int kMessagePackOffset = 9;
 /// Should be kept in sync with SETUP_WORKER_FILENAME in ray_constants.py
 constexpr char kSetupWorkerFilename[] = "setup_worker.py";
 
+/// Filenames of the Python worker entry point and of the fork server that starts
+/// Python workers from a process that has already imported them.
+constexpr char kDefaultWorkerFilename[] = "default_worker.py";
+constexpr char kWorkerForkServerFilename[] = "worker_fork_server.py";
+
 /// The version of Ray
 constexpr char kRayVersion[] = "3.0.0.dev0";
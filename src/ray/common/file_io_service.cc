@@ -0,0 +1,436 @@
+// Copyright 2023 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/common/file_io_service.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define RAY_HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <boost/asio/post.hpp>
+#include <cerrno>
+#include <cstring>
+
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace {
+
+/// The largest read or write submitted at once, the io_uring length is 32 bits.
+const size_t kMaxTransferSize = 1 << 30;
+
+}  // namespace
+
+#ifdef RAY_HAVE_IO_URING
+
+struct FileIOService::Ring {
+  ~Ring() {
+    if (sqes != nullptr) {
+      munmap(sqes, sqes_size);
+    }
+    if (cq_ptr != nullptr && cq_ptr != sq_ptr) {
+      munmap(cq_ptr, cq_size);
+    }
+    if (sq_ptr != nullptr) {
+      munmap(sq_ptr, sq_size);
+    }
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+
+  /// Set up an io_uring with room for entries submissions.
+  /// \return nullptr if io_uring is not available.
+  static std::unique_ptr<Ring> Create(uint32_t entries) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    auto ring = std::make_unique<Ring>();
+    ring->fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (ring->fd < 0) {
+      RAY_LOG(INFO) << "io_uring is not available, file IO falls back to a thread "
+                    << "pool: " << strerror(errno);
+      return nullptr;
+    }
+    ring->sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+      ring->sq_size = ring->cq_size = std::max(ring->sq_size, ring->cq_size);
+    }
+    ring->sq_ptr = Map(ring->sq_size, ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ptr == nullptr) {
+      return nullptr;
+    }
+    if (single_mmap) {
+      ring->cq_ptr = ring->sq_ptr;
+    } else {
+      ring->cq_ptr = Map(ring->cq_size, ring->fd, IORING_OFF_CQ_RING);
+      if (ring->cq_ptr == nullptr) {
+        return nullptr;
+      }
+    }
+    ring->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    ring->sqes =
+        static_cast<io_uring_sqe *>(Map(ring->sqes_size, ring->fd, IORING_OFF_SQES));
+    if (ring->sqes == nullptr) {
+      return nullptr;
+    }
+    auto *sq = static_cast<uint8_t *>(ring->sq_ptr);
+    ring->sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    ring->sq_mask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    ring->sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    auto *cq = static_cast<uint8_t *>(ring->cq_ptr);
+    ring->cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    ring->cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    ring->cq_mask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    return ring;
+  }
+
+  static void *Map(size_t size, int fd, off_t offset) {
+    void *ptr = mmap(
+        nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+    if (ptr == MAP_FAILED) {
+      RAY_LOG(WARNING) << "Failed to map the io_uring: " << strerror(errno);
+      return nullptr;
+    }
+    return ptr;
+  }
+
+  /// Queue a submission and tell the kernel about it. The caller serializes
+  /// submissions.
+  void Push(const io_uring_sqe &sqe) {
+    const unsigned tail = *sq_tail;
+    const unsigned index = tail & sq_mask;
+    sqes[index] = sqe;
+    sq_array[index] = index;
+    __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+    while (syscall(__NR_io_uring_enter, fd, 1, 0, 0, nullptr, 0) < 0) {
+      if (errno != EINTR && errno != EAGAIN) {
+        // The entry stays in the ring and is picked up by the next enter call.
+        RAY_LOG(WARNING) << "io_uring_enter failed: " << strerror(errno);
+        break;
+      }
+    }
+  }
+
+  /// Block until at least one completion is available.
+  void WaitForCompletion() {
+    if (syscall(__NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) <
+            0 &&
+        errno != EINTR) {
+      RAY_LOG(WARNING) << "io_uring_enter failed: " << strerror(errno);
+    }
+  }
+
+  int fd = -1;
+  void *sq_ptr = nullptr;
+  size_t sq_size = 0;
+  void *cq_ptr = nullptr;
+  size_t cq_size = 0;
+  io_uring_sqe *sqes = nullptr;
+  size_t sqes_size = 0;
+  unsigned *sq_tail = nullptr;
+  unsigned sq_mask = 0;
+  unsigned *sq_array = nullptr;
+  unsigned *cq_head = nullptr;
+  unsigned *cq_tail = nullptr;
+  unsigned cq_mask = 0;
+  io_uring_cqe *cqes = nullptr;
+  /// The maximum number of operations in flight.
+  int64_t queue_depth = 0;
+};
+
+#else
+
+struct FileIOService::Ring {
+  int64_t queue_depth = 0;
+};
+
+#endif
+
+FileIOService::FileIOService(instrumented_io_context &io_context,
+                             size_t num_fallback_threads,
+                             uint32_t queue_depth)
+    : io_context_(io_context), fallback_pool_(num_fallback_threads) {
+#ifdef RAY_HAVE_IO_URING
+  if (queue_depth > 0) {
+    // One more entry for the shutdown marker.
+    ring_ = Ring::Create(queue_depth + 1);
+  }
+  if (ring_ != nullptr) {
+    ring_->queue_depth = queue_depth;
+    completion_thread_ = std::thread([this] { RunCompletionLoop(); });
+  }
+#endif
+}
+
+FileIOService::~FileIOService() {
+#ifdef RAY_HAVE_IO_URING
+  if (ring_ != nullptr) {
+    {
+      absl::MutexLock lock(&mutex_);
+      shutting_down_ = true;
+      struct io_uring_sqe sqe;
+      memset(&sqe, 0, sizeof(sqe));
+      sqe.opcode = IORING_OP_NOP;
+      sqe.user_data = 0;
+      ring_->Push(sqe);
+    }
+    completion_thread_.join();
+  }
+#endif
+  fallback_pool_.join();
+}
+
+void FileIOService::AsyncRead(
+    int fd, void *buffer, size_t size, int64_t offset, FileIOCallback callback) {
+  Submit(std::unique_ptr<Operation>(new Operation{
+      OpType::READ, fd, static_cast<uint8_t *>(buffer), size, offset, 0, callback}));
+}
+
+void FileIOService::AsyncWrite(
+    int fd, const void *buffer, size_t size, int64_t offset, FileIOCallback callback) {
+  // The buffer is only read from.
+  auto *data = static_cast<uint8_t *>(const_cast<void *>(buffer));
+  Submit(std::unique_ptr<Operation>(
+      new Operation{OpType::WRITE, fd, data, size, offset, 0, callback}));
+}
+
+void FileIOService::AsyncFsync(int fd, FileIOCallback callback) {
+  Submit(std::unique_ptr<Operation>(
+      new Operation{OpType::FSYNC, fd, nullptr, 0, 0, 0, callback}));
+}
+
+void FileIOService::AsyncFallocate(int fd,
+                                   int64_t offset,
+                                   int64_t size,
+                                   FileIOCallback callback) {
+  Submit(std::unique_ptr<Operation>(new Operation{
+      OpType::FALLOCATE, fd, nullptr, static_cast<size_t>(size), offset, 0, callback}));
+}
+
+int64_t FileIOService::NumPendingOperations() const {
+  absl::MutexLock lock(&mutex_);
+  return num_in_ring_ + waiting_.size() + num_in_thread_pool_;
+}
+
+void FileIOService::Submit(std::unique_ptr<Operation> op) {
+  if (ring_ == nullptr) {
+    SubmitToThreadPool(std::move(op));
+    return;
+  }
+  absl::MutexLock lock(&mutex_);
+  RAY_CHECK(!shutting_down_);
+  if (num_in_ring_ < ring_->queue_depth) {
+    num_in_ring_++;
+    SubmitToRing(op.release());
+  } else {
+    waiting_.push_back(std::move(op));
+  }
+}
+
+void FileIOService::SubmitToRing(Operation *op) {
+#ifdef RAY_HAVE_IO_URING
+  struct io_uring_sqe sqe;
+  memset(&sqe, 0, sizeof(sqe));
+  sqe.fd = op->fd;
+  sqe.user_data = reinterpret_cast<uint64_t>(op);
+  switch (op->type) {
+  case OpType::READ:
+  case OpType::WRITE:
+    sqe.opcode = op->type == OpType::READ ? IORING_OP_READ : IORING_OP_WRITE;
+    sqe.addr = reinterpret_cast<uint64_t>(op->buffer + op->done);
+    sqe.len = static_cast<uint32_t>(std::min(op->size - op->done, kMaxTransferSize));
+    sqe.off = op->offset + op->done;
+    break;
+  case OpType::FSYNC:
+    sqe.opcode = IORING_OP_FSYNC;
+    break;
+  case OpType::FALLOCATE:
+    // The length goes in addr and the mode in len.
+    sqe.opcode = IORING_OP_FALLOCATE;
+    sqe.off = op->offset;
+    sqe.addr = op->size;
+    sqe.len = 0;
+    break;
+  }
+  ring_->Push(sqe);
+#endif
+}
+
+void FileIOService::RunCompletionLoop() {
+#ifdef RAY_HAVE_IO_URING
+  bool shutdown_marker_seen = false;
+  while (true) {
+    {
+      absl::MutexLock lock(&mutex_);
+      if (shutdown_marker_seen && num_in_ring_ == 0 && waiting_.empty()) {
+        return;
+      }
+    }
+    ring_->WaitForCompletion();
+    unsigned head = *ring_->cq_head;
+    const unsigned tail = __atomic_load_n(ring_->cq_tail, __ATOMIC_ACQUIRE);
+    for (; head != tail; head++) {
+      const io_uring_cqe &cqe = ring_->cqes[head & ring_->cq_mask];
+      if (cqe.user_data == 0) {
+        shutdown_marker_seen = true;
+      } else {
+        HandleRingCompletion(reinterpret_cast<Operation *>(cqe.user_data), cqe.res);
+      }
+    }
+    __atomic_store_n(ring_->cq_head, head, __ATOMIC_RELEASE);
+  }
+#endif
+}
+
+void FileIOService::HandleRingCompletion(Operation *op, int32_t result) {
+  const bool transfer = op->type == OpType::READ || op->type == OpType::WRITE;
+  if (result > 0 && transfer) {
+    op->done += result;
+  }
+  if (result == -EINTR || result == -EAGAIN ||
+      (result > 0 && transfer && op->done < op->size)) {
+    // Interrupted or partial transfer, submit the rest.
+    absl::MutexLock lock(&mutex_);
+    SubmitToRing(op);
+    return;
+  }
+
+  std::unique_ptr<Operation> finished(op);
+  {
+    absl::MutexLock lock(&mutex_);
+    num_in_ring_--;
+    while (!waiting_.empty() && num_in_ring_ < ring_->queue_depth) {
+      num_in_ring_++;
+      SubmitToRing(waiting_.front().release());
+      waiting_.pop_front();
+    }
+  }
+  if ((result == -EINVAL || result == -EOPNOTSUPP) && finished->done == 0) {
+    // The kernel may be too old for this operation.
+    SubmitToThreadPool(std::move(finished));
+  } else if (result < 0) {
+    Complete(std::move(finished), -result);
+  } else if (result == 0 && finished->type == OpType::WRITE &&
+             finished->done < finished->size) {
+    Complete(std::move(finished), EIO);
+  } else {
+    Complete(std::move(finished), 0);
+  }
+}
+
+void FileIOService::SubmitToThreadPool(std::unique_ptr<Operation> op) {
+  {
+    absl::MutexLock lock(&mutex_);
+    num_in_thread_pool_++;
+  }
+  Operation *raw = op.release();
+  boost::asio::post(fallback_pool_, [this, raw]() {
+    std::unique_ptr<Operation> op(raw);
+    int error = 0;
+#ifdef _WIN32
+    error = ENOSYS;
+#else
+    switch (op->type) {
+    case OpType::READ:
+    case OpType::WRITE:
+      while (op->done < op->size) {
+        const size_t size = std::min(op->size - op->done, kMaxTransferSize);
+        const ssize_t n =
+            op->type == OpType::READ
+                ? pread(op->fd, op->buffer + op->done, size, op->offset + op->done)
+                : pwrite(op->fd, op->buffer + op->done, size, op->offset + op->done);
+        if (n < 0 && errno == EINTR) {
+          continue;
+        }
+        if (n < 0) {
+          error = errno;
+          break;
+        }
+        if (n == 0) {
+          // End of file for reads, a write that makes no progress is an error.
+          error = op->type == OpType::WRITE ? EIO : 0;
+          break;
+        }
+        op->done += n;
+      }
+      break;
+    case OpType::FSYNC:
+      while (fsync(op->fd) != 0) {
+        if (errno != EINTR) {
+          error = errno;
+          break;
+        }
+      }
+      break;
+    case OpType::FALLOCATE:
+#ifdef __linux__
+      error = posix_fallocate(op->fd, op->offset, op->size);
+#else
+      struct stat st;
+      if (fstat(op->fd, &st) != 0) {
+        error = errno;
+      } else if (st.st_size < op->offset + static_cast<int64_t>(op->size) &&
+                 ftruncate(op->fd, op->offset + op->size) != 0) {
+        error = errno;
+      }
+#endif
+      break;
+    }
+#endif
+    {
+      absl::MutexLock lock(&mutex_);
+      num_in_thread_pool_--;
+    }
+    Complete(std::move(op), error);
+  });
+}
+
+void FileIOService::Complete(std::unique_ptr<Operation> op, int error) {
+  const auto status = error == 0 ? Status::OK() : Status::IOError(strerror(error));
+  const size_t bytes = op->done;
+  std::string name;
+  switch (op->type) {
+  case OpType::READ:
+    name = "FileIOService.Read";
+    break;
+  case OpType::WRITE:
+    name = "FileIOService.Write";
+    break;
+  case OpType::FSYNC:
+    name = "FileIOService.Fsync";
+    break;
+  case OpType::FALLOCATE:
+    name = "FileIOService.Fallocate";
+    break;
+  }
+  io_context_.post([callback = std::move(op->callback),
+                    status,
+                    bytes]() { callback(status, bytes); },
+                   name);
+}
+
+}  // namespace ray
@@ -0,0 +1,139 @@
+// Copyright 2023 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <boost/asio/thread_pool.hpp>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "ray/common/asio/instrumented_io_context.h"
+#include "ray/common/status.h"
+
+namespace ray {
+
+/// Callback of an asynchronous file operation.
+///
+/// \param status OK, or the IOError of the failed syscall.
+/// \param bytes The number of bytes read or written. A read that hits the end of
+/// the file reports fewer bytes than requested.
+using FileIOCallback = std::function<void(const Status &status, size_t bytes)>;
+
+/// Runs file reads, writes, fsyncs and fallocates asynchronously and posts their
+/// completion callbacks to an event loop, so that the thread running the event
+/// loop never blocks on disk.
+///
+/// On Linux the operations are submitted to an io_uring, which lets many of them
+/// be in flight with a single completion thread. If io_uring is not available
+/// (old kernel, seccomp filter, non-Linux platform) or doesn't support an
+/// operation, the operation runs synchronously on a small thread pool instead.
+///
+/// The caller owns the file descriptors and buffers, and must keep them valid until
+/// the callback runs. This class is thread safe.
+///
+/// The object manager uses it to read the chunks of spilled objects it pushes.
+/// Plasma fallback allocation still calls fallocate synchronously, because the
+/// allocator has to return the mapped file in the same call.
+class FileIOService {
+ public:
+  /// \param io_context The event loop the callbacks are posted to.
+  /// \param num_fallback_threads The size of the thread pool used when io_uring is
+  /// not available.
+  /// \param queue_depth The maximum number of operations in flight in the
+  /// io_uring. Additional operations wait until earlier ones complete. If 0,
+  /// io_uring is not used.
+  FileIOService(instrumented_io_context &io_context,
+                size_t num_fallback_threads = 4,
+                uint32_t queue_depth = 64);
+
+  /// Waits for all the operations in flight to complete.
+  ~FileIOService();
+
+  /// Read size bytes at offset of the file into buffer.
+  void AsyncRead(
+      int fd, void *buffer, size_t size, int64_t offset, FileIOCallback callback);
+
+  /// Write size bytes of buffer at offset of the file.
+  void AsyncWrite(
+      int fd, const void *buffer, size_t size, int64_t offset, FileIOCallback callback);
+
+  /// Flush the file to disk.
+  void AsyncFsync(int fd, FileIOCallback callback);
+
+  /// Allocate the disk blocks of the range [offset, offset + size) of the file,
+  /// growing the file if needed.
+  void AsyncFallocate(int fd, int64_t offset, int64_t size, FileIOCallback callback);
+
+  /// Whether the operations are submitted to an io_uring.
+  bool UsesIoUring() const { return ring_ != nullptr; }
+
+  /// The number of operations submitted and not completed yet.
+  int64_t NumPendingOperations() const;
+
+ private:
+  enum class OpType { READ, WRITE, FSYNC, FALLOCATE };
+
+  struct Operation {
+    OpType type;
+    int fd;
+    uint8_t *buffer;
+    size_t size;
+    int64_t offset;
+    /// The bytes transferred so far, reads and writes may complete partially.
+    size_t done = 0;
+    FileIOCallback callback;
+  };
+
+  /// The memory mapped io_uring, defined in the .cc file.
+  struct Ring;
+
+  void Submit(std::unique_ptr<Operation> op);
+
+  /// Hand the operation to the kernel. Requires a free submission slot.
+  void SubmitToRing(Operation *op) EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Run the operation synchronously on the fallback thread pool.
+  void SubmitToThreadPool(std::unique_ptr<Operation> op);
+
+  /// Loop of the thread reaping the io_uring completions.
+  void RunCompletionLoop();
+
+  /// Handle the result of one io_uring operation, with the semantics of the return
+  /// value of the corresponding syscall.
+  void HandleRingCompletion(Operation *op, int32_t result);
+
+  /// Post the callback of a finished operation to the event loop.
+  void Complete(std::unique_ptr<Operation> op, int error);
+
+  instrumented_io_context &io_context_;
+  boost::asio::thread_pool fallback_pool_;
+  std::unique_ptr<Ring> ring_;
+  std::thread completion_thread_;
+
+  mutable absl::Mutex mutex_;
+  /// Operations in the io_uring.
+  int64_t num_in_ring_ GUARDED_BY(mutex_) = 0;
+  /// Operations waiting for a free slot in the io_uring.
+  std::deque<std::unique_ptr<Operation>> waiting_ GUARDED_BY(mutex_);
+  /// Operations running on the fallback thread pool.
+  int64_t num_in_thread_pool_ GUARDED_BY(mutex_) = 0;
+  bool shutting_down_ GUARDED_BY(mutex_) = false;
+};
+
+}  // namespace ray
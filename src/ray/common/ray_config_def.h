@@ -171,6 +171,43 @@ RAY_CONFIG(int64_t, worker_cap_max_backoff_delay_ms, 1000 * 10)
 /// even balancing of load. Low values (min 0.0) encourage more load spreading.
 RAY_CONFIG(float, scheduler_spread_threshold, 0.5);
 
+/// The scorer the hybrid and placement group scheduling policies rank the available
+/// nodes with: "least_resource" or "most_allocated", which packs requests onto the
+/// busiest nodes so that idle nodes can be scaled down. If empty, tasks go to the
+/// least utilized node and placement groups use "least_resource".
+RAY_CONFIG(std::string, scheduler_node_scorer, "")
+
+/// The weight of the data locality of the task arguments when the hybrid policy ranks
+/// the available nodes, against a weight of 1 for the node scorer. The owner sends
+/// the bytes of the arguments on each node with the lease request if it is set.
+/// 0 disables it.
+RAY_CONFIG(double, scheduler_data_locality_weight, 0)
+
+/// Whether the cluster task manager places the queued tasks of a scheduling class in
+/// batches: a single scheduling decision picks a node and places there as many
+/// tasks as the hybrid policy would have placed one by one. The batches follow the
+/// default ranking of the hybrid policy, so they aren't used when
+/// scheduler_node_scorer or scheduler_data_locality_weight is set.
+RAY_CONFIG(bool, scheduler_batch_scheduling_enabled, false)
+
+/// Whether a lease request for a task without arguments is granted to an idle worker
+/// right away when the local node has the resources for it and the hybrid policy
+/// would keep the task local, instead of going through the scheduling queues.
+RAY_CONFIG(bool, worker_lease_fast_path_enabled, false)
+
+/// Whether the local task manager may kill the workers leased to lower priority tasks
+/// when a higher priority task can't get the resources it needs on this node or any
+/// other node. The preempted tasks fail with a system error and are retried by their
+/// owners like any other task whose worker died.
+RAY_CONFIG(bool, scheduler_preemption_enabled, false)
+
+/// How often an idle raylet asks the most loaded node in its resource view for queued
+/// tasks it could run instead, in milliseconds. 0 disables work stealing.
+RAY_CONFIG(uint64_t, work_stealing_period_ms, 0)
+
+/// The maximum number of queued tasks an idle raylet asks for at once.
+RAY_CONFIG(int64_t, work_stealing_max_tasks, 16)
+
 /// Whether to only report the usage of pinned copies of objects in the
 /// object_store_memory resource. This means nodes holding secondary copies only
 /// will become eligible for removal in the autoscaler.
@@ -426,6 +463,25 @@ RAY_CONFIG(int64_t, task_rpc_inlined_bytes_limit, 10 * 1024 * 1024)
 /// Maximum number of pending lease requests per scheduling category
 RAY_CONFIG(uint64_t, max_pending_lease_requests_per_scheduling_category, 10)
 
+/// Maximum number of workers leased by one lease request. With more than 1, the
+/// raylet grants along with the requested worker the other workers it can grant right
+/// away, so that a burst of tasks needs fewer lease round-trips.
+RAY_CONFIG(uint64_t, max_leases_per_lease_request, 1)
+
+/// Maximum number of normal tasks pushed to a leased worker before the first of them
+/// finishes. The worker queues the others, so that short tasks don't leave it idle for
+/// a round-trip between each other. Tasks queued behind a long task wait for it, so
+/// only raise this for workloads of short tasks.
+RAY_CONFIG(uint32_t, max_tasks_in_flight_per_worker, 1)
+
+/// Maximum number of tasks that a worker runs inline, on its own threads, for the task
+/// it is executing. Only tasks submitted with the inline execution option, that take
+/// their arguments by value, are run inline, as long as all the tasks run inline fit in
+/// the resources of the submitting task. The submitting task keeps its resources while
+/// it waits for them. The threads are started with the first task run inline. Value of
+/// 0 means tasks are never run inline.
+RAY_CONFIG(uint32_t, max_inline_tasks_in_flight, 1)
+
 /// Wait timeout for dashboard agent register.
 #ifdef _WIN32
 // agent startup time can involve creating conda environments
@@ -448,6 +504,34 @@ RAY_CONFIG(int64_t, gcs_server_request_timeout_seconds, 60)
 /// Whether to enable worker prestarting: https://github.com/ray-project/ray/issues/12052
 RAY_CONFIG(bool, enable_worker_prestart, true)
 
+/// Whether to start Python workers without a runtime env by forking them from a
+/// zygote process that has already imported the worker modules, instead of starting
+/// a new interpreter for each worker.
+RAY_CONFIG(bool, worker_fork_server_enabled, false)
+
+/// A cgroup-v2 directory delegated to the raylet. If set, each worker process is put
+/// in a group of its own under it, and the memory and CPU usage of the workers are
+/// read from cgroupfs. Empty means workers are not put in cgroups.
+RAY_CONFIG(std::string, worker_cgroup_root, "")
+
+/// Whether to cap the CPU time of a worker that is in a cgroup to the CPUs of the
+/// task it runs. Only used if worker_cgroup_root is set.
+RAY_CONFIG(bool, worker_cgroup_cpu_quota, false)
+
+/// Whether the memory monitor kills the worker whose cgroup uses the most memory,
+/// instead of the worker with the latest task, when the node runs out of memory.
+/// Only used if worker_cgroup_root is set.
+RAY_CONFIG(bool, worker_cgroup_kill_largest_on_oom, false)
+
+/// The interval at which the raylet samples the number of queued tasks of each kind
+/// of worker, to prestart the workers it forecasts will be needed and keep them from
+/// being killed as idle. Value of 0 means predictive prestart is disabled.
+RAY_CONFIG(uint64_t, worker_demand_forecast_period_ms, 0)
+
+/// The fraction of the gap to a lower demand that the worker demand forecast closes
+/// at each sample. Lower values keep idle workers around for longer.
+RAY_CONFIG(float, worker_demand_forecast_decay, 0.05)
+
 /// The interval of periodic idle worker killing. Value of 0 means worker capping is
 /// disabled.
 RAY_CONFIG(uint64_t, kill_idle_workers_interval_ms, 200)
@@ -498,6 +582,22 @@ RAY_CONFIG(int64_t, min_spilling_size, 100 * 1024 * 1024)
 /// take more than this percentage of the available memory.
 RAY_CONFIG(float, object_spilling_threshold, 0.8)
 
+/// If greater than 0, the raylet checks the object store usage at this interval
+/// and spills the coldest pinned objects in the background to keep some headroom
+/// free, instead of spilling only once object creation is blocked.
+RAY_CONFIG(uint64_t, proactive_spilling_interval_ms, 0)
+
+/// The fraction of the object store that proactive spilling tries to keep free.
+RAY_CONFIG(float, proactive_spilling_headroom_fraction, 0.2)
+
+/// Proactive spilling keeps at least enough headroom to absorb the bytes pinned
+/// at the current pin rate during this period.
+RAY_CONFIG(uint64_t, proactive_spilling_lookahead_ms, 1000)
+
+/// If the system memory usage is above this fraction, the proactive spilling
+/// headroom is doubled.
+RAY_CONFIG(float, proactive_spilling_memory_pressure_fraction, 0.85)
+
 /// Maximum number of objects that can be fused into a single file.
 RAY_CONFIG(int64_t, max_fused_object_count, 2000)
 
@@ -510,6 +610,15 @@ RAY_CONFIG(int64_t, oom_grace_period_s, 2)
 /// specified by object_spilling_config.
 RAY_CONFIG(bool, is_external_storage_type_fs, true)
 
+/// Whether a raylet adopts the objects that dead raylets on the same host left
+/// in the local spill directories, e.g. after a raylet restart. The objects are
+/// reported to their owners as spilled on the new node, so they can be restored
+/// instead of being reconstructed. A raylet holds a lock in each spill directory
+/// while it's alive only when this is enabled, and only the files of raylets that
+/// held such a lock are adopted, so all the raylets sharing a spill directory should
+/// use the same value.
+RAY_CONFIG(bool, recover_spilled_objects_on_restart, false)
+
 /// Control the capacity threshold for ray local file system (for object store).
 /// Once we are over the capacity, all subsequent object creation will fail.
 RAY_CONFIG(float, local_fs_capacity_threshold, 0.95);
@@ -517,6 +626,19 @@ RAY_CONFIG(float, local_fs_capacity_threshold, 0.95);
 /// Control the frequency of checking the disk usage.
 RAY_CONFIG(uint64_t, local_fs_monitor_interval_ms, 100);
 
+/// Directory of the plasma warm tier, a disk backed (ideally NVMe) mmapped arena
+/// between shared memory and external storage. Objects evicted from shared
+/// memory are demoted there and can still be read in place by clients.
+/// The warm tier is disabled if this is empty.
+RAY_CONFIG(std::string, plasma_warm_tier_directory, "")
+
+/// The size of the plasma warm tier arena in bytes.
+RAY_CONFIG(int64_t, plasma_warm_tier_capacity_bytes, 0)
+
+/// The number of accesses after which an object in the warm tier is promoted
+/// back to shared memory, if there is free space.
+RAY_CONFIG(int64_t, plasma_warm_tier_promotion_threshold, 2)
+
 /* Configuration parameters for locality-aware scheduling. */
 /// Whether to enable locality-aware leasing. If enabled, then Ray will consider task
 /// dependency locality when choosing a worker for leasing.
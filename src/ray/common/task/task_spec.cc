@@ -122,8 +122,11 @@ void TaskSpecification::ComputeResources() {
             : GetRequiredResources();
     const auto &function_descriptor = FunctionDescriptor();
     auto depth = GetDepth();
-    auto sched_cls_desc = SchedulingClassDescriptor(
-        resource_set, function_descriptor, depth, GetSchedulingStrategy());
+    auto sched_cls_desc = SchedulingClassDescriptor(resource_set,
+                                                    function_descriptor,
+                                                    depth,
+                                                    GetSchedulingStrategy(),
+                                                    GetPriority());
     // Map the scheduling class descriptor to an integer for performance.
     sched_cls_id_ = GetSchedulingClass(sched_cls_desc);
   }
@@ -180,6 +183,8 @@ bool TaskSpecification::HasRuntimeEnv() const {
 
 uint64_t TaskSpecification::AttemptNumber() const { return message_->attempt_number(); }
 
+int32_t TaskSpecification::MaxRetries() const { return message_->max_retries(); }
+
 int TaskSpecification::GetRuntimeEnvHash() const {
   absl::flat_hash_map<std::string, double> required_resource;
   if (RayConfig::instance().worker_resource_limits_enabled()) {
@@ -320,6 +325,16 @@ std::string TaskSpecification::GetDebuggerBreakpoint() const {
 
 int64_t TaskSpecification::GetDepth() const { return message_->depth(); }
 
+bool TaskSpecification::IsGangTask() const {
+  return !message_->gang_id().empty() && message_->gang_size() > 1;
+}
+
+const std::string &TaskSpecification::GetGangId() const { return message_->gang_id(); }
+
+int32_t TaskSpecification::GetGangSize() const { return message_->gang_size(); }
+
+int32_t TaskSpecification::GetPriority() const { return message_->priority(); }
+
 bool TaskSpecification::IsDriverTask() const {
   return message_->type() == TaskType::DRIVER_TASK;
 }
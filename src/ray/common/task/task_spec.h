@@ -46,20 +46,26 @@ struct SchedulingClassDescriptor {
   explicit SchedulingClassDescriptor(ResourceSet rs,
                                      FunctionDescriptor fd,
                                      int64_t d,
-                                     rpc::SchedulingStrategy scheduling_strategy)
+                                     rpc::SchedulingStrategy scheduling_strategy,
+                                     int32_t p = 0)
       : resource_set(std::move(rs)),
         function_descriptor(std::move(fd)),
         depth(d),
-        scheduling_strategy(std::move(scheduling_strategy)) {}
+        scheduling_strategy(std::move(scheduling_strategy)),
+        priority(p) {}
   ResourceSet resource_set;
   FunctionDescriptor function_descriptor;
   int64_t depth;
   rpc::SchedulingStrategy scheduling_strategy;
+  /// Tasks of different priorities never share a scheduling class, so that
+  /// the dispatch queues can be ordered by priority.
+  int32_t priority;
 
   bool operator==(const SchedulingClassDescriptor &other) const {
     return depth == other.depth && resource_set == other.resource_set &&
            function_descriptor == other.function_descriptor &&
-           scheduling_strategy == other.scheduling_strategy;
+           scheduling_strategy == other.scheduling_strategy &&
+           priority == other.priority;
   }
 
   std::string DebugString() const {
@@ -68,6 +74,7 @@ struct SchedulingClassDescriptor {
            << "depth=" << depth << " "
            << "function_descriptor=" << function_descriptor->ToString() << " "
            << "scheduling_strategy=" << scheduling_strategy.DebugString() << " "
+           << "priority=" << priority << " "
            << "resource_set="
            << "{";
     for (const auto &pair : resource_set.GetResourceMap()) {
@@ -113,6 +120,7 @@ struct hash<ray::SchedulingClassDescriptor> {
     hash ^= sched_cls.function_descriptor->Hash();
     hash ^= sched_cls.depth;
     hash ^= std::hash<ray::rpc::SchedulingStrategy>()(sched_cls.scheduling_strategy);
+    hash ^= std::hash<int32_t>()(sched_cls.priority);
     return hash;
   }
 };
@@ -213,6 +221,10 @@ class TaskSpecification : public MessageWrapper<rpc::TaskSpec> {
 
   uint64_t AttemptNumber() const;
 
+  /// The number of times a normal task is retried when its worker dies, -1 retries
+  /// it forever.
+  int32_t MaxRetries() const;
+
   size_t NumArgs() const;
 
   size_t NumReturns() const;
@@ -296,6 +308,19 @@ class TaskSpecification : public MessageWrapper<rpc::TaskSpec> {
   /// \return The depth.
   int64_t GetDepth() const;
 
+  /// Whether this task belongs to a gang of tasks that are placed all at once.
+  bool IsGangTask() const;
+
+  /// Return the id of the gang of this task, empty if it doesn't belong to one.
+  const std::string &GetGangId() const;
+
+  /// Return the number of tasks in the gang of this task.
+  int32_t GetGangSize() const;
+
+  /// Return the priority of this task. Tasks with a higher priority are
+  /// dispatched first.
+  int32_t GetPriority() const;
+
   bool IsDriverTask() const;
 
   Language GetLanguage() const;
@@ -153,6 +153,25 @@ class TaskSpecBuilder {
     return *this;
   }
 
+  /// Make the task a member of a gang of tasks that are placed all at once.
+  /// See `common.proto` for meaning of the arguments.
+  ///
+  /// \return Reference to the builder object itself.
+  TaskSpecBuilder &SetGang(const std::string &gang_id, int32_t gang_size) {
+    message_->set_gang_id(gang_id);
+    message_->set_gang_size(gang_size);
+    return *this;
+  }
+
+  /// Set the priority of the task. Tasks with a higher priority are dispatched
+  /// first. See `common.proto` for details.
+  ///
+  /// \return Reference to the builder object itself.
+  TaskSpecBuilder &SetPriority(int32_t priority) {
+    message_->set_priority(priority);
+    return *this;
+  }
+
   /// Set the driver attributes of the task spec.
   /// See `common.proto` for meaning of the arguments.
   ///
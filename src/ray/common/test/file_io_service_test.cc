@@ -0,0 +1,135 @@
+// Copyright 2023 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/common/file_io_service.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ray/common/asio/instrumented_io_context.h"
+#include "ray/util/util.h"
+
+namespace ray {
+
+// Runs every test with io_uring (when the kernel allows it) and with the thread
+// pool fallback.
+class FileIOServiceTest : public ::testing::TestWithParam<uint32_t> {
+ protected:
+  void SetUp() override {
+    path_ = (std::filesystem::temp_directory_path() / GenerateUUIDV4()).string();
+    fd_ = open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    ASSERT_GE(fd_, 0);
+    service_ = std::make_unique<FileIOService>(io_context_, 2, GetParam());
+  }
+
+  void TearDown() override {
+    service_.reset();
+    close(fd_);
+    std::filesystem::remove(path_);
+  }
+
+  /// Run the event loop until the given number of callbacks ran.
+  void RunCallbacks(int num_callbacks) {
+    while (num_callbacks_ < num_callbacks) {
+      io_context_.run_one();
+    }
+    io_context_.restart();
+  }
+
+  FileIOCallback ExpectResult(bool ok, size_t expected_bytes) {
+    return [this, ok, expected_bytes](const Status &status, size_t bytes) {
+      EXPECT_EQ(status.ok(), ok) << status.ToString();
+      EXPECT_EQ(bytes, expected_bytes);
+      num_callbacks_++;
+    };
+  }
+
+  instrumented_io_context io_context_;
+  boost::asio::io_context::work work_{io_context_};
+  std::string path_;
+  int fd_;
+  std::unique_ptr<FileIOService> service_;
+  int num_callbacks_ = 0;
+};
+
+TEST_P(FileIOServiceTest, TestWriteAndRead) {
+  const size_t num_chunks = 256;
+  const size_t chunk_size = 4096;
+  // More writes than the queue depth are in flight at the same time.
+  std::vector<std::string> chunks;
+  for (size_t i = 0; i < num_chunks; i++) {
+    chunks.emplace_back(chunk_size, static_cast<char>('a' + i % 26));
+  }
+  for (size_t i = 0; i < num_chunks; i++) {
+    service_->AsyncWrite(fd_,
+                         chunks[i].data(),
+                         chunk_size,
+                         i * chunk_size,
+                         ExpectResult(true, chunk_size));
+  }
+  service_->AsyncFsync(fd_, ExpectResult(true, 0));
+  RunCallbacks(num_chunks + 1);
+  ASSERT_EQ(service_->NumPendingOperations(), 0);
+
+  std::string data(num_chunks * chunk_size, '\0');
+  service_->AsyncRead(
+      fd_, data.data(), data.size(), 0, ExpectResult(true, num_chunks * chunk_size));
+  RunCallbacks(num_chunks + 2);
+  for (size_t i = 0; i < num_chunks; i++) {
+    ASSERT_EQ(data.substr(i * chunk_size, chunk_size), chunks[i]);
+  }
+
+  // Reads past the end of the file are short.
+  std::string tail(2 * chunk_size, '\0');
+  service_->AsyncRead(fd_,
+                      tail.data(),
+                      tail.size(),
+                      (num_chunks - 1) * chunk_size,
+                      ExpectResult(true, chunk_size));
+  RunCallbacks(num_chunks + 3);
+  ASSERT_EQ(tail.substr(0, chunk_size), chunks.back());
+}
+
+TEST_P(FileIOServiceTest, TestFallocate) {
+  service_->AsyncFallocate(fd_, 0, 1 << 20, ExpectResult(true, 0));
+  RunCallbacks(1);
+  struct stat st;
+  ASSERT_EQ(fstat(fd_, &st), 0);
+  ASSERT_EQ(st.st_size, 1 << 20);
+}
+
+TEST_P(FileIOServiceTest, TestError) {
+  char buffer[16];
+  service_->AsyncRead(-1, buffer, sizeof(buffer), 0, ExpectResult(false, 0));
+  service_->AsyncWrite(-1, buffer, sizeof(buffer), 0, ExpectResult(false, 0));
+  RunCallbacks(2);
+  ASSERT_EQ(service_->NumPendingOperations(), 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(FileIOService,
+                         FileIOServiceTest,
+                         ::testing::Values(/*thread pool*/ 0, /*io_uring*/ 16));
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -79,6 +79,14 @@ struct TaskOptions {
   /// fields which not contained in Runtime Env, such as eager_install.
   /// Propagated to child actors and tasks.
   std::string serialized_runtime_env_info;
+  /// Whether the submitting worker may run this task itself, without leasing a worker,
+  /// if it is executing a task whose resources it fits in.
+  bool allow_inline_execution = false;
+  /// The id of the gang this task belongs to, empty if it doesn't belong to one. The
+  /// tasks of a gang are placed all at once.
+  std::string gang_id;
+  /// The number of tasks in the gang.
+  int32_t gang_size = 0;
 };
 
 /// Options for actor creation tasks.
@@ -299,6 +299,12 @@ bool WorkerContext::ShouldReleaseResourcesOnBlockingCalls() const {
          CurrentThreadIsMain();
 }
 
+void WorkerContext::SetInlineTasksRunning(bool running) {
+  inline_tasks_running_ = running;
+}
+
+bool WorkerContext::InlineTasksRunning() const { return inline_tasks_running_; }
+
 // TODO(edoakes): simplify these checks now that we only support direct call mode.
 bool WorkerContext::CurrentActorIsDirectCall() const {
   absl::ReaderMutexLock lock(&mutex_);
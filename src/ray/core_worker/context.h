@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <boost/thread.hpp>
 
 #include "absl/base/thread_annotations.h"
@@ -72,6 +73,13 @@ class WorkerContext {
   /// This only applies to direct task calls.
   bool ShouldReleaseResourcesOnBlockingCalls() const;
 
+  /// Set whether tasks run inline use the resources of the task of the main thread.
+  void SetInlineTasksRunning(bool running);
+
+  /// Returns whether tasks run inline use the resources of the task of the main
+  /// thread. The resources are then kept by the worker when that task blocks.
+  bool InlineTasksRunning() const;
+
   /// Returns whether we are in a direct call actor.
   bool CurrentActorIsDirectCall() const LOCKS_EXCLUDED(mutex_);
 
@@ -117,6 +125,8 @@ class WorkerContext {
   std::shared_ptr<rpc::RuntimeEnvInfo> runtime_env_info_ GUARDED_BY(mutex_);
   /// The id of the (main) thread that constructed this worker context.
   const boost::thread::id main_thread_id_;
+  /// Whether tasks run inline use the resources of the task of the main thread.
+  std::atomic<bool> inline_tasks_running_ = false;
   // To protect access to mutable members;
   mutable absl::Mutex mutex_;
 
@@ -101,7 +101,8 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
                                   std::placeholders::_3,
                                   std::placeholders::_4,
                                   std::placeholders::_5,
-                                  std::placeholders::_6);
+                                  std::placeholders::_6,
+                                  /*is_inline=*/false);
     direct_task_receiver_ = std::make_unique<CoreWorkerDirectTaskReceiver>(
         worker_context_, task_execution_service_, execute_task, [this] {
           return local_raylet_client_->TaskDone();
@@ -552,6 +553,15 @@ void CoreWorker::Shutdown() {
       options_.terminate_asyncio_thread();
     }
     direct_task_receiver_->Stop();
+    BoundedExecutor *inline_task_executor = nullptr;
+    {
+      absl::MutexLock lock(&inline_tasks_mutex_);
+      inline_task_executor = inline_task_executor_.get();
+    }
+    if (inline_task_executor) {
+      inline_task_executor->Stop();
+      inline_task_executor->Join();
+    }
     task_execution_service_.stop();
   }
   if (options_.on_worker_shutdown) {
@@ -1294,6 +1304,22 @@ Status CoreWorker::Wait(const std::vector<ObjectID> &ids,
   if (fetch_local) {
     RetryObjectInPlasmaErrors(
         memory_store_, worker_context_, memory_object_ids, plasma_object_ids, ready);
+    // The objects we own whose primary copy is pinned in the local object store are
+    // ready without asking the raylet.
+    const NodeID local_node_id = GetCurrentNodeId();
+    for (auto it = plasma_object_ids.begin();
+         it != plasma_object_ids.end() && static_cast<int>(ready.size()) < num_objects;) {
+      bool owned_by_us = false;
+      NodeID pinned_at;
+      bool spilled = false;
+      auto current = it++;
+      if (reference_counter_->IsPlasmaObjectPinnedOrSpilled(
+              *current, &owned_by_us, &pinned_at, &spilled) &&
+          owned_by_us && !spilled && pinned_at == local_node_id) {
+        ready.insert(*current);
+        plasma_object_ids.erase(current);
+      }
+    }
     if (static_cast<int>(ready.size()) < num_objects && plasma_object_ids.size() > 0) {
       RAY_RETURN_NOT_OK(plasma_store_provider_->Wait(
           plasma_object_ids,
@@ -1654,6 +1680,9 @@ std::vector<rpc::ObjectReference> CoreWorker::SubmitTask(
                             retry_exceptions,
                             serialized_retry_exception_allowlist,
                             scheduling_strategy);
+  if (!task_options.gang_id.empty()) {
+    builder.SetGang(task_options.gang_id, task_options.gang_size);
+  }
   TaskSpecification task_spec = builder.Build();
   RAY_LOG(DEBUG) << "Submitting normal task " << task_spec.DebugString();
   std::vector<rpc::ObjectReference> returned_refs;
@@ -1662,11 +1691,13 @@ std::vector<rpc::ObjectReference> CoreWorker::SubmitTask(
   } else {
     returned_refs = task_manager_->AddPendingTask(
         task_spec.CallerAddress(), task_spec, CurrentCallSite(), max_retries);
-    io_service_.post(
-        [this, task_spec]() {
-          RAY_UNUSED(direct_task_submitter_->SubmitTask(task_spec));
-        },
-        "CoreWorker.SubmitTask");
+    if (!task_options.allow_inline_execution || !TryExecuteTaskInline(task_spec)) {
+      io_service_.post(
+          [this, task_spec]() {
+            RAY_UNUSED(direct_task_submitter_->SubmitTask(task_spec));
+          },
+          "CoreWorker.SubmitTask");
+    }
   }
   return returned_refs;
 }
@@ -1999,6 +2030,13 @@ Status CoreWorker::CancelTask(const ObjectID &object_id,
         object_id, obj_addr, force_kill, recursive);
   }
 
+  if (CancelInlineTask(object_id.TaskId())) {
+    if (force_kill) {
+      RAY_LOG(WARNING) << "Task " << object_id.TaskId() << " runs inline, so its worker "
+                       << "isn't killed.";
+    }
+    return Status::OK();
+  }
   auto task_spec = task_manager_->GetTaskSpec(object_id.TaskId());
   if (task_spec.has_value() && !task_spec.value().IsActorCreationTask()) {
     return direct_task_submitter_->CancelTask(task_spec.value(), force_kill, recursive);
@@ -2009,6 +2047,9 @@ Status CoreWorker::CancelTask(const ObjectID &object_id,
 Status CoreWorker::CancelChildren(const TaskID &task_id, bool force_kill) {
   bool recursive_success = true;
   for (const auto &child_id : task_manager_->GetPendingChildrenTasks(task_id)) {
+    if (CancelInlineTask(child_id)) {
+      continue;
+    }
     auto child_spec = task_manager_->GetTaskSpec(child_id);
     if (child_spec.has_value()) {
       auto result =
@@ -2228,7 +2269,8 @@ Status CoreWorker::ExecuteTask(
     std::vector<std::pair<ObjectID, std::shared_ptr<RayObject>>> *return_objects,
     std::vector<std::pair<ObjectID, std::shared_ptr<RayObject>>> *dynamic_return_objects,
     ReferenceCounter::ReferenceTableProto *borrowed_refs,
-    bool *is_retryable_error) {
+    bool *is_retryable_error,
+    bool is_inline) {
   RAY_LOG(DEBUG) << "Executing task, task info = " << task_spec.DebugString();
   task_queue_length_ -= 1;
   num_executed_tasks_ += 1;
@@ -2237,7 +2279,11 @@ Status CoreWorker::ExecuteTask(
   std::string func_name = task_spec.FunctionDescriptor()->CallString();
   task_counter_.MovePendingToRunning(func_name);
 
-  if (!options_.is_local_mode) {
+  if (is_inline) {
+    // Set only this thread's context: the main thread still runs the submitting task.
+    worker_context_.SetCurrentTask(task_spec);
+    worker_context_.SetCurrentTaskId(task_spec.TaskId(), task_spec.AttemptNumber());
+  } else if (!options_.is_local_mode) {
     worker_context_.SetCurrentTask(task_spec);
     SetCurrentTaskId(task_spec.TaskId(), task_spec.AttemptNumber(), task_spec.GetName());
   }
@@ -2335,6 +2381,11 @@ Status CoreWorker::ExecuteTask(
       defined_concurrency_groups,
       name_of_concurrency_group_to_execute);
   
+  if (task_spec.IsNormalTask() && !is_inline) {
+    // The reply returns the lease, which the tasks run inline still use.
+    WaitForInlineTasks();
+  }
+
   auto te_exec_call_task = current_sys_time_us();
   RAY_LOG(WARNING) << "hucc time for exec task callback to lanaguage time: " << te_exec_call_task << ", " << ts_exec_call_task <<"\n"; 
   // Get the reference counts for any IDs that we borrowed during this task,
@@ -2367,7 +2418,10 @@ Status CoreWorker::ExecuteTask(
            "reference counting, and may cause problems in the object store.";
   }
 
-  if (!options_.is_local_mode) {
+  if (is_inline) {
+    worker_context_.SetCurrentTaskId(TaskID::Nil(), /*attempt_number=*/0);
+    worker_context_.ResetCurrentTask();
+  } else if (!options_.is_local_mode) {
     SetCurrentTaskId(TaskID::Nil(), /*attempt_number=*/0, "");
     worker_context_.ResetCurrentTask();
   }
@@ -2376,7 +2430,7 @@ Status CoreWorker::ExecuteTask(
     auto it = current_tasks_.find(task_spec.TaskId());
     RAY_CHECK(it != current_tasks_.end());
     current_tasks_.erase(it);
-    if (task_spec.IsNormalTask()) {
+    if (task_spec.IsNormalTask() && !is_inline) {
       resource_ids_.reset(new ResourceMappingType());
     }
   }
@@ -2384,6 +2438,11 @@ Status CoreWorker::ExecuteTask(
   task_counter_.MoveRunningToFinished(func_name);
   RAY_LOG(DEBUG) << "Finished executing task " << task_spec.TaskId()
                  << ", status=" << status;
+  if (is_inline) {
+    // Don't exit the worker, it still runs the submitting task. ExecuteTaskInline fails
+    // this task instead.
+    return status;
+  }
 
   std::ostringstream stream;
   if (status.IsCreationTaskError()) {
@@ -2536,6 +2595,161 @@ std::vector<rpc::ObjectReference> CoreWorker::ExecuteTaskLocalMode(
   return returned_refs;
 }
 
+bool CoreWorker::TryExecuteTaskInline(const TaskSpecification &task_spec) {
+  const auto max_in_flight = RayConfig::instance().max_inline_tasks_in_flight();
+  if (options_.worker_type != WorkerType::WORKER || max_in_flight == 0) {
+    return false;
+  }
+  // The task borrows the lease of the task this thread is executing, so it must be
+  // able to run in its worker.
+  const auto current_task = worker_context_.GetCurrentTask();
+  if (current_task == nullptr || !current_task->IsNormalTask() ||
+      current_task->GetLanguage() != task_spec.GetLanguage() ||
+      current_task->SerializedRuntimeEnv() != task_spec.SerializedRuntimeEnv()) {
+    return false;
+  }
+  if (task_spec.GetSchedulingStrategy().scheduling_strategy_case() !=
+          rpc::SchedulingStrategy::SchedulingStrategyCase::kDefaultSchedulingStrategy ||
+      task_spec.ReturnsDynamic() || task_spec.IsGangTask()) {
+    return false;
+  }
+  // Arguments passed by reference would have to be fetched, or borrowed from this
+  // worker, which owns them.
+  for (size_t i = 0; i < task_spec.NumArgs(); i++) {
+    if (task_spec.ArgByRef(i) || !task_spec.ArgInlinedRefs(i).empty()) {
+      return false;
+    }
+  }
+
+  BoundedExecutor *inline_task_executor = nullptr;
+  {
+    absl::MutexLock lock(&inline_tasks_mutex_);
+    // Never queue a task behind another inline task: it could be the one waiting for
+    // it.
+    if (inline_tasks_.size() >= max_in_flight) {
+      return false;
+    }
+    // All the tasks run inline must fit in the lease at once.
+    ResourceSet resources = inline_task_resources_;
+    resources.AddResources(task_spec.GetRequiredResources());
+    if (!resources.IsSubset(current_task->GetRequiredResources())) {
+      return false;
+    }
+    inline_task_resources_ = std::move(resources);
+    inline_tasks_.emplace(task_spec.TaskId(), false);
+    // Keep the lease when the submitting task blocks, the inline tasks use it.
+    worker_context_.SetInlineTasksRunning(true);
+    if (!inline_task_executor_) {
+      inline_task_executor_ = std::make_unique<BoundedExecutor>(max_in_flight);
+    }
+    inline_task_executor = inline_task_executor_.get();
+  }
+
+  RAY_LOG(DEBUG) << "Executing task " << task_spec.TaskId() << " inline";
+  task_queue_length_ += 1;
+  task_counter_.IncPending(task_spec.FunctionDescriptor()->CallString());
+  task_manager_->MarkDependenciesResolved(task_spec.TaskId());
+  task_manager_->MarkTaskWaitingForExecution(task_spec.TaskId());
+  inline_task_executor->Post([this, task_spec]() { ExecuteTaskInline(task_spec); });
+  return true;
+}
+
+void CoreWorker::ExecuteTaskInline(const TaskSpecification &task_spec) {
+  const auto task_id = task_spec.TaskId();
+  bool cancelled = false;
+  {
+    absl::MutexLock lock(&inline_tasks_mutex_);
+    cancelled = inline_tasks_.at(task_id);
+  }
+
+  std::vector<std::pair<ObjectID, std::shared_ptr<RayObject>>> return_objects;
+  std::vector<std::pair<ObjectID, std::shared_ptr<RayObject>>> dynamic_return_objects;
+  auto reply = std::make_shared<rpc::PushTaskReply>();
+  Status status;
+  bool objects_valid = false;
+  if (cancelled) {
+    // The task was cancelled before it started, don't run it.
+    const std::string func_name = task_spec.FunctionDescriptor()->CallString();
+    task_queue_length_ -= 1;
+    task_counter_.MovePendingToRunning(func_name);
+    task_counter_.MoveRunningToFinished(func_name);
+  } else {
+    bool is_retryable_error = false;
+    status = ExecuteTask(task_spec,
+                         /*resource_ids=*/nullptr,
+                         &return_objects,
+                         &dynamic_return_objects,
+                         reply->mutable_borrowed_refs(),
+                         &is_retryable_error,
+                         /*is_inline=*/true);
+    reply->set_is_retryable_error(is_retryable_error);
+
+    objects_valid = return_objects.size() == task_spec.NumReturns();
+    for (const auto &return_object : return_objects) {
+      if (return_object.second == nullptr) {
+        objects_valid = false;
+      }
+    }
+    if (objects_valid) {
+      for (const auto &return_object : return_objects) {
+        SerializeReturnObject(
+            return_object.first, return_object.second, reply->add_return_objects());
+      }
+    }
+  }
+
+  {
+    absl::MutexLock lock(&inline_tasks_mutex_);
+    auto it = inline_tasks_.find(task_id);
+    cancelled = it->second;
+    inline_tasks_.erase(it);
+    inline_task_resources_.SubtractResources(task_spec.GetRequiredResources());
+    if (inline_tasks_.empty()) {
+      worker_context_.SetInlineTasksRunning(false);
+    }
+  }
+
+  // Complete the task on the io service, as for the reply of a worker.
+  io_service_.post(
+      [this, task_spec, reply, status, objects_valid, cancelled]() {
+        const auto task_id = task_spec.TaskId();
+        if (cancelled) {
+          RAY_UNUSED(task_manager_->FailOrRetryPendingTask(
+              task_id, rpc::ErrorType::TASK_CANCELLED, nullptr));
+        } else if (!objects_valid) {
+          RAY_UNUSED(task_manager_->FailOrRetryPendingTask(
+              task_id, rpc::ErrorType::WORKER_DIED, &status));
+        } else if (!task_spec.GetMessage().retry_exceptions() ||
+                   !reply->is_retryable_error() ||
+                   !task_manager_->RetryTaskIfPossible(task_id)) {
+          task_manager_->CompletePendingTask(task_id, *reply, rpc_address_);
+        }
+      },
+      "CoreWorker.ExecuteTaskInline");
+}
+
+bool CoreWorker::CancelInlineTask(const TaskID &task_id) {
+  {
+    absl::MutexLock lock(&inline_tasks_mutex_);
+    auto it = inline_tasks_.find(task_id);
+    if (it == inline_tasks_.end()) {
+      return false;
+    }
+    it->second = true;
+  }
+  RAY_LOG(INFO) << "Cancelling task " << task_id << ", which runs inline";
+  // A cancelled task isn't retried.
+  RAY_UNUSED(task_manager_->MarkTaskCanceled(task_id));
+  return true;
+}
+
+void CoreWorker::WaitForInlineTasks() {
+  absl::MutexLock lock(&inline_tasks_mutex_);
+  inline_tasks_mutex_.Await(absl::Condition(
+      +[](absl::flat_hash_map<TaskID, bool> *tasks) { return tasks->empty(); },
+      &inline_tasks_));
+}
+
 Status CoreWorker::GetAndPinArgsForExecutor(const TaskSpecification &task,
                                             std::vector<std::shared_ptr<RayObject>> *args,
                                             std::vector<rpc::ObjectReference> *arg_refs,
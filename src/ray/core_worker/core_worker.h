@@ -967,6 +967,9 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   ///                     objects whose IDs we passed to the task in its
   ///                     arguments and recursively, any object IDs that were
   ///                     contained in those objects.
+  /// \param spec[in] is_inline Whether the task runs inline, next to the task that
+  ///                 submitted it. The worker's task context and resources are then
+  ///                 left to the submitting task, and the worker doesn't exit.
   /// \return Status.
   Status ExecuteTask(
       const TaskSpecification &task_spec,
@@ -975,13 +978,41 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
       std::vector<std::pair<ObjectID, std::shared_ptr<RayObject>>>
           *dynamic_return_objects,
       ReferenceCounter::ReferenceTableProto *borrowed_refs,
-      bool *is_retryable_error);
+      bool *is_retryable_error,
+      bool is_inline = false);
 
   /// Put an object in the local plasma store.
   Status PutInLocalPlasmaStore(const RayObject &object,
                                const ObjectID &object_id,
                                bool pin_object);
 
+  /// Run a normal task on the inline task executor instead of leasing a worker for it,
+  /// if the task allows it and, with the other tasks run inline, fits in the resources
+  /// of the task that this thread is executing. The task must have been added to the
+  /// task manager.
+  ///
+  /// \param spec[in] task_spec Task specification.
+  /// \return Whether the task was posted to the inline task executor.
+  bool TryExecuteTaskInline(const TaskSpecification &task_spec);
+
+  /// Execute a task on the inline task executor, and complete it in the task manager
+  /// as if a worker had replied with its results.
+  ///
+  /// \param spec[in] task_spec Task specification.
+  void ExecuteTaskInline(const TaskSpecification &task_spec);
+
+  /// Cancel a task run inline. The thread running it can't be interrupted, so a task
+  /// that already started runs to the end, but it fails with TASK_CANCELLED either
+  /// way.
+  ///
+  /// \param spec[in] task_id The task to cancel.
+  /// \return Whether the task is run inline.
+  bool CancelInlineTask(const TaskID &task_id);
+
+  /// Wait until the tasks run inline have finished. They use the lease of the task of
+  /// the main thread, which must not be returned before.
+  void WaitForInlineTasks();
+
   /// Execute a local mode task (runs normal ExecuteTask)
   ///
   /// \param spec[in] task_spec Task specification.
@@ -1255,6 +1286,21 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   // Interface that receives tasks from direct actor calls.
   std::unique_ptr<CoreWorkerDirectTaskReceiver> direct_task_receiver_;
 
+  /// Protects the state of the tasks run inline.
+  absl::Mutex inline_tasks_mutex_;
+
+  /// Threads that run tasks inline for the task this worker is executing. Created when
+  /// the first task is run inline.
+  std::unique_ptr<BoundedExecutor> inline_task_executor_ GUARDED_BY(inline_tasks_mutex_);
+
+  /// The tasks posted to the inline task executor that haven't finished, and whether
+  /// each of them was cancelled.
+  absl::flat_hash_map<TaskID, bool> inline_tasks_ GUARDED_BY(inline_tasks_mutex_);
+
+  /// The resources of `inline_tasks_`. They are counted against the lease of the task
+  /// that submitted them.
+  ResourceSet inline_task_resources_ GUARDED_BY(inline_tasks_mutex_);
+
   /// Event loop where tasks are processed.
   /// task_execution_service_ should be destructed first to avoid
   /// issues like https://github.com/ray-project/ray/issues/18857
@@ -47,29 +47,34 @@ std::pair<rpc::Address, bool> LocalityAwareLeasePolicy::GetBestNodeForTask(
 /// Criteria for "best" node: The node with the most object bytes (from object_ids) local.
 absl::optional<NodeID> LocalityAwareLeasePolicy::GetBestNodeIdForTask(
     const TaskSpecification &spec) {
-  const auto object_ids = spec.GetDependencyIds();
-  // Number of object bytes (from object_ids) that a given node has local.
-  absl::flat_hash_map<NodeID, uint64_t> bytes_local_table;
   uint64_t max_bytes = 0;
   absl::optional<NodeID> max_bytes_node;
   // Finds the node with the maximum number of object bytes local.
+  for (const auto &[node_id, bytes] : GetArgBytesByNode(spec)) {
+    if (bytes > max_bytes) {
+      max_bytes = bytes;
+      max_bytes_node = node_id;
+    }
+  }
+  return max_bytes_node;
+}
+
+absl::flat_hash_map<NodeID, uint64_t> LocalityAwareLeasePolicy::GetArgBytesByNode(
+    const TaskSpecification &spec) {
+  const auto object_ids = spec.GetDependencyIds();
+  // Number of object bytes (from object_ids) that a given node has local.
+  absl::flat_hash_map<NodeID, uint64_t> bytes_local_table;
   for (const ObjectID &object_id : object_ids) {
     if (auto locality_data = locality_data_provider_->GetLocalityData(object_id)) {
       for (const NodeID &node_id : locality_data->nodes_containing_object) {
-        auto &bytes = bytes_local_table[node_id];
-        bytes += locality_data->object_size;
-        // Update max, if needed.
-        if (bytes > max_bytes) {
-          max_bytes = bytes;
-          max_bytes_node = node_id;
-        }
+        bytes_local_table[node_id] += locality_data->object_size;
       }
     } else {
       RAY_LOG(WARNING) << "No locality data available for object " << object_id
                        << ", won't be included in locality cost";
     }
   }
-  return max_bytes_node;
+  return bytes_local_table;
 }
 
 std::pair<rpc::Address, bool> LocalLeasePolicy::GetBestNodeForTask(
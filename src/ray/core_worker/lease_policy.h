@@ -45,6 +45,12 @@ class LeasePolicyInterface {
   virtual std::pair<rpc::Address, bool> GetBestNodeForTask(
       const TaskSpecification &spec) = 0;
 
+  /// Get the bytes of the arguments of the provided task already on each node.
+  virtual absl::flat_hash_map<NodeID, uint64_t> GetArgBytesByNode(
+      const TaskSpecification &spec) {
+    return {};
+  }
+
   virtual ~LeasePolicyInterface() {}
 };
 
@@ -69,6 +75,10 @@ class LocalityAwareLeasePolicy : public LeasePolicyInterface {
   std::pair<rpc::Address, bool> GetBestNodeForTask(
       const TaskSpecification &spec) override;
 
+  /// Get the bytes of the arguments of the provided task already on each node.
+  absl::flat_hash_map<NodeID, uint64_t> GetArgBytesByNode(
+      const TaskSpecification &spec) override;
+
  private:
   /// Get the best worker node for a lease request for the provided task.
   absl::optional<NodeID> GetBestNodeIdForTask(const TaskSpecification &spec);
@@ -360,7 +360,10 @@ Status CoreWorkerMemoryStore::GetImpl(const std::vector<ObjectID> &object_ids,
     // hucc add time for NotifyDirectCallTaskBlocked
     // auto ts_ndctb = current_sys_time_us();
 
-    RAY_CHECK_OK(raylet_client_->NotifyDirectCallTaskBlocked(/*release_resources=*/true));
+    // The tasks run inline use the resources of the blocked task, so they can't be
+    // given to other leases.
+    RAY_CHECK_OK(raylet_client_->NotifyDirectCallTaskBlocked(
+        /*release_resources=*/!ctx.InlineTasksRunning()));
 
     // auto te_ndctb = current_sys_time_us();
     // RAY_LOG(INFO) << "hucc time for NotifyDirectCallTaskBlocked in local mem: " << te_ndctb - ts_ndctb << "\n";
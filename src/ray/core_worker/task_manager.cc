@@ -752,6 +752,17 @@ void TaskManager::MarkTaskWaitingForExecution(const TaskID &task_id) {
   it->second.SetStatus(rpc::TaskStatus::WAITING_FOR_EXECUTION);
 }
 
+void TaskManager::MarkTaskNotExecuted(const TaskID &task_id) {
+  absl::MutexLock lock(&mu_);
+  auto it = submissible_tasks_.find(task_id);
+  if (it == submissible_tasks_.end()) {
+    return;
+  }
+  if (it->second.GetStatus() == rpc::TaskStatus::WAITING_FOR_EXECUTION) {
+    it->second.SetStatus(rpc::TaskStatus::SCHEDULED);
+  }
+}
+
 void TaskManager::FillTaskInfo(rpc::GetCoreWorkerStatsReply *reply,
                                const int64_t limit) const {
   absl::MutexLock lock(&mu_);
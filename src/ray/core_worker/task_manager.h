@@ -67,6 +67,8 @@ class TaskFinisherInterface {
 
   virtual void MarkTaskWaitingForExecution(const TaskID &task_id) = 0;
 
+  virtual void MarkTaskNotExecuted(const TaskID &task_id) = 0;
+
   virtual void OnTaskDependenciesInlined(
       const std::vector<ObjectID> &inlined_dependency_ids,
       const std::vector<ObjectID> &contained_ids) = 0;
@@ -280,6 +282,12 @@ class TaskManager : public TaskFinisherInterface, public TaskResubmissionInterfa
   /// \param[in] task_id The task that is will be running.
   void MarkTaskWaitingForExecution(const TaskID &task_id) override;
 
+  /// Record that the worker the given task was pushed to exited without running it,
+  /// and that the task is scheduled again.
+  ///
+  /// \param[in] task_id The task that is scheduled again.
+  void MarkTaskNotExecuted(const TaskID &task_id) override;
+
   /// Add debug information about the current task status for the ObjectRefs
   /// included in the given stats.
   ///
@@ -109,6 +109,8 @@ class MockTaskFinisher : public TaskFinisherInterface {
 
   void MarkTaskWaitingForExecution(const TaskID &task_id) override {}
 
+  void MarkTaskNotExecuted(const TaskID &task_id) override {}
+
   int num_tasks_complete = 0;
   int num_tasks_failed = 0;
   int num_inlined_dependencies = 0;
@@ -215,6 +215,11 @@ TEST(LocalityAwareLeasePolicyTest, TestBestLocalityBetterNode) {
   // Test that best node was chosen.
   ASSERT_EQ(NodeID::FromBinary(best_node_address.raylet_id()), best_node);
   ASSERT_TRUE(is_selected_based_on_locality);
+  // The bytes on each node are sent to the raylet to weigh data locality.
+  absl::flat_hash_map<NodeID, uint64_t> expected_arg_bytes_by_node{
+      {fallback_node, 8}, {bad_node, 24}, {best_node, 28}};
+  ASSERT_EQ(locality_lease_policy.GetArgBytesByNode(task_spec),
+            expected_arg_bytes_by_node);
 }
 
 TEST(LocalityAwareLeasePolicyTest, TestBestLocalityFallbackNoLocations) {
@@ -108,6 +108,12 @@ TEST_F(TaskManagerTest, TestTaskSuccess) {
   ASSERT_FALSE(manager_.IsTaskWaitingForExecution(spec.TaskId()));
   manager_.MarkTaskWaitingForExecution(spec.TaskId());
   ASSERT_TRUE(manager_.IsTaskWaitingForExecution(spec.TaskId()));
+  // The worker exited before running the task, which is pushed to another one.
+  manager_.MarkTaskNotExecuted(spec.TaskId());
+  ASSERT_TRUE(manager_.IsTaskPending(spec.TaskId()));
+  ASSERT_FALSE(manager_.IsTaskWaitingForExecution(spec.TaskId()));
+  manager_.MarkTaskWaitingForExecution(spec.TaskId());
+  ASSERT_TRUE(manager_.IsTaskWaitingForExecution(spec.TaskId()));
   rpc::PushTaskReply reply;
   auto return_object = reply.add_return_objects();
   return_object->set_object_id(return_id.Binary());
@@ -47,6 +47,11 @@
 namespace ray {
 namespace core {
 
+/// Serialize a task return object into the reply to the caller of the task.
+void SerializeReturnObject(const ObjectID &object_id,
+                           const std::shared_ptr<RayObject> &return_object,
+                           rpc::ReturnObject *return_object_proto);
+
 class CoreWorkerDirectTaskReceiver {
  public:
   using TaskHandler = std::function<Status(
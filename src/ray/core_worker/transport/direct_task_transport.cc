@@ -86,33 +86,39 @@ Status CoreWorkerDirectTaskSubmitter::SubmitTask(TaskSpecification task_spec) {
       if (keep_executing) {
         // Note that the dependencies in the task spec are mutated to only contain
         // plasma dependencies after ResolveDependencies finishes.
-        const SchedulingKey scheduling_key(task_spec.GetSchedulingClass(),
-                                           task_spec.GetDependencyIds(),
-                                           task_spec.IsActorCreationTask()
-                                               ? task_spec.ActorCreationId()
-                                               : ActorID::Nil(),
-                                           task_spec.GetRuntimeEnvHash());
+        const SchedulingKey scheduling_key = GetSchedulingKey(task_spec);
         auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
         scheduling_key_entry.task_queue.push_back(task_spec);
         scheduling_key_entry.resource_spec = task_spec;
+        if (scheduling_key_entry.task_queue.size() == 1 &&
+            std::get<2>(scheduling_key).IsNil()) {
+          scheduling_keys_by_reuse_key_[GetWorkerReuseKey(scheduling_key)].insert(
+              scheduling_key);
+        }
 
-        if (!scheduling_key_entry.AllWorkersBusy()) {
-          // There are idle workers, so we don't need more
-          // workers.
-
-          for (auto active_worker_addr : scheduling_key_entry.active_workers) {
+        if (!scheduling_key_entry.AllPipelinesToWorkersFull(
+                max_tasks_in_flight_per_worker_)) {
+          // There are workers with room in their pipeline, so we don't need more
+          // workers. Push to the least loaded one, so that tasks are spread out.
+          const rpc::WorkerAddress *least_loaded_addr = nullptr;
+          uint32_t least_tasks_in_flight = max_tasks_in_flight_per_worker_;
+          for (const auto &active_worker_addr : scheduling_key_entry.active_workers) {
             RAY_CHECK(worker_to_lease_entry_.find(active_worker_addr) !=
                       worker_to_lease_entry_.end());
-            auto &lease_entry = worker_to_lease_entry_[active_worker_addr];
-            if (!lease_entry.is_busy) {
-              OnWorkerIdle(active_worker_addr,
-                           scheduling_key,
-                           /*was_error*/ false,
-                           /*worker_exiting*/ false,
-                           lease_entry.assigned_resources);
-              break;
+            const auto &lease_entry = worker_to_lease_entry_[active_worker_addr];
+            if (lease_entry.tasks_in_flight < least_tasks_in_flight) {
+              least_loaded_addr = &active_worker_addr;
+              least_tasks_in_flight = lease_entry.tasks_in_flight;
             }
           }
+          if (least_loaded_addr != nullptr) {
+            const rpc::WorkerAddress addr = *least_loaded_addr;
+            OnWorkerIdle(addr,
+                         scheduling_key,
+                         /*was_error*/ false,
+                         /*worker_exiting*/ false,
+                         worker_to_lease_entry_[addr].assigned_resources);
+          }
         }
         RequestNewWorkerIfNeeded(scheduling_key);
       }
@@ -151,7 +157,7 @@ void CoreWorkerDirectTaskSubmitter::ReturnWorker(const rpc::WorkerAddress addr,
   RAY_CHECK(scheduling_key_entry.active_workers.size() >= 1);
   auto &lease_entry = worker_to_lease_entry_[addr];
   RAY_CHECK(lease_entry.lease_client);
-  RAY_CHECK(!lease_entry.is_busy);
+  RAY_CHECK(lease_entry.tasks_in_flight == 0);
 
   // Decrement the number of active workers consuming tasks from the queue associated
   // with the current scheduling_key
@@ -159,7 +165,7 @@ void CoreWorkerDirectTaskSubmitter::ReturnWorker(const rpc::WorkerAddress addr,
   if (scheduling_key_entry.CanDelete()) {
     // We can safely remove the entry keyed by scheduling_key from the
     // scheduling_key_entries_ hashmap.
-    scheduling_key_entries_.erase(scheduling_key);
+    EraseSchedulingKeyEntry(scheduling_key);
   }
 
   auto status = lease_entry.lease_client->ReturnWorker(
@@ -180,9 +186,23 @@ void CoreWorkerDirectTaskSubmitter::OnWorkerIdle(
   if (!lease_entry.lease_client) {
     return;
   }
+  worker_exiting = worker_exiting || lease_entry.worker_exiting;
 
   auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
   auto &current_queue = scheduling_key_entry.task_queue;
+  if (!was_error && !worker_exiting && lease_entry.tasks_in_flight == 0 &&
+      current_queue.empty() && current_time_ms() <= lease_entry.lease_expiration_time) {
+    // Keep the worker for the tasks of another function with the same resource shape,
+    // instead of returning it to the raylet and leasing it again.
+    auto reuse_key = FindSchedulingKeyToReuseWorker(scheduling_key);
+    if (reuse_key) {
+      RAY_LOG(DEBUG) << "Reusing worker " << addr.worker_id
+                     << " for tasks of another scheduling key";
+      MoveWorkerLease(addr, scheduling_key, *reuse_key);
+      OnWorkerIdle(addr, *reuse_key, was_error, worker_exiting, assigned_resources);
+      return;
+    }
+  }
   // Return the worker if there was an error executing the previous task,
   // the lease is expired; Return the worker if there are no more applicable
   // queued tasks.
@@ -192,21 +212,23 @@ void CoreWorkerDirectTaskSubmitter::OnWorkerIdle(
     RAY_CHECK(scheduling_key_entry.active_workers.size() >= 1);
 
     // Return the worker only if there are no tasks to do.
-    if (!lease_entry.is_busy) {
+    if (lease_entry.tasks_in_flight == 0) {
       ReturnWorker(addr, was_error, worker_exiting, scheduling_key);
     }
   } else {
     auto &client = *client_cache_->GetOrConnect(addr.ToProto());
 
-    while (!current_queue.empty() && !lease_entry.is_busy) {
+    // Fill the worker's pipeline, it queues the tasks behind the running one.
+    while (!current_queue.empty() &&
+           lease_entry.tasks_in_flight < max_tasks_in_flight_per_worker_) {
       auto task_spec = current_queue.front();
-      lease_entry.is_busy = true;
+      lease_entry.tasks_in_flight++;
 
       // Increment the total number of tasks in flight to any worker associated with the
       // current scheduling_key
 
       RAY_CHECK(scheduling_key_entry.active_workers.size() >= 1);
-      scheduling_key_entry.num_busy_workers++;
+      scheduling_key_entry.total_tasks_in_flight++;
 
       executing_tasks_.emplace(task_spec.TaskId(), addr);
       PushNormalTask(addr, client, scheduling_key, task_spec, assigned_resources);
@@ -218,6 +240,93 @@ void CoreWorkerDirectTaskSubmitter::OnWorkerIdle(
   RequestNewWorkerIfNeeded(scheduling_key);
 }
 
+SchedulingKey CoreWorkerDirectTaskSubmitter::GetSchedulingKey(
+    const TaskSpecification &task_spec) {
+  ActorID actor_id = ActorID::Nil();
+  if (task_spec.IsActorCreationTask()) {
+    actor_id = task_spec.ActorCreationId();
+  } else if (task_spec.IsGangTask()) {
+    // Key every task of a gang on its own, so that the raylet gets a lease request
+    // for each of them and their workers are never shared.
+    actor_id = ActorID::Of(task_spec.JobId(), task_spec.TaskId(), 0);
+  }
+  return SchedulingKey(task_spec.GetSchedulingClass(),
+                       task_spec.GetDependencyIds(),
+                       actor_id,
+                       task_spec.GetRuntimeEnvHash());
+}
+
+SchedulingKey CoreWorkerDirectTaskSubmitter::GetWorkerReuseKey(
+    const SchedulingKey &scheduling_key) {
+  // The descriptor is copied, the registry it is in may grow concurrently.
+  SchedulingClassDescriptor descriptor =
+      TaskSpecification::GetSchedulingClassDescriptor(std::get<0>(scheduling_key));
+  descriptor.function_descriptor = FunctionDescriptorBuilder::Empty();
+  return std::make_tuple(TaskSpecification::GetSchedulingClass(descriptor),
+                         std::get<1>(scheduling_key),
+                         ActorID::Nil(),
+                         std::get<3>(scheduling_key));
+}
+
+absl::optional<SchedulingKey>
+CoreWorkerDirectTaskSubmitter::FindSchedulingKeyToReuseWorker(
+    const SchedulingKey &scheduling_key) {
+  // Actor creation tasks and the tasks of a gang get a dedicated worker.
+  if (!std::get<2>(scheduling_key).IsNil()) {
+    return absl::nullopt;
+  }
+  auto it = scheduling_keys_by_reuse_key_.find(GetWorkerReuseKey(scheduling_key));
+  if (it == scheduling_keys_by_reuse_key_.end()) {
+    return absl::nullopt;
+  }
+  absl::optional<SchedulingKey> best_key;
+  int64_t best_num_unleased_tasks = 0;
+  for (const auto &key : it->second) {
+    auto entry_it = scheduling_key_entries_.find(key);
+    if (key == scheduling_key || entry_it == scheduling_key_entries_.end() ||
+        entry_it->second.task_queue.empty()) {
+      continue;
+    }
+    const auto &entry = entry_it->second;
+    // The tasks without a pending lease are the ones the worker helps most. Keys
+    // whose tasks all have a pending lease are still worth it, the worker is ready.
+    int64_t num_unleased_tasks = static_cast<int64_t>(entry.task_queue.size()) -
+                                 static_cast<int64_t>(entry.num_pending_leases);
+    if (!best_key || num_unleased_tasks > best_num_unleased_tasks) {
+      best_key = key;
+      best_num_unleased_tasks = num_unleased_tasks;
+    }
+  }
+  return best_key;
+}
+
+void CoreWorkerDirectTaskSubmitter::EraseSchedulingKeyEntry(
+    const SchedulingKey &scheduling_key) {
+  scheduling_key_entries_.erase(scheduling_key);
+  if (!std::get<2>(scheduling_key).IsNil()) {
+    return;
+  }
+  auto it = scheduling_keys_by_reuse_key_.find(GetWorkerReuseKey(scheduling_key));
+  if (it != scheduling_keys_by_reuse_key_.end()) {
+    it->second.erase(scheduling_key);
+    if (it->second.empty()) {
+      scheduling_keys_by_reuse_key_.erase(it);
+    }
+  }
+}
+
+void CoreWorkerDirectTaskSubmitter::MoveWorkerLease(const rpc::WorkerAddress &addr,
+                                                     const SchedulingKey &from_key,
+                                                     const SchedulingKey &to_key) {
+  auto &from_entry = scheduling_key_entries_[from_key];
+  RAY_CHECK(from_entry.active_workers.erase(addr));
+  if (from_entry.CanDelete()) {
+    EraseSchedulingKeyEntry(from_key);
+  }
+  RAY_CHECK(scheduling_key_entries_[to_key].active_workers.emplace(addr).second);
+  worker_to_lease_entry_[addr].scheduling_key = to_key;
+}
+
 void CoreWorkerDirectTaskSubmitter::CancelWorkerLeaseIfNeeded(
     const SchedulingKey &scheduling_key) {
   auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
@@ -334,8 +443,8 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
   RAY_CHECK(scheduling_key_entry.pending_lease_requests.size() <
             max_pending_lease_requests_per_scheduling_category_);
 
-  if (!scheduling_key_entry.AllWorkersBusy()) {
-    // There are idle workers, so we don't need more.
+  if (!scheduling_key_entry.AllPipelinesToWorkersFull(max_tasks_in_flight_per_worker_)) {
+    // The pipelines to some workers aren't full, so we don't need more.
     return;
   }
 
@@ -344,20 +453,38 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
     if (scheduling_key_entry.CanDelete()) {
       // We can safely remove the entry keyed by scheduling_key from the
       // scheduling_key_entries_ hashmap.
-      scheduling_key_entries_.erase(scheduling_key);
+      EraseSchedulingKeyEntry(scheduling_key);
     }
     return;
   } else if (scheduling_key_entry.task_queue.size() <=
-             scheduling_key_entry.pending_lease_requests.size()) {
+             scheduling_key_entry.num_pending_leases) {
     // All tasks have corresponding pending leases, no need to request more
     return;
   }
+  // Ask for a worker for each task without a pending lease, so that a burst of tasks
+  // is leased workers in few round-trips.
+  const uint64_t max_leases =
+      std::min<uint64_t>(max_leases_per_lease_request_,
+                         task_queue.size() - scheduling_key_entry.num_pending_leases);
 
   num_leases_requested_++;
   // Create a TaskSpecification with an overwritten TaskID to make sure we don't reuse the
   // same TaskID to request a worker
   auto resource_spec_msg = scheduling_key_entry.resource_spec.GetMutableMessage();
   resource_spec_msg.set_task_id(TaskID::FromRandom(job_id_).Binary());
+  if (scheduling_key_entry.gang_placed) {
+    // The rest of the gang has been placed, so the raylet mustn't wait for it again.
+    resource_spec_msg.clear_gang_id();
+    resource_spec_msg.clear_gang_size();
+  }
+  if (RayConfig::instance().scheduler_data_locality_weight() > 0) {
+    // Let the raylet weigh the data locality of the nodes it may pick.
+    auto &arg_bytes_by_node = *resource_spec_msg.mutable_lease_arg_bytes_by_node();
+    for (const auto &[node_id, bytes] :
+         lease_policy_->GetArgBytesByNode(scheduling_key_entry.resource_spec)) {
+      arg_bytes_by_node[node_id.Binary()] = bytes;
+    }
+  }
   const TaskSpecification resource_spec = TaskSpecification(resource_spec_msg);
   rpc::Address best_node_address;
   const bool is_spillback = (raylet_address != nullptr);
@@ -378,8 +505,13 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
   lease_client->RequestWorkerLease(
       resource_spec.GetMessage(),
       /*grant_or_reject=*/is_spillback,
-      [this, scheduling_key, task_id, is_spillback, raylet_address = *raylet_address](
-          const Status &status, const rpc::RequestWorkerLeaseReply &reply) {
+      [this,
+       scheduling_key,
+       task_id,
+       is_spillback,
+       max_leases,
+       raylet_address = *raylet_address](const Status &status,
+                                         const rpc::RequestWorkerLeaseReply &reply) {
         std::deque<TaskSpecification> tasks_to_fail;
         rpc::RayErrorInfo error_info;
         ray::Status error_status;
@@ -390,6 +522,22 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
           auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
           auto lease_client = GetOrConnectLeaseClient(&raylet_address);
           scheduling_key_entry.pending_lease_requests.erase(task_id);
+          scheduling_key_entry.num_pending_leases -= max_leases;
+
+          // The additional workers are added before handling the reply, so that they
+          // are counted as idle instead of being leased again.
+          std::vector<rpc::WorkerAddress> additional_workers;
+          if (status.ok()) {
+            for (const auto &lease : reply.additional_leases()) {
+              rpc::WorkerAddress addr(lease.worker_address());
+              RAY_LOG(DEBUG) << "Additional lease granted with task " << task_id
+                             << " from raylet " << addr.raylet_id << " with worker "
+                             << addr.worker_id;
+              AddWorkerLeaseClient(
+                  addr, lease_client, lease.resource_mapping(), scheduling_key);
+              additional_workers.push_back(addr);
+            }
+          }
 
           if (status.ok()) {
             if (reply.canceled()) {
@@ -430,7 +578,7 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
                 tasks_to_fail = std::move(scheduling_key_entry.task_queue);
                 scheduling_key_entry.task_queue.clear();
                 if (scheduling_key_entry.CanDelete()) {
-                  scheduling_key_entries_.erase(scheduling_key);
+                  EraseSchedulingKeyEntry(scheduling_key);
                 }
               } else {
                 RequestNewWorkerIfNeeded(scheduling_key);
@@ -463,6 +611,9 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
             } else {
               // The raylet redirected us to a different raylet to retry at.
               RAY_CHECK(!is_spillback);
+              // The raylet only redirects the task of a gang once it placed the gang.
+              scheduling_key_entry.gang_placed =
+                  scheduling_key_entry.resource_spec.IsGangTask();
               RAY_LOG(DEBUG) << "Redirect lease for task " << task_id << " from raylet "
                              << NodeID::FromBinary(raylet_address.raylet_id())
                              << " to raylet "
@@ -499,7 +650,7 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
               tasks_to_fail = std::move(scheduling_key_entry.task_queue);
               scheduling_key_entry.task_queue.clear();
               if (scheduling_key_entry.CanDelete()) {
-                scheduling_key_entries_.erase(scheduling_key);
+                EraseSchedulingKeyEntry(scheduling_key);
               }
             } else {
               RAY_LOG(WARNING)
@@ -511,6 +662,16 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
               RequestNewWorkerIfNeeded(scheduling_key);
             }
           }
+
+          // Push tasks to the additional workers, tasks are pipelined across all the
+          // workers leased by the request.
+          for (size_t i = 0; i < additional_workers.size(); i++) {
+            OnWorkerIdle(additional_workers[i],
+                         scheduling_key,
+                         /*error=*/false,
+                         /*worker_exiting=*/false,
+                         reply.additional_leases(i).resource_mapping());
+          }
         }
 
         while (!tasks_to_fail.empty()) {
@@ -530,8 +691,10 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
         }
       },
       task_queue.size(),
-      is_selected_based_on_locality);
+      is_selected_based_on_locality,
+      max_leases);
   scheduling_key_entry.pending_lease_requests.emplace(task_id, *raylet_address);
+  scheduling_key_entry.num_pending_leases += max_leases;
   ReportWorkerBacklogIfNeeded(scheduling_key);
 }
 
@@ -568,6 +731,7 @@ void CoreWorkerDirectTaskSubmitter::PushNormalTask(
        scheduling_key,
        addr,
        assigned_resources](Status status, const rpc::PushTaskReply &reply) {
+        bool resubmit = false;
         {
           //hucc push normal task end
           auto te_push_task = current_sys_time_us();
@@ -581,15 +745,23 @@ void CoreWorkerDirectTaskSubmitter::PushNormalTask(
 
           // Decrement the number of tasks in flight to the worker
           auto &lease_entry = worker_to_lease_entry_[addr];
-          RAY_CHECK(lease_entry.is_busy);
-          lease_entry.is_busy = false;
+          RAY_CHECK(lease_entry.tasks_in_flight > 0);
+          lease_entry.tasks_in_flight--;
+          // A task pipelined behind the last task of an exiting worker never ran, so
+          // it is submitted again without using one of its retries.
+          resubmit = !status.ok() && lease_entry.worker_exiting &&
+                     std::get<2>(scheduling_key).IsNil() &&
+                     !cancelled_tasks_.contains(task_id);
+          if (reply.worker_exiting()) {
+            lease_entry.worker_exiting = true;
+          }
 
           // Decrement the total number of tasks in flight to any worker with the current
           // scheduling_key.
           auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
           RAY_CHECK_GE(scheduling_key_entry.active_workers.size(), 1u);
-          RAY_CHECK_GE(scheduling_key_entry.num_busy_workers, 1u);
-          scheduling_key_entry.num_busy_workers--;
+          RAY_CHECK_GE(scheduling_key_entry.total_tasks_in_flight, 1u);
+          scheduling_key_entry.total_tasks_in_flight--;
 
           if (!status.ok() || !is_actor_creation || reply.worker_exiting()) {
             // Successful actor creation leases the worker indefinitely from the raylet.
@@ -599,6 +771,22 @@ void CoreWorkerDirectTaskSubmitter::PushNormalTask(
                          /*worker_exiting=*/reply.worker_exiting(),
                          assigned_resources);
           }
+          if (resubmit) {
+            RAY_LOG(DEBUG) << "Resubmitting task " << task_id
+                           << " pipelined to exiting worker " << addr.worker_id;
+            task_finisher_->MarkTaskNotExecuted(task_id);
+            auto &entry = scheduling_key_entries_[scheduling_key];
+            entry.task_queue.push_front(task_spec);
+            if (entry.task_queue.size() == 1) {
+              entry.resource_spec = task_spec;
+              scheduling_keys_by_reuse_key_[GetWorkerReuseKey(scheduling_key)].insert(
+                  scheduling_key);
+            }
+            RequestNewWorkerIfNeeded(scheduling_key);
+          }
+        }
+        if (resubmit) {
+          return;
         }
         if (!status.ok()) {
           // TODO: It'd be nice to differentiate here between process vs node
@@ -623,11 +811,7 @@ Status CoreWorkerDirectTaskSubmitter::CancelTask(TaskSpecification task_spec,
                                                  bool recursive) {
   RAY_LOG(INFO) << "Cancelling a task: " << task_spec.TaskId()
                 << " force_kill: " << force_kill << " recursive: " << recursive;
-  const SchedulingKey scheduling_key(
-      task_spec.GetSchedulingClass(),
-      task_spec.GetDependencyIds(),
-      task_spec.IsActorCreationTask() ? task_spec.ActorCreationId() : ActorID::Nil(),
-      task_spec.GetRuntimeEnvHash());
+  const SchedulingKey scheduling_key = GetSchedulingKey(task_spec);
   std::shared_ptr<rpc::CoreWorkerClientInterface> client = nullptr;
   {
     absl::MutexLock lock(&mu_);
@@ -666,7 +850,7 @@ Status CoreWorkerDirectTaskSubmitter::CancelTask(TaskSpecification task_spec,
       if (scheduling_key_entry.CanDelete()) {
         // We can safely remove the entry keyed by scheduling_key from the
         // scheduling_key_entries_ hashmap.
-        scheduling_key_entries_.erase(scheduling_key);
+        EraseSchedulingKeyEntry(scheduling_key);
       }
       return Status::OK();
     }
@@ -71,7 +71,11 @@ class CoreWorkerDirectTaskSubmitter {
       const JobID &job_id,
       absl::optional<boost::asio::steady_timer> cancel_timer = absl::nullopt,
       uint64_t max_pending_lease_requests_per_scheduling_category =
-          ::RayConfig::instance().max_pending_lease_requests_per_scheduling_category())
+          ::RayConfig::instance().max_pending_lease_requests_per_scheduling_category(),
+      uint64_t max_leases_per_lease_request =
+          ::RayConfig::instance().max_leases_per_lease_request(),
+      uint32_t max_tasks_in_flight_per_worker =
+          ::RayConfig::instance().max_tasks_in_flight_per_worker())
       : rpc_address_(rpc_address),
         local_lease_client_(lease_client),
         lease_client_factory_(lease_client_factory),
@@ -86,6 +90,10 @@ class CoreWorkerDirectTaskSubmitter {
         job_id_(job_id),
         max_pending_lease_requests_per_scheduling_category_(
             max_pending_lease_requests_per_scheduling_category),
+        max_leases_per_lease_request_(
+            std::max<uint64_t>(max_leases_per_lease_request, 1)),
+        max_tasks_in_flight_per_worker_(
+            std::max<uint32_t>(max_tasks_in_flight_per_worker, 1)),
         cancel_retry_timer_(std::move(cancel_timer)) {}
 
   /// Schedule a task for direct submission to a worker.
@@ -123,9 +131,10 @@ class CoreWorkerDirectTaskSubmitter {
   void ReportWorkerBacklog();
 
  private:
-  /// Schedule more work onto an idle worker or return it back to the raylet if
-  /// no more tasks are queued for submission. If an error was encountered
-  /// processing the worker, we don't attempt to re-use the worker.
+  /// Schedule more work onto a worker with room in its pipeline or return it back to
+  /// the raylet if no more tasks are queued for submission and none is in flight. If
+  /// an error was encountered processing the worker, we don't attempt to re-use the
+  /// worker.
   ///
   /// \param[in] addr The address of the worker.
   /// \param[in] task_queue_key The scheduling class of the worker.
@@ -140,6 +149,33 @@ class CoreWorkerDirectTaskSubmitter {
       const google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry> &assigned_resources)
       EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  /// Get the scheduling key of a task. Actor creation tasks and the tasks of a gang
+  /// have a key of their own.
+  static SchedulingKey GetSchedulingKey(const TaskSpecification &task_spec);
+
+  /// Get the key that indexes the scheduling keys whose tasks can run on the same
+  /// workers: the scheduling key without the function of its scheduling class.
+  static SchedulingKey GetWorkerReuseKey(const SchedulingKey &scheduling_key);
+
+  /// Find another scheduling key with queued tasks that can run on the workers leased
+  /// for the given key: normal tasks that only differ by function, which need the
+  /// same resources, dependencies, runtime env, scheduling strategy, depth and
+  /// priority.
+  ///
+  /// \param[in] scheduling_key The scheduling key of an idle worker.
+  /// \return The key with the most tasks without a pending lease, if any.
+  absl::optional<SchedulingKey> FindSchedulingKeyToReuseWorker(
+      const SchedulingKey &scheduling_key) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  /// Remove the entry of a scheduling key, once it can be deleted.
+  void EraseSchedulingKeyEntry(const SchedulingKey &scheduling_key)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  /// Move a leased worker to the tasks of another scheduling key.
+  void MoveWorkerLease(const rpc::WorkerAddress &addr,
+                       const SchedulingKey &from_key,
+                       const SchedulingKey &to_key) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   /// Get an existing lease client or connect a new one. If a raylet_address is
   /// provided, this connects to a remote raylet. Else, this connects to the
   /// local raylet.
@@ -247,18 +283,28 @@ class CoreWorkerDirectTaskSubmitter {
   // Max number of pending lease requests per SchedulingKey.
   const uint64_t max_pending_lease_requests_per_scheduling_category_;
 
+  // Max number of workers leased by one lease request.
+  const uint64_t max_leases_per_lease_request_;
+
+  // Max number of tasks pushed to a leased worker before the first one finishes. The
+  // worker queues the tasks it is not running yet.
+  const uint32_t max_tasks_in_flight_per_worker_;
+
   /// A LeaseEntry struct is used to condense the metadata about a single executor:
   /// (1) The lease client through which the worker should be returned
   /// (2) The expiration time of a worker's lease.
-  /// (3) Whether the worker has assigned task to do.
+  /// (3) The number of tasks pushed to the worker that have not finished.
   /// (5) The resources assigned to the worker
   /// (6) The SchedulingKey assigned to tasks that will be sent to the worker
   struct LeaseEntry {
     std::shared_ptr<WorkerLeaseInterface> lease_client;
     int64_t lease_expiration_time;
-    bool is_busy = false;
+    uint32_t tasks_in_flight = 0;
     google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry> assigned_resources;
     SchedulingKey scheduling_key;
+    /// Whether the worker replied that it exits after a task, e.g. because the
+    /// function reached its max_calls. The tasks pipelined behind that task won't run.
+    bool worker_exiting = false;
 
     LeaseEntry(
         std::shared_ptr<WorkerLeaseInterface> lease_client = nullptr,
@@ -280,6 +326,9 @@ class CoreWorkerDirectTaskSubmitter {
   struct SchedulingKeyEntry {
     // Keep track of pending worker lease requests to the raylet.
     absl::flat_hash_map<TaskID, rpc::Address> pending_lease_requests;
+    // The number of workers asked for by the pending lease requests, a request may
+    // lease more than one worker.
+    uint64_t num_pending_leases = 0;
     TaskSpecification resource_spec = TaskSpecification();
     // Tasks that are queued for execution. We keep an individual queue per
     // scheduling class to ensure fairness.
@@ -288,36 +337,41 @@ class CoreWorkerDirectTaskSubmitter {
     // room for more tasks in flight
     absl::flat_hash_set<rpc::WorkerAddress> active_workers =
         absl::flat_hash_set<rpc::WorkerAddress>();
-    // Keep track of how many workers have tasks to do.
-    uint32_t num_busy_workers = 0;
+    // Keep track of how many tasks are in flight to the active workers.
+    uint32_t total_tasks_in_flight = 0;
     int64_t last_reported_backlog_size = 0;
+    // Whether the raylet placed the gang of the task of this key, so that the task is
+    // leased a worker on its own if its lease has to be requested again.
+    bool gang_placed = false;
 
     // Check whether it's safe to delete this SchedulingKeyEntry from the
     // scheduling_key_entries_ hashmap.
     inline bool CanDelete() const {
       if (pending_lease_requests.empty() && task_queue.empty() &&
-          active_workers.size() == 0 && num_busy_workers == 0) {
+          active_workers.size() == 0 && total_tasks_in_flight == 0) {
         return true;
       }
 
       return false;
     }
 
-    // Check whether all workers are busy.
-    inline bool AllWorkersBusy() const {
-      RAY_CHECK_LE(num_busy_workers, active_workers.size());
-      return num_busy_workers == active_workers.size();
+    // Check whether the pipelines to all workers are full.
+    inline bool AllPipelinesToWorkersFull(uint32_t max_tasks_in_flight_per_worker) const {
+      RAY_CHECK_LE(total_tasks_in_flight,
+                   active_workers.size() * max_tasks_in_flight_per_worker);
+      return total_tasks_in_flight ==
+             active_workers.size() * max_tasks_in_flight_per_worker;
     }
 
     // Get the current backlog size for this scheduling key
     [[nodiscard]] inline int64_t BacklogSize() const {
-      if (task_queue.size() < pending_lease_requests.size()) {
+      if (task_queue.size() < num_pending_leases) {
         // This can happen if worker is reused.
         return 0;
       }
 
       // Subtract tasks with pending lease requests so we don't double count them.
-      return task_queue.size() - pending_lease_requests.size();
+      return task_queue.size() - num_pending_leases;
     }
   };
 
@@ -327,6 +381,12 @@ class CoreWorkerDirectTaskSubmitter {
   absl::flat_hash_map<SchedulingKey, SchedulingKeyEntry> scheduling_key_entries_
       GUARDED_BY(mu_);
 
+  // The scheduling keys of normal tasks in scheduling_key_entries_ that had tasks
+  // queued, by GetWorkerReuseKey, so that an idle worker finds the tasks it can run
+  // without going through all the keys.
+  absl::flat_hash_map<SchedulingKey, absl::flat_hash_set<SchedulingKey>>
+      scheduling_keys_by_reuse_key_ GUARDED_BY(mu_);
+
   // Tasks that were cancelled while being resolved.
   absl::flat_hash_set<TaskID> cancelled_tasks_ GUARDED_BY(mu_);
 
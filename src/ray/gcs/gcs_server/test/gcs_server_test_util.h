@@ -84,7 +84,8 @@ struct GcsServerMocker {
         bool grant_or_reject,
         const rpc::ClientCallback<rpc::RequestWorkerLeaseReply> &callback,
         const int64_t backlog_size,
-        const bool is_selected_based_on_locality) override {
+        const bool is_selected_based_on_locality,
+        const int64_t max_leases) override {
       num_workers_requested += 1;
       callbacks.push_back(callback);
     }
@@ -63,4 +63,61 @@ absl::optional<std::string> ChunkObjectReader::GetChunk(uint64_t chunk_index) co
   }
   return absl::optional<std::string>(std::move(result));
 }
+
+void ChunkObjectReader::AsyncGetChunk(
+    FileIOService &file_io_service,
+    uint64_t chunk_index,
+    std::function<void(absl::optional<std::string>)> callback) const {
+  // Same layout as GetChunk: the data part of the chunk, then the metadata part.
+  const auto cur_chunk_offset = chunk_index * chunk_size_;
+  const auto cur_chunk_size =
+      std::min(chunk_size_,
+               object_->GetDataSize() + object_->GetMetadataSize() - cur_chunk_offset);
+  uint64_t data_size = 0;
+  if (cur_chunk_offset < object_->GetDataSize()) {
+    data_size = std::min(object_->GetDataSize() - cur_chunk_offset, cur_chunk_size);
+  }
+  const uint64_t metadata_offset =
+      std::max(cur_chunk_offset, object_->GetDataSize()) - object_->GetDataSize();
+  const uint64_t metadata_size = cur_chunk_size - data_size;
+
+  auto result = std::make_shared<std::string>(cur_chunk_size, '\0');
+  // The metadata is read after the data, and only if there is any.
+  auto read_metadata = [object = object_,
+                        &file_io_service,
+                        result,
+                        data_size,
+                        metadata_offset,
+                        metadata_size,
+                        callback = std::move(callback)](bool ok) {
+    if (!ok) {
+      callback(absl::optional<std::string>());
+      return;
+    }
+    if (metadata_size == 0) {
+      callback(absl::optional<std::string>(std::move(*result)));
+      return;
+    }
+    object->AsyncReadFromSection(
+        file_io_service,
+        /*from_metadata=*/true,
+        metadata_offset,
+        metadata_size,
+        &(*result)[data_size],
+        [result, callback](bool ok) {
+          callback(ok ? absl::optional<std::string>(std::move(*result))
+                      : absl::optional<std::string>());
+        });
+  };
+  if (data_size == 0) {
+    read_metadata(true);
+    return;
+  }
+  object_->AsyncReadFromSection(file_io_service,
+                                /*from_metadata=*/false,
+                                cur_chunk_offset,
+                                data_size,
+                                &(*result)[0],
+                                std::move(read_metadata));
+}
 };  // namespace ray
@@ -14,6 +14,10 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <string>
+
 #include "ray/object_manager/spilled_object_reader.h"
 
 namespace ray {
@@ -36,6 +40,17 @@ class ChunkObjectReader {
   ///                    equal to GetNumChunks() yields undefined behavior.
   absl::optional<std::string> GetChunk(uint64_t chunk_index) const;
 
+  /// Same as GetChunk, but the reads of file backed objects are submitted to
+  /// file_io_service instead of blocking the calling thread.
+  ///
+  /// \param file_io_service service to submit file reads to.
+  /// \param chunk_index the index of chunk to return.
+  /// \param callback called with the chunk, or an empty optional if the read failed.
+  void AsyncGetChunk(
+      FileIOService &file_io_service,
+      uint64_t chunk_index,
+      std::function<void(absl::optional<std::string>)> callback) const;
+
   const IObjectReader &GetObject() const { return *object_; }
 
  private:
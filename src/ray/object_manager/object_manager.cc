@@ -101,6 +101,7 @@ ObjectManager::ObjectManager(
       buffer_pool_store_client_(std::make_shared<plasma::PlasmaClient>()),
       buffer_pool_(buffer_pool_store_client_, config_.object_chunk_size),
       rpc_work_(rpc_service_),
+      file_io_service_(rpc_service_),
       object_manager_server_("ObjectManager",
                              config_.object_manager_port,
                              config_.object_manager_address == "127.0.0.1",
@@ -520,27 +521,71 @@ void ObjectManager::SendObjectChunk(const UniqueID &push_id,
                                     std::function<void(const Status &)> on_complete,
                                     std::shared_ptr<ChunkObjectReader> chunk_reader,
                                     bool from_disk) {
+  if (from_disk) {
+    chunk_reader->AsyncGetChunk(
+        file_io_service_,
+        chunk_index,
+        [this,
+         push_id,
+         object_id,
+         node_id,
+         chunk_index,
+         rpc_client,
+         on_complete,
+         chunk_reader](absl::optional<std::string> chunk) {
+          SendObjectChunkData(push_id,
+                              object_id,
+                              node_id,
+                              chunk_index,
+                              rpc_client,
+                              on_complete,
+                              *chunk_reader,
+                              std::move(chunk),
+                              /*from_disk=*/true);
+        });
+    return;
+  }
+  SendObjectChunkData(push_id,
+                      object_id,
+                      node_id,
+                      chunk_index,
+                      rpc_client,
+                      on_complete,
+                      *chunk_reader,
+                      chunk_reader->GetChunk(chunk_index),
+                      /*from_disk=*/false);
+}
+
+void ObjectManager::SendObjectChunkData(
+    const UniqueID &push_id,
+    const ObjectID &object_id,
+    const NodeID &node_id,
+    uint64_t chunk_index,
+    std::shared_ptr<rpc::ObjectManagerClient> rpc_client,
+    std::function<void(const Status &)> on_complete,
+    const ChunkObjectReader &chunk_reader,
+    absl::optional<std::string> chunk,
+    bool from_disk) {
   double start_time = absl::GetCurrentTimeNanos() / 1e9;
   rpc::PushRequest push_request;
   // Set request header
   push_request.set_push_id(push_id.Binary());
   push_request.set_object_id(object_id.Binary());
   push_request.mutable_owner_address()->CopyFrom(
-      chunk_reader->GetObject().GetOwnerAddress());
+      chunk_reader.GetObject().GetOwnerAddress());
   push_request.set_node_id(self_node_id_.Binary());
-  push_request.set_data_size(chunk_reader->GetObject().GetObjectSize());
-  push_request.set_metadata_size(chunk_reader->GetObject().GetMetadataSize());
+  push_request.set_data_size(chunk_reader.GetObject().GetObjectSize());
+  push_request.set_metadata_size(chunk_reader.GetObject().GetMetadataSize());
   push_request.set_chunk_index(chunk_index);
 
-  // read a chunk into push_request and handle errors.
-  auto optional_chunk = chunk_reader->GetChunk(chunk_index);
-  if (!optional_chunk.has_value()) {
+  // Move the chunk into push_request and handle read errors.
+  if (!chunk.has_value()) {
     RAY_LOG(DEBUG) << "Read chunk " << chunk_index << " of object " << object_id
                    << " failed. It may have been evicted.";
     on_complete(Status::IOError("Failed to read spilled object"));
     return;
   }
-  push_request.set_data(std::move(optional_chunk.value()));
+  push_request.set_data(std::move(chunk.value()));
   if (from_disk) {
     num_bytes_pushed_from_disk_ += push_request.data().length();
   } else {
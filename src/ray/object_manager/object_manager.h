@@ -30,6 +30,7 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/time/clock.h"
 #include "ray/common/asio/instrumented_io_context.h"
+#include "ray/common/file_io_service.h"
 #include "ray/common/id.h"
 #include "ray/common/ray_config.h"
 #include "ray/common/status.h"
@@ -296,8 +297,8 @@ class ObjectManager : public ObjectManagerInterface,
   /// \param rpc_client Rpc client used to send message to remote object manager
   /// \param on_complete Callback when the chunk is sent
   /// \param chunk_reader Chunk reader used to read a chunk of the object
-  /// \param from_disk Whether chunk is being read from disk or plasma. This is
-  /// used only for metrics.
+  /// \param from_disk Whether chunk is being read from disk or plasma. Chunks
+  /// read from disk go through file_io_service_.
   void SendObjectChunk(const UniqueID &push_id,
                        const ObjectID &object_id,
                        const NodeID &node_id,
@@ -307,6 +308,18 @@ class ObjectManager : public ObjectManagerInterface,
                        std::shared_ptr<ChunkObjectReader> chunk_reader,
                        bool from_disk);
 
+  /// Send a chunk that has already been read. The arguments are the same as
+  /// SendObjectChunk, chunk is empty if the read failed.
+  void SendObjectChunkData(const UniqueID &push_id,
+                           const ObjectID &object_id,
+                           const NodeID &node_id,
+                           uint64_t chunk_index,
+                           std::shared_ptr<rpc::ObjectManagerClient> rpc_client,
+                           std::function<void(const Status &)> on_complete,
+                           const ChunkObjectReader &chunk_reader,
+                           absl::optional<std::string> chunk,
+                           bool from_disk);
+
   /// Handle starting, running, and stopping asio rpc_service.
   void StartRpcService();
   void RunRpcService(int index);
@@ -414,6 +427,10 @@ class ObjectManager : public ObjectManagerInterface,
   /// Data copy operations during request are done in this thread pool.
   std::vector<std::thread> rpc_threads_;
 
+  /// Reads the chunks of spilled objects being pushed, so that the RPC threads
+  /// don't block on disk. Completions run on rpc_service_.
+  FileIOService file_io_service_;
+
   /// Mapping from locally available objects to information about those objects
   /// including when the object was last pushed to other object managers.
   absl::flat_hash_map<ObjectID, LocalObjectInfo> local_objects_;
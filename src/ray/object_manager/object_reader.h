@@ -14,10 +14,14 @@
 
 #pragma once
 
+#include <functional>
+
 #include "src/ray/protobuf/common.pb.h"
 
 namespace ray {
 
+class FileIOService;
+
 /// Reader over an immutable Ray object.
 class IObjectReader {
  public:
@@ -53,5 +57,26 @@ class IObjectReader {
   virtual bool ReadFromMetadataSection(uint64_t offset,
                                        uint64_t size,
                                        char *output) const = 0;
+
+  /// Read from the data or metadata section without blocking the caller. Readers
+  /// backed by a file submit the read to file_io_service, the default reads
+  /// synchronously and calls the callback inline.
+  ///
+  /// \param file_io_service service to submit file reads to.
+  /// \param from_metadata whether to read from the metadata section.
+  /// \param offset offset to the section to copy from.
+  /// \param size number of bytes to copy.
+  /// \param output pointer to the memory location to copy to, it must stay valid
+  /// until the callback runs.
+  /// \param callback called with whether the read succeeded.
+  virtual void AsyncReadFromSection(FileIOService &file_io_service,
+                                    bool from_metadata,
+                                    uint64_t offset,
+                                    uint64_t size,
+                                    char *output,
+                                    std::function<void(bool)> callback) const {
+    callback(from_metadata ? ReadFromMetadataSection(offset, size, output)
+                           : ReadFromDataSection(offset, size, output));
+  }
 };
 }  // namespace ray
@@ -46,6 +46,13 @@ enum class ObjectState : int {
   PLASMA_SEALED = 2,
 };
 
+enum class ObjectTier : int {
+  /// Object lives in the shared memory (or fallback) allocation.
+  Hot = 0,
+  /// Object lives in the disk backed warm tier arena.
+  Warm = 1,
+};
+
 // Represents a chunk of allocated memory.
 struct Allocation {
   /// Pointer to the allocated memory.
@@ -86,6 +93,7 @@ struct Allocation {
       : address(nullptr), size(0), fd(), offset(0), device_num(0), mmap_size(0) {}
 
   friend class PlasmaAllocator;
+  friend class WarmTierAllocator;
   friend class DummyAllocator;
   friend struct ObjectLifecycleManagerTest;
   FRIEND_TEST(ObjectStoreTest, PassThroughTest);
@@ -113,6 +121,8 @@ class LocalObject {
 
   const plasma::flatbuf::ObjectSource &GetSource() const { return source; }
 
+  ObjectTier GetTier() const { return tier; }
+
   void ToPlasmaObject(PlasmaObject *object, bool check_sealed) const {
     RAY_DCHECK(object != nullptr);
     if (check_sealed) {
@@ -152,5 +162,10 @@ class LocalObject {
   ObjectState state;
   /// The source of the object. Used for debugging purposes.
   plasma::flatbuf::ObjectSource source;
+  /// The storage tier the allocation belongs to.
+  ObjectTier tier;
+  /// Number of times the object was accessed while in the warm tier. Used to
+  /// decide when to promote it back to shared memory.
+  mutable int64_t num_warm_tier_accesses;
 };
 }  // namespace plasma
@@ -292,6 +292,10 @@ int fake_munmap(void *addr, int64_t size) {
 namespace internal {
 void SetMallocGranularity(int value) { change_mparam(M_GRANULARITY, value); }
 
+// Returns a fresh unique id for an mmapped file, shared with allocators that
+// manage their own mappings so clients can tell fds apart.
+int64_t NextMmapUniqueId() { return next_mmap_unique_id++; }
+
 // Returns whether the given pointer is outside the initially allocated region.
 bool IsOutsideInitialAllocation(void *p) {
   if (initial_region_ptr == nullptr) {
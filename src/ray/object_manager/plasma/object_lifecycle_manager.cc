@@ -24,10 +24,16 @@ namespace plasma {
 using namespace flatbuf;
 
 ObjectLifecycleManager::ObjectLifecycleManager(
-    IAllocator &allocator, ray::DeleteObjectCallback delete_object_callback)
-    : object_store_(std::make_unique<ObjectStore>(allocator)),
+    IAllocator &allocator,
+    IAllocator *warm_tier_allocator,
+    ray::DeleteObjectCallback delete_object_callback)
+    : object_store_(std::make_unique<ObjectStore>(allocator, warm_tier_allocator)),
       eviction_policy_(std::make_unique<EvictionPolicy>(*object_store_, allocator)),
       delete_object_callback_(delete_object_callback),
+      warm_cache_("warm tier lru",
+                  warm_tier_allocator ? warm_tier_allocator->GetFootprintLimit() : 0),
+      warm_tier_promotion_threshold_(
+          RayConfig::instance().plasma_warm_tier_promotion_threshold()),
       earger_deletion_objects_(),
       stats_collector_() {}
 
@@ -45,7 +51,11 @@ std::pair<const LocalObject *, flatbuf::PlasmaError> ObjectLifecycleManager::Cre
   if (entry == nullptr) {
     return {nullptr, PlasmaError::OutOfMemory};
   }
-  eviction_policy_->ObjectCreated(object_info.object_id);
+  if (entry->GetTier() == ObjectTier::Warm) {
+    warm_cache_.Add(object_info.object_id, entry->GetObjectSize());
+  } else {
+    eviction_policy_->ObjectCreated(object_info.object_id);
+  }
   stats_collector_.OnObjectCreated(*entry);
   return {entry, PlasmaError::OK};
 }
@@ -127,8 +137,14 @@ bool ObjectLifecycleManager::AddReference(const ObjectID &object_id) {
   // If there are no other clients using this object, notify the eviction policy
   // that the object is being used.
   if (entry->ref_count == 0) {
-    // Tell the eviction policy that this object is being used.
-    eviction_policy_->BeginObjectAccess(object_id);
+    if (entry->GetTier() == ObjectTier::Warm) {
+      // Warm objects are served in place; just make them unevictable.
+      warm_cache_.Remove(object_id);
+      entry->num_warm_tier_accesses++;
+    } else {
+      // Tell the eviction policy that this object is being used.
+      eviction_policy_->BeginObjectAccess(object_id);
+    }
   }
   // Increase reference count.
   entry->ref_count++;
@@ -157,10 +173,18 @@ bool ObjectLifecycleManager::RemoveReference(const ObjectID &object_id) {
   RAY_LOG(DEBUG) << "Releasing object no longer in use " << object_id
                  << ", num bytes in use is now " << GetNumBytesInUse();
 
-  eviction_policy_->EndObjectAccess(object_id);
-
   // TODO(scv119): handle this anomaly in upper layer.
   RAY_CHECK(entry->Sealed()) << object_id << " is not sealed while ref count becomes 0.";
+  if (entry->GetTier() == ObjectTier::Warm) {
+    if (earger_deletion_objects_.count(object_id) > 0) {
+      DeleteObjectInternal(object_id);
+    } else {
+      MaybePromoteObject(object_id);
+    }
+    return true;
+  }
+
+  eviction_policy_->EndObjectAccess(object_id);
   if (earger_deletion_objects_.count(object_id) > 0) {
     DeleteObjectInternal(object_id);
   }
@@ -168,6 +192,9 @@ bool ObjectLifecycleManager::RemoveReference(const ObjectID &object_id) {
 }
 
 std::string ObjectLifecycleManager::EvictionPolicyDebugString() const {
+  if (IsWarmTierEnabled()) {
+    return eviction_policy_->DebugString() + warm_cache_.DebugString();
+  }
   return eviction_policy_->DebugString();
 }
 
@@ -203,9 +230,9 @@ const LocalObject *ObjectLifecycleManager::CreateObjectInternal(
     return nullptr;
   }
 
-  RAY_LOG(INFO)
-      << "Shared memory store full, falling back to allocating from filesystem: "
-      << object_info.GetObjectSize();
+  RAY_LOG(INFO) << "Shared memory store full, falling back to allocating from "
+                << (IsWarmTierEnabled() ? "the warm tier or " : "")
+                << "filesystem: " << object_info.GetObjectSize();
 
   auto result =
       object_store_->CreateObject(object_info, source, /*fallback_allocate*/ true);
@@ -229,10 +256,54 @@ void ObjectLifecycleManager::EvictObjects(const std::vector<ObjectID> &object_id
     RAY_CHECK(entry->ref_count == 0)
         << "To evict an object, there must be no clients currently using it.";
 
+    if (DemoteObject(object_id)) {
+      continue;
+    }
     DeleteObjectInternal(object_id);
   }
 }
 
+bool ObjectLifecycleManager::DemoteObject(const ObjectID &object_id) {
+  if (!IsWarmTierEnabled() || earger_deletion_objects_.count(object_id) > 0) {
+    return false;
+  }
+  auto entry = object_store_->GetObject(object_id);
+  const int64_t object_size = entry->GetObjectSize();
+  if (entry->GetTier() != ObjectTier::Hot ||
+      object_size > warm_cache_.OriginalCapacity()) {
+    return false;
+  }
+  entry = object_store_->MoveObject(object_id, ObjectTier::Warm);
+  if (entry == nullptr) {
+    // Make room by deleting cold warm objects, then retry once. Due to
+    // fragmentation this may still fail, in which case the object is deleted.
+    std::vector<ObjectID> warm_objects_to_evict;
+    warm_cache_.ChooseObjectsToEvict(object_size, warm_objects_to_evict);
+    for (const auto &warm_object_id : warm_objects_to_evict) {
+      DeleteObjectInternal(warm_object_id);
+    }
+    entry = object_store_->MoveObject(object_id, ObjectTier::Warm);
+  }
+  if (entry == nullptr) {
+    return false;
+  }
+  RAY_LOG(DEBUG) << "Demoted object " << object_id << " to the warm tier";
+  entry->num_warm_tier_accesses = 0;
+  warm_cache_.Add(object_id, object_size);
+  return true;
+}
+
+void ObjectLifecycleManager::MaybePromoteObject(const ObjectID &object_id) {
+  auto entry = object_store_->GetObject(object_id);
+  if (entry->num_warm_tier_accesses >= warm_tier_promotion_threshold_ &&
+      object_store_->MoveObject(object_id, ObjectTier::Hot) != nullptr) {
+    RAY_LOG(DEBUG) << "Promoted object " << object_id << " from the warm tier";
+    eviction_policy_->ObjectCreated(object_id);
+    return;
+  }
+  warm_cache_.Add(object_id, entry->GetObjectSize());
+}
+
 void ObjectLifecycleManager::DeleteObjectInternal(const ObjectID &object_id) {
   auto entry = object_store_->GetObject(object_id);
   RAY_CHECK(entry != nullptr);
@@ -241,7 +312,11 @@ void ObjectLifecycleManager::DeleteObjectInternal(const ObjectID &object_id) {
 
   stats_collector_.OnObjectDeleting(*entry);
   earger_deletion_objects_.erase(object_id);
-  eviction_policy_->RemoveObject(object_id);
+  if (entry->GetTier() == ObjectTier::Warm) {
+    warm_cache_.Remove(object_id);
+  } else {
+    eviction_policy_->RemoveObject(object_id);
+  }
   object_store_->DeleteObject(object_id);
 
   if (!aborted) {
@@ -286,10 +361,14 @@ absl::flat_hash_map<ObjectID, std::unique_ptr<LocalObject>>  *ObjectLifecycleMan
 ObjectLifecycleManager::ObjectLifecycleManager(
     std::unique_ptr<IObjectStore> store,
     std::unique_ptr<IEvictionPolicy> eviction_policy,
-    ray::DeleteObjectCallback delete_object_callback)
+    ray::DeleteObjectCallback delete_object_callback,
+    int64_t warm_tier_capacity)
     : object_store_(std::move(store)),
       eviction_policy_(std::move(eviction_policy)),
       delete_object_callback_(delete_object_callback),
+      warm_cache_("warm tier lru", warm_tier_capacity),
+      warm_tier_promotion_threshold_(
+          RayConfig::instance().plasma_warm_tier_promotion_threshold()),
       earger_deletion_objects_(),
       stats_collector_() {}
 
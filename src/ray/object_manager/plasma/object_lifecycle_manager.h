@@ -98,9 +98,15 @@ class IObjectLifecycleManager {
 // ObjectLifecycleManager allocates LocalObjects from the allocator.
 // It tracks object’s lifecycle states such as reference count or object states
 // (created/sealed). It lazily garbage collects objects when running out of space.
+//
+// If a warm tier allocator is given, objects chosen for eviction are demoted to
+// the warm tier instead of being deleted, and are only deleted once the warm tier
+// itself runs out of space (in LRU order). Warm objects that are accessed often
+// enough are promoted back to shared memory when they are released.
 class ObjectLifecycleManager : public IObjectLifecycleManager {
  public:
   ObjectLifecycleManager(IAllocator &allocator,
+                         IAllocator *warm_tier_allocator,
                          ray::DeleteObjectCallback delete_object_callback);
 
   std::pair<const LocalObject *, flatbuf::PlasmaError> CreateObject(
@@ -150,7 +156,8 @@ class ObjectLifecycleManager : public IObjectLifecycleManager {
   // Test only
   ObjectLifecycleManager(std::unique_ptr<IObjectStore> store,
                          std::unique_ptr<IEvictionPolicy> eviction_policy,
-                         ray::DeleteObjectCallback delete_object_callback);
+                         ray::DeleteObjectCallback delete_object_callback,
+                         int64_t warm_tier_capacity = 0);
 
   const LocalObject *CreateObjectInternal(const ray::ObjectInfo &object_info,
                                           plasma::flatbuf::ObjectSource source,
@@ -163,11 +170,25 @@ class ObjectLifecycleManager : public IObjectLifecycleManager {
 
   void DeleteObjectInternal(const ObjectID &object_id);
 
+  /// Demote an unused object to the warm tier, deleting the least recently used
+  /// warm objects if there is not enough room.
+  ///
+  /// \return true if the object was demoted, false if it should be deleted.
+  bool DemoteObject(const ObjectID &object_id);
+
+  /// Promote a released warm object back to shared memory if it has been
+  /// accessed often enough and there is free space; otherwise make it evictable
+  /// in the warm tier again.
+  void MaybePromoteObject(const ObjectID &object_id);
+
+  bool IsWarmTierEnabled() const { return warm_cache_.OriginalCapacity() > 0; }
+
  private:
   friend struct ObjectLifecycleManagerTest;
   friend struct ObjectStatsCollectorTest;
   FRIEND_TEST(ObjectLifecycleManagerTest, DeleteFailure);
   FRIEND_TEST(ObjectLifecycleManagerTest, RemoveReferenceOneRefEagerlyDeletion);
+  FRIEND_TEST(ObjectLifecycleManagerTest, CreateObjectTriggerGCDemotesToWarmTier);
   friend struct GetRequestQueueTest;
   FRIEND_TEST(GetRequestQueueTest, TestAddRequest);
 
@@ -175,6 +196,13 @@ class ObjectLifecycleManager : public IObjectLifecycleManager {
   std::unique_ptr<IEvictionPolicy> eviction_policy_;
   const ray::DeleteObjectCallback delete_object_callback_;
 
+  /// LRU of the unused objects in the warm tier. Its capacity is 0 if the warm
+  /// tier is disabled.
+  LRUCache warm_cache_;
+
+  /// Number of accesses after which a warm object is promoted.
+  const int64_t warm_tier_promotion_threshold_;
+
   // list of objects which will be removed immediately
   // once reference count becomes 0.
   absl::flat_hash_set<ObjectID> earger_deletion_objects_;
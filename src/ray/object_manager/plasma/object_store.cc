@@ -17,10 +17,14 @@
 
 #include "ray/object_manager/plasma/object_store.h"
 
+#include <cstring>
+
 namespace plasma {
 
-ObjectStore::ObjectStore(IAllocator &allocator)
-    : allocator_(allocator), object_table_() {}
+ObjectStore::ObjectStore(IAllocator &allocator, IAllocator *warm_tier_allocator)
+    : allocator_(allocator),
+      warm_tier_allocator_(warm_tier_allocator),
+      object_table_() {}
 
 const LocalObject *ObjectStore::CreateObject(const ray::ObjectInfo &object_info,
                                              plasma::flatbuf::ObjectSource source,
@@ -32,8 +36,19 @@ const LocalObject *ObjectStore::CreateObject(const ray::ObjectInfo &object_info,
   RAY_CHECK(object_table_.count(object_info.object_id) == 0)
       << object_info.object_id << " already exists!";
   auto object_size = object_info.GetObjectSize();
-  auto allocation = fallback_allocate ? allocator_.FallbackAllocate(object_size)
-                                      : allocator_.Allocate(object_size);
+  auto tier = ObjectTier::Hot;
+  absl::optional<Allocation> allocation;
+  if (fallback_allocate && warm_tier_allocator_ != nullptr) {
+    // Prefer the managed warm tier arena over one-off fallback files.
+    allocation = warm_tier_allocator_->Allocate(object_size);
+    if (allocation.has_value()) {
+      tier = ObjectTier::Warm;
+    }
+  }
+  if (!allocation.has_value()) {
+    allocation = fallback_allocate ? allocator_.FallbackAllocate(object_size)
+                                   : allocator_.Allocate(object_size);
+  }
   RAY_LOG_EVERY_MS(INFO, 10 * 60 * 1000)
       << "Object store current usage " << (allocator_.Allocated() / 1e9) << " / "
       << (allocator_.GetFootprintLimit() / 1e9) << " GB.";
@@ -48,6 +63,7 @@ const LocalObject *ObjectStore::CreateObject(const ray::ObjectInfo &object_info,
   entry->create_time = std::time(nullptr);
   entry->construct_duration = -1;
   entry->source = source;
+  entry->tier = tier;
 
   RAY_LOG(DEBUG) << "create object " << object_info.object_id << " succeeded";
   return entry;
@@ -76,11 +92,44 @@ bool ObjectStore::DeleteObject(const ObjectID &object_id) {
   if (entry == nullptr) {
     return false;
   }
-  allocator_.Free(std::move(entry->allocation));
+  GetAllocator(entry->tier).Free(std::move(entry->allocation));
   object_table_.erase(object_id);
   return true;
 }
 
+const LocalObject *ObjectStore::MoveObject(const ObjectID &object_id, ObjectTier tier) {
+  auto entry = GetMutableObject(object_id);
+  if (entry == nullptr || entry->state != ObjectState::PLASMA_SEALED ||
+      entry->tier == tier) {
+    return nullptr;
+  }
+  if (tier == ObjectTier::Warm && warm_tier_allocator_ == nullptr) {
+    return nullptr;
+  }
+  auto object_size = entry->GetObjectSize();
+  auto allocation = GetAllocator(tier).Allocate(object_size);
+  if (!allocation.has_value()) {
+    RAY_LOG(DEBUG) << "Not enough space to move object " << object_id << " of size "
+                   << object_size << " to tier " << static_cast<int>(tier);
+    return nullptr;
+  }
+  std::memcpy(allocation->address, entry->allocation.address, object_size);
+  GetAllocator(entry->tier).Free(std::move(entry->allocation));
+  entry->allocation = std::move(allocation.value());
+  entry->tier = tier;
+  RAY_LOG(DEBUG) << "moved object " << object_id << " to tier "
+                 << static_cast<int>(tier);
+  return entry;
+}
+
+IAllocator &ObjectStore::GetAllocator(ObjectTier tier) {
+  if (tier == ObjectTier::Warm) {
+    RAY_CHECK(warm_tier_allocator_ != nullptr);
+    return *warm_tier_allocator_;
+  }
+  return allocator_;
+}
+
 LocalObject *ObjectStore::GetMutableObject(const ObjectID &object_id) {
   auto it = object_table_.find(object_id);
   if (it == object_table_.end()) {
@@ -68,14 +68,28 @@ class IObjectStore {
   ///   - true if deleted.
   virtual bool DeleteObject(const ObjectID &object_id) = 0;
 
+  /// Move a sealed object to the given storage tier by copying its payload
+  /// into a new allocation and releasing the old one. The caller must make sure
+  /// no client is using the object.
+  ///
+  /// \param object_id Object ID of the object to be moved.
+  /// \param tier The tier to move the object to.
+  /// \return
+  ///   - nullptr if such object doesn't exist, is not sealed, is already in the
+  ///     given tier, or there is not enough space in the destination tier.
+  ///   - otherwise, pointer to the moved object.
+  virtual const LocalObject *MoveObject(const ObjectID &object_id, ObjectTier tier) = 0;
+
   virtual absl::flat_hash_map<ObjectID, std::unique_ptr<LocalObject>>  *GetPlasmaMeta() = 0;
 };
 
 // ObjectStore implements IObjectStore. It uses IAllocator
-// to allocate memory for object creation.
+// to allocate memory for object creation. If a warm tier allocator is given,
+// fallback allocations are served from the warm tier first.
 class ObjectStore : public IObjectStore {
  public:
-  explicit ObjectStore(IAllocator &allocator);
+  explicit ObjectStore(IAllocator &allocator,
+                       IAllocator *warm_tier_allocator = nullptr);
 
   const LocalObject *CreateObject(const ray::ObjectInfo &object_info,
                                   plasma::flatbuf::ObjectSource source,
@@ -87,6 +101,8 @@ class ObjectStore : public IObjectStore {
 
   bool DeleteObject(const ObjectID &object_id) override;
 
+  const LocalObject *MoveObject(const ObjectID &object_id, ObjectTier tier) override;
+
   // hucc GetPlasmaMeta
   absl::flat_hash_map<ObjectID, std::unique_ptr<LocalObject>>  *GetPlasmaMeta() override;
 
@@ -95,9 +111,15 @@ class ObjectStore : public IObjectStore {
 
   LocalObject *GetMutableObject(const ObjectID &object_id);
 
+  /// Returns the allocator that owns allocations of the given tier.
+  IAllocator &GetAllocator(ObjectTier tier);
+
   /// Allocator that allocates memory.
   IAllocator &allocator_;
 
+  /// Allocator of the warm tier. nullptr if the warm tier is disabled.
+  IAllocator *warm_tier_allocator_;
+
   /// Mapping from ObjectIDs to information about the object.
   absl::flat_hash_map<ObjectID, std::unique_ptr<LocalObject>> object_table_;
 };
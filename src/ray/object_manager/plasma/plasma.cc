@@ -22,5 +22,8 @@
 namespace plasma {
 
 LocalObject::LocalObject(Allocation allocation)
-    : allocation(std::move(allocation)), ref_count(0) {}
+    : allocation(std::move(allocation)),
+      ref_count(0),
+      tier(ObjectTier::Hot),
+      num_warm_tier_accesses(0) {}
 }  // namespace plasma
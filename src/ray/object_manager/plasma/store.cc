@@ -72,6 +72,7 @@ ray::ObjectID GetCreateRequestObjectId(const std::vector<uint8_t> &message) {
 
 PlasmaStore::PlasmaStore(instrumented_io_context &main_service,
                          IAllocator &allocator,
+                         IAllocator *warm_tier_allocator,
                          ray::FileSystemMonitor &fs_monitor,
                          const std::string &socket_name,
                          uint32_t delay_on_oom_ms,
@@ -88,7 +89,7 @@ PlasmaStore::PlasmaStore(instrumented_io_context &main_service,
       fs_monitor_(fs_monitor),
       add_object_callback_(add_object_callback),
       delete_object_callback_(delete_object_callback),
-      object_lifecycle_mgr_(allocator_, delete_object_callback_),
+      object_lifecycle_mgr_(allocator_, warm_tier_allocator, delete_object_callback_),
       delay_on_oom_ms_(delay_on_oom_ms),
       object_spilling_threshold_(object_spilling_threshold),
       create_request_queue_(
@@ -61,6 +61,7 @@ class PlasmaStore {
  public:
   PlasmaStore(instrumented_io_context &main_service,
               IAllocator &allocator,
+              IAllocator *warm_tier_allocator,
               ray::FileSystemMonitor &fs_monitor,
               const std::string &socket_name,
               uint32_t delay_on_oom_ms,
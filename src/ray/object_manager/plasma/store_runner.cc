@@ -91,6 +91,12 @@ void PlasmaStoreRunner::Start(ray::SpillObjectsCallback spill_objects_callback,
     allocator_ = std::make_unique<PlasmaAllocator>(
         plasma_directory_, fallback_directory_, hugepages_enabled_, system_memory_);
 #ifndef _WIN32
+    const auto &warm_tier_directory = RayConfig::instance().plasma_warm_tier_directory();
+    if (!warm_tier_directory.empty() &&
+        RayConfig::instance().plasma_warm_tier_capacity_bytes() > 0) {
+      warm_tier_allocator_ = std::make_unique<WarmTierAllocator>(
+          warm_tier_directory, RayConfig::instance().plasma_warm_tier_capacity_bytes());
+    }
     std::vector<std::string> local_spilling_paths;
     if (RayConfig::instance().is_external_storage_type_fs()) {
       local_spilling_paths =
@@ -107,6 +113,7 @@ void PlasmaStoreRunner::Start(ray::SpillObjectsCallback spill_objects_callback,
 #endif
     store_.reset(new PlasmaStore(main_service_,
                                  *allocator_,
+                                 warm_tier_allocator_.get(),
                                  *fs_monitor_,
                                  socket_name_,
                                  RayConfig::instance().object_store_full_delay_ms(),
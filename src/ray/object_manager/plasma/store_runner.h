@@ -8,6 +8,7 @@
 #include "ray/common/file_system_monitor.h"
 #include "ray/object_manager/plasma/plasma_allocator.h"
 #include "ray/object_manager/plasma/store.h"
+#include "ray/object_manager/plasma/warm_tier_allocator.h"
 
 namespace plasma {
 
@@ -44,6 +45,7 @@ class PlasmaStoreRunner {
   std::string fallback_directory_;
   mutable instrumented_io_context main_service_;
   std::unique_ptr<PlasmaAllocator> allocator_;
+  std::unique_ptr<WarmTierAllocator> warm_tier_allocator_;
   std::unique_ptr<ray::FileSystemMonitor> fs_monitor_;
   std::unique_ptr<PlasmaStore> store_;
 };
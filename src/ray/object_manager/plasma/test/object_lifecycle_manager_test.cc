@@ -46,6 +46,11 @@ class MockObjectStore : public IObjectStore {
   MOCK_CONST_METHOD1(GetObject, const LocalObject *(const ObjectID &));
   MOCK_METHOD1(SealObject, const LocalObject *(const ObjectID &));
   MOCK_METHOD1(DeleteObject, bool(const ObjectID &));
+  MOCK_METHOD2(MoveObject, const LocalObject *(const ObjectID &, ObjectTier));
+  MOCK_METHOD((absl::flat_hash_map<ObjectID, std::unique_ptr<LocalObject>> *),
+              GetPlasmaMeta,
+              (),
+              (override));
   MOCK_CONST_METHOD1(GetDebugDump, void(std::stringstream &buffer));
 };
 
@@ -139,6 +144,48 @@ TEST_F(ObjectLifecycleManagerTest, CreateObjectTriggerGC) {
   EXPECT_EQ(expect_notified_ids, notify_deleted_ids_);
 }
 
+TEST_F(ObjectLifecycleManagerTest, CreateObjectTriggerGCDemotesToWarmTier) {
+  auto eviction_policy = std::make_unique<MockEvictionPolicy>();
+  auto object_store = std::make_unique<MockObjectStore>();
+  eviction_policy_ = eviction_policy.get();
+  object_store_ = object_store.get();
+  manager_ = std::make_unique<ObjectLifecycleManager>(ObjectLifecycleManager(
+      std::move(object_store),
+      std::move(eviction_policy),
+      [this](auto &id) { notify_deleted_ids_.push_back(id); },
+      /*warm_tier_capacity=*/1024));
+
+  EXPECT_CALL(*object_store_, GetObject(_))
+      .Times(2)
+      .WillOnce(Return(nullptr))
+      // called during eviction and demotion.
+      .WillRepeatedly(Return(&sealed_object_));
+  EXPECT_CALL(*object_store_, CreateObject(_, _, false))
+      .Times(2)
+      .WillOnce(Return(nullptr))
+      .WillOnce(Return(&object1_));
+  EXPECT_CALL(*eviction_policy_, RequireSpace(_, _))
+      .Times(1)
+      .WillOnce(Invoke([&](auto size, auto &to_evict) {
+        to_evict.push_back(id1_);
+        return 0;
+      }));
+  EXPECT_CALL(*eviction_policy_, ObjectCreated(_)).Times(1);
+
+  // The evicted object is demoted instead of deleted.
+  EXPECT_CALL(*object_store_, MoveObject(id1_, ObjectTier::Warm))
+      .Times(1)
+      .WillOnce(Return(&sealed_object_));
+  EXPECT_CALL(*object_store_, DeleteObject(_)).Times(0);
+
+  auto expected = std::pair<const LocalObject *, flatbuf::PlasmaError>(
+      &object1_, flatbuf::PlasmaError::OK);
+  auto result = manager_->CreateObject({}, {}, /*falback*/ false);
+  EXPECT_EQ(expected, result);
+  EXPECT_TRUE(notify_deleted_ids_.empty());
+  EXPECT_TRUE(manager_->warm_cache_.Exists(id1_));
+}
+
 TEST_F(ObjectLifecycleManagerTest, CreateObjectTriggerGCExhaused) {
   EXPECT_CALL(*object_store_, GetObject(_)).Times(1).WillOnce(Return(nullptr));
   EXPECT_CALL(*object_store_, CreateObject(_, _, false))
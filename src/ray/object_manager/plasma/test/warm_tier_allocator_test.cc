@@ -0,0 +1,110 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/plasma/warm_tier_allocator.h"
+
+#include <cstring>
+#include <filesystem>
+
+#include "gtest/gtest.h"
+#include "ray/object_manager/plasma/malloc.h"
+#include "ray/util/util.h"
+
+using namespace std::filesystem;
+
+namespace plasma {
+namespace {
+const int64_t kKB = 1024;
+std::string CreateTestDir() {
+  path directory = std::filesystem::temp_directory_path() / GenerateUUIDV4();
+  create_directories(directory);
+  return directory.string();
+}
+};  // namespace
+
+TEST(WarmTierAllocatorTest, AllocateAndFree) {
+  WarmTierAllocator allocator(CreateTestDir(), 4 * kKB);
+  EXPECT_EQ(4 * kKB, allocator.GetFootprintLimit());
+
+  auto allocation_1 = allocator.Allocate(kKB);
+  ASSERT_TRUE(allocation_1.has_value());
+  auto allocation_2 = allocator.Allocate(kKB);
+  ASSERT_TRUE(allocation_2.has_value());
+  EXPECT_EQ(2 * kKB, allocator.Allocated());
+  EXPECT_EQ(0, allocator.FallbackAllocated());
+
+  // Both allocations share the arena file and can be mapped by clients.
+  EXPECT_EQ(allocation_1->fd, allocation_2->fd);
+  EXPECT_NE(allocation_1->offset, allocation_2->offset);
+  EXPECT_EQ(4 * kKB + kMmapRegionsGap, allocation_1->mmap_size);
+  EXPECT_EQ(static_cast<uint8_t *>(allocation_1->address) - allocation_1->offset,
+            static_cast<uint8_t *>(allocation_2->address) - allocation_2->offset);
+
+  // The memory is writable.
+  std::memset(allocation_1->address, 1, kKB);
+  std::memset(allocation_2->address, 2, kKB);
+  EXPECT_EQ(1, static_cast<uint8_t *>(allocation_1->address)[kKB - 1]);
+
+  allocator.Free(std::move(allocation_1.value()));
+  allocator.Free(std::move(allocation_2.value()));
+  EXPECT_EQ(0, allocator.Allocated());
+}
+
+TEST(WarmTierAllocatorTest, OutOfSpaceAndCoalesce) {
+  WarmTierAllocator allocator(CreateTestDir(), 4 * kKB);
+  std::vector<Allocation> allocations;
+  for (int i = 0; i < 4; i++) {
+    auto allocation = allocator.Allocate(kKB);
+    ASSERT_TRUE(allocation.has_value());
+    allocations.push_back(std::move(allocation.value()));
+  }
+  EXPECT_FALSE(allocator.Allocate(1).has_value());
+  EXPECT_FALSE(allocator.FallbackAllocate(1).has_value());
+
+  // Free the two middle blocks, they must coalesce into a single 2KB range.
+  allocator.Free(std::move(allocations[2]));
+  allocator.Free(std::move(allocations[1]));
+  EXPECT_EQ(2 * kKB, allocator.Allocated());
+  auto allocation = allocator.Allocate(2 * kKB);
+  ASSERT_TRUE(allocation.has_value());
+  EXPECT_EQ(kKB, allocation->offset);
+  EXPECT_FALSE(allocator.Allocate(1).has_value());
+
+  allocator.Free(std::move(allocation.value()));
+  allocator.Free(std::move(allocations[0]));
+  allocator.Free(std::move(allocations[3]));
+  EXPECT_EQ(0, allocator.Allocated());
+  EXPECT_TRUE(allocator.Allocate(4 * kKB).has_value());
+}
+
+TEST(WarmTierAllocatorTest, UnalignedSizes) {
+  WarmTierAllocator allocator(CreateTestDir(), 4 * kKB);
+  auto allocation_1 = allocator.Allocate(1);
+  auto allocation_2 = allocator.Allocate(0);
+  ASSERT_TRUE(allocation_1.has_value());
+  ASSERT_TRUE(allocation_2.has_value());
+  EXPECT_EQ(0, allocation_2->offset % 64);
+  EXPECT_NE(allocation_1->address, allocation_2->address);
+  EXPECT_EQ(1, allocator.Allocated());
+  allocator.Free(std::move(allocation_1.value()));
+  allocator.Free(std::move(allocation_2.value()));
+  EXPECT_EQ(0, allocator.Allocated());
+}
+
+}  // namespace plasma
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
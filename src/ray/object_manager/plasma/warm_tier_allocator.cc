@@ -0,0 +1,185 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ray/object_manager/plasma/warm_tier_allocator.h"
+
+#ifdef __linux__
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* Turns on fallocate() definition */
+#endif              /* _GNU_SOURCE */
+#include <fcntl.h>
+#endif /* __linux__ */
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+#include "ray/object_manager/plasma/malloc.h"
+#include "ray/util/logging.h"
+
+namespace plasma {
+namespace internal {
+int64_t NextMmapUniqueId();
+}  // namespace internal
+
+namespace {
+// Keep in sync with kAllocationAlignment in plasma_allocator.cc.
+const size_t kWarmTierAlignment = 64;
+}  // namespace
+
+WarmTierAllocator::WarmTierAllocator(const std::string &directory, int64_t capacity)
+    : kCapacity(capacity),
+      kAlignment(kWarmTierAlignment),
+      base_(nullptr),
+      fd_(INVALID_FD, INVALID_UNIQUE_FD_ID),
+      mmap_size_(0),
+      allocated_(0) {
+  RAY_CHECK(kCapacity > 0) << "Warm tier capacity must be positive.";
+#ifdef _WIN32
+  RAY_LOG(FATAL) << "The plasma warm tier is not supported on Windows.";
+#else
+  std::string file_template = directory + "/plasma_warmXXXXXX";
+  std::vector<char> file_name(file_template.begin(), file_template.end());
+  file_name.push_back('\0');
+  int fd = mkstemp(&file_name[0]);
+  if (fd < 0) {
+    RAY_LOG(FATAL) << "Failed to create warm tier file " << &file_name[0] << ", error "
+                   << std::strerror(errno);
+  }
+  // Immediately unlink the file so we do not leave traces in the system.
+  if (unlink(&file_name[0]) != 0) {
+    RAY_LOG(FATAL) << "Failed to unlink warm tier file " << &file_name[0] << ", error "
+                   << std::strerror(errno);
+  }
+  // Clients subtract kMmapRegionsGap from the mmap size they receive (see
+  // ClientMmapTableEntry), so reserve the gap at the end of the file to make
+  // sure the whole arena is visible to them.
+  mmap_size_ = kCapacity + kMmapRegionsGap;
+  bool reserved = false;
+#ifdef __linux__
+  // Reserve the blocks up front so writes into the mapping never SIGBUS.
+  if (fallocate(fd, /*mode*/ 0, /*offset*/ 0, mmap_size_) == 0) {
+    reserved = true;
+  } else if (errno != EOPNOTSUPP && errno != ENOSYS) {
+    RAY_LOG(FATAL) << "Not enough disk space in " << directory << " for a warm tier of "
+                   << kCapacity << " bytes: " << std::strerror(errno);
+  }
+#endif /* __linux__ */
+  if (!reserved && ftruncate(fd, (off_t)mmap_size_) != 0) {
+    RAY_LOG(FATAL) << "Failed to ftruncate warm tier file, error "
+                   << std::strerror(errno);
+  }
+  void *pointer = mmap(NULL, mmap_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (pointer == MAP_FAILED) {
+    RAY_LOG(FATAL) << "Failed to mmap warm tier file, error " << std::strerror(errno);
+  }
+  base_ = static_cast<uint8_t *>(pointer);
+  fd_ = {fd, internal::NextMmapUniqueId()};
+  free_ranges_.emplace(0, kCapacity);
+  RAY_LOG(INFO) << "Plasma warm tier of " << kCapacity << " bytes created in "
+                << directory;
+#endif
+}
+
+WarmTierAllocator::~WarmTierAllocator() {
+#ifndef _WIN32
+  if (base_ != nullptr) {
+    munmap(base_, mmap_size_);
+    close(fd_.first);
+  }
+#endif
+}
+
+absl::optional<Allocation> WarmTierAllocator::Allocate(size_t bytes) {
+  const int64_t size = static_cast<int64_t>(AlignedSize(bytes));
+  for (auto it = free_ranges_.begin(); it != free_ranges_.end(); it++) {
+    if (it->second < size) {
+      continue;
+    }
+    const int64_t offset = it->first;
+    const int64_t remaining = it->second - size;
+    free_ranges_.erase(it);
+    if (remaining > 0) {
+      free_ranges_.emplace(offset + size, remaining);
+    }
+    allocated_ += bytes;
+    RAY_LOG(DEBUG) << "warm tier allocated " << bytes << " at offset " << offset;
+    return Allocation(base_ + offset,
+                      static_cast<int64_t>(bytes),
+                      fd_,
+                      offset,
+                      0 /* device_number*/,
+                      mmap_size_);
+  }
+  return absl::nullopt;
+}
+
+absl::optional<Allocation> WarmTierAllocator::FallbackAllocate(size_t bytes) {
+  return Allocate(bytes);
+}
+
+void WarmTierAllocator::Free(Allocation allocation) {
+  RAY_CHECK(allocation.address != nullptr) << "Cannot free the nullptr";
+  RAY_CHECK(allocation.fd == fd_) << "Allocation doesn't belong to the warm tier.";
+  int64_t offset = allocation.offset;
+  int64_t size = static_cast<int64_t>(AlignedSize(allocation.size));
+  RAY_LOG(DEBUG) << "warm tier deallocating " << allocation.size << " at offset "
+                 << offset;
+  auto next = free_ranges_.lower_bound(offset);
+  RAY_CHECK(next == free_ranges_.end() || next->first >= offset + size)
+      << "Double free in warm tier at offset " << offset;
+  // Merge with the following free range.
+  if (next != free_ranges_.end() && next->first == offset + size) {
+    size += next->second;
+    next = free_ranges_.erase(next);
+  }
+  // Merge with the preceding free range.
+  if (next != free_ranges_.begin()) {
+    auto prev = std::prev(next);
+    RAY_CHECK(prev->first + prev->second <= offset)
+        << "Double free in warm tier at offset " << offset;
+    if (prev->first + prev->second == offset) {
+      prev->second += size;
+      allocated_ -= allocation.size;
+      return;
+    }
+  }
+  free_ranges_.emplace(offset, size);
+  allocated_ -= allocation.size;
+}
+
+int64_t WarmTierAllocator::GetFootprintLimit() const { return kCapacity; }
+
+int64_t WarmTierAllocator::Allocated() const { return allocated_; }
+
+int64_t WarmTierAllocator::FallbackAllocated() const { return 0; }
+
+size_t WarmTierAllocator::AlignedSize(size_t bytes) const {
+  // Zero sized objects still need a distinct address.
+  if (bytes == 0) {
+    return kAlignment;
+  }
+  return (bytes + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+}  // namespace plasma
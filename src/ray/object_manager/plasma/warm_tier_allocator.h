@@ -0,0 +1,90 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "absl/types/optional.h"
+#include "ray/object_manager/plasma/allocator.h"
+#include "ray/object_manager/plasma/common.h"
+
+namespace plasma {
+
+// WarmTierAllocator manages a single large mmapped arena file that lives on a
+// local (typically NVMe) filesystem. It sits between the /dev/shm backed
+// PlasmaAllocator and external storage: objects demoted from shared memory are
+// copied into this arena, and since the arena is a regular mmapped file its
+// allocations carry an fd/offset pair that clients can map directly, exactly like
+// the primary allocations.
+//
+// Unlike PlasmaAllocator this class does not depend on dlmalloc, so it can be
+// instantiated independently. It is not thread safe.
+class WarmTierAllocator : public IAllocator {
+ public:
+  /// \param directory Directory in which the arena file is created. The file is
+  /// unlinked right after creation so it never outlives the process.
+  /// \param capacity Size of the arena in bytes.
+  WarmTierAllocator(const std::string &directory, int64_t capacity);
+
+  ~WarmTierAllocator() override;
+
+  /// Allocates bytes from the arena using first-fit.
+  ///
+  /// \param bytes Number of bytes.
+  /// \return allocated memory. returns empty if not enough contiguous space.
+  absl::optional<Allocation> Allocate(size_t bytes) override;
+
+  /// The warm tier has no fallback; this is the same as Allocate.
+  absl::optional<Allocation> FallbackAllocate(size_t bytes) override;
+
+  /// Returns the allocation to the arena, coalescing adjacent free ranges.
+  ///
+  /// \param allocation allocation to free.
+  void Free(Allocation allocation) override;
+
+  /// Get the capacity of the arena.
+  int64_t GetFootprintLimit() const override;
+
+  /// Get the number of bytes allocated so far.
+  int64_t Allocated() const override;
+
+  /// Always 0, the warm tier never falls back.
+  int64_t FallbackAllocated() const override;
+
+ private:
+  /// Round the request up to the allocation alignment.
+  size_t AlignedSize(size_t bytes) const;
+
+  const int64_t kCapacity;
+  const size_t kAlignment;
+  /// Start address of the mmapped arena.
+  uint8_t *base_;
+  /// The fd of the arena file, paired with its unique id.
+  MEMFD_TYPE fd_;
+  /// The size of the file mapping, including kMmapRegionsGap.
+  int64_t mmap_size_;
+  /// Free ranges of the arena, keyed by offset with the size as value.
+  /// Adjacent ranges are always coalesced.
+  std::map<int64_t, int64_t> free_ranges_;
+  int64_t allocated_;
+};
+
+}  // namespace plasma
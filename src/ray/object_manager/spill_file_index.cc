@@ -0,0 +1,150 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/spill_file_index.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include "ray/util/crc32.h"
+#include "ray/util/logging.h"
+
+namespace ray {
+namespace {
+const char kSpillFileMagic[] = "RAYSPIL2";
+// Records are verified in pieces of this size.
+const size_t kVerifyBufferSize = 1024 * 1024;
+
+uint64_t DecodeUINT64(const char *p) {
+  uint64_t result = 0;
+  for (size_t i = 0; i < 8; i++) {
+    result |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+  }
+  return result;
+}
+
+uint32_t DecodeUINT32(const char *p) {
+  uint32_t result = 0;
+  for (size_t i = 0; i < 4; i++) {
+    result |= static_cast<uint32_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+  }
+  return result;
+}
+}  // namespace
+
+/* static */
+bool SpillFileIndex::IsIndexedSpillFile(std::istream &is) {
+  std::string magic(kMagicSize, '\0');
+  if (!is.seekg(0) || !is.read(&magic[0], kMagicSize)) {
+    is.clear();
+    return false;
+  }
+  return magic == kSpillFileMagic;
+}
+
+/* static */
+bool SpillFileIndex::ReadIndex(std::istream &is,
+                               std::vector<SpillFileIndexEntry> &entries) {
+  entries.clear();
+  if (!IsIndexedSpillFile(is) || !is.seekg(0, std::ios::end)) {
+    return false;
+  }
+  const uint64_t file_size = is.tellg();
+  if (file_size < kMagicSize + kFooterSize) {
+    return false;
+  }
+
+  std::string footer(kFooterSize, '\0');
+  if (!is.seekg(file_size - kFooterSize) || !is.read(&footer[0], kFooterSize) ||
+      footer.compare(kFooterSize - kMagicSize, kMagicSize, kSpillFileMagic) != 0) {
+    return false;
+  }
+  const uint64_t index_offset = DecodeUINT64(&footer[0]);
+  const uint64_t num_objects = DecodeUINT64(&footer[8]);
+  const uint32_t index_checksum = DecodeUINT32(&footer[16]);
+  if (index_offset < kMagicSize || index_offset > file_size - kFooterSize ||
+      num_objects != (file_size - kFooterSize - index_offset) / kEntrySize ||
+      (file_size - kFooterSize - index_offset) % kEntrySize != 0) {
+    return false;
+  }
+
+  std::string index(num_objects * kEntrySize, '\0');
+  if (!is.seekg(index_offset) || !is.read(&index[0], index.size()) ||
+      Crc32(index.data(), index.size()) != index_checksum) {
+    return false;
+  }
+  entries.reserve(num_objects);
+  for (uint64_t i = 0; i < num_objects; i++) {
+    const char *p = &index[i * kEntrySize];
+    SpillFileIndexEntry entry;
+    entry.object_id = ObjectID::FromBinary(std::string(p, kUniqueIDSize));
+    entry.offset = DecodeUINT64(p + kUniqueIDSize);
+    entry.size = DecodeUINT64(p + kUniqueIDSize + 8);
+    entry.checksum = DecodeUINT32(p + kUniqueIDSize + 16);
+    if (entry.offset < kMagicSize || entry.offset + entry.size > index_offset) {
+      entries.clear();
+      return false;
+    }
+    entries.push_back(std::move(entry));
+  }
+  return true;
+}
+
+/* static */
+bool SpillFileIndex::ReadIndex(const std::string &file_path,
+                               std::vector<SpillFileIndexEntry> &entries) {
+  std::ifstream is(file_path, std::ios::binary);
+  return is && ReadIndex(is, entries);
+}
+
+/* static */
+absl::optional<SpillFileIndexEntry> SpillFileIndex::FindEntry(
+    const std::vector<SpillFileIndexEntry> &entries, uint64_t offset) {
+  // Entries are written in offset order.
+  auto it = std::lower_bound(
+      entries.begin(), entries.end(), offset, [](const auto &entry, uint64_t value) {
+        return entry.offset < value;
+      });
+  if (it == entries.end() || it->offset != offset) {
+    return absl::nullopt;
+  }
+  return *it;
+}
+
+/* static */
+bool SpillFileIndex::VerifyRecord(std::istream &is, const SpillFileIndexEntry &entry) {
+  if (!is.seekg(entry.offset)) {
+    return false;
+  }
+  std::vector<char> buffer(std::min<uint64_t>(entry.size, kVerifyBufferSize));
+  uint64_t remaining = entry.size;
+  uint32_t checksum = 0;
+  while (remaining > 0) {
+    const size_t size = std::min<uint64_t>(remaining, buffer.size());
+    if (!is.read(buffer.data(), size)) {
+      return false;
+    }
+    checksum = Crc32(buffer.data(), size, checksum);
+    remaining -= size;
+  }
+  if (checksum != entry.checksum) {
+    RAY_LOG(ERROR) << "Checksum mismatch for spilled object " << entry.object_id
+                   << " at offset " << entry.offset << ", expected " << entry.checksum
+                   << " but got " << checksum;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace ray
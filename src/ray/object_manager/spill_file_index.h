@@ -0,0 +1,98 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "ray/common/id.h"
+
+namespace ray {
+
+/// An entry of the index stored in the footer of a spill file.
+struct SpillFileIndexEntry {
+  /// The object stored in the record.
+  ObjectID object_id;
+  /// Offset of the object record in the file. This is the offset used in the
+  /// spilled object url.
+  uint64_t offset = 0;
+  /// Size of the whole object record, including its header.
+  uint64_t size = 0;
+  /// CRC-32 (zlib) of the whole object record.
+  uint32_t checksum = 0;
+};
+
+/// Reader of the self-describing (v2) spill file format. IO workers fuse objects
+/// into a single file with the following layout. All integers are little-endian.
+///     --- file header (at offset 0) ---
+///      magic               (8 bytes, "RAYSPIL2")
+///     --- object records, see SpilledObjectReader::ParseObjectHeader ---
+///      address_size        (8 bytes),
+///      metadata_size       (8 bytes),
+///      data_size           (8 bytes),
+///      serialized_address  (address_size bytes),
+///      metadata_payload    (metadata_size bytes),
+///      data_payload        (data_size bytes)
+///      ...
+///     --- index, one entry per object record ---
+///      object_id           (28 bytes),
+///      record_offset       (8 bytes),
+///      record_size         (8 bytes),
+///      record_crc32        (4 bytes)
+///      ...
+///     --- footer (last 32 bytes of the file) ---
+///      index_offset        (8 bytes),
+///      num_objects         (8 bytes),
+///      index_crc32         (4 bytes),
+///      reserved            (4 bytes),
+///      magic               (8 bytes, "RAYSPIL2")
+///
+/// Object urls keep pointing at the object records, so records of v2 files can
+/// be read exactly like the legacy format which has no file header and no index.
+/// The index additionally allows validating records and listing the objects of
+/// a file without the owner's url table.
+class SpillFileIndex {
+ public:
+  static constexpr size_t kMagicSize = 8;
+  static constexpr size_t kEntrySize = kUniqueIDSize + 8 + 8 + 4;
+  static constexpr size_t kFooterSize = 8 + 8 + 4 + 4 + kMagicSize;
+
+  /// Return true if the stream starts with the v2 magic.
+  static bool IsIndexedSpillFile(std::istream &is);
+
+  /// Read and validate the index of a v2 spill file.
+  /// Return false if the file is not a v2 spill file or the index is corrupted.
+  ///
+  /// \param[in] is input stream to read from.
+  /// \param[out] entries index entries, in the order the objects were written.
+  /// \return bool.
+  static bool ReadIndex(std::istream &is, std::vector<SpillFileIndexEntry> &entries);
+
+  /// Read the index of the v2 spill file at the given path.
+  static bool ReadIndex(const std::string &file_path,
+                        std::vector<SpillFileIndexEntry> &entries);
+
+  /// Find the index entry of the record at the given offset.
+  static absl::optional<SpillFileIndexEntry> FindEntry(
+      const std::vector<SpillFileIndexEntry> &entries, uint64_t offset);
+
+  /// Recompute the checksum of a record and compare it with the index entry.
+  /// Return false on mismatch or if the record can't be read.
+  static bool VerifyRecord(std::istream &is, const SpillFileIndexEntry &entry);
+};
+
+}  // namespace ray
@@ -14,9 +14,16 @@
 
 #include "ray/object_manager/spilled_object_reader.h"
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include <fstream>
 #include <regex>
 
+#include "ray/common/file_io_service.h"
+#include "ray/object_manager/spill_file_index.h"
 #include "ray/util/logging.h"
 
 namespace ray {
@@ -54,6 +61,23 @@ SpilledObjectReader::CreateSpilledObjectReader(const std::string &object_url) {
     return absl::optional<SpilledObjectReader>();
   }
 
+  // Files in the indexed format carry a checksum for every record. Reject
+  // records that don't match their index entry instead of serving corrupted
+  // data. Legacy files have no index and are read unchecked.
+  if (SpillFileIndex::IsIndexedSpillFile(is)) {
+    std::vector<SpillFileIndexEntry> entries;
+    if (!SpillFileIndex::ReadIndex(is, entries)) {
+      RAY_LOG(WARNING) << "Corrupted index in spill file " << file_path;
+      return absl::optional<SpilledObjectReader>();
+    }
+    auto entry = SpillFileIndex::FindEntry(entries, object_offset);
+    if (!entry || entry->size != object_size ||
+        !SpillFileIndex::VerifyRecord(is, *entry)) {
+      RAY_LOG(WARNING) << "Failed to verify spilled object " << object_url;
+      return absl::optional<SpilledObjectReader>();
+    }
+  }
+
   return absl::optional<SpilledObjectReader>(
       SpilledObjectReader(std::move(file_path),
                           object_size,
@@ -179,4 +203,32 @@ bool SpilledObjectReader::ReadFromMetadataSection(uint64_t offset,
   std::ifstream is(file_path_, std::ios::binary);
   return is.seekg(metadata_offset_ + offset) && is.read(output, size);
 }
+
+void SpilledObjectReader::AsyncReadFromSection(FileIOService &file_io_service,
+                                               bool from_metadata,
+                                               uint64_t offset,
+                                               uint64_t size,
+                                               char *output,
+                                               std::function<void(bool)> callback) const {
+#ifdef _WIN32
+  IObjectReader::AsyncReadFromSection(
+      file_io_service, from_metadata, offset, size, output, std::move(callback));
+#else
+  int fd = open(file_path_.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    callback(false);
+    return;
+  }
+  const uint64_t file_offset = (from_metadata ? metadata_offset_ : data_offset_) + offset;
+  file_io_service.AsyncRead(
+      fd,
+      output,
+      size,
+      file_offset,
+      [fd, size, callback = std::move(callback)](const Status &status, size_t bytes) {
+        close(fd);
+        callback(status.ok() && bytes == size);
+      });
+#endif
+}
 }  // namespace ray
@@ -44,28 +44,12 @@ class SpilledObjectReader : public IObjectReader {
   bool ReadFromMetadataSection(uint64_t offset,
                                uint64_t size,
                                char *output) const override;
-
- private:
-  SpilledObjectReader(std::string file_path,
-                      uint64_t total_size,
-                      uint64_t data_offset,
-                      uint64_t data_size,
-                      uint64_t metadata_offset,
-                      uint64_t metadata_size,
-                      rpc::Address owner_address);
-
-  /// Parse the object url in the form of {path}?offset={offset}&size={size}.
-  /// Return false if parsing failed.
-  ///
-  /// \param[in] object_url url to parse from.
-  /// \param[out] file_path file stores the object.
-  /// \param[out] object_offset offset of the object stored in the file..
-  /// \param[out] total_size object size in the file.
-  /// \return bool.
-  static bool ParseObjectURL(const std::string &object_url,
-                             std::string &file_path,
-                             uint64_t &object_offset,
-                             uint64_t &total_size);
+  void AsyncReadFromSection(FileIOService &file_io_service,
+                            bool from_metadata,
+                            uint64_t offset,
+                            uint64_t size,
+                            char *output,
+                            std::function<void(bool)> callback) const override;
 
   /// Read the istream, parse the object header according to the following format.
   /// Return false if the input stream is deleted or corrupted.
@@ -95,6 +79,28 @@ class SpilledObjectReader : public IObjectReader {
                                 uint64_t &metadata_size,
                                 rpc::Address &owner_address);
 
+ private:
+  SpilledObjectReader(std::string file_path,
+                      uint64_t total_size,
+                      uint64_t data_offset,
+                      uint64_t data_size,
+                      uint64_t metadata_offset,
+                      uint64_t metadata_size,
+                      rpc::Address owner_address);
+
+  /// Parse the object url in the form of {path}?offset={offset}&size={size}.
+  /// Return false if parsing failed.
+  ///
+  /// \param[in] object_url url to parse from.
+  /// \param[out] file_path file stores the object.
+  /// \param[out] object_offset offset of the object stored in the file..
+  /// \param[out] total_size object size in the file.
+  /// \return bool.
+  static bool ParseObjectURL(const std::string &object_url,
+                             std::string &file_path,
+                             uint64_t &object_offset,
+                             uint64_t &total_size);
+
   /// Read 8 bytes from inputstream and deserialize it as a little-endian
   /// uint64_t. Return false if reach end of stream early.
   static bool ReadUINT64(std::istream &is, uint64_t &output);
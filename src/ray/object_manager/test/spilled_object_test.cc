@@ -17,10 +17,14 @@
 
 #include "absl/strings/str_format.h"
 #include "gtest/gtest.h"
+#include "ray/common/asio/instrumented_io_context.h"
+#include "ray/common/file_io_service.h"
 #include "ray/common/test_util.h"
 #include "ray/object_manager/chunk_object_reader.h"
 #include "ray/object_manager/memory_object_reader.h"
+#include "ray/object_manager/spill_file_index.h"
 #include "ray/object_manager/spilled_object_reader.h"
+#include "ray/util/crc32.h"
 #include "ray/util/filesystem.h"
 
 namespace ray {
@@ -292,6 +296,115 @@ TEST(SpilledObjectReaderTest, CreateSpilledObjectReader) {
   ASSERT_FALSE(SpilledObjectReader::CreateSpilledObjectReader(object_url1).has_value());
 }
 
+namespace {
+void AppendUINT64(std::string &s, uint64_t value) {
+  value = boost::endian::native_to_little(value);
+  s.append((char *)(&value), 8);
+}
+
+void AppendUINT32(std::string &s, uint32_t value) {
+  value = boost::endian::native_to_little(value);
+  s.append((char *)(&value), 4);
+}
+
+/// Write a v2 spill file with one record per data string and return its path.
+/// The urls of the records are appended to object_urls.
+std::string CreateIndexedSpillFileOnTmp(const std::vector<std::string> &data,
+                                        std::vector<ObjectID> &object_ids,
+                                        std::vector<std::string> &object_urls) {
+  std::string file("RAYSPIL2");
+  std::string index;
+  for (const auto &d : data) {
+    auto record = ContructObjectString(0, d, "metadata", rpc::Address());
+    auto object_id = ObjectID::FromRandom();
+    index.append(object_id.Binary());
+    AppendUINT64(index, file.size());
+    AppendUINT64(index, record.size());
+    AppendUINT32(index, Crc32(record.data(), record.size()));
+    object_ids.push_back(object_id);
+    object_urls.push_back(std::to_string(file.size()) + "&size=" +
+                          std::to_string(record.size()));
+    file.append(record);
+  }
+  uint64_t index_offset = file.size();
+  file.append(index);
+  AppendUINT64(file, index_offset);
+  AppendUINT64(file, data.size());
+  AppendUINT32(file, Crc32(index.data(), index.size()));
+  AppendUINT32(file, 0);
+  file.append("RAYSPIL2");
+
+  std::string tmp_file = ray::JoinPaths(
+      ray::GetUserTempDir(), "spilled_object_test" + ObjectID::FromRandom().Hex());
+  std::ofstream f(tmp_file, std::ios::binary);
+  RAY_CHECK(f.write(file.c_str(), file.size()));
+  f.close();
+  for (auto &url : object_urls) {
+    url = tmp_file + "?offset=" + url;
+  }
+  return tmp_file;
+}
+
+void CorruptFileAt(const std::string &file_path, uint64_t offset) {
+  std::fstream f(file_path, std::ios::binary | std::ios::in | std::ios::out);
+  f.seekg(offset);
+  char c = f.get();
+  f.seekp(offset);
+  f.put(c ^ 0x1);
+}
+}  // namespace
+
+TEST(SpillFileIndexTest, ReadIndex) {
+  std::vector<ObjectID> object_ids;
+  std::vector<std::string> object_urls;
+  auto file_path =
+      CreateIndexedSpillFileOnTmp({"data1", "data22"}, object_ids, object_urls);
+
+  std::vector<SpillFileIndexEntry> entries;
+  ASSERT_TRUE(SpillFileIndex::ReadIndex(file_path, entries));
+  ASSERT_EQ(2, entries.size());
+  ASSERT_EQ(object_ids[0], entries[0].object_id);
+  ASSERT_EQ(object_ids[1], entries[1].object_id);
+  ASSERT_EQ(SpillFileIndex::kMagicSize, entries[0].offset);
+  ASSERT_EQ(entries[0].offset + entries[0].size, entries[1].offset);
+
+  ASSERT_TRUE(SpillFileIndex::FindEntry(entries, entries[1].offset).has_value());
+  ASSERT_FALSE(SpillFileIndex::FindEntry(entries, entries[1].offset + 1).has_value());
+
+  std::ifstream is(file_path, std::ios::binary);
+  ASSERT_TRUE(SpillFileIndex::VerifyRecord(is, entries[0]));
+  ASSERT_TRUE(SpillFileIndex::VerifyRecord(is, entries[1]));
+
+  // Legacy files have no index.
+  auto legacy_url = CreateSpilledObjectReaderOnTmp(
+      0 /* object_offset */, "data", "metadata", ray::rpc::Address());
+  auto legacy_path = legacy_url.substr(0, legacy_url.find('?'));
+  ASSERT_FALSE(SpillFileIndex::ReadIndex(legacy_path, entries));
+}
+
+TEST(SpillFileIndexTest, DetectCorruption) {
+  std::vector<ObjectID> object_ids;
+  std::vector<std::string> object_urls;
+  auto file_path =
+      CreateIndexedSpillFileOnTmp({"data1", "data22"}, object_ids, object_urls);
+  ASSERT_TRUE(SpilledObjectReader::CreateSpilledObjectReader(object_urls[0]).has_value());
+  ASSERT_TRUE(SpilledObjectReader::CreateSpilledObjectReader(object_urls[1]).has_value());
+
+  // Flip the last byte of the second object's data.
+  std::vector<SpillFileIndexEntry> entries;
+  ASSERT_TRUE(SpillFileIndex::ReadIndex(file_path, entries));
+  CorruptFileAt(file_path, entries[1].offset + entries[1].size - 1);
+  ASSERT_TRUE(SpilledObjectReader::CreateSpilledObjectReader(object_urls[0]).has_value());
+  ASSERT_FALSE(
+      SpilledObjectReader::CreateSpilledObjectReader(object_urls[1]).has_value());
+
+  // A corrupted index invalidates the whole file.
+  CorruptFileAt(file_path, entries[1].offset + entries[1].size);
+  ASSERT_FALSE(SpillFileIndex::ReadIndex(file_path, entries));
+  ASSERT_FALSE(
+      SpilledObjectReader::CreateSpilledObjectReader(object_urls[0]).has_value());
+}
+
 template <class T>
 std::shared_ptr<T> CreateObjectReader(std::string &data,
                                       std::string &metadata,
@@ -411,6 +524,46 @@ TYPED_TEST(ObjectReaderTest, GetChunk) {
   }
 }
 
+TYPED_TEST(ObjectReaderTest, AsyncGetChunk) {
+  instrumented_io_context io_context;
+  boost::asio::io_context::work work(io_context);
+  FileIOService file_io_service(io_context);
+  std::vector<std::string> list_data{"", "alotofdata", "da", "data"};
+  std::vector<std::string> list_metadata{"", "meta", "metadata", "alotofmetadata"};
+  for (auto &data : list_data) {
+    for (auto &metadata : list_metadata) {
+      std::vector<uint64_t> chunk_sizes{1, 2, 3, 5, 100};
+      rpc::Address owner_address;
+      std::string expected_output = data + metadata;
+
+      for (auto chunk_size : chunk_sizes) {
+        auto reader = ChunkObjectReader(
+            TestFixture::CreateObjectReader_(data, metadata, owner_address), chunk_size);
+
+        // The chunks must match the synchronous reads.
+        std::string actual_output_by_chunks;
+        for (uint64_t i = 0; i < reader.GetNumChunks(); i++) {
+          absl::optional<std::string> chunk;
+          bool done = false;
+          reader.AsyncGetChunk(
+              file_io_service, i, [&](absl::optional<std::string> result) {
+                chunk = std::move(result);
+                done = true;
+              });
+          while (!done) {
+            io_context.run_one();
+          }
+          io_context.restart();
+          ASSERT_TRUE(chunk.has_value());
+          ASSERT_EQ(reader.GetChunk(i).value(), chunk.value());
+          actual_output_by_chunks.append(chunk.value());
+        }
+        ASSERT_EQ(expected_output, actual_output_by_chunks);
+      }
+    }
+  }
+}
+
 TEST(StringAllocationTest, TestNoCopyWhenStringMoved) {
   // Since protobuf always allocate string on heap,
   // move assign a string field doesn't copy the data.
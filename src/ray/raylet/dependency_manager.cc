@@ -173,17 +173,18 @@ bool DependencyManager::RequestTaskDependencies(
 
   const auto required_ids = ObjectRefsToIds(required_objects);
   absl::flat_hash_set<ObjectID> deduped_ids(required_ids.begin(), required_ids.end());
-  auto inserted = queued_task_requests_.emplace(task_id, std::move(deduped_ids));
+  auto inserted = queued_task_requests_.emplace(
+      task_id, std::make_unique<TaskDependencies>(std::move(deduped_ids)));
   RAY_CHECK(inserted.second) << "Task depedencies can be requested only once per task. "
                              << task_id;
-  auto &task_entry = inserted.first->second;
+  auto &task_entry = *inserted.first->second;
 
   for (const auto &ref : required_objects) {
     const auto obj_id = ObjectRefToId(ref);
     RAY_LOG(DEBUG) << "Task " << task_id << " blocked on object " << obj_id;
 
     auto it = GetOrInsertRequiredObject(obj_id, ref);
-    it->second.dependent_tasks.insert(task_id);
+    it->second.dependent_tasks.emplace(task_id, &task_entry);
   }
 
   for (const auto &obj_id : task_entry.dependencies) {
@@ -208,13 +209,13 @@ void DependencyManager::RemoveTaskDependencies(const TaskID &task_id) {
   RAY_CHECK(task_entry != queued_task_requests_.end())
       << "Can't remove dependencies of tasks that are not queued.";
 
-  if (task_entry->second.pull_request_id > 0) {
+  if (task_entry->second->pull_request_id > 0) {
     RAY_LOG(DEBUG) << "Canceling pull for dependencies of task " << task_id
-                   << " request: " << task_entry->second.pull_request_id;
-    object_manager_.CancelPull(task_entry->second.pull_request_id);
+                   << " request: " << task_entry->second->pull_request_id;
+    object_manager_.CancelPull(task_entry->second->pull_request_id);
   }
 
-  for (const auto &obj_id : task_entry->second.dependencies) {
+  for (const auto &obj_id : task_entry->second->dependencies) {
     auto it = required_objects_.find(obj_id);
     RAY_CHECK(it != required_objects_.end());
     it->second.dependent_tasks.erase(task_id);
@@ -233,15 +234,13 @@ std::vector<TaskID> DependencyManager::HandleObjectMissing(
   std::vector<TaskID> waiting_task_ids;
   auto object_entry = required_objects_.find(object_id);
   if (object_entry != required_objects_.end()) {
-    for (auto &dependent_task_id : object_entry->second.dependent_tasks) {
-      auto it = queued_task_requests_.find(dependent_task_id);
-      RAY_CHECK(it != queued_task_requests_.end());
-      auto &task_entry = it->second;
+    for (const auto &dependent_task : object_entry->second.dependent_tasks) {
+      auto &task_entry = *dependent_task.second;
       // If the dependent task had all of its arguments ready, it was ready to
       // run but must be switched to waiting since one of its arguments is now
       // missing.
       if (task_entry.num_missing_dependencies == 0) {
-        waiting_task_ids.push_back(dependent_task_id);
+        waiting_task_ids.push_back(dependent_task.first);
         // During normal execution we should be able to include the check
         // RAY_CHECK(pending_tasks_.count(dependent_task_id) == 1);
         // However, this invariant will not hold during unit test execution.
@@ -265,15 +264,17 @@ std::vector<TaskID> DependencyManager::HandleObjectLocal(const ray::ObjectID &ob
   auto object_entry = required_objects_.find(object_id);
   if (object_entry != required_objects_.end()) {
     // Loop through all tasks that depend on the newly available object.
-    for (const auto &dependent_task_id : object_entry->second.dependent_tasks) {
-      auto it = queued_task_requests_.find(dependent_task_id);
-      RAY_CHECK(it != queued_task_requests_.end());
-      auto &task_entry = it->second;
+    for (const auto &dependent_task : object_entry->second.dependent_tasks) {
+      auto &task_entry = *dependent_task.second;
       task_entry.num_missing_dependencies--;
       // If the dependent task now has all of its arguments ready, it's ready
       // to run.
       if (task_entry.num_missing_dependencies == 0) {
-        ready_task_ids.push_back(dependent_task_id);
+        ready_task_ids.push_back(dependent_task.first);
+        if (!task_entry.in_ready_tasks) {
+          task_entry.in_ready_tasks = true;
+          ready_tasks_.push_back(dependent_task.first);
+        }
       }
     }
 
@@ -302,18 +303,37 @@ std::vector<TaskID> DependencyManager::HandleObjectLocal(const ray::ObjectID &ob
   return ready_task_ids;
 }
 
+std::vector<TaskID> DependencyManager::TakeReadyTasks() {
+  std::vector<TaskID> ready_task_ids;
+  for (const auto &task_id : ready_tasks_) {
+    auto it = queued_task_requests_.find(task_id);
+    // The same task may be in the batch twice if its dependencies were removed and
+    // requested again, only the first one is taken.
+    if (it == queued_task_requests_.end() || !it->second->in_ready_tasks) {
+      continue;
+    }
+    it->second->in_ready_tasks = false;
+    if (it->second->num_missing_dependencies == 0) {
+      ready_task_ids.push_back(task_id);
+    }
+  }
+  ready_tasks_.clear();
+  return ready_task_ids;
+}
+
 bool DependencyManager::TaskDependenciesBlocked(const TaskID &task_id) const {
   auto it = queued_task_requests_.find(task_id);
   RAY_CHECK(it != queued_task_requests_.end());
-  RAY_CHECK(it->second.pull_request_id != 0);
+  RAY_CHECK(it->second->pull_request_id != 0);
   return !object_manager_.PullRequestActiveOrWaitingForMetadata(
-      it->second.pull_request_id);
+      it->second->pull_request_id);
 }
 
 std::string DependencyManager::DebugString() const {
   std::stringstream result;
   result << "TaskDependencyManager:";
   result << "\n- task deps map size: " << queued_task_requests_.size();
+  result << "\n- ready tasks batch size: " << ready_tasks_.size();
   result << "\n- get req map size: " << get_requests_.size();
   result << "\n- wait req map size: " << wait_requests_.size();
   result << "\n- local objects map size: " << local_objects_.size();
@@ -138,12 +138,23 @@ class DependencyManager : public TaskDependencyManagerInterface {
 
   /// Handle an object becoming locally available.
   ///
+  /// The tasks that become ready are also added to the batch returned by
+  /// TakeReadyTasks, so that the caller can dispatch the tasks made ready by
+  /// many objects at once.
+  ///
   /// \param object_id The object ID of the object to mark as locally
   /// available.
   /// \return A list of task IDs. This contains all added tasks that now have
   /// all of their dependencies fulfilled.
   std::vector<TaskID> HandleObjectLocal(const ray::ObjectID &object_id);
 
+  /// Take the batch of tasks that became ready since the last call, in the
+  /// order they became ready. Tasks that are missing an object again, or whose
+  /// dependencies were removed, are left out.
+  ///
+  /// \return The IDs of the tasks that are ready to run.
+  std::vector<TaskID> TakeReadyTasks();
+
   /// Handle an object that is no longer locally available.
   ///
   /// \param object_id The object ID of the object that was previously locally
@@ -165,12 +176,15 @@ class DependencyManager : public TaskDependencyManagerInterface {
  private:
   /// Metadata for an object that is needed by at least one executing worker
   /// and/or one queued task.
+  struct TaskDependencies;
   struct ObjectDependencies {
     ObjectDependencies(const rpc::ObjectReference &ref)
         : owner_address(ref.owner_address()) {}
     /// The tasks that depend on this object, either because the object is a task argument
-    /// or because the task called `ray.get` on the object.
-    std::unordered_set<TaskID> dependent_tasks;
+    /// or because the task called `ray.get` on the object. Each task points to its
+    /// entry in queued_task_requests_, so that the tasks waiting on an object are
+    /// updated without looking them up.
+    absl::flat_hash_map<TaskID, TaskDependencies *> dependent_tasks;
     /// The workers that depend on this object because they called `ray.get` on the
     /// object.
     std::unordered_set<WorkerID> dependent_get_requests;
@@ -204,6 +218,8 @@ class DependencyManager : public TaskDependencyManagerInterface {
     /// Used to identify the pull request for the dependencies to the object
     /// manager.
     uint64_t pull_request_id = 0;
+    /// Whether the task is in ready_tasks_, waiting to be taken by TakeReadyTasks.
+    bool in_ready_tasks = false;
   };
 
   /// Stop tracking this object, if it is no longer needed by any worker or
@@ -219,8 +235,13 @@ class DependencyManager : public TaskDependencyManagerInterface {
   ObjectManagerInterface &object_manager_;
 
   /// A map from the ID of a queued task to metadata about whether the task's
-  /// dependencies are all local or not.
-  absl::flat_hash_map<TaskID, TaskDependencies> queued_task_requests_;
+  /// dependencies are all local or not. The entries are pointed to by the
+  /// objects the task depends on, so they are allocated separately.
+  absl::flat_hash_map<TaskID, std::unique_ptr<TaskDependencies>> queued_task_requests_;
+
+  /// The tasks that became ready since the last call to TakeReadyTasks. Tasks
+  /// whose entry doesn't have in_ready_tasks set any more are skipped.
+  std::vector<TaskID> ready_tasks_;
 
   /// A map from worker ID to the set of objects that the worker called
   /// `ray.get` on and a pull request ID for these objects. The pull request ID
@@ -241,7 +262,7 @@ class DependencyManager : public TaskDependencyManagerInterface {
 
   /// The set of locally available objects. This is used to determine which
   /// tasks are ready to run and which `ray.wait` requests can be finished.
-  std::unordered_set<ray::ObjectID> local_objects_;
+  absl::flat_hash_set<ray::ObjectID> local_objects_;
 
   friend class DependencyManagerTest;
 };
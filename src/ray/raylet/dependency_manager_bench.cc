@@ -0,0 +1,149 @@
+// Copyright 2023 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the DependencyManager on graphs of queued tasks and their arguments, with
+// a fake object manager. Each graph has the given number of dependency edges, from
+// one task to one argument, in one of three shapes:
+//
+//   wide    Tasks with many arguments each, no argument is shared.
+//   shared  Tasks with one argument each, shared by many tasks.
+//   mesh    Tasks with many arguments each, each argument shared by many tasks.
+//
+// For each shape, the benchmark times requesting the dependencies of all tasks,
+// making all arguments local in batches of objects that arrive in the same event
+// loop iteration, and removing the dependencies of the ready tasks.
+//
+// Usage: dependency_manager_bench [num_edges] [objects_per_batch]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ray/common/common_protocol.h"
+#include "ray/raylet/dependency_manager.h"
+
+namespace ray {
+namespace raylet {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+class FakeObjectManager : public ObjectManagerInterface {
+ public:
+  uint64_t Pull(const std::vector<rpc::ObjectReference> &object_refs,
+                BundlePriority prio) override {
+    return next_request_id_++;
+  }
+
+  void CancelPull(uint64_t request_id) override {}
+
+  bool PullRequestActiveOrWaitingForMetadata(uint64_t request_id) const override {
+    return true;
+  }
+
+ private:
+  uint64_t next_request_id_ = 1;
+};
+
+double SecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/// Run one graph of num_tasks tasks with args_per_task arguments each, out of
+/// num_objects objects. Task i depends on objects i * args_per_task + j, modulo
+/// num_objects.
+void RunGraph(const std::string &shape,
+              int64_t num_tasks,
+              int64_t args_per_task,
+              int64_t num_objects,
+              int64_t objects_per_batch) {
+  FakeObjectManager object_manager;
+  DependencyManager dependency_manager(object_manager);
+  const auto job_id = JobID::FromInt(1);
+  std::vector<ObjectID> objects;
+  objects.reserve(num_objects);
+  for (int64_t i = 0; i < num_objects; i++) {
+    objects.push_back(ObjectID::FromRandom());
+  }
+  std::vector<TaskID> tasks;
+  tasks.reserve(num_tasks);
+  for (int64_t i = 0; i < num_tasks; i++) {
+    tasks.push_back(TaskID::FromRandom(job_id));
+  }
+
+  auto start = Clock::now();
+  std::vector<rpc::ObjectReference> args;
+  for (int64_t i = 0; i < num_tasks; i++) {
+    args.clear();
+    for (int64_t j = 0; j < args_per_task; j++) {
+      args.push_back(
+          ObjectIdToRef(objects[(i * args_per_task + j) % num_objects], rpc::Address()));
+    }
+    RAY_CHECK(!dependency_manager.RequestTaskDependencies(tasks[i], args));
+  }
+  double request_s = SecondsSince(start);
+
+  start = Clock::now();
+  int64_t num_ready = 0;
+  int64_t num_batches = 0;
+  for (int64_t i = 0; i < num_objects; i++) {
+    dependency_manager.HandleObjectLocal(objects[i]);
+    if ((i + 1) % objects_per_batch == 0 || i + 1 == num_objects) {
+      num_ready += dependency_manager.TakeReadyTasks().size();
+      num_batches++;
+    }
+  }
+  double local_s = SecondsSince(start);
+  RAY_CHECK(num_ready == num_tasks) << num_ready << " of " << num_tasks << " ready";
+
+  start = Clock::now();
+  for (const auto &task_id : tasks) {
+    dependency_manager.RemoveTaskDependencies(task_id);
+  }
+  double remove_s = SecondsSince(start);
+
+  int64_t num_edges = num_tasks * args_per_task;
+  std::cout << shape << ": " << num_tasks << " tasks, " << num_objects << " objects, "
+            << num_edges << " edges, " << num_batches << " batches" << std::endl;
+  std::cout << "  request: " << request_s << " s ("
+            << static_cast<int64_t>(num_edges / request_s) << " edges/s)" << std::endl;
+  std::cout << "  local:   " << local_s << " s ("
+            << static_cast<int64_t>(num_edges / local_s) << " edges/s)" << std::endl;
+  std::cout << "  remove:  " << remove_s << " s ("
+            << static_cast<int64_t>(num_edges / remove_s) << " edges/s)" << std::endl;
+}
+
+}  // namespace
+}  // namespace raylet
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  int64_t num_edges = argc > 1 ? std::atoll(argv[1]) : 1000000;
+  int64_t objects_per_batch = argc > 2 ? std::atoll(argv[2]) : 100;
+  if (num_edges <= 0 || objects_per_batch <= 0) {
+    std::cerr << "Usage: dependency_manager_bench [num_edges] [objects_per_batch]"
+              << std::endl;
+    return 1;
+  }
+  int64_t side = std::max<int64_t>(1, std::sqrt(static_cast<double>(num_edges)));
+  ray::raylet::RunGraph("wide", num_edges / side, side, num_edges, objects_per_batch);
+  ray::raylet::RunGraph("shared", num_edges, 1, side, objects_per_batch);
+  ray::raylet::RunGraph(
+      "mesh", num_edges / side, side, num_edges / side, objects_per_batch);
+  return 0;
+}
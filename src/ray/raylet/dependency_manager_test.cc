@@ -345,6 +345,46 @@ TEST_F(DependencyManagerTest, TestDuplicateTaskArgs) {
   AssertNoLeaks();
 }
 
+/// Test that the tasks made ready by several objects are taken in one batch, without
+/// the tasks that are no longer ready.
+TEST_F(DependencyManagerTest, TestTakeReadyTasks) {
+  ObjectID obj1 = ObjectID::FromRandom();
+  ObjectID obj2 = ObjectID::FromRandom();
+  ObjectID obj3 = ObjectID::FromRandom();
+  TaskID task1 = RandomTaskId();
+  TaskID task2 = RandomTaskId();
+  TaskID task3 = RandomTaskId();
+  TaskID task4 = RandomTaskId();
+  ASSERT_FALSE(
+      dependency_manager_.RequestTaskDependencies(task1, ObjectIdsToRefs({obj1})));
+  ASSERT_FALSE(
+      dependency_manager_.RequestTaskDependencies(task2, ObjectIdsToRefs({obj1, obj2})));
+  ASSERT_FALSE(
+      dependency_manager_.RequestTaskDependencies(task3, ObjectIdsToRefs({obj2})));
+  ASSERT_FALSE(
+      dependency_manager_.RequestTaskDependencies(task4, ObjectIdsToRefs({obj3})));
+  ASSERT_TRUE(dependency_manager_.TakeReadyTasks().empty());
+
+  ASSERT_EQ(dependency_manager_.HandleObjectLocal(obj1).size(), 1);
+  ASSERT_EQ(dependency_manager_.HandleObjectLocal(obj2).size(), 2);
+  ASSERT_EQ(dependency_manager_.HandleObjectLocal(obj3).size(), 1);
+  // Task 2 is missing an object again, task 3 is canceled.
+  ASSERT_EQ(dependency_manager_.HandleObjectMissing(obj1).size(), 2);
+  dependency_manager_.RemoveTaskDependencies(task3);
+  ASSERT_EQ(dependency_manager_.TakeReadyTasks(), std::vector<TaskID>({task4}));
+
+  // Task 1 becomes ready again, the tasks that were taken are not taken twice.
+  ASSERT_EQ(dependency_manager_.HandleObjectLocal(obj1).size(), 2);
+  ASSERT_THAT(dependency_manager_.TakeReadyTasks(),
+              ::testing::UnorderedElementsAre(task1, task2));
+  ASSERT_TRUE(dependency_manager_.TakeReadyTasks().empty());
+
+  dependency_manager_.RemoveTaskDependencies(task1);
+  dependency_manager_.RemoveTaskDependencies(task2);
+  dependency_manager_.RemoveTaskDependencies(task4);
+  AssertNoLeaks();
+}
+
 }  // namespace raylet
 
 }  // namespace ray
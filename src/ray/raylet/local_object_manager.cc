@@ -14,7 +14,21 @@
 
 #include "ray/raylet/local_object_manager.h"
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
 #include "ray/common/asio/instrumented_io_context.h"
+#include "ray/object_manager/spill_file_index.h"
+#include "ray/object_manager/spilled_object_reader.h"
 #include "ray/stats/metric_defs.h"
 #include "ray/util/util.h"
 
@@ -22,6 +36,12 @@ namespace ray {
 
 namespace raylet {
 
+namespace {
+// Keep in sync with DEFAULT_OBJECT_PREFIX in ray_constants.py.
+const char kSpilledObjectsDirName[] = "ray_spilled_objects";
+const char kSpillLockFileSuffix[] = ".lock";
+}  // namespace
+
 void LocalObjectManager::PinObjectsAndWaitForFree(
     const std::vector<ObjectID> &object_ids,
     std::vector<std::unique_ptr<RayObject>> &&objects,
@@ -42,7 +62,9 @@ void LocalObjectManager::PinObjectsAndWaitForFree(
       // This is the first time we're pinning this object.
       RAY_LOG(DEBUG) << "Pinning object " << object_id;
       pinned_objects_size_ += object->GetSize();
+      pinned_bytes_total_ += object->GetSize();
       pinned_objects_.emplace(object_id, std::move(object));
+      pinned_objects_order_.push_back(object_id);
     } else {
       auto original_worker_id =
           WorkerID::FromBinary(inserted.first->second.owner_address.worker_id());
@@ -58,50 +80,56 @@ void LocalObjectManager::PinObjectsAndWaitForFree(
       continue;
     }
 
-    // Create a object eviction subscription message.
-    auto wait_request = std::make_unique<rpc::WorkerObjectEvictionSubMessage>();
-    wait_request->set_object_id(object_id.Binary());
-    wait_request->set_intended_worker_id(owner_address.worker_id());
-    if (!generator_id.IsNil()) {
-      wait_request->set_generator_id(generator_id.Binary());
-    }
-    rpc::Address subscriber_address;
-    subscriber_address.set_raylet_id(self_node_id_.Binary());
-    subscriber_address.set_ip_address(self_node_address_);
-    subscriber_address.set_port(self_node_port_);
-    wait_request->mutable_subscriber_address()->CopyFrom(subscriber_address);
-
-    // If the subscription succeeds, register the subscription callback.
-    // Callback is invoked when the owner publishes the object to evict.
-    auto subscription_callback = [this, owner_address](const rpc::PubMessage &msg) {
-      RAY_CHECK(msg.has_worker_object_eviction_message());
-      const auto object_eviction_msg = msg.worker_object_eviction_message();
-      const auto object_id = ObjectID::FromBinary(object_eviction_msg.object_id());
-      ReleaseFreedObject(object_id);
-      core_worker_subscriber_->Unsubscribe(
-          rpc::ChannelType::WORKER_OBJECT_EVICTION, owner_address, object_id.Binary());
-    };
-
-    // Callback that is invoked when the owner of the object id is dead.
-    auto owner_dead_callback = [this, owner_address](const std::string &object_id_binary,
-                                                     const Status &) {
-      const auto object_id = ObjectID::FromBinary(object_id_binary);
-      ReleaseFreedObject(object_id);
-    };
-
-    auto sub_message = std::make_unique<rpc::SubMessage>();
-    sub_message->mutable_worker_object_eviction_message()->Swap(wait_request.get());
-
-    RAY_CHECK(core_worker_subscriber_->Subscribe(std::move(sub_message),
-                                                 rpc::ChannelType::WORKER_OBJECT_EVICTION,
-                                                 owner_address,
-                                                 object_id.Binary(),
-                                                 /*subscribe_done_callback=*/nullptr,
-                                                 subscription_callback,
-                                                 owner_dead_callback));
+    SubscribeToObjectEviction(object_id, owner_address, generator_id);
   }
 }
 
+void LocalObjectManager::SubscribeToObjectEviction(const ObjectID &object_id,
+                                                   const rpc::Address &owner_address,
+                                                   const ObjectID &generator_id) {
+  // Create a object eviction subscription message.
+  auto wait_request = std::make_unique<rpc::WorkerObjectEvictionSubMessage>();
+  wait_request->set_object_id(object_id.Binary());
+  wait_request->set_intended_worker_id(owner_address.worker_id());
+  if (!generator_id.IsNil()) {
+    wait_request->set_generator_id(generator_id.Binary());
+  }
+  rpc::Address subscriber_address;
+  subscriber_address.set_raylet_id(self_node_id_.Binary());
+  subscriber_address.set_ip_address(self_node_address_);
+  subscriber_address.set_port(self_node_port_);
+  wait_request->mutable_subscriber_address()->CopyFrom(subscriber_address);
+
+  // If the subscription succeeds, register the subscription callback.
+  // Callback is invoked when the owner publishes the object to evict.
+  auto subscription_callback = [this, owner_address](const rpc::PubMessage &msg) {
+    RAY_CHECK(msg.has_worker_object_eviction_message());
+    const auto object_eviction_msg = msg.worker_object_eviction_message();
+    const auto object_id = ObjectID::FromBinary(object_eviction_msg.object_id());
+    ReleaseFreedObject(object_id);
+    core_worker_subscriber_->Unsubscribe(
+        rpc::ChannelType::WORKER_OBJECT_EVICTION, owner_address, object_id.Binary());
+  };
+
+  // Callback that is invoked when the owner of the object id is dead.
+  auto owner_dead_callback = [this, owner_address](const std::string &object_id_binary,
+                                                   const Status &) {
+    const auto object_id = ObjectID::FromBinary(object_id_binary);
+    ReleaseFreedObject(object_id);
+  };
+
+  auto sub_message = std::make_unique<rpc::SubMessage>();
+  sub_message->mutable_worker_object_eviction_message()->Swap(wait_request.get());
+
+  RAY_CHECK(core_worker_subscriber_->Subscribe(std::move(sub_message),
+                                               rpc::ChannelType::WORKER_OBJECT_EVICTION,
+                                               owner_address,
+                                               object_id.Binary(),
+                                               /*subscribe_done_callback=*/nullptr,
+                                               subscription_callback,
+                                               owner_dead_callback));
+}
+
 void LocalObjectManager::ReleaseFreedObject(const ObjectID &object_id) {
   // Only free the object if it is not already freed.
   auto it = local_objects_.find(object_id);
@@ -123,6 +151,7 @@ void LocalObjectManager::ReleaseFreedObject(const ObjectID &object_id) {
     pinned_objects_size_ -= pinned_objects_[object_id]->GetSize();
     pinned_objects_.erase(object_id);
     local_objects_.erase(it);
+    TrimPinnedObjectsOrder();
   } else {
     // If the object is being spilled or is already spilled, then we will clean
     // up the local_objects_ entry once the spilled copy has been
@@ -150,6 +179,162 @@ void LocalObjectManager::FlushFreeObjects() {
   last_free_objects_at_ms_ = current_time_ms();
 }
 
+int64_t LocalObjectManager::RecoverSpilledObjects(
+    const std::vector<std::string> &spill_directories) {
+  if (!is_external_storage_type_fs_) {
+    return 0;
+  }
+#ifdef _WIN32
+  RAY_LOG(INFO) << "Recovery of spilled objects is not supported on Windows.";
+  return 0;
+#else
+  const std::string self_prefix = self_node_id_.Hex() + "-";
+  int64_t num_recovered = 0;
+  for (const auto &spill_directory : spill_directories) {
+    const auto directory =
+        std::filesystem::path(spill_directory) / kSpilledObjectsDirName;
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+      RAY_LOG(WARNING) << "Failed to create spill directory " << directory << ": "
+                       << ec.message();
+      continue;
+    }
+
+    // Take our own lock before looking at other locks, so that two raylets
+    // starting at the same time never consider each other dead.
+    const auto self_lock_path = directory / (self_node_id_.Hex() + kSpillLockFileSuffix);
+    int self_lock_fd = open(self_lock_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (self_lock_fd < 0 || flock(self_lock_fd, LOCK_EX | LOCK_NB) != 0) {
+      RAY_LOG(WARNING) << "Failed to lock " << self_lock_path << ", spill files in "
+                       << directory << " won't be recovered: " << strerror(errno);
+      if (self_lock_fd >= 0) {
+        close(self_lock_fd);
+      }
+      continue;
+    }
+    spill_directory_lock_fds_.push_back(self_lock_fd);
+
+    // List the directory up front since it's modified while recovering.
+    std::vector<std::string> file_names;
+    for (const auto &entry : std::filesystem::directory_iterator(directory, ec)) {
+      file_names.push_back(entry.path().filename().string());
+    }
+    for (const auto &lock_file_name : file_names) {
+      const size_t suffix_size = sizeof(kSpillLockFileSuffix) - 1;
+      if (lock_file_name.size() <= suffix_size ||
+          lock_file_name.compare(lock_file_name.size() - suffix_size,
+                                 suffix_size,
+                                 kSpillLockFileSuffix) != 0) {
+        continue;
+      }
+      const std::string node_id_hex =
+          lock_file_name.substr(0, lock_file_name.size() - suffix_size);
+      if (node_id_hex == self_node_id_.Hex()) {
+        continue;
+      }
+      const auto lock_path = directory / lock_file_name;
+      int lock_fd = open(lock_path.c_str(), O_RDWR | O_CLOEXEC);
+      if (lock_fd < 0) {
+        // Claimed by another raylet in the meantime.
+        continue;
+      }
+      if (flock(lock_fd, LOCK_EX | LOCK_NB) != 0) {
+        // The raylet is alive.
+        close(lock_fd);
+        continue;
+      }
+
+      RAY_LOG(INFO) << "Recovering spill files of dead node " << node_id_hex << " in "
+                    << directory;
+      const std::string dead_prefix = node_id_hex + "-";
+      for (const auto &file_name : file_names) {
+        if (file_name.compare(0, dead_prefix.size(), dead_prefix) != 0) {
+          continue;
+        }
+        // Claim the file. Only one raylet can succeed.
+        const auto file_path =
+            directory / (self_prefix + file_name.substr(dead_prefix.size()));
+        if (std::rename((directory / file_name).c_str(), file_path.c_str()) != 0) {
+          continue;
+        }
+        num_recovered += RecoverSpillFile(file_path.string());
+      }
+      unlink(lock_path.c_str());
+      close(lock_fd);
+    }
+  }
+  if (num_recovered > 0) {
+    RAY_LOG(INFO) << "Recovered " << num_recovered
+                  << " spilled objects left behind by dead nodes.";
+  }
+  return num_recovered;
+#endif
+}
+
+int64_t LocalObjectManager::RecoverSpillFile(const std::string &file_path) {
+  std::vector<SpillFileIndexEntry> entries;
+  std::ifstream is(file_path, std::ios::binary);
+  if (!is || !SpillFileIndex::ReadIndex(is, entries)) {
+    // The file was only partially written, or it is in the legacy format
+    // without an index. No object in it can be located, so drop it.
+    RAY_LOG(WARNING) << "Deleting spill file without a valid index " << file_path;
+    is.close();
+    std::remove(file_path.c_str());
+    return 0;
+  }
+
+  int64_t num_recovered = 0;
+  for (const auto &entry : entries) {
+    uint64_t data_offset = 0;
+    uint64_t data_size = 0;
+    uint64_t metadata_offset = 0;
+    uint64_t metadata_size = 0;
+    rpc::Address owner_address;
+    if (!SpilledObjectReader::ParseObjectHeader(is,
+                                                entry.offset,
+                                                data_offset,
+                                                data_size,
+                                                metadata_offset,
+                                                metadata_size,
+                                                owner_address)) {
+      RAY_LOG(WARNING) << "Failed to parse the header of spilled object "
+                       << entry.object_id << " in " << file_path;
+      is.clear();
+      continue;
+    }
+    if (local_objects_.contains(entry.object_id)) {
+      continue;
+    }
+    // Record checksums are verified once the object is restored, reading
+    // every record here would make startup proportional to the spilled bytes.
+    const std::string object_url = file_path + "?offset=" +
+                                   std::to_string(entry.offset) +
+                                   "&size=" + std::to_string(entry.size);
+    RAY_LOG(DEBUG) << "Recovered spilled object " << entry.object_id << " at "
+                   << object_url;
+    // The generator id isn't persisted, so the owner of a dynamically created
+    // object has to know about it already for the new location to be used.
+    local_objects_.emplace(entry.object_id,
+                           LocalObjectInfo(owner_address, ObjectID::Nil()));
+    spilled_objects_url_.emplace(entry.object_id, object_url);
+    url_ref_count_[file_path] += 1;
+    SubscribeToObjectEviction(entry.object_id, owner_address, ObjectID::Nil());
+    object_directory_->ReportObjectSpilled(entry.object_id,
+                                           self_node_id_,
+                                           owner_address,
+                                           object_url,
+                                           ObjectID::Nil(),
+                                           is_external_storage_type_fs_);
+    num_recovered++;
+  }
+  if (num_recovered == 0) {
+    is.close();
+    std::remove(file_path.c_str());
+  }
+  return num_recovered;
+}
+
 void LocalObjectManager::SpillObjectUptoMaxThroughput() {
   if (RayConfig::instance().object_spilling_config().empty()) {
     return;
@@ -168,25 +353,124 @@ void LocalObjectManager::SpillObjectUptoMaxThroughput() {
   }
 }
 
+void LocalObjectManager::CompactPinnedObjectsOrder() {
+  absl::flat_hash_set<ObjectID> seen;
+  std::deque<ObjectID> order;
+  for (const auto &object_id : pinned_objects_order_) {
+    if (pinned_objects_.contains(object_id) && seen.insert(object_id).second) {
+      order.push_back(object_id);
+    }
+  }
+  pinned_objects_order_.swap(order);
+}
+
+void LocalObjectManager::TrimPinnedObjectsOrder() {
+  while (!pinned_objects_order_.empty() &&
+         !pinned_objects_.contains(pinned_objects_order_.front())) {
+    pinned_objects_order_.pop_front();
+  }
+  if (pinned_objects_order_.size() > 2 * pinned_objects_.size() + 1024) {
+    CompactPinnedObjectsOrder();
+  }
+}
+
+void LocalObjectManager::UpdatePinRate() {
+  const int64_t now = absl::GetCurrentTimeNanos();
+  if (pin_rate_last_update_ns_ > 0 && now > pin_rate_last_update_ns_) {
+    const double rate = (pinned_bytes_total_ - pin_rate_last_bytes_) /
+                        ((now - pin_rate_last_update_ns_) / 1e9);
+    // Exponential moving average, so a single burst doesn't dominate.
+    pin_rate_bytes_per_s_ = 0.5 * pin_rate_bytes_per_s_ + 0.5 * rate;
+  }
+  pin_rate_last_bytes_ = pinned_bytes_total_;
+  pin_rate_last_update_ns_ = now;
+}
+
+int64_t LocalObjectManager::SpillObjectsToMaintainHeadroom(int64_t capacity,
+                                                           bool under_memory_pressure) {
+  UpdatePinRate();
+  if (RayConfig::instance().object_spilling_config().empty() || capacity <= 0) {
+    return 0;
+  }
+  // Secondary copies are evicted on demand, so only the primary copies take space
+  // away from the objects about to be created.
+  const int64_t used_bytes = GetPrimaryBytes();
+  const auto &config = RayConfig::instance();
+  int64_t headroom = std::max(
+      static_cast<int64_t>(capacity * config.proactive_spilling_headroom_fraction()),
+      static_cast<int64_t>(pin_rate_bytes_per_s_ *
+                           config.proactive_spilling_lookahead_ms() / 1000));
+  if (under_memory_pressure) {
+    headroom *= 2;
+  }
+  headroom = std::min(headroom, capacity);
+  // Bytes being spilled are about to become evictable.
+  int64_t deficit = headroom - (capacity - used_bytes) -
+                    static_cast<int64_t>(num_bytes_pending_spill_);
+  int64_t bytes_spilled = 0;
+  while (deficit > 0) {
+    {
+      absl::MutexLock lock(&mutex_);
+      if (num_active_workers_ >= max_active_workers_) {
+        // Spill bandwidth is saturated. Producers are throttled by the
+        // create-time spilling if the store fills up.
+        proactive_spilling_saturated_total_++;
+        break;
+      }
+    }
+    const auto bytes_pending_spill = static_cast<int64_t>(num_bytes_pending_spill_);
+    if (!SpillObjectsOfSize(min_spilling_size_,
+                            std::max(deficit, min_spilling_size_))) {
+      break;
+    }
+    const int64_t bytes =
+        static_cast<int64_t>(num_bytes_pending_spill_) - bytes_pending_spill;
+    if (bytes <= 0) {
+      break;
+    }
+    bytes_spilled += bytes;
+    deficit -= bytes;
+  }
+  if (bytes_spilled > 0) {
+    RAY_LOG(DEBUG) << "Proactively spilling " << bytes_spilled << " bytes to keep "
+                   << headroom << " bytes of headroom, primary " << used_bytes << "/"
+                   << capacity << ", pin rate " << pin_rate_bytes_per_s_ << " B/s";
+    proactively_spilled_bytes_total_ += bytes_spilled;
+  }
+  return bytes_spilled;
+}
+
 bool LocalObjectManager::IsSpillingInProgress() {
   absl::MutexLock lock(&mutex_);
   return num_active_workers_ > 0;
 }
 
-bool LocalObjectManager::SpillObjectsOfSize(int64_t num_bytes_to_spill) {
+bool LocalObjectManager::SpillObjectsOfSize(int64_t num_bytes_to_spill,
+                                            int64_t max_bytes_to_spill) {
   if (RayConfig::instance().object_spilling_config().empty()) {
     return false;
   }
 
   RAY_LOG(DEBUG) << "Choosing objects to spill of total size " << num_bytes_to_spill;
+  // The objects moved to pending spill by the previous call are at the cold end,
+  // they would otherwise be scanned on every call.
+  TrimPinnedObjectsOrder();
+
   int64_t bytes_to_spill = 0;
-  auto it = pinned_objects_.begin();
+  auto it = pinned_objects_order_.begin();
   std::vector<ObjectID> objects_to_spill;
+  absl::flat_hash_set<ObjectID> chosen;
   int64_t counts = 0;
-  while (it != pinned_objects_.end() && counts < max_fused_object_count_) {
-    if (is_plasma_object_spillable_(it->first)) {
-      bytes_to_spill += it->second->GetSize();
-      objects_to_spill.push_back(it->first);
+  while (it != pinned_objects_order_.end() && counts < max_fused_object_count_ &&
+         bytes_to_spill < max_bytes_to_spill) {
+    const auto pinned_it = pinned_objects_.find(*it);
+    if (pinned_it == pinned_objects_.end() || !chosen.insert(*it).second) {
+      it++;
+      continue;
+    }
+    if (is_plasma_object_spillable_(*it)) {
+      bytes_to_spill += pinned_it->second->GetSize();
+      objects_to_spill.push_back(*it);
     }
     it++;
     counts += 1;
@@ -195,7 +479,7 @@ bool LocalObjectManager::SpillObjectsOfSize(int64_t num_bytes_to_spill) {
     return false;
   }
 
-  if (it == pinned_objects_.end() && bytes_to_spill < num_bytes_to_spill &&
+  if (it == pinned_objects_order_.end() && bytes_to_spill < num_bytes_to_spill &&
       !objects_pending_spill_.empty()) {
     // We have gone through all spillable objects but we have not yet reached
     // the minimum bytes to spill and we are already spilling other objects.
@@ -355,6 +639,8 @@ void LocalObjectManager::SpillObjectsInternal(
                 pinned_objects_size_ += it->second->GetSize();
                 num_bytes_pending_spill_ -= it->second->GetSize();
                 pinned_objects_.emplace(object_id, std::move(it->second));
+                // The object is still the coldest one.
+                pinned_objects_order_.push_front(object_id);
                 objects_pending_spill_.erase(it);
               }
 
@@ -543,6 +829,7 @@ void LocalObjectManager::ProcessSpilledObjectsDeleteQueue(uint32_t max_batch_siz
       // If the object was not spilled, it gets pinned again. Unpin here to
       // prevent a memory leak.
       pinned_objects_.erase(object_id);
+      TrimPinnedObjectsOrder();
     }
     local_objects_.erase(object_id);
     spilled_object_pending_delete_.pop();
@@ -638,6 +925,11 @@ std::string LocalObjectManager::DebugString() const {
   result << "- num objects pending restore: " << objects_pending_restore_.size() << "\n";
   result << "- num objects pending spill: " << objects_pending_spill_.size() << "\n";
   result << "- num bytes pending spill: " << num_bytes_pending_spill_ << "\n";
+  result << "- pin rate (bytes/s): " << pin_rate_bytes_per_s_ << "\n";
+  result << "- cumulative proactively spilled bytes: "
+         << proactively_spilled_bytes_total_ << "\n";
+  result << "- proactive spilling saturated: " << proactive_spilling_saturated_total_
+         << "\n";
   result << "- cumulative spill requests: " << spilled_objects_total_ << "\n";
   result << "- cumulative restore requests: " << restored_objects_total_ << "\n";
   result << "- spilled objects pending delete: " << spilled_object_pending_delete_.size()
@@ -16,7 +16,9 @@
 
 #include <google/protobuf/repeated_field.h>
 
+#include <deque>
 #include <functional>
+#include <limits>
 
 #include "ray/common/id.h"
 #include "ray/common/ray_object.h"
@@ -97,6 +99,23 @@ class LocalObjectManager {
   /// \return True if spilling is in progress.
   void SpillObjectUptoMaxThroughput();
 
+  /// Spill the coldest primary copies ahead of demand, so that the object store
+  /// keeps enough free space for the objects expected to be created soon and
+  /// producers don't block on spilling. The headroom is the larger of
+  /// proactive_spilling_headroom_fraction of the capacity and the bytes pinned
+  /// over the last proactive_spilling_lookahead_ms at the current rate, and it
+  /// is doubled under system memory pressure. Spilling stops once all spill
+  /// workers are busy, in which case producers fall back to the regular
+  /// create-time spilling and are throttled by it.
+  ///
+  /// The free space is computed from the primary copies, since secondary copies
+  /// are evicted when space is needed.
+  ///
+  /// \param capacity The capacity of the object store.
+  /// \param under_memory_pressure Whether the system memory usage is high.
+  /// \return The number of bytes for which spilling started.
+  int64_t SpillObjectsToMaintainHeadroom(int64_t capacity, bool under_memory_pressure);
+
   /// Spill objects to external storage.
   ///
   /// \param objects_ids_to_spill The objects to be spilled.
@@ -123,6 +142,22 @@ class LocalObjectManager {
   /// objects.
   void FlushFreeObjects();
 
+  /// Adopt the spill files left behind by dead raylets on this host, e.g. the
+  /// previous incarnation of this raylet. The objects in these files are
+  /// registered as spilled on this node and the new URLs are reported to their
+  /// owners, so the objects can be restored instead of reconstructed.
+  ///
+  /// Every raylet holds an exclusive lock on a lock file named after its node
+  /// id in each spill directory for as long as it's alive. Spill files are
+  /// prefixed with the node id of the raylet that wrote them, so the files of a
+  /// raylet whose lock can be acquired are orphaned. Files are claimed by
+  /// renaming them, which makes concurrent recovery by several raylets safe.
+  /// This is a no-op unless objects are spilled to the local filesystem.
+  ///
+  /// \param spill_directories The directories configured in the spilling config.
+  /// \return The number of recovered objects.
+  int64_t RecoverSpilledObjects(const std::vector<std::string> &spill_directories);
+
   /// Judge if objects are deletable from pending_delete_queue and delete them if
   /// necessary.
   /// TODO(sang): We currently only use 1 IO worker per each call to this method because
@@ -177,11 +212,14 @@ class LocalObjectManager {
     const std::optional<ObjectID> generator_id;
   };
 
+  FRIEND_TEST(LocalObjectManagerTest, TestPin);
   FRIEND_TEST(LocalObjectManagerTest, TestSpillObjectsOfSizeZero);
   FRIEND_TEST(LocalObjectManagerTest, TestSpillUptoMaxFuseCount);
   FRIEND_TEST(LocalObjectManagerTest,
               TestSpillObjectsOfSizeNumBytesToSpillHigherThanMinBytesToSpill);
   FRIEND_TEST(LocalObjectManagerTest, TestSpillObjectNotEvictable);
+  FRIEND_TEST(LocalObjectManagerTest, TestRecoverSpilledObjects);
+  FRIEND_TEST(LocalObjectManagerTest, TestSpillObjectsToMaintainHeadroom);
 
   /// Asynchronously spill objects when space is needed. The callback tries to
   /// spill at least num_bytes_to_spill and returns true if we found objects to
@@ -191,17 +229,45 @@ class LocalObjectManager {
   /// currently spilling objects time to finish.
   /// NOTE(sang): If 0 is given, this method spills a single object.
   ///
+  /// Objects are chosen in the order they were pinned, oldest first.
+  ///
   /// \param num_bytes_to_spill The total number of bytes to spill.
+  /// \param max_bytes_to_spill Stop adding objects once this many bytes are chosen.
   /// \return True if it can spill num_bytes_to_spill. False otherwise.
-  bool SpillObjectsOfSize(int64_t num_bytes_to_spill);
+  bool SpillObjectsOfSize(
+      int64_t num_bytes_to_spill,
+      int64_t max_bytes_to_spill = std::numeric_limits<int64_t>::max());
+
+  /// Drop the entries of pinned_objects_order_ that are no longer pinned.
+  void CompactPinnedObjectsOrder();
+
+  /// Drop the entries of unpinned objects at the cold end of pinned_objects_order_,
+  /// and compact it once most of its entries are stale. Called whenever an object is
+  /// unpinned, so the order doesn't grow on nodes that never spill.
+  void TrimPinnedObjectsOrder();
+
+  /// Update the moving average of the rate at which primary copies are pinned.
+  void UpdatePinRate();
 
   /// Internal helper method for spilling objects.
   void SpillObjectsInternal(const std::vector<ObjectID> &objects_ids,
                             std::function<void(const ray::Status &)> callback);
 
+  /// Subscribe to the owner of a local object to be notified once the object
+  /// should be freed.
+  void SubscribeToObjectEviction(const ObjectID &object_id,
+                                 const rpc::Address &owner_address,
+                                 const ObjectID &generator_id);
+
   /// Release an object that has been freed by its owner.
   void ReleaseFreedObject(const ObjectID &object_id);
 
+  /// Register all objects of a spill file claimed from a dead raylet.
+  ///
+  /// \param file_path Path of the claimed file.
+  /// \return The number of recovered objects.
+  int64_t RecoverSpillFile(const std::string &file_path);
+
   /// Do operations that are needed after spilling objects such as
   /// 1. Unpin the pending spilling object.
   /// 2. Update the spilled URL to the owner.
@@ -250,6 +316,14 @@ class LocalObjectManager {
   // Total size of objects pinned on this node.
   size_t pinned_objects_size_ = 0;
 
+  /// Objects in pinned_objects_ in the order they were pinned, coldest first.
+  /// Entries of objects that were unpinned since are removed lazily, and an
+  /// object may appear twice if it was pinned again after a failed spill.
+  std::deque<ObjectID> pinned_objects_order_;
+
+  /// Total bytes ever pinned on this node, used to estimate the pin rate.
+  int64_t pinned_bytes_total_ = 0;
+
   // Objects that were pinned on this node but that are being spilled.
   // These objects will be released once spilling is complete and the URL is
   // written to the object directory.
@@ -331,6 +405,10 @@ class LocalObjectManager {
   /// The object directory interface to access object information.
   IObjectDirectory *object_directory_;
 
+  /// File descriptors of the lock files held in the spill directories, which
+  /// mark the spill files of this node as owned by a live raylet.
+  std::vector<int> spill_directory_lock_fds_;
+
   ///
   /// Stats
   ///
@@ -362,6 +440,19 @@ class LocalObjectManager {
   /// The last time a spill log finished.
   int64_t last_spill_log_ns_ = 0;
 
+  /// The moving average of the bytes pinned per second.
+  double pin_rate_bytes_per_s_ = 0;
+
+  /// pinned_bytes_total_ and the time at the last pin rate update.
+  int64_t pin_rate_last_bytes_ = 0;
+  int64_t pin_rate_last_update_ns_ = 0;
+
+  /// The total number of bytes spilled proactively.
+  int64_t proactively_spilled_bytes_total_ = 0;
+
+  /// The number of times proactive spilling was short of spill workers.
+  int64_t proactive_spilling_saturated_total_ = 0;
+
   /// The last time a restore log finished.
   int64_t last_restore_log_ns_ = 0;
 
@@ -35,6 +35,8 @@ LocalTaskManager::LocalTaskManager(
     std::function<bool(const std::vector<ObjectID> &object_ids,
                        std::vector<std::unique_ptr<RayObject>> *results)>
         get_task_arguments,
+    std::function<void(const std::shared_ptr<WorkerInterface> &, const std::string &)>
+        preempt_worker,
     size_t max_pinned_task_arguments_bytes,
     std::function<int64_t(void)> get_time_ms,
     int64_t sched_cls_cap_interval_ms)
@@ -48,6 +50,8 @@ LocalTaskManager::LocalTaskManager(
       worker_pool_(worker_pool),
       leased_workers_(leased_workers),
       get_task_arguments_(get_task_arguments),
+      preempt_worker_(preempt_worker),
+      preemption_enabled_(RayConfig::instance().scheduler_preemption_enabled()),
       max_pinned_task_arguments_bytes_(max_pinned_task_arguments_bytes),
       get_time_ms_(get_time_ms),
       sched_cls_cap_enabled_(RayConfig::instance().worker_cap_enabled()),
@@ -102,9 +106,32 @@ void LocalTaskManager::DispatchScheduledTasksToWorkers() {
   // blocking where a task which cannot be dispatched because
   // there are not enough available resources blocks other
   // tasks from being dispatched.
-  for (auto shapes_it = tasks_to_dispatch_.begin();
-       shapes_it != tasks_to_dispatch_.end();) {
-    auto &scheduling_class = shapes_it->first;
+  //
+  // The scheduling classes are visited in descending order of priority. Tasks
+  // of different priorities never share a scheduling class, so the priority of
+  // a class is the priority of any of its tasks.
+  std::vector<std::pair<int32_t, SchedulingClass>> sched_cls_by_priority;
+  sched_cls_by_priority.reserve(tasks_to_dispatch_.size());
+  for (const auto &entry : tasks_to_dispatch_) {
+    int32_t priority =
+        entry.second.empty()
+            ? 0
+            : entry.second.front()->task.GetTaskSpecification().GetPriority();
+    sched_cls_by_priority.emplace_back(priority, entry.first);
+  }
+  std::stable_sort(sched_cls_by_priority.begin(),
+                   sched_cls_by_priority.end(),
+                   [](const std::pair<int32_t, SchedulingClass> &left,
+                      const std::pair<int32_t, SchedulingClass> &right) {
+                     return left.first > right.first;
+                   });
+
+  for (const auto &entry : sched_cls_by_priority) {
+    const SchedulingClass scheduling_class = entry.second;
+    auto shapes_it = tasks_to_dispatch_.find(scheduling_class);
+    if (shapes_it == tasks_to_dispatch_.end()) {
+      continue;
+    }
     auto &dispatch_queue = shapes_it->second;
 
     if (info_by_sched_cls_.find(scheduling_class) == info_by_sched_cls_.end()) {
@@ -203,17 +230,23 @@ void LocalTaskManager::DispatchScheduledTasksToWorkers() {
           task_dependency_manager_.RemoveTaskDependencies(task_id);
         }
         ReleaseTaskArgs(task_id);
+        ReleaseReservedResources(work);
         work_it = dispatch_queue.erase(work_it);
         continue;
       }
 
       // Check if the node is still schedulable. It may not be if dependency resolution
-      // took a long time.
-      auto allocated_instances = std::make_shared<TaskResourceInstances>();
-      bool schedulable =
-          cluster_resource_scheduler_->GetLocalResourceManager()
-              .AllocateLocalTaskResources(spec.GetRequiredResources().GetResourceMap(),
-                                          allocated_instances);
+      // took a long time. The tasks of a gang were queued with their resources
+      // already reserved.
+      auto allocated_instances = work->allocated_instances;
+      bool schedulable = allocated_instances != nullptr;
+      if (!schedulable) {
+        allocated_instances = std::make_shared<TaskResourceInstances>();
+        schedulable =
+            cluster_resource_scheduler_->GetLocalResourceManager()
+                .AllocateLocalTaskResources(spec.GetRequiredResources().GetResourceMap(),
+                                            allocated_instances);
+      }
 
       if (!schedulable) {
         ReleaseTaskArgs(task_id);
@@ -224,6 +257,13 @@ void LocalTaskManager::DispatchScheduledTasksToWorkers() {
           // There must not be any other available nodes in the cluster, so the task
           // should stay on this node. We can skip the rest of the shape because the
           // scheduler will make the same decision.
+          if (preemption_enabled_ && !is_infeasible) {
+            PreemptWorkersForTask(spec);
+          }
+          if (work->GetUnscheduledCause() !=
+              internal::UnscheduledWorkCause::WAITING_FOR_RESOURCES_AVAILABLE) {
+            ray::stats::STATS_scheduler_admission_decisions.Record(1, "Deferred");
+          }
           work->SetStateWaiting(
               internal::UnscheduledWorkCause::WAITING_FOR_RESOURCES_AVAILABLE);
           break;
@@ -235,40 +275,7 @@ void LocalTaskManager::DispatchScheduledTasksToWorkers() {
         }
         work_it = dispatch_queue.erase(work_it);
       } else {
-        // Force us to recalculate the next update time the next time a task
-        // comes through this queue. We should only do this when we're
-        // confident we're ready to dispatch the task after all checks have
-        // passed.
-        sched_cls_info.next_update_time = std::numeric_limits<int64_t>::max();
-        sched_cls_info.running_tasks.insert(spec.TaskId());
-        // The local node has the available resources to run the task, so we should run
-        // it.
-        std::string allocated_instances_serialized_json = "{}";
-        if (RayConfig::instance().worker_resource_limits_enabled()) {
-          allocated_instances_serialized_json = allocated_instances->SerializeAsJson();
-        }
-        work->allocated_instances = allocated_instances;
-        work->SetStateWaitingForWorker();
-        bool is_detached_actor = spec.IsDetachedActor();
-        auto &owner_address = spec.CallerAddress();
-        /// TODO(scv119): if a worker is not started, the resources is leaked and
-        // task might be hanging.
-        worker_pool_.PopWorker(
-            spec,
-            [this, task_id, scheduling_class, work, is_detached_actor, owner_address](
-                const std::shared_ptr<WorkerInterface> worker,
-                PopWorkerStatus status,
-                const std::string &runtime_env_setup_error_message) -> bool {
-              return PoppedWorkerHandler(worker,
-                                         status,
-                                         task_id,
-                                         scheduling_class,
-                                         work,
-                                         is_detached_actor,
-                                         owner_address,
-                                         runtime_env_setup_error_message);
-            },
-            allocated_instances_serialized_json);
+        PopWorkerForTask(work, allocated_instances, sched_cls_info);
         work_it++;
       }
     }
@@ -283,13 +290,258 @@ void LocalTaskManager::DispatchScheduledTasksToWorkers() {
     if (is_infeasible) {
       // TODO(scv119): fail the request.
       // Call CancelTask
-      tasks_to_dispatch_.erase(shapes_it++);
+      tasks_to_dispatch_.erase(shapes_it);
     } else if (dispatch_queue.empty()) {
+      tasks_to_dispatch_.erase(shapes_it);
+    }
+  }
+}
+
+void LocalTaskManager::PopWorkerForTask(
+    const std::shared_ptr<internal::Work> &work,
+    std::shared_ptr<TaskResourceInstances> allocated_instances,
+    SchedulingClassInfo &sched_cls_info) {
+  const auto &spec = work->task.GetTaskSpecification();
+  const TaskID task_id = spec.TaskId();
+  const SchedulingClass scheduling_class = spec.GetSchedulingClass();
+  // Force us to recalculate the next update time the next time a task
+  // comes through this queue. We should only do this when we're
+  // confident we're ready to dispatch the task after all checks have
+  // passed.
+  sched_cls_info.next_update_time = std::numeric_limits<int64_t>::max();
+  sched_cls_info.running_tasks.insert(task_id);
+  ray::stats::STATS_scheduler_admission_decisions.Record(1, "Admitted");
+  // The local node has the available resources to run the task, so we should run
+  // it.
+  std::string allocated_instances_serialized_json = "{}";
+  if (RayConfig::instance().worker_resource_limits_enabled()) {
+    allocated_instances_serialized_json = allocated_instances->SerializeAsJson();
+  }
+  work->allocated_instances = allocated_instances;
+  work->SetStateWaitingForWorker();
+  bool is_detached_actor = spec.IsDetachedActor();
+  auto &owner_address = spec.CallerAddress();
+  /// TODO(scv119): if a worker is not started, the resources is leaked and
+  // task might be hanging.
+  worker_pool_.PopWorker(
+      spec,
+      [this, task_id, scheduling_class, work, is_detached_actor, owner_address](
+          const std::shared_ptr<WorkerInterface> worker,
+          PopWorkerStatus status,
+          const std::string &runtime_env_setup_error_message) -> bool {
+        return PoppedWorkerHandler(worker,
+                                   status,
+                                   task_id,
+                                   scheduling_class,
+                                   work,
+                                   is_detached_actor,
+                                   owner_address,
+                                   runtime_env_setup_error_message);
+      },
+      allocated_instances_serialized_json);
+}
+
+bool LocalTaskManager::TryDispatchToIdleWorker(std::shared_ptr<internal::Work> work) {
+  const auto &spec = work->task.GetTaskSpecification();
+  const SchedulingClass scheduling_class = spec.GetSchedulingClass();
+  // Tasks with arguments need them to be local and pinned first, which the dispatch
+  // loop takes care of.
+  if (!spec.GetDependencies().empty() || tasks_to_dispatch_.contains(scheduling_class) ||
+      !worker_pool_.HasIdleWorker(spec)) {
+    return false;
+  }
+  auto sched_cls_it = info_by_sched_cls_.find(scheduling_class);
+  if (sched_cls_cap_enabled_ && sched_cls_it != info_by_sched_cls_.end() &&
+      sched_cls_it->second.running_tasks.size() >= sched_cls_it->second.capacity) {
+    return false;
+  }
+  auto allocated_instances = std::make_shared<TaskResourceInstances>();
+  if (!cluster_resource_scheduler_->GetLocalResourceManager().AllocateLocalTaskResources(
+          spec.GetRequiredResources().GetResourceMap(), allocated_instances)) {
+    return false;
+  }
+  RAY_LOG(DEBUG) << "Granting task " << spec.TaskId() << " to an idle worker";
+  if (sched_cls_it == info_by_sched_cls_.end()) {
+    sched_cls_it =
+        info_by_sched_cls_
+            .emplace(scheduling_class,
+                     SchedulingClassInfo(
+                         MaxRunningTasksPerSchedulingClass(scheduling_class)))
+            .first;
+  }
+  // The popped worker handler removes the task from the dispatch queue.
+  tasks_to_dispatch_[scheduling_class].push_back(work);
+  PopWorkerForTask(work, allocated_instances, sched_cls_it->second);
+  return true;
+}
+
+bool LocalTaskManager::PreemptWorkersForTask(const TaskSpecification &spec) {
+  // Wait until the workers preempted earlier have returned their resources,
+  // they may already be enough to run this task.
+  for (auto it = preempted_workers_.begin(); it != preempted_workers_.end();) {
+    auto worker_it = leased_workers_.find(*it);
+    if (worker_it == leased_workers_.end() ||
+        worker_it->second->GetAllocatedInstances() == nullptr) {
+      preempted_workers_.erase(it++);
+    } else {
+      it++;
+    }
+  }
+  if (!preempted_workers_.empty()) {
+    return false;
+  }
+
+  const int32_t priority = spec.GetPriority();
+  std::vector<std::shared_ptr<WorkerInterface>> candidates;
+  for (const auto &entry : leased_workers_) {
+    const auto &worker = entry.second;
+    const auto &worker_spec = worker->GetAssignedTask().GetTaskSpecification();
+    // Actors hold their resources for their whole lifetime, and blocked workers
+    // have already given their CPUs back, so neither of them is preempted.
+    if (worker_spec.IsActorCreationTask() || worker->IsBlocked() ||
+        worker->GetAllocatedInstances() == nullptr ||
+        worker_spec.GetPriority() >= priority) {
+      continue;
+    }
+    // Preempting a task that has no retries left would fail it.
+    if (worker_spec.MaxRetries() != -1 &&
+        worker_spec.AttemptNumber() >= static_cast<uint64_t>(worker_spec.MaxRetries())) {
+      continue;
+    }
+    candidates.push_back(worker);
+  }
+  if (candidates.empty()) {
+    return false;
+  }
+  // Preempt the lowest priority first, and the most recently started tasks
+  // among those, since they lose the least work.
+  std::sort(candidates.begin(),
+            candidates.end(),
+            [](const std::shared_ptr<WorkerInterface> &left,
+               const std::shared_ptr<WorkerInterface> &right) {
+              auto left_priority =
+                  left->GetAssignedTask().GetTaskSpecification().GetPriority();
+              auto right_priority =
+                  right->GetAssignedTask().GetTaskSpecification().GetPriority();
+              if (left_priority != right_priority) {
+                return left_priority < right_priority;
+              }
+              return left->GetAssignedTaskTime() > right->GetAssignedTaskTime();
+            });
+
+  const auto resource_request = ResourceMapToResourceRequest(
+      spec.GetRequiredResources().GetResourceMap(),
+      /*requires_object_store_memory=*/false);
+  auto local_node_id = cluster_resource_scheduler_->GetLocalResourceManager().GetNodeId();
+  NodeResources node_resources =
+      cluster_resource_scheduler_->GetClusterResourceManager().GetNodeResources(
+          local_node_id);
+  std::vector<std::shared_ptr<WorkerInterface>> to_preempt;
+  for (const auto &worker : candidates) {
+    if (node_resources.IsAvailable(resource_request, /*ignore_at_capacity=*/true)) {
+      break;
+    }
+    node_resources.available += worker->GetAllocatedInstances()->ToResourceRequest();
+    to_preempt.push_back(worker);
+  }
+  if (to_preempt.empty() ||
+      !node_resources.IsAvailable(resource_request, /*ignore_at_capacity=*/true)) {
+    // Preempting every lower priority task still wouldn't make room.
+    return false;
+  }
+
+  for (const auto &worker : to_preempt) {
+    std::stringstream message;
+    message << "The worker running task "
+            << worker->GetAssignedTask().GetTaskSpecification().TaskId()
+            << " was preempted to run the higher priority task " << spec.TaskId()
+            << " (priority " << priority << ").";
+    RAY_LOG(INFO) << message.str();
+    preempted_workers_.insert(worker->WorkerId());
+    num_workers_preempted_++;
+    ray::stats::STATS_scheduler_admission_decisions.Record(1, "Preempted");
+    preempt_worker_(worker, message.str());
+  }
+  return true;
+}
+
+size_t LocalTaskManager::StealTasks(
+    const NodeID &thief_node_id,
+    const absl::flat_hash_map<std::string, double> &available_resources,
+    size_t max_tasks) {
+  if (thief_node_id == self_node_id_ || get_node_info_(thief_node_id) == nullptr) {
+    return 0;
+  }
+  auto available = ResourceMapToResourceRequest(available_resources,
+                                                /*requires_object_store_memory=*/false);
+  size_t num_stolen = 0;
+  for (auto shapes_it = tasks_to_dispatch_.begin();
+       shapes_it != tasks_to_dispatch_.end() && num_stolen < max_tasks;) {
+    auto &dispatch_queue = shapes_it->second;
+    // Steal from the back of the queue, these tasks would be dispatched last here.
+    auto work_it = dispatch_queue.end();
+    while (work_it != dispatch_queue.begin() && num_stolen < max_tasks) {
+      work_it--;
+      const auto &work = *work_it;
+      const auto &spec = work->task.GetTaskSpecification();
+      const auto strategy_case = spec.GetSchedulingStrategy().scheduling_strategy_case();
+      // Only the tasks that wait for local resources are stolen. Tasks that must
+      // be granted or rejected here, or that are tied to some nodes by their
+      // scheduling strategy, stay.
+      if (work->GetState() != internal::WorkStatus::WAITING ||
+          work->GetUnscheduledCause() !=
+              internal::UnscheduledWorkCause::WAITING_FOR_RESOURCES_AVAILABLE ||
+          work->grant_or_reject ||
+          (strategy_case != rpc::SchedulingStrategy::SchedulingStrategyCase::
+                                kDefaultSchedulingStrategy &&
+           strategy_case != rpc::SchedulingStrategy::SchedulingStrategyCase::
+                                SCHEDULING_STRATEGY_NOT_SET)) {
+        continue;
+      }
+      auto resource_request =
+          ResourceMapToResourceRequest(spec.GetRequiredResources().GetResourceMap(),
+                                       /*requires_object_store_memory=*/false);
+      if (!(resource_request <= available)) {
+        continue;
+      }
+      available -= resource_request;
+      RAY_LOG(DEBUG) << "Task " << spec.TaskId() << " is stolen by node "
+                     << thief_node_id;
+      Spillback(thief_node_id, work);
+      if (!spec.GetDependencies().empty()) {
+        task_dependency_manager_.RemoveTaskDependencies(spec.TaskId());
+      }
+      work_it = dispatch_queue.erase(work_it);
+      num_stolen++;
+    }
+    if (dispatch_queue.empty()) {
       tasks_to_dispatch_.erase(shapes_it++);
     } else {
       shapes_it++;
     }
   }
+  num_task_stolen_ += num_stolen;
+  return num_stolen;
+}
+
+absl::flat_hash_map<WorkerDemandKey, int64_t> LocalTaskManager::GetWorkerDemand() const {
+  absl::flat_hash_map<WorkerDemandKey, int64_t> demand;
+  auto count = [&demand](const std::shared_ptr<internal::Work> &work) {
+    const auto &spec = work->task.GetTaskSpecification();
+    if (spec.IsActorCreationTask() && !spec.DynamicWorkerOptions().empty()) {
+      return;
+    }
+    demand[{spec.GetLanguage(), spec.GetRuntimeEnvHash(), spec.JobId()}]++;
+  };
+  for (const auto &shapes_it : tasks_to_dispatch_) {
+    for (const auto &work : shapes_it.second) {
+      count(work);
+    }
+  }
+  for (const auto &work : waiting_task_queue_) {
+    count(work);
+  }
+  return demand;
 }
 
 void LocalTaskManager::SpillWaitingTasks() {
@@ -310,6 +562,10 @@ void LocalTaskManager::SpillWaitingTasks() {
     it--;
     const auto &task = (*it)->task;
     const auto &task_id = task.GetTaskSpecification().TaskId();
+    // The tasks of a gang hold their resources here, keep them with the gang.
+    if ((*it)->allocated_instances != nullptr) {
+      continue;
+    }
 
     // Check whether this task's dependencies are blocked (not being actively
     // pulled).  If this is true, then we should force the task onto a remote
@@ -532,6 +788,7 @@ bool LocalTaskManager::PoppedWorkerHandler(
 
 void LocalTaskManager::Spillback(const NodeID &spillback_to,
                                  const std::shared_ptr<internal::Work> &work) {
+  ReleaseReservedResources(work);
   auto send_reply_callback = work->callback;
 
   if (work->grant_or_reject) {
@@ -565,6 +822,19 @@ void LocalTaskManager::Spillback(const NodeID &spillback_to,
   send_reply_callback();
 }
 
+void LocalTaskManager::ReleaseReservedResources(
+    const std::shared_ptr<internal::Work> &work) {
+  // Tasks waiting for a worker hold the resources allocated to pop it, which are
+  // released with the worker.
+  if (work->allocated_instances == nullptr ||
+      work->GetState() == internal::WorkStatus::WAITING_FOR_WORKER) {
+    return;
+  }
+  cluster_resource_scheduler_->GetLocalResourceManager().ReleaseWorkerResources(
+      work->allocated_instances);
+  work->allocated_instances = nullptr;
+}
+
 void LocalTaskManager::TasksUnblocked(const std::vector<TaskID> &ready_ids) {
   if (ready_ids.empty()) {
     return;
@@ -737,6 +1007,7 @@ bool LocalTaskManager::CancelTask(
       if (task.GetTaskSpecification().TaskId() == task_id) {
         RAY_LOG(DEBUG) << "Canceling task " << task_id << " from dispatch queue.";
         ReplyCancelled(*work_it, failure_type, scheduling_failure_message);
+        ReleaseReservedResources(*work_it);
         if ((*work_it)->GetState() == internal::WorkStatus::WAITING_FOR_WORKER) {
           // We've already acquired resources so we need to release them.
           cluster_resource_scheduler_->GetLocalResourceManager().ReleaseWorkerResources(
@@ -763,6 +1034,7 @@ bool LocalTaskManager::CancelTask(
   if (iter != waiting_tasks_index_.end()) {
     const auto &task = (*iter->second)->task;
     ReplyCancelled(*iter->second, failure_type, scheduling_failure_message);
+    ReleaseReservedResources(*iter->second);
     if (!task.GetTaskSpecification().GetDependencies().empty()) {
       task_dependency_manager_.RemoveTaskDependencies(
           task.GetTaskSpecification().TaskId());
@@ -1040,6 +1312,8 @@ void LocalTaskManager::DebugStr(std::stringstream &buffer) const {
   buffer << "Number of spilled waiting tasks: " << num_waiting_task_spilled_ << "\n";
   buffer << "Number of spilled unschedulable tasks: " << num_unschedulable_task_spilled_
          << "\n";
+  buffer << "Number of preempted workers: " << num_workers_preempted_ << "\n";
+  buffer << "Number of tasks stolen by other nodes: " << num_task_stolen_ << "\n";
   buffer << "Resource usage {\n";
 
   // Calculates how much resources are occupied by tasks or actors.
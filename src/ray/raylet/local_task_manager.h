@@ -25,6 +25,7 @@
 #include "ray/raylet/scheduling/internal.h"
 #include "ray/raylet/scheduling/local_task_manager_interface.h"
 #include "ray/raylet/worker.h"
+#include "ray/raylet/worker_demand_forecaster.h"
 #include "ray/raylet/worker_pool.h"
 #include "ray/rpc/grpc_client.h"
 #include "ray/rpc/node_manager/node_manager_client.h"
@@ -68,6 +69,8 @@ class LocalTaskManager : public ILocalTaskManager {
   /// \param leased_workers: A reference to the leased workers map.
   /// \param get_task_arguments: A callback for getting a tasks' arguments by
   ///                            their ids.
+  /// \param preempt_worker: A callback to kill a leased worker so that its
+  ///                        resources can be given to a higher priority task.
   /// \param max_pinned_task_arguments_bytes: The cap on pinned arguments.
   /// \param get_time_ms: A callback which returns the current time in milliseconds.
   /// \param sched_cls_cap_interval_ms: The time before we increase the cap
@@ -85,6 +88,8 @@ class LocalTaskManager : public ILocalTaskManager {
       std::function<bool(const std::vector<ObjectID> &object_ids,
                          std::vector<std::unique_ptr<RayObject>> *results)>
           get_task_arguments,
+      std::function<void(const std::shared_ptr<WorkerInterface> &, const std::string &)>
+          preempt_worker,
       size_t max_pinned_task_arguments_bytes,
       std::function<int64_t(void)> get_time_ms =
           []() { return (int64_t)(absl::GetCurrentTimeNanos() / 1e6); },
@@ -97,6 +102,10 @@ class LocalTaskManager : public ILocalTaskManager {
   // Schedule and dispatch tasks.
   void ScheduleAndDispatchTasks() override;
 
+  /// See interface. Tasks of a scheduling class that already has tasks waiting to
+  /// be dispatched are not granted, so that they don't overtake them.
+  bool TryDispatchToIdleWorker(std::shared_ptr<internal::Work> work) override;
+
   /// Move tasks from waiting to ready for dispatch. Called when a task's
   /// dependencies are resolved.
   ///
@@ -168,6 +177,24 @@ class LocalTaskManager : public ILocalTaskManager {
 
   void ClearWorkerBacklog(const WorkerID &worker_id);
 
+  /// Spill back queued tasks that are waiting for local resources to an idle
+  /// node that asked for them. Tasks are taken from the back of the dispatch
+  /// queues, and only those that may run on any node and fit in the resources
+  /// the idle node offers are given away.
+  ///
+  /// \param thief_node_id The node that asked for tasks.
+  /// \param available_resources The resources available on that node.
+  /// \param max_tasks The maximum number of tasks to give away.
+  /// \return The number of tasks given away.
+  size_t StealTasks(const NodeID &thief_node_id,
+                    const absl::flat_hash_map<std::string, double> &available_resources,
+                    size_t max_tasks);
+
+  /// Count the queued tasks that will need a worker from the worker pool, by kind
+  /// of worker. Actor creation tasks with dynamic worker options get a dedicated
+  /// worker and are not counted.
+  absl::flat_hash_map<WorkerDemandKey, int64_t> GetWorkerDemand() const;
+
   const absl::flat_hash_map<SchedulingClass, std::deque<std::shared_ptr<internal::Work>>>
       &GetTaskToDispatch() const override {
     return tasks_to_dispatch_;
@@ -203,15 +230,32 @@ class LocalTaskManager : public ILocalTaskManager {
                            const rpc::Address &owner_address,
                            const std::string &runtime_env_setup_error_message);
 
+  /// Admit a task to its scheduling class and pop a worker for it, once its
+  /// resources are allocated. The task must be in `tasks_to_dispatch_`.
+  void PopWorkerForTask(const std::shared_ptr<internal::Work> &work,
+                        std::shared_ptr<TaskResourceInstances> allocated_instances,
+                        SchedulingClassInfo &sched_cls_info);
+
   /// Attempts to dispatch all tasks which are ready to run. A task
   /// will be dispatched if it is on `tasks_to_dispatch_` and there are still
-  /// available resources on the node.
+  /// available resources on the node. Scheduling classes are visited in
+  /// descending order of priority, so higher priority tasks get the resources
+  /// first.
   ///
   /// If there are not enough resources locally, up to one task per resource
   /// shape (the task at the head of the queue) will get spilled back to a
   /// different node.
   void DispatchScheduledTasksToWorkers();
 
+  /// Kill the workers leased to lower priority tasks, if doing so frees enough
+  /// resources to run the given task on this node. The most recently started
+  /// tasks of the lowest priority are preempted first. Nothing is preempted
+  /// while earlier preemptions haven't returned their resources yet.
+  ///
+  /// \param spec The task that can't get its resources.
+  /// \return Whether any worker was preempted.
+  bool PreemptWorkersForTask(const TaskSpecification &spec);
+
   /// Helper method when the current node does not have the available resources to run a
   /// task.
   ///
@@ -254,6 +298,10 @@ class LocalTaskManager : public ILocalTaskManager {
 
   void Spillback(const NodeID &spillback_to, const std::shared_ptr<internal::Work> &work);
 
+  /// Release the resources reserved for a gang task that leaves the node before it
+  /// waits for a worker.
+  void ReleaseReservedResources(const std::shared_ptr<internal::Work> &work);
+
   /// Sum up the backlog size across all workers for a given scheduling class.
   int64_t TotalBacklogSize(SchedulingClass scheduling_class);
 
@@ -338,6 +386,9 @@ class LocalTaskManager : public ILocalTaskManager {
   absl::flat_hash_map<SchedulingClass, absl::flat_hash_map<WorkerID, int64_t>>
       backlog_tracker_;
 
+  /// Workers that were preempted and haven't returned their resources yet.
+  absl::flat_hash_set<WorkerID> preempted_workers_;
+
   /// TODO(Shanly): Remove `worker_pool_` and `leased_workers_` and make them as
   /// parameters of methods if necessary once we remove the legacy scheduler.
   WorkerPoolInterface &worker_pool_;
@@ -349,6 +400,13 @@ class LocalTaskManager : public ILocalTaskManager {
                      std::vector<std::unique_ptr<RayObject>> *results)>
       get_task_arguments_;
 
+  /// Callback to kill a leased worker to make room for a higher priority task.
+  std::function<void(const std::shared_ptr<WorkerInterface> &, const std::string &)>
+      preempt_worker_;
+
+  /// Whether lower priority tasks may be preempted.
+  const bool preemption_enabled_;
+
   /// Arguments needed by currently granted lease requests. These should be
   /// pinned before the lease is granted to ensure that the arguments are not
   /// evicted before the task(s) start running.
@@ -382,6 +440,8 @@ class LocalTaskManager : public ILocalTaskManager {
   size_t num_task_spilled_ = 0;
   size_t num_waiting_task_spilled_ = 0;
   size_t num_unschedulable_task_spilled_ = 0;
+  size_t num_task_stolen_ = 0;
+  size_t num_workers_preempted_ = 0;
 
   friend class SchedulerResourceReporter;
   friend class ClusterTaskManagerTest;
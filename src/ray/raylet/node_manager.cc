@@ -27,6 +27,7 @@
 #include "ray/common/buffer.h"
 #include "ray/common/common_protocol.h"
 #include "ray/common/constants.h"
+#include "ray/common/file_system_monitor.h"
 #include "ray/common/memory_monitor.h"
 #include "ray/common/status.h"
 #include "ray/gcs/pb_util.h"
@@ -402,6 +403,21 @@ NodeManager::NodeManager(instrumented_io_context &io_service,
              std::vector<std::unique_ptr<RayObject>> *results) {
         return GetObjectsFromPlasma(object_ids, results);
       },
+      [this](const std::shared_ptr<WorkerInterface> &worker,
+             const std::string &preemption_message) {
+        // Posted because destroying the worker dispatches tasks again, and this is
+        // called while the local task manager is dispatching.
+        io_service_.post(
+            [this, worker, preemption_message]() {
+              if (!worker->IsDead()) {
+                DestroyWorker(worker,
+                              rpc::WorkerExitType::SYSTEM_ERROR,
+                              preemption_message,
+                              /*force=*/true);
+              }
+            },
+            "NodeManager.PreemptWorker");
+      },
       max_task_args_memory);
   cluster_task_manager_ = std::make_shared<ClusterTaskManager>(
       self_node_id_,
@@ -415,6 +431,19 @@ NodeManager::NodeManager(instrumented_io_context &io_service,
   periodical_runner_.RunFnPeriodically(
       [this]() { cluster_task_manager_->ScheduleAndDispatchTasks(); },
       RayConfig::instance().worker_cap_initial_backoff_delay_ms());
+  if (RayConfig::instance().work_stealing_period_ms() > 0) {
+    periodical_runner_.RunFnPeriodically([this] { StealTasksFromPeers(); },
+                                         RayConfig::instance().work_stealing_period_ms(),
+                                         "NodeManager.deadline_timer.steal_tasks");
+  }
+  if (RayConfig::instance().worker_demand_forecast_period_ms() > 0) {
+    periodical_runner_.RunFnPeriodically(
+        [this] {
+          worker_pool_.UpdateWorkerDemand(local_task_manager_->GetWorkerDemand());
+        },
+        RayConfig::instance().worker_demand_forecast_period_ms(),
+        "NodeManager.deadline_timer.forecast_worker_demand");
+  }
 
   RAY_CHECK_OK(store_client_.Connect(config.store_socket_name.c_str()));
   // Run the node manger rpc server.
@@ -520,6 +549,15 @@ ray::Status NodeManager::RegisterGcs() {
         RayConfig::instance().free_objects_period_milliseconds(),
         "NodeManager.deadline_timer.flush_free_objects");
   }
+  if (RayConfig::instance().proactive_spilling_interval_ms() > 0) {
+    periodical_runner_.RunFnPeriodically(
+        [this] {
+          local_object_manager_.SpillObjectsToMaintainHeadroom(
+              object_manager_.GetMemoryCapacity(), system_memory_under_pressure_);
+        },
+        RayConfig::instance().proactive_spilling_interval_ms(),
+        "NodeManager.deadline_timer.proactive_spilling");
+  }
   last_resource_report_at_ms_ = now_ms;
   /// If periodic asio stats print is enabled, it will print it.
   const auto event_stats_print_interval_ms =
@@ -779,6 +817,75 @@ void NodeManager::HandleGetTasksInfo(const rpc::GetTasksInfoRequest &request,
       /*on_all_replied*/ [total, reply]() { reply->set_total(*total); });
 }
 
+void NodeManager::HandleStealTasks(const rpc::StealTasksRequest &request,
+                                   rpc::StealTasksReply *reply,
+                                   rpc::SendReplyCallback send_reply_callback) {
+  auto num_stolen = local_task_manager_->StealTasks(
+      NodeID::FromBinary(request.thief_node_id()),
+      MapFromProtobuf(request.available_resources()),
+      std::max<int64_t>(request.max_tasks(), 0));
+  reply->set_num_stolen(num_stolen);
+  send_reply_callback(Status::OK(), nullptr, nullptr);
+}
+
+void NodeManager::StealTasksFromPeers() {
+  if (steal_tasks_in_flight_ || !local_task_manager_->GetTaskToDispatch().empty()) {
+    return;
+  }
+  const auto &cluster_resource_manager =
+      cluster_resource_scheduler_->GetClusterResourceManager();
+  const auto &local_resources = cluster_resource_manager.GetNodeResources(
+      scheduling::NodeID(self_node_id_.Binary()));
+  if (local_resources.available.Get(scheduling::ResourceID::CPU()) <= 0) {
+    return;
+  }
+
+  // The load of the other nodes comes with their resource usage broadcast. Pick the
+  // node whose queued CPU demand exceeds its available CPUs the most.
+  NodeID victim_node_id = NodeID::Nil();
+  FixedPoint max_backlog = 0;
+  for (const auto &entry : cluster_resource_manager.GetResourceView()) {
+    auto node_id = NodeID::FromBinary(entry.first.Binary());
+    if (node_id == self_node_id_ || !remote_node_manager_addresses_.contains(node_id)) {
+      continue;
+    }
+    const auto &node_resources = entry.second.GetLocalView();
+    auto backlog = node_resources.load.Get(scheduling::ResourceID::CPU()) -
+                   node_resources.available.Get(scheduling::ResourceID::CPU());
+    if (backlog > max_backlog) {
+      max_backlog = backlog;
+      victim_node_id = node_id;
+    }
+  }
+  if (victim_node_id.IsNil()) {
+    return;
+  }
+
+  rpc::StealTasksRequest request;
+  request.set_thief_node_id(self_node_id_.Binary());
+  for (const auto &resource : local_resources.available.ToResourceMap()) {
+    (*request.mutable_available_resources())[resource.first] = resource.second;
+  }
+  request.set_max_tasks(RayConfig::instance().work_stealing_max_tasks());
+  const auto &address = remote_node_manager_addresses_[victim_node_id];
+  auto client = std::make_shared<rpc::NodeManagerClient>(
+      address.first, address.second, client_call_manager_);
+  steal_tasks_in_flight_ = true;
+  client->StealTasks(
+      request,
+      [this, client, victim_node_id](const Status &status,
+                                     const rpc::StealTasksReply &reply) {
+        steal_tasks_in_flight_ = false;
+        if (!status.ok()) {
+          RAY_LOG(DEBUG) << "Failed to steal tasks from node " << victim_node_id << ": "
+                         << status.ToString();
+          return;
+        }
+        RAY_LOG(DEBUG) << "Stole " << reply.num_stolen() << " tasks from node "
+                       << victim_node_id;
+      });
+}
+
 void NodeManager::HandleGetObjectsInfo(const rpc::GetObjectsInfoRequest &request,
                                        rpc::GetObjectsInfoReply *reply,
                                        rpc::SendReplyCallback send_reply_callback) {
@@ -965,6 +1072,15 @@ void NodeManager::NodeAdded(const GcsNodeInfo &node_info) {
 
   RAY_LOG(DEBUG) << "[NodeAdded] Received callback from node id " << node_id;
   if (node_id == self_node_id_) {
+    // Owners only accept spilled locations on nodes they know about, so the
+    // spill files of dead raylets are recovered once this node is published.
+    if (!spilled_objects_recovered_ &&
+        RayConfig::instance().recover_spilled_objects_on_restart() &&
+        !RayConfig::instance().object_spilling_config().empty()) {
+      spilled_objects_recovered_ = true;
+      local_object_manager_.RecoverSpilledObjects(
+          ParseSpillingPaths(RayConfig::instance().object_spilling_config()));
+    }
     return;
   }
 
@@ -1889,11 +2005,89 @@ void NodeManager::HandleRequestWorkerLease(const rpc::RequestWorkerLeaseRequest
         send_reply_callback(status, success, failure);
       };
 
-  cluster_task_manager_->QueueAndScheduleTask(task,
-                                              request.grant_or_reject(),
-                                              request.is_selected_based_on_locality(),
-                                              reply,
-                                              send_reply_callback_wrapper);
+  const int64_t num_additional_leases =
+      is_actor_creation_task ? 0 : request.max_leases() - 1;
+  if (num_additional_leases <= 0) {
+    cluster_task_manager_->QueueAndScheduleTask(task,
+                                                request.grant_or_reject(),
+                                                request.is_selected_based_on_locality(),
+                                                reply,
+                                                send_reply_callback_wrapper);
+    return;
+  }
+
+  // The request asks for more than one worker. The additional workers are leased by
+  // lease requests of their own that are only granted on this node. The reply waits
+  // for the first worker, and carries the additional workers granted by then.
+  struct AdditionalLeases {
+    /// The additional lease requests that are not done yet.
+    absl::flat_hash_set<TaskID> pending;
+    /// Whether the lease request for the first worker is done.
+    bool first_lease_done = false;
+    /// Whether the reply is sent.
+    bool replied = false;
+  };
+  auto additional_leases = std::make_shared<AdditionalLeases>();
+  cluster_task_manager_->QueueAndScheduleTask(
+      task,
+      request.grant_or_reject(),
+      request.is_selected_based_on_locality(),
+      reply,
+      [this, additional_leases, send_reply_callback_wrapper](
+          Status status, std::function<void()> success, std::function<void()> failure) {
+        additional_leases->first_lease_done = true;
+        // Reply after the additional leases that already got a worker, their workers
+        // are handed out by callbacks that are already posted.
+        io_service_.post(
+            [this,
+             additional_leases,
+             send_reply_callback_wrapper,
+             status,
+             success,
+             failure]() {
+              additional_leases->replied = true;
+              for (const auto &task_id : additional_leases->pending) {
+                cluster_task_manager_->CancelTask(task_id);
+              }
+              send_reply_callback_wrapper(status, success, failure);
+            },
+            "NodeManager.ReplyWorkerLease");
+      });
+  if (additional_leases->first_lease_done) {
+    // The request was replied right away, e.g. spilled back to another node.
+    return;
+  }
+
+  for (int64_t i = 0; i < num_additional_leases; i++) {
+    rpc::Task lease_message(task_message);
+    lease_message.mutable_task_spec()->set_task_id(
+        TaskID::FromRandom(task.GetTaskSpecification().JobId()).Binary());
+    RayTask lease_task(lease_message);
+    const TaskID task_id = lease_task.GetTaskSpecification().TaskId();
+    auto lease_reply = std::make_shared<rpc::RequestWorkerLeaseReply>();
+    additional_leases->pending.insert(task_id);
+    cluster_task_manager_->QueueAndScheduleTask(
+        lease_task,
+        /*grant_or_reject=*/true,
+        request.is_selected_based_on_locality(),
+        lease_reply.get(),
+        [additional_leases, task_id, lease_reply, reply](
+            Status, std::function<void()>, std::function<void()>) {
+          if (additional_leases->replied) {
+            // Canceled when the reply was sent.
+            return;
+          }
+          additional_leases->pending.erase(task_id);
+          if (lease_reply->canceled() || lease_reply->rejected() ||
+              lease_reply->worker_address().raylet_id().empty()) {
+            return;
+          }
+          auto *lease = reply->add_additional_leases();
+          lease->mutable_worker_address()->CopyFrom(lease_reply->worker_address());
+          lease->mutable_resource_mapping()->CopyFrom(lease_reply->resource_mapping());
+          lease->set_worker_pid(lease_reply->worker_pid());
+        });
+  }
 }
 
 void NodeManager::HandlePrepareBundleResources(
@@ -2262,7 +2456,13 @@ void NodeManager::HandleObjectLocal(const ObjectInfo &object_info) {
   RAY_LOG(DEBUG) << "Object local " << object_id << ", "
                  << " on " << self_node_id_ << ", " << ready_task_ids.size()
                  << " tasks ready";
-  local_task_manager_->TasksUnblocked(ready_task_ids);
+  if (!ready_task_ids.empty() && !unblocked_tasks_dispatch_posted_) {
+    // The other objects that became local in this iteration of the event loop
+    // are handled before the tasks are dispatched.
+    unblocked_tasks_dispatch_posted_ = true;
+    io_service_.post([this]() { DispatchUnblockedTasks(); },
+                     "NodeManager.DispatchUnblockedTasks");
+  }
 
   // Notify the wait manager that this object is local.
   wait_manager_.HandleObjectLocal(object_id);
@@ -2289,6 +2489,11 @@ void NodeManager::HandleObjectLocal(const ObjectInfo &object_info) {
   }
 }
 
+void NodeManager::DispatchUnblockedTasks() {
+  unblocked_tasks_dispatch_posted_ = false;
+  local_task_manager_->TasksUnblocked(dependency_manager_.TakeReadyTasks());
+}
+
 bool NodeManager::IsActorCreationTask(const TaskID &task_id) {
   auto actor_id = task_id.ActorId();
   if (!actor_id.IsNil() && task_id == TaskID::ForActorCreationTask(actor_id)) {
@@ -2419,10 +2624,19 @@ std::string NodeManager::WorkersDebugString(
   int64_t index = 1;
   for (auto &worker : workers) {
     auto pid = worker->GetProcess().GetId();
-    auto used_memory = memory_monitor_->GetProcessMemoryBytes(pid);
+    // Prefer the cgroup's accounting, which includes the children of the worker.
+    auto used_memory = worker_pool_.GetWorkerMemoryBytes(pid);
+    if (used_memory < 0) {
+      used_memory = memory_monitor_->GetProcessMemoryBytes(pid);
+    }
     result << "Worker " << index << ": task assigned time counter "
            << worker->GetAssignedTaskTime().time_since_epoch().count() << " memory used "
-           << used_memory << " task spec "
+           << used_memory;
+    auto cpu_usage_micros = worker_pool_.GetWorkerCpuUsageMicros(pid);
+    if (cpu_usage_micros >= 0) {
+      result << " cpu time us " << cpu_usage_micros;
+    }
+    result << " task spec "
            << worker->GetAssignedTask().GetTaskSpecification().DebugString() << "\n";
     index += 1;
     if (index > num_workers) {
@@ -2918,6 +3132,10 @@ MemoryUsageRefreshCallback NodeManager::CreateMemoryUsageRefreshCallback() {
   return [this](bool is_usage_above_threshold,
                 MemorySnapshot system_memory,
                 float usage_threshold) {
+    system_memory_under_pressure_ =
+        system_memory.total_bytes > 0 &&
+        static_cast<float>(system_memory.used_bytes) / system_memory.total_bytes >=
+            RayConfig::instance().proactive_spilling_memory_pressure_fraction();
     if (high_memory_eviction_target_ != nullptr) {
       if (!high_memory_eviction_target_->GetProcess().IsAlive()) {
         RAY_LOG(INFO) << "Worker evicted and process killed to reclaim memory. "
@@ -2935,7 +3153,13 @@ MemoryUsageRefreshCallback NodeManager::CreateMemoryUsageRefreshCallback() {
             << "worker pid: " << high_memory_eviction_target_->GetProcess().GetId()
             << "task: " << high_memory_eviction_target_->GetAssignedTaskId();
       } else {
-        auto workers = this->WorkersWithLatestSubmittedTasks();
+        // Reading the usage of the cgroups is cheap enough to pick the largest worker
+        // on every refresh.
+        const bool kill_largest =
+            !RayConfig::instance().worker_cgroup_root().empty() &&
+            RayConfig::instance().worker_cgroup_kill_largest_on_oom();
+        auto workers = kill_largest ? this->WorkersWithLargestMemoryUsage()
+                                    : this->WorkersWithLatestSubmittedTasks();
         if (!workers.empty()) {
           std::shared_ptr<WorkerInterface> latest_worker = workers.front();
           high_memory_eviction_target_ = latest_worker;
@@ -2957,7 +3181,9 @@ MemoryUsageRefreshCallback NodeManager::CreateMemoryUsageRefreshCallback() {
               << "System memory low at node with IP " << latest_worker->IpAddress()
               << ". Used memory (" << used_bytes_gb << "GB) / total capacity ("
               << total_bytes_gb << "GB) (" << usage_fraction << ") exceeds threshold "
-              << usage_threshold << ", killing latest task with name "
+              << usage_threshold << ", killing "
+              << (kill_largest ? "the task using the most memory" : "latest task")
+              << " with name "
               << latest_worker->GetAssignedTask().GetTaskSpecification().GetName()
               << " and " << id_ss.str() << " to avoid running out of memory.\n"
               << "This may indicate a memory leak in a task or actor, or that too many "
@@ -3015,6 +3241,32 @@ NodeManager::WorkersWithLatestSubmittedTasks() const {
   return workers;
 }
 
+const std::vector<std::shared_ptr<WorkerInterface>>
+NodeManager::WorkersWithLargestMemoryUsage() const {
+  // Read the usage of each worker only once.
+  std::vector<std::pair<int64_t, std::shared_ptr<WorkerInterface>>> usages;
+  for (auto &worker : worker_pool_.GetAllRegisteredWorkers()) {
+    usages.emplace_back(worker_pool_.GetWorkerMemoryBytes(worker->GetProcess().GetId()),
+                        worker);
+  }
+  std::sort(usages.begin(),
+            usages.end(),
+            [](const std::pair<int64_t, std::shared_ptr<WorkerInterface>> &left,
+               const std::pair<int64_t, std::shared_ptr<WorkerInterface>> &right) {
+              if (left.first != right.first) {
+                return left.first > right.first;
+              }
+              return left.second->GetAssignedTaskTime() >
+                     right.second->GetAssignedTaskTime();
+            });
+  std::vector<std::shared_ptr<WorkerInterface>> workers;
+  workers.reserve(usages.size());
+  for (auto &usage : usages) {
+    workers.push_back(std::move(usage.second));
+  }
+  return workers;
+}
+
 }  // namespace raylet
 
 }  // namespace ray
@@ -192,6 +192,14 @@ class NodeManager : public rpc::NodeManagerServiceHandler,
   const std::vector<std::shared_ptr<WorkerInterface>> WorkersWithLatestSubmittedTasks()
       const;
 
+  /// Returns workers sorted by the memory used by their cgroups, in descending order.
+  /// Workers that are not in a cgroup come last, and workers using the same memory
+  /// are sorted by the time of the last submitted task.
+  ///
+  /// \return the list of sorted workers
+  const std::vector<std::shared_ptr<WorkerInterface>> WorkersWithLargestMemoryUsage()
+      const;
+
   /// Returns debug string of the workers.
   ///
   /// \param workers The workers to be printed.
@@ -420,6 +428,11 @@ class NodeManager : public rpc::NodeManagerServiceHandler,
   /// \return Void.
   void HandleObjectMissing(const ObjectID &object_id);
 
+  /// Dispatch the tasks whose arguments became local since the last call. This
+  /// runs once per event loop iteration in which objects became local, so that
+  /// many objects arriving together cost one scheduling pass.
+  void DispatchUnblockedTasks();
+
   /// Handles the event that a job is started.
   ///
   /// \param job_id ID of the started job.
@@ -629,6 +642,15 @@ class NodeManager : public rpc::NodeManagerServiceHandler,
                               rpc::NotifyGCSRestartReply *reply,
                               rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Handle a `StealTasks` request.
+  void HandleStealTasks(const rpc::StealTasksRequest &request,
+                        rpc::StealTasksReply *reply,
+                        rpc::SendReplyCallback send_reply_callback) override;
+
+  /// If this node is idle, ask the node with the largest CPU backlog in the
+  /// resource view for queued tasks that this node can run instead.
+  void StealTasksFromPeers();
+
   /// Trigger local GC on each worker of this raylet.
   void DoLocalGC(bool triggered_by_global_gc = false);
 
@@ -738,6 +760,10 @@ class NodeManager : public rpc::NodeManagerServiceHandler,
   /// called `ray.get` or `ray.wait`.
   DependencyManager dependency_manager_;
 
+  /// Whether DispatchUnblockedTasks is posted to the event loop and has not
+  /// run yet.
+  bool unblocked_tasks_dispatch_posted_ = false;
+
   /// A manager for wait requests.
   WaitManager wait_manager_;
 
@@ -757,10 +783,20 @@ class NodeManager : public rpc::NodeManagerServiceHandler,
   /// copies), freed, and/or spilled.
   LocalObjectManager local_object_manager_;
 
+  /// Whether the spill files of dead raylets on this host have been recovered.
+  bool spilled_objects_recovered_ = false;
+
+  /// Whether the system memory usage reported by the memory monitor is above
+  /// proactive_spilling_memory_pressure_fraction.
+  bool system_memory_under_pressure_ = false;
+
   /// Map from node ids to addresses of the remote node managers.
   absl::flat_hash_map<NodeID, std::pair<std::string, int32_t>>
       remote_node_manager_addresses_;
 
+  /// Whether a `StealTasks` request sent by this node hasn't been replied yet.
+  bool steal_tasks_in_flight_ = false;
+
   /// Map of workers leased out to direct call clients.
   absl::flat_hash_map<WorkerID, std::shared_ptr<WorkerInterface>> leased_workers_;
 
@@ -14,13 +14,18 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <boost/range/adaptor/map.hpp>
 #include <iostream>
+#include <iterator>
 #include <sstream>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/container/inlined_vector.h"
 #include "ray/common/id.h"
 #include "ray/raylet/scheduling/fixed_point.h"
 #include "ray/raylet/scheduling/scheduling_ids.h"
@@ -30,17 +35,87 @@ namespace ray {
 
 using scheduling::ResourceID;
 
-bool IsPredefinedResource(scheduling::ResourceID resource_id);
+inline bool IsPredefinedResource(scheduling::ResourceID resource_id) {
+  return resource_id.ToInt() >= 0 && resource_id.ToInt() < PredefinedResourcesEnum_MAX;
+}
 
 /// Represents a set of resources.
 /// NOTE: negative values are valid in this set, while 0 is not. This means if any
 /// resource value is changed to 0, the resource will be removed.
+///
+/// The resources are stored densely, so that comparing two sets, which the scheduler
+/// does for every candidate node, doesn't hash: the predefined resources live in
+/// fixed slots (0 meaning absent), and the custom resources in a vector sorted by
+/// resource ID.
 /// TODO(hchen): This class should be independent with tasks. We should move out the
 /// "requires_object_store_memory_" field, and rename this class to ResourceSet.
 class ResourceRequest {
  public:
-  using ResourceIdIterator =
-      boost::select_first_range<absl::flat_hash_map<ResourceID, FixedPoint>>;
+  /// A range over the IDs of the resources in a ResourceRequest, the predefined
+  /// resources first. It is invalidated by changes to the request.
+  class ResourceIdIterator {
+   public:
+    class Iterator {
+     public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = ResourceID;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const ResourceID *;
+      using reference = const ResourceID &;
+
+      Iterator(const ResourceRequest *request, size_t index)
+          : request_(request), index_(index) {
+        SkipAbsent();
+      }
+
+      reference operator*() const {
+        if (index_ < PredefinedResourcesEnum_MAX) {
+          return PredefinedResourceIds()[index_];
+        }
+        return request_->custom_resources_[index_ - PredefinedResourcesEnum_MAX].first;
+      }
+
+      pointer operator->() const { return &**this; }
+
+      Iterator &operator++() {
+        index_++;
+        SkipAbsent();
+        return *this;
+      }
+
+      Iterator operator++(int) {
+        Iterator it = *this;
+        ++*this;
+        return it;
+      }
+
+      bool operator==(const Iterator &other) const { return index_ == other.index_; }
+      bool operator!=(const Iterator &other) const { return index_ != other.index_; }
+
+     private:
+      void SkipAbsent() {
+        while (index_ < PredefinedResourcesEnum_MAX &&
+               request_->predefined_resources_[index_] == 0) {
+          index_++;
+        }
+      }
+
+      const ResourceRequest *request_;
+      size_t index_;
+    };
+
+    explicit ResourceIdIterator(const ResourceRequest *request) : request_(request) {}
+
+    Iterator begin() const { return Iterator(request_, 0); }
+
+    Iterator end() const {
+      return Iterator(request_,
+                      PredefinedResourcesEnum_MAX + request_->custom_resources_.size());
+    }
+
+   private:
+    const ResourceRequest *request_;
+  };
 
   /// Construct an empty ResourceRequest.
   ResourceRequest() : ResourceRequest({}, false) {}
@@ -53,9 +128,7 @@ class ResourceRequest {
                   bool requires_object_store_memory)
       : requires_object_store_memory_(requires_object_store_memory) {
     for (auto entry : resource_map) {
-      if (entry.second != 0) {
-        resources_[entry.first] = entry.second;
-      }
+      Set(entry.first, entry.second);
     }
   }
 
@@ -66,8 +139,11 @@ class ResourceRequest {
   /// Get the value of a particular resource.
   /// If the resource doesn't exist, return 0.
   FixedPoint Get(ResourceID resource_id) const {
-    auto it = resources_.find(resource_id);
-    if (it == resources_.end()) {
+    if (IsPredefinedResource(resource_id)) {
+      return predefined_resources_[resource_id.ToInt()];
+    }
+    auto it = FindCustom(resource_id);
+    if (it == custom_resources_.end() || it->first != resource_id) {
       return FixedPoint(0);
     } else {
       return it->second;
@@ -77,45 +153,66 @@ class ResourceRequest {
   /// Set a resource to the given value.
   /// NOTE: if the new value is 0, the resource will be removed.
   ResourceRequest &Set(ResourceID resource_id, FixedPoint value) {
-    if (value == 0) {
-      resources_.erase(resource_id);
-    } else {
-      resources_[resource_id] = value;
+    if (IsPredefinedResource(resource_id)) {
+      predefined_resources_[resource_id.ToInt()] = value;
+      return *this;
+    }
+    auto it = FindCustom(resource_id);
+    if (it != custom_resources_.end() && it->first == resource_id) {
+      if (value == 0) {
+        custom_resources_.erase(it);
+      } else {
+        it->second = value;
+      }
+    } else if (value != 0) {
+      custom_resources_.insert(it, {resource_id, value});
     }
     return *this;
   }
 
   /// Check whether a particular resource exist.
-  bool Has(ResourceID resource_id) const { return resources_.contains(resource_id); }
+  bool Has(ResourceID resource_id) const { return Get(resource_id) != 0; }
 
   /// Clear the whole set.
-  void Clear() { resources_.clear(); }
+  void Clear() {
+    predefined_resources_.fill(FixedPoint(0));
+    custom_resources_.clear();
+  }
 
   /// Remove the negative values in this set.
   void RemoveNegative() {
-    for (auto it = resources_.begin(); it != resources_.end();) {
-      if (it->second < 0) {
-        resources_.erase(it++);
-      } else {
-        it++;
+    for (auto &value : predefined_resources_) {
+      if (value < 0) {
+        value = FixedPoint(0);
       }
     }
+    custom_resources_.erase(
+        std::remove_if(custom_resources_.begin(),
+                       custom_resources_.end(),
+                       [](const auto &entry) { return entry.second < 0; }),
+        custom_resources_.end());
   }
 
   /// Return the number of resources in this set.
-  size_t Size() const { return resources_.size(); }
+  size_t Size() const {
+    size_t size = custom_resources_.size();
+    for (const auto &value : predefined_resources_) {
+      size += value != 0;
+    }
+    return size;
+  }
 
   /// Return true if this set is empty.
-  bool IsEmpty() const { return resources_.empty(); }
+  bool IsEmpty() const { return Size() == 0; }
 
-  /// Return a boost::range object that can be used as an iterator of the resource IDs.
-  ResourceIdIterator ResourceIds() const { return boost::adaptors::keys(resources_); }
+  /// Return a range object that can be used as an iterator of the resource IDs.
+  ResourceIdIterator ResourceIds() const { return ResourceIdIterator(this); }
 
   /// Return a map from the resource ids to the values.
   absl::flat_hash_map<ResourceID, FixedPoint> ToMap() const {
     absl::flat_hash_map<ResourceID, FixedPoint> res;
-    for (auto entry : resources_) {
-      res.emplace(entry.first, entry.second);
+    for (auto &resource_id : ResourceIds()) {
+      res.emplace(resource_id, Get(resource_id));
     }
     return res;
   }
@@ -123,8 +220,8 @@ class ResourceRequest {
   /// Return a map from resource names (string) to values (double).
   absl::flat_hash_map<std::string, double> ToResourceMap() const {
     absl::flat_hash_map<std::string, double> resource_map;
-    for (auto entry : resources_) {
-      resource_map.emplace(entry.first.Binary(), entry.second.Double());
+    for (auto &resource_id : ResourceIds()) {
+      resource_map.emplace(resource_id.Binary(), Get(resource_id).Double());
     }
     return resource_map;
   }
@@ -142,37 +239,28 @@ class ResourceRequest {
   }
 
   ResourceRequest &operator+=(const ResourceRequest &other) {
-    for (auto &entry : other.resources_) {
-      auto it = resources_.find(entry.first);
-      if (it != resources_.end()) {
-        it->second += entry.second;
-        if (it->second == 0) {
-          resources_.erase(it);
-        }
-      } else {
-        resources_.emplace(entry.first, entry.second);
-      }
+    for (size_t i = 0; i < PredefinedResourcesEnum_MAX; i++) {
+      predefined_resources_[i] += other.predefined_resources_[i];
+    }
+    for (auto &entry : other.custom_resources_) {
+      Set(entry.first, Get(entry.first) + entry.second);
     }
     return *this;
   }
 
   ResourceRequest &operator-=(const ResourceRequest &other) {
-    for (auto &entry : other.resources_) {
-      auto it = resources_.find(entry.first);
-      if (it != resources_.end()) {
-        it->second -= entry.second;
-        if (it->second == 0) {
-          resources_.erase(it);
-        }
-      } else {
-        resources_.emplace(entry.first, -entry.second);
-      }
+    for (size_t i = 0; i < PredefinedResourcesEnum_MAX; i++) {
+      predefined_resources_[i] -= other.predefined_resources_[i];
+    }
+    for (auto &entry : other.custom_resources_) {
+      Set(entry.first, Get(entry.first) - entry.second);
     }
     return *this;
   }
 
   bool operator==(const ResourceRequest &other) const {
-    return this->resources_ == other.resources_;
+    return predefined_resources_ == other.predefined_resources_ &&
+           custom_resources_ == other.custom_resources_;
   }
 
   bool operator!=(const ResourceRequest &other) const { return !(*this == other); }
@@ -181,24 +269,35 @@ class ResourceRequest {
   /// If A <= B, it means for each resource, its value in A is less than or equqal to that
   /// in B.
   bool operator<=(const ResourceRequest &other) const {
-    // Check all resources that exist in this.
-    for (auto &entry : resources_) {
-      auto &this_value = entry.second;
-      auto other_value = FixedPoint(0);
-      auto it = other.resources_.find(entry.first);
-      if (it != other.resources_.end()) {
-        other_value = it->second;
-      }
-      if (this_value > other_value) {
-        return false;
-      }
+    // Compare all the predefined slots without branching, absent resources are 0.
+    bool is_subset = true;
+    for (size_t i = 0; i < PredefinedResourcesEnum_MAX; i++) {
+      is_subset &= predefined_resources_[i] <= other.predefined_resources_[i];
+    }
+    if (!is_subset) {
+      return false;
     }
-    // Check all resources that exist in other, but not in this.
-    for (auto &entry : other.resources_) {
-      if (!resources_.contains(entry.first)) {
-        if (entry.second < 0) {
+    // Merge the sorted custom resources, a resource missing on one side is 0.
+    auto it = custom_resources_.begin();
+    auto other_it = other.custom_resources_.begin();
+    while (it != custom_resources_.end() || other_it != other.custom_resources_.end()) {
+      if (other_it == other.custom_resources_.end() ||
+          (it != custom_resources_.end() && it->first < other_it->first)) {
+        if (it->second > 0) {
+          return false;
+        }
+        it++;
+      } else if (it == custom_resources_.end() || other_it->first < it->first) {
+        if (other_it->second < 0) {
+          return false;
+        }
+        other_it++;
+      } else {
+        if (it->second > other_it->second) {
           return false;
         }
+        it++;
+        other_it++;
       }
     }
     return true;
@@ -226,8 +325,39 @@ class ResourceRequest {
   }
 
  private:
-  /// Map from the resource IDs to the resource values.
-  absl::flat_hash_map<ResourceID, FixedPoint> resources_;
+  using CustomResources = absl::InlinedVector<std::pair<ResourceID, FixedPoint>, 2>;
+
+  /// The IDs of the predefined resources, indexed by their values.
+  static const std::array<ResourceID, PredefinedResourcesEnum_MAX>
+      &PredefinedResourceIds() {
+    static const std::array<ResourceID, PredefinedResourcesEnum_MAX> ids = {
+        ResourceID(CPU), ResourceID(MEM), ResourceID(GPU), ResourceID(OBJECT_STORE_MEM)};
+    return ids;
+  }
+
+  /// Return the position of the resource in custom_resources_, or where it should be
+  /// inserted.
+  CustomResources::const_iterator FindCustom(ResourceID resource_id) const {
+    return std::lower_bound(
+        custom_resources_.begin(),
+        custom_resources_.end(),
+        resource_id,
+        [](const auto &entry, const ResourceID &id) { return entry.first < id; });
+  }
+
+  CustomResources::iterator FindCustom(ResourceID resource_id) {
+    return std::lower_bound(
+        custom_resources_.begin(),
+        custom_resources_.end(),
+        resource_id,
+        [](const auto &entry, const ResourceID &id) { return entry.first < id; });
+  }
+
+  /// The values of the predefined resources, indexed by PredefinedResourcesEnum.
+  /// A value of 0 means the resource is absent.
+  std::array<FixedPoint, PredefinedResourcesEnum_MAX> predefined_resources_{};
+  /// The custom resources with non-zero values, sorted by resource ID.
+  CustomResources custom_resources_;
   /// Whether this task requires object store memory.
   /// TODO(swang): This should be a quantity instead of a flag.
   bool requires_object_store_memory_ = false;
@@ -253,7 +383,7 @@ class TaskResourceInstances {
       std::vector<FixedPoint> instances;
       auto value = request.Get(resource_id);
       if (resource_id.IsUnitInstanceResource()) {
-        size_t num_instances = static_cast<size_t>(value.Double());
+        size_t num_instances = static_cast<size_t>(value.Truncate());
         for (size_t i = 0; i < num_instances; i++) {
           instances.push_back(1.0);
         };
@@ -45,6 +45,8 @@ void ClusterResourceManager::AddOrUpdateNode(scheduling::NodeID node_id,
     // This node exists, so update its resources.
     it->second = Node(node_resources);
   }
+  node_resource_index_.AddOrUpdateNode(node_id, node_resources);
+  resource_view_version_++;
 }
 
 bool ClusterResourceManager::UpdateNode(scheduling::NodeID node_id,
@@ -65,6 +67,12 @@ bool ClusterResourceManager::UpdateNode(scheduling::NodeID node_id,
     local_view.available = node_resources.available;
     local_view.object_pulls_queued = resource_data.object_pulls_queued();
   }
+  if (resource_data.resource_load_changed()) {
+    // Used by idle nodes to find loaded nodes to steal queued tasks from.
+    local_view.load =
+        ResourceMapToResourceRequest(MapFromProtobuf(resource_data.resource_load()),
+                                     /*requires_object_store_memory=*/false);
+  }
 
   AddOrUpdateNode(node_id, local_view);
   return true;
@@ -77,6 +85,8 @@ bool ClusterResourceManager::RemoveNode(scheduling::NodeID node_id) {
     return false;
   } else {
     nodes_.erase(it);
+    node_resource_index_.RemoveNode(node_id);
+    resource_view_version_++;
     return true;
   }
 }
@@ -100,6 +110,10 @@ const NodeResources &ClusterResourceManager::GetNodeResources(
 
 int64_t ClusterResourceManager::NumNodes() const { return nodes_.size(); }
 
+uint64_t ClusterResourceManager::GetResourceViewVersion() const {
+  return resource_view_version_;
+}
+
 void ClusterResourceManager::UpdateResourceCapacity(scheduling::NodeID node_id,
                                                     scheduling::ResourceID resource_id,
                                                     double resource_total) {
@@ -124,6 +138,8 @@ void ClusterResourceManager::UpdateResourceCapacity(scheduling::NodeID node_id,
   }
   local_view->total.Set(resource_id, total);
   local_view->available.Set(resource_id, available);
+  node_resource_index_.AddOrUpdateNode(node_id, *local_view);
+  resource_view_version_++;
 }
 
 bool ClusterResourceManager::DeleteResources(
@@ -138,6 +154,8 @@ bool ClusterResourceManager::DeleteResources(
     local_view->total.Set(resource_id, 0);
     local_view->available.Set(resource_id, 0);
   }
+  node_resource_index_.AddOrUpdateNode(node_id, *local_view);
+  resource_view_version_++;
   return true;
 }
 
@@ -167,6 +185,8 @@ bool ClusterResourceManager::SubtractNodeAvailableResources(
 
   resources->available -= resource_request;
   resources->available.RemoveNegative();
+  node_resource_index_.AddOrUpdateNode(node_id, *resources);
+  resource_view_version_++;
 
   // TODO(swang): We should also subtract object store memory if the task has
   // arguments. Right now we do not modify object_pulls_queued in case of
@@ -213,6 +233,8 @@ bool ClusterResourceManager::AddNodeAvailableResources(
       node_resources->available.Set(resource_id, new_available);
     }
   }
+  node_resource_index_.AddOrUpdateNode(node_id, *node_resources);
+  resource_view_version_++;
   return true;
 }
 
@@ -237,6 +259,8 @@ bool ClusterResourceManager::UpdateNodeAvailableResourcesIfExist(
   for (auto &resource_id : node_resources->total.ResourceIds()) {
     node_resources->available.Set(resource_id, resources.Get(resource_id));
   }
+  node_resource_index_.AddOrUpdateNode(node_id, *node_resources);
+  resource_view_version_++;
   return true;
 }
 
@@ -254,6 +278,7 @@ bool ClusterResourceManager::UpdateNodeNormalTaskResources(
       auto &local_normal_task_resources = node_resources->normal_task_resources;
       if (normal_task_resources != local_normal_task_resources) {
         local_normal_task_resources = normal_task_resources;
+        resource_view_version_++;
         node_resources->latest_resources_normal_task_timestamp =
             resource_data.resources_normal_task_timestamp();
         return true;
@@ -276,4 +301,8 @@ BundleLocationIndex &ClusterResourceManager::GetBundleLocationIndex() {
   return bundle_location_index_;
 }
 
+const NodeResourceIndex &ClusterResourceManager::GetNodeResourceIndex() const {
+  return node_resource_index_;
+}
+
 }  // namespace ray
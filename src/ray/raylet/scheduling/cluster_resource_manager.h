@@ -26,6 +26,7 @@
 #include "ray/raylet/scheduling/cluster_resource_data.h"
 #include "ray/raylet/scheduling/fixed_point.h"
 #include "ray/raylet/scheduling/local_resource_manager.h"
+#include "ray/raylet/scheduling/node_resource_index.h"
 #include "ray/util/logging.h"
 #include "src/ray/protobuf/gcs.pb.h"
 
@@ -65,6 +66,11 @@ class ClusterResourceManager {
   /// Get number of nodes in the cluster.
   int64_t NumNodes() const;
 
+  /// Get the version of the resource view. It is bumped whenever a node is added,
+  /// removed or its resources change, so a scheduling decision made at a version
+  /// still holds as long as the version is the same.
+  uint64_t GetResourceViewVersion() const;
+
   /// Update total capacity of a given resource of a given node.
   ///
   /// \param node_id: Node whose resource we want to update.
@@ -127,6 +133,9 @@ class ClusterResourceManager {
 
   BundleLocationIndex &GetBundleLocationIndex();
 
+  /// Get the index used to find the candidate nodes of a request.
+  const NodeResourceIndex &GetNodeResourceIndex() const;
+
  private:
   friend class ClusterResourceScheduler;
   friend class gcs::GcsActorSchedulerTest;
@@ -152,6 +161,12 @@ class ClusterResourceManager {
 
   BundleLocationIndex bundle_location_index_;
 
+  /// Index of the nodes in `nodes_`, updated on every change of their resources.
+  NodeResourceIndex node_resource_index_;
+
+  /// Bumped on every change of `nodes_`.
+  uint64_t resource_view_version_ = 0;
+
   friend class ClusterResourceSchedulerTest;
   friend struct ClusterResourceManagerTest;
   friend class raylet::ClusterTaskManagerTest;
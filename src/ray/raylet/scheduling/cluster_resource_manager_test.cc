@@ -173,4 +173,27 @@ TEST_F(ClusterResourceManagerTest, UpdateNodeNormalTaskResources) {
   ASSERT_TRUE(node_resources.normal_task_resources.Get(ResourceID::CPU()) == 0.8);
 }
 
+TEST_F(ClusterResourceManagerTest, ResourceViewVersion) {
+  auto version = manager->GetResourceViewVersion();
+  // Failed updates don't change the view.
+  ASSERT_FALSE(manager->RemoveNode(node3));
+  ASSERT_FALSE(manager->SubtractNodeAvailableResources(
+      node3, ResourceMapToResourceRequest({{"CPU", 1}}, false)));
+  ASSERT_EQ(manager->GetResourceViewVersion(), version);
+
+  ASSERT_TRUE(manager->SubtractNodeAvailableResources(
+      node0, ResourceMapToResourceRequest({{"CPU", 1}}, false)));
+  ASSERT_GT(manager->GetResourceViewVersion(), version);
+  version = manager->GetResourceViewVersion();
+  ASSERT_TRUE(manager->AddNodeAvailableResources(
+      node0, ResourceMapToResourceRequest({{"CPU", 1}}, false)));
+  ASSERT_GT(manager->GetResourceViewVersion(), version);
+  version = manager->GetResourceViewVersion();
+  manager->AddOrUpdateNode(node3, CreateNodeResources(1, 1));
+  ASSERT_GT(manager->GetResourceViewVersion(), version);
+  version = manager->GetResourceViewVersion();
+  ASSERT_TRUE(manager->RemoveNode(node3));
+  ASSERT_GT(manager->GetResourceViewVersion(), version);
+}
+
 }  // namespace ray
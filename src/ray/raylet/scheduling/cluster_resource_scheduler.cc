@@ -14,6 +14,7 @@
 
 #include "ray/raylet/scheduling/cluster_resource_scheduler.h"
 
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 
 #include "ray/common/grpc_util.h"
@@ -74,6 +75,7 @@ void ClusterResourceScheduler::Init(
           *cluster_resource_manager_,
           /*is_node_available_fn*/
           [this](auto node_id) { return this->NodeAlive(node_id); });
+  node_scorer_ = CreateNodeScorer(RayConfig::instance().scheduler_node_scorer());
 }
 
 bool ClusterResourceScheduler::NodeAlive(scheduling::NodeID node_id) const {
@@ -124,7 +126,8 @@ scheduling::NodeID ClusterResourceScheduler::GetBestSchedulableNode(
     bool actor_creation,
     bool force_spillback,
     int64_t *total_violations,
-    bool *is_infeasible) {
+    bool *is_infeasible,
+    const absl::flat_hash_map<scheduling::NodeID, int64_t> &arg_bytes_by_node) {
   // The zero cpu actor is a special case that must be handled the same way by all
   // scheduling policies, except for HARD node affnity scheduling policy.
   if (actor_creation && resource_request.IsEmpty() &&
@@ -164,11 +167,14 @@ scheduling::NodeID ClusterResourceScheduler::GetBestSchedulableNode(
   } else {
     // TODO (Alex): Setting require_available == force_spillback is a hack in order to
     // remain bug compatible with the legacy scheduling algorithms.
-    best_node_id =
-        scheduling_policy_->Schedule(resource_request,
-                                     SchedulingOptions::Hybrid(
-                                         /*avoid_local_node*/ force_spillback,
-                                         /*require_node_available*/ force_spillback));
+    auto options = SchedulingOptions::Hybrid(
+        /*avoid_local_node*/ force_spillback,
+        /*require_node_available*/ force_spillback);
+    options.node_scorer = node_scorer_;
+    options.arg_bytes_by_node = arg_bytes_by_node;
+    options.data_locality_weight =
+        RayConfig::instance().scheduler_data_locality_weight();
+    best_node_id = scheduling_policy_->Schedule(resource_request, options);
   }
 
   *is_infeasible = best_node_id.IsNil();
@@ -193,7 +199,8 @@ scheduling::NodeID ClusterResourceScheduler::GetBestSchedulableNode(
     bool actor_creation,
     bool force_spillback,
     int64_t *total_violations,
-    bool *is_infeasible) {
+    bool *is_infeasible,
+    const absl::flat_hash_map<scheduling::NodeID, int64_t> &arg_bytes_by_node) {
   ResourceRequest resource_request =
       ResourceMapToResourceRequest(task_resources, requires_object_store_memory);
   return GetBestSchedulableNode(resource_request,
@@ -201,7 +208,8 @@ scheduling::NodeID ClusterResourceScheduler::GetBestSchedulableNode(
                                 actor_creation,
                                 force_spillback,
                                 total_violations,
-                                is_infeasible);
+                                is_infeasible,
+                                arg_bytes_by_node);
 }
 
 bool ClusterResourceScheduler::SubtractRemoteNodeAvailableResources(
@@ -242,6 +250,33 @@ bool ClusterResourceScheduler::IsSchedulableOnNode(
   return IsSchedulable(resource_request, node_id);
 }
 
+int64_t ClusterResourceScheduler::GetNumSchedulableInBatch(
+    scheduling::NodeID node_id,
+    const absl::flat_hash_map<std::string, double> &shape,
+    int64_t max_num_requests) {
+  auto resource_request =
+      ResourceMapToResourceRequest(shape, /*requires_object_store_memory=*/false);
+  if (max_num_requests <= 1 || !IsSchedulable(resource_request, node_id)) {
+    return std::max<int64_t>(max_num_requests, 1);
+  }
+
+  NodeResources node_resources;
+  RAY_CHECK(cluster_resource_manager_->GetNodeResources(node_id, &node_resources));
+  // The hybrid policy keeps packing the first node in its traversal order until its
+  // utilization reaches the spread threshold, and then picks the least utilized node
+  // for every request.
+  const float spread_threshold = RayConfig::instance().scheduler_spread_threshold();
+  int64_t num_requests = 1;
+  node_resources.available -= resource_request;
+  while (num_requests < max_num_requests &&
+         node_resources.CalculateCriticalResourceUtilization() < spread_threshold &&
+         node_resources.IsAvailable(resource_request, /*ignore_at_capacity=*/true)) {
+    node_resources.available -= resource_request;
+    num_requests++;
+  }
+  return num_requests;
+}
+
 scheduling::NodeID ClusterResourceScheduler::GetBestSchedulableNode(
     const TaskSpecification &task_spec,
     bool prioritize_local_node,
@@ -258,6 +293,13 @@ scheduling::NodeID ClusterResourceScheduler::GetBestSchedulableNode(
     return local_node_id_;
   }
 
+  absl::flat_hash_map<scheduling::NodeID, int64_t> arg_bytes_by_node;
+  if (RayConfig::instance().scheduler_data_locality_weight() > 0) {
+    for (const auto &entry : task_spec.GetMessage().lease_arg_bytes_by_node()) {
+      arg_bytes_by_node.emplace(scheduling::NodeID(entry.first), entry.second);
+    }
+  }
+
   // This argument is used to set violation, which is an unsupported feature now.
   int64_t _unused;
   scheduling::NodeID best_node =
@@ -267,7 +309,8 @@ scheduling::NodeID ClusterResourceScheduler::GetBestSchedulableNode(
                              task_spec.IsActorCreationTask(),
                              exclude_local_node,
                              &_unused,
-                             is_infeasible);
+                             is_infeasible,
+                             arg_bytes_by_node);
 
   // There is no other available nodes.
   if (!best_node.IsNil() &&
@@ -293,6 +336,9 @@ scheduling::NodeID ClusterResourceScheduler::GetBestSchedulableNode(
 SchedulingResult ClusterResourceScheduler::Schedule(
     const std::vector<const ResourceRequest *> &resource_request_list,
     SchedulingOptions options) {
+  if (options.node_scorer == nullptr) {
+    options.node_scorer = node_scorer_;
+  }
   return bundle_scheduling_policy_->Schedule(resource_request_list, options);
 }
 
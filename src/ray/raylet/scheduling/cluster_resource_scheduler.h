@@ -119,6 +119,22 @@ class ClusterResourceScheduler {
                            const absl::flat_hash_map<std::string, double> &shape,
                            bool requires_object_store_memory);
 
+  /// Get how many identical requests the hybrid policy would place on a node in a
+  /// row, so that they can all be placed after a single scheduling decision.
+  ///
+  /// This is the number of requests the node can take while its utilization stays
+  /// below the spread threshold, and at least one. If the request isn't available
+  /// on the node, it is all of them, since placing a request there doesn't change
+  /// the resource view.
+  ///
+  /// \param node_id The node picked for the first request.
+  /// \param shape The resource demand's shape.
+  /// \param max_num_requests The number of identical requests to place.
+  /// \return A number between 1 and max_num_requests.
+  int64_t GetNumSchedulableInBatch(scheduling::NodeID node_id,
+                                   const absl::flat_hash_map<std::string, double> &shape,
+                                   int64_t max_num_requests);
+
   LocalResourceManager &GetLocalResourceManager() { return *local_resource_manager_; }
   ClusterResourceManager &GetClusterResourceManager() {
     return *cluster_resource_manager_;
@@ -163,6 +179,8 @@ class ClusterResourceScheduler {
   ///                     a node that can schedule resource_request is found).
   ///  \param is_infeasible[in]: It is set true if the task is not schedulable because it
   ///  is infeasible.
+  ///  \param arg_bytes_by_node: The bytes of the arguments of the task on each node,
+  ///  weighed by the hybrid policy if scheduler_data_locality_weight is set.
   ///
   ///  \return -1, if no node can schedule the current request; otherwise,
   ///          return the ID of a node that can schedule the resource request.
@@ -172,7 +190,8 @@ class ClusterResourceScheduler {
       bool actor_creation,
       bool force_spillback,
       int64_t *violations,
-      bool *is_infeasible);
+      bool *is_infeasible,
+      const absl::flat_hash_map<scheduling::NodeID, int64_t> &arg_bytes_by_node = {});
 
   /// Similar to
   ///    int64_t GetBestSchedulableNode(...)
@@ -187,7 +206,8 @@ class ClusterResourceScheduler {
       bool actor_creation,
       bool force_spillback,
       int64_t *violations,
-      bool *is_infeasible);
+      bool *is_infeasible,
+      const absl::flat_hash_map<scheduling::NodeID, int64_t> &arg_bytes_by_node = {});
 
   /// Judging whether it affinity with placement group bundle
   bool IsAffinityWithBundleSchedule(const rpc::SchedulingStrategy &scheduling_strategy);
@@ -204,6 +224,9 @@ class ClusterResourceScheduler {
   /// The bundle scheduling policy to use.
   std::unique_ptr<raylet_scheduling_policy::IBundleSchedulingPolicy>
       bundle_scheduling_policy_;
+  /// The scorer the hybrid and bundle policies rank the nodes with, from the
+  /// scheduler_node_scorer config. Null to use the default ranking of each policy.
+  std::shared_ptr<raylet_scheduling_policy::NodeScorer> node_scorer_;
   /// Whether there is a raylet on the local node.
   bool is_local_node_with_raylet_ = true;
 
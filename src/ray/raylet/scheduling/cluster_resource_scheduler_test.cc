@@ -1472,6 +1472,42 @@ TEST_F(ClusterResourceSchedulerTest, TestForceSpillback) {
             node_ids[51]);
 }
 
+TEST_F(ClusterResourceSchedulerTest, TestNumSchedulableInBatch) {
+  absl::flat_hash_map<std::string, double> local_resources({{"CPU", 10}});
+  ClusterResourceScheduler resource_scheduler(
+      scheduling::NodeID("local"), local_resources, is_node_available_fn_);
+  auto remote_node_id = scheduling::NodeID(NodeID::FromRandom().Binary());
+  absl::flat_hash_map<std::string, double> remote_total({{"CPU", 4}});
+  absl::flat_hash_map<std::string, double> remote_available({{"CPU", 0}});
+  resource_scheduler.GetClusterResourceManager().AddOrUpdateNode(
+      remote_node_id, remote_total, remote_available);
+  absl::flat_hash_map<std::string, double> shape({{"CPU", 1}});
+
+  // The local node is packed until its utilization reaches the spread threshold.
+  RayConfig::instance().scheduler_spread_threshold() = 0.5;
+  ASSERT_EQ(resource_scheduler.GetNumSchedulableInBatch(
+                scheduling::NodeID("local"), shape, /*max_num_requests=*/100),
+            5);
+  ASSERT_EQ(resource_scheduler.GetNumSchedulableInBatch(
+                scheduling::NodeID("local"), shape, /*max_num_requests=*/3),
+            3);
+  // Above the threshold, every request gets its own decision.
+  RayConfig::instance().scheduler_spread_threshold() = 0;
+  ASSERT_EQ(resource_scheduler.GetNumSchedulableInBatch(
+                scheduling::NodeID("local"), shape, /*max_num_requests=*/100),
+            1);
+  // No more than the available resources are taken.
+  RayConfig::instance().scheduler_spread_threshold() = 1;
+  ASSERT_EQ(resource_scheduler.GetNumSchedulableInBatch(
+                scheduling::NodeID("local"), shape, /*max_num_requests=*/100),
+            10);
+  // Every request is queued on a node where it isn't available.
+  ASSERT_EQ(resource_scheduler.GetNumSchedulableInBatch(
+                remote_node_id, shape, /*max_num_requests=*/100),
+            100);
+  RayConfig::instance().scheduler_spread_threshold() = 0.5;
+}
+
 TEST_F(ClusterResourceSchedulerTest, CustomResourceInstanceTest) {
   SetUnitInstanceResourceIds({ResourceID("FPGA")});
   ClusterResourceScheduler resource_scheduler(
@@ -1590,6 +1626,51 @@ TEST_F(ClusterResourceSchedulerTest, AffinityWithBundleScheduleTest) {
   test_schedule({{"CPU", 2}}, bundle_1, scheduling::NodeID::Nil());
 }
 
+TEST_F(ClusterResourceSchedulerTest, NodeScorerConfigTest) {
+  absl::flat_hash_map<std::string, double> resource_total({{"CPU", 8}});
+  absl::flat_hash_map<std::string, double> remote_available({{"CPU", 2}});
+  auto local_node_id = scheduling::NodeID(NodeID::FromRandom().Binary());
+  auto remote_node_id = scheduling::NodeID(NodeID::FromRandom().Binary());
+  auto make_scheduler = [&](const std::string &node_scorer) {
+    // The scorer is read from the config when the scheduler is created.
+    RayConfig::instance().scheduler_node_scorer() = node_scorer;
+    auto scheduler = std::make_unique<ClusterResourceScheduler>(
+        local_node_id, resource_total, is_node_available_fn_);
+    RayConfig::instance().scheduler_node_scorer() = "";
+    scheduler->GetClusterResourceManager().AddOrUpdateNode(
+        remote_node_id, resource_total, remote_available);
+    return scheduler;
+  };
+  auto schedule_task = [](ClusterResourceScheduler &scheduler) {
+    absl::flat_hash_map<std::string, double> task_resources({{"CPU", 1}});
+    int64_t violations;
+    bool is_infeasible;
+    return scheduler.GetBestSchedulableNode(task_resources,
+                                            rpc::SchedulingStrategy(),
+                                            false,
+                                            false,
+                                            false,
+                                            &violations,
+                                            &is_infeasible);
+  };
+  ResourceRequest bundle = CreateResourceRequest({{ResourceID::CPU(), 1}});
+  std::vector<const ResourceRequest *> bundles{&bundle};
+
+  // By default tasks and bundles go to the idle local node.
+  auto scheduler = make_scheduler("");
+  ASSERT_EQ(schedule_task(*scheduler), local_node_id);
+  auto result = scheduler->Schedule(bundles, SchedulingOptions::BundlePack());
+  ASSERT_TRUE(result.status.IsSuccess());
+  ASSERT_EQ(result.selected_nodes[0], local_node_id);
+
+  // Bin packing puts both on the busy remote node.
+  scheduler = make_scheduler("most_allocated");
+  ASSERT_EQ(schedule_task(*scheduler), remote_node_id);
+  result = scheduler->Schedule(bundles, SchedulingOptions::BundlePack());
+  ASSERT_TRUE(result.status.IsSuccess());
+  ASSERT_EQ(result.selected_nodes[0], remote_node_id);
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
@@ -18,6 +18,7 @@
 
 #include <boost/range/join.hpp>
 
+#include "ray/common/ray_config.h"
 #include "ray/stats/metric_defs.h"
 #include "ray/util/logging.h"
 
@@ -36,8 +37,10 @@ ClusterTaskManager::ClusterTaskManager(
       get_node_info_(get_node_info),
       announce_infeasible_task_(announce_infeasible_task),
       local_task_manager_(std::move(local_task_manager)),
-      scheduler_resource_reporter_(
-          tasks_to_schedule_, infeasible_tasks_, *local_task_manager_),
+      scheduler_resource_reporter_(tasks_to_schedule_,
+                                   infeasible_tasks_,
+                                   gangs_to_schedule_,
+                                   *local_task_manager_),
       internal_stats_(*this, *local_task_manager_),
       get_time_ms_(get_time_ms) {}
 
@@ -54,16 +57,62 @@ void ClusterTaskManager::QueueAndScheduleTask(
         send_reply_callback(Status::OK(), nullptr, nullptr);
       });
   const auto &scheduling_class = task.GetTaskSpecification().GetSchedulingClass();
-  // If the scheduling class is infeasible, just add the work to the infeasible queue
-  // directly.
-  if (infeasible_tasks_.count(scheduling_class) > 0) {
+  // The members of a gang wait for each other. A retried member, or one spilled here
+  // by the raylet that placed its gang, is scheduled on its own since the rest of its
+  // gang has already been placed.
+  if (task.GetTaskSpecification().IsGangTask() &&
+      task.GetTaskSpecification().AttemptNumber() == 0 && !grant_or_reject) {
+    auto &gang = gangs_to_schedule_[task.GetTaskSpecification().GetGangId()];
+    gang.works.push_back(work);
+    gang.unschedulable_version.reset();
+  } else if (infeasible_tasks_.count(scheduling_class) > 0) {
+    // If the scheduling class is infeasible, just add the work to the infeasible queue
+    // directly.
     infeasible_tasks_[scheduling_class].push_back(work);
+  } else if (TryGrantToIdleWorker(work)) {
+    return;
   } else {
     tasks_to_schedule_[scheduling_class].push_back(work);
   }
   ScheduleAndDispatchTasks();
 }
 
+bool ClusterTaskManager::TryGrantToIdleWorker(
+    const std::shared_ptr<internal::Work> &work) {
+  const auto &task_spec = work->task.GetTaskSpecification();
+  if (!RayConfig::instance().worker_lease_fast_path_enabled() ||
+      task_spec.IsActorCreationTask() || !task_spec.GetDependencies().empty() ||
+      tasks_to_schedule_.contains(task_spec.GetSchedulingClass())) {
+    return false;
+  }
+  const auto strategy_case =
+      task_spec.GetMessage().scheduling_strategy().scheduling_strategy_case();
+  if (strategy_case != rpc::SchedulingStrategy::SchedulingStrategyCase::
+                           kDefaultSchedulingStrategy &&
+      strategy_case != rpc::SchedulingStrategy::SchedulingStrategyCase::
+                           SCHEDULING_STRATEGY_NOT_SET) {
+    return false;
+  }
+  // Only grant the lease where the hybrid policy would have granted it: it keeps a
+  // task on the local node while the node's utilization is below the spread
+  // threshold, or always if the local node is preferred.
+  if (!work->PrioritizeLocalNode()) {
+    const auto &local_resources =
+        cluster_resource_scheduler_->GetClusterResourceManager().GetNodeResources(
+            scheduling::NodeID(self_node_id_.Binary()));
+    if (local_resources.CalculateCriticalResourceUtilization() >=
+        RayConfig::instance().scheduler_spread_threshold()) {
+      return false;
+    }
+  }
+  if (!local_task_manager_->TryDispatchToIdleWorker(work)) {
+    internal_stats_.LeaseFastPathMiss();
+    return false;
+  }
+  internal_stats_.LeaseFastPathHit();
+  return true;
+}
+
 namespace {
 void ReplyCancelled(const internal::Work &work,
                     rpc::RequestWorkerLeaseReply::SchedulingFailureType failure_type,
@@ -75,14 +124,46 @@ void ReplyCancelled(const internal::Work &work,
   reply->set_scheduling_failure_message(scheduling_failure_message);
   callback();
 }
+
+/// Whether the tasks of this scheduling class can be placed in batches, i.e. whether
+/// they are scheduled by the hybrid policy with its default ranking of the nodes.
+bool IsBatchSchedulable(const TaskSpecification &task_spec) {
+  const auto &config = RayConfig::instance();
+  if (!config.scheduler_batch_scheduling_enabled() ||
+      !config.scheduler_node_scorer().empty() ||
+      config.scheduler_data_locality_weight() > 0 || task_spec.IsActorCreationTask()) {
+    return false;
+  }
+  const auto strategy_case =
+      task_spec.GetMessage().scheduling_strategy().scheduling_strategy_case();
+  return strategy_case == rpc::SchedulingStrategy::SchedulingStrategyCase::
+                              kDefaultSchedulingStrategy ||
+         strategy_case == rpc::SchedulingStrategy::SchedulingStrategyCase::
+                              SCHEDULING_STRATEGY_NOT_SET;
+}
 }  // namespace
 
 void ClusterTaskManager::ScheduleAndDispatchTasks() {
   // Always try to schedule infeasible tasks in case they are now feasible.
   TryScheduleInfeasibleTask();
+  ScheduleGangs();
+  const auto &cluster_resource_manager =
+      cluster_resource_scheduler_->GetClusterResourceManager();
   for (auto shapes_it = tasks_to_schedule_.begin();
        shapes_it != tasks_to_schedule_.end();) {
     auto &work_queue = shapes_it->second;
+    // Skip the classes whose head couldn't be scheduled the last time if nothing
+    // changed in the cluster since then, it still can't be scheduled.
+    auto verdict_it = unschedulable_classes_.find(shapes_it->first);
+    if (verdict_it != unschedulable_classes_.end()) {
+      if (verdict_it->second.resource_view_version ==
+              cluster_resource_manager.GetResourceViewVersion() &&
+          verdict_it->second.head == work_queue.front().get()) {
+        shapes_it++;
+        continue;
+      }
+      unschedulable_classes_.erase(verdict_it);
+    }
     bool is_infeasible = false;
     for (auto work_it = work_queue.begin(); work_it != work_queue.end();) {
       // Check every task in task_to_schedule queue to see
@@ -124,12 +205,37 @@ void ClusterTaskManager::ScheduleAndDispatchTasks() {
           continue;
         }
 
+        if (!is_infeasible) {
+          unschedulable_classes_[shapes_it->first] = {
+              cluster_resource_manager.GetResourceViewVersion(), work.get()};
+        }
         break;
       }
 
       NodeID node_id = NodeID::FromBinary(scheduling_node_id.Binary());
+      // The following tasks of the class have the same shape, so place as many of
+      // them as the policy would have placed on this node one by one, without
+      // running it again for each of them. The tasks that prefer the local node
+      // still get their own scheduling decision.
+      int64_t num_to_place = 1;
+      if (!work->PrioritizeLocalNode() &&
+          IsBatchSchedulable(task.GetTaskSpecification())) {
+        num_to_place = cluster_resource_scheduler_->GetNumSchedulableInBatch(
+            scheduling_node_id,
+            task.GetTaskSpecification().GetRequiredResources().GetResourceMap(),
+            std::distance(work_it, work_queue.end()));
+      }
       ScheduleOnNode(node_id, work);
       work_it = work_queue.erase(work_it);
+      for (int64_t i = 1; i < num_to_place && work_it != work_queue.end() &&
+                          !(*work_it)->PrioritizeLocalNode();
+           i++) {
+        RAY_LOG(DEBUG) << "Scheduling pending task "
+                       << (*work_it)->task.GetTaskSpecification().TaskId()
+                       << " in a batch";
+        ScheduleOnNode(node_id, *work_it);
+        work_it = work_queue.erase(work_it);
+      }
     }
 
     if (is_infeasible) {
@@ -154,7 +260,135 @@ void ClusterTaskManager::ScheduleAndDispatchTasks() {
   local_task_manager_->ScheduleAndDispatchTasks();
 }
 
+void ClusterTaskManager::ScheduleGangs() {
+  const auto resource_view_version =
+      cluster_resource_scheduler_->GetClusterResourceManager().GetResourceViewVersion();
+  for (auto gang_it = gangs_to_schedule_.begin(); gang_it != gangs_to_schedule_.end();) {
+    auto &gang = gang_it->second;
+    const auto &first_spec = gang.works.front()->task.GetTaskSpecification();
+    if (static_cast<int64_t>(gang.works.size()) < first_spec.GetGangSize() ||
+        gang.unschedulable_version == resource_view_version) {
+      gang_it++;
+      continue;
+    }
+
+    std::vector<ResourceRequest> resource_requests;
+    resource_requests.reserve(gang.works.size());
+    ResourceRequest aggregated_resource_request;
+    for (const auto &work : gang.works) {
+      resource_requests.push_back(ResourceMapToResourceRequest(
+          work->task.GetTaskSpecification().GetRequiredResources().GetResourceMap(),
+          /*requires_object_store_memory=*/false));
+      aggregated_resource_request += resource_requests.back();
+    }
+
+    // Keep the whole gang local if it fits, otherwise place it across the cluster
+    // like a placement group with the PACK strategy, but without reserving the
+    // resources through the GCS.
+    std::vector<scheduling::NodeID> selected_nodes;
+    const auto local_node_id = scheduling::NodeID(self_node_id_.Binary());
+    if (cluster_resource_scheduler_->GetClusterResourceManager().HasSufficientResource(
+            local_node_id,
+            aggregated_resource_request,
+            /*ignore_object_store_memory_requirement=*/true)) {
+      selected_nodes.assign(gang.works.size(), local_node_id);
+    } else {
+      std::vector<const ResourceRequest *> resource_request_list;
+      for (const auto &resource_request : resource_requests) {
+        resource_request_list.push_back(&resource_request);
+      }
+      auto result = cluster_resource_scheduler_->Schedule(
+          resource_request_list,
+          raylet_scheduling_policy::SchedulingOptions::BundlePack());
+      if (result.status.IsInfeasible() && !gang.announced_infeasible) {
+        RAY_LOG(DEBUG) << "Gang " << first_spec.GetGangId() << " is infeasible";
+        if (announce_infeasible_task_) {
+          announce_infeasible_task_(gang.works.front()->task);
+        }
+        gang.announced_infeasible = true;
+      }
+      if (!result.status.IsSuccess()) {
+        gang.unschedulable_version = resource_view_version;
+        gang_it++;
+        continue;
+      }
+      selected_nodes = std::move(result.selected_nodes);
+    }
+
+    if (!ReserveGangResources(gang.works, selected_nodes)) {
+      RAY_LOG(DEBUG) << "Failed to reserve the resources of gang "
+                     << first_spec.GetGangId();
+      // Releasing the partial reservation bumped the version of the resource view.
+      gang.unschedulable_version =
+          cluster_resource_scheduler_->GetClusterResourceManager()
+              .GetResourceViewVersion();
+      gang_it++;
+      continue;
+    }
+
+    RAY_LOG(DEBUG) << "Scheduling the " << gang.works.size() << " tasks of gang "
+                   << first_spec.GetGangId();
+    for (size_t i = 0; i < gang.works.size(); i++) {
+      ScheduleOnNode(NodeID::FromBinary(selected_nodes[i].Binary()),
+                     gang.works[i],
+                     /*resources_reserved=*/true);
+    }
+    gangs_to_schedule_.erase(gang_it++);
+  }
+}
+
+bool ClusterTaskManager::ReserveGangResources(
+    const std::vector<std::shared_ptr<internal::Work>> &works,
+    const std::vector<scheduling::NodeID> &selected_nodes) {
+  const auto local_node_id = scheduling::NodeID(self_node_id_.Binary());
+  auto &local_resource_manager = cluster_resource_scheduler_->GetLocalResourceManager();
+  size_t num_reserved = 0;
+  for (; num_reserved < works.size(); num_reserved++) {
+    const auto &work = works[num_reserved];
+    const auto &resources =
+        work->task.GetTaskSpecification().GetRequiredResources().GetResourceMap();
+    if (selected_nodes[num_reserved] == local_node_id) {
+      // The local task manager dispatches the task with these instances.
+      auto allocated_instances = std::make_shared<TaskResourceInstances>();
+      if (!local_resource_manager.AllocateLocalTaskResources(resources,
+                                                             allocated_instances)) {
+        break;
+      }
+      work->allocated_instances = allocated_instances;
+    } else if (!cluster_resource_scheduler_->AllocateRemoteTaskResources(
+                   selected_nodes[num_reserved], resources)) {
+      break;
+    }
+  }
+  if (num_reserved == works.size()) {
+    return true;
+  }
+
+  for (size_t i = 0; i < num_reserved; i++) {
+    const auto &resources =
+        works[i]->task.GetTaskSpecification().GetRequiredResources().GetResourceMap();
+    if (selected_nodes[i] == local_node_id) {
+      local_resource_manager.ReleaseWorkerResources(works[i]->allocated_instances);
+      works[i]->allocated_instances = nullptr;
+    } else {
+      cluster_resource_scheduler_->GetClusterResourceManager().AddNodeAvailableResources(
+          selected_nodes[i],
+          ResourceMapToResourceRequest(resources,
+                                       /*requires_object_store_memory=*/false));
+    }
+  }
+  return false;
+}
+
 void ClusterTaskManager::TryScheduleInfeasibleTask() {
+  // The infeasible classes were all checked against the current resource view,
+  // so they can only have become feasible if it changed.
+  const auto resource_view_version =
+      cluster_resource_scheduler_->GetClusterResourceManager().GetResourceViewVersion();
+  if (infeasible_tasks_checked_version_ == resource_view_version) {
+    return;
+  }
+  infeasible_tasks_checked_version_ = resource_view_version;
   for (auto shapes_it = infeasible_tasks_.begin();
        shapes_it != infeasible_tasks_.end();) {
     auto &work_queue = shapes_it->second;
@@ -206,6 +440,7 @@ bool ClusterTaskManager::CancelTask(
         ReplyCancelled(*(*work_it), failure_type, scheduling_failure_message);
         work_queue.erase(work_it);
         if (work_queue.empty()) {
+          unschedulable_classes_.erase(shapes_it->first);
           tasks_to_schedule_.erase(shapes_it);
         }
         return true;
@@ -230,6 +465,25 @@ bool ClusterTaskManager::CancelTask(
     }
   }
 
+  for (auto gang_it = gangs_to_schedule_.begin(); gang_it != gangs_to_schedule_.end();
+       gang_it++) {
+    auto &works = gang_it->second.works;
+    for (auto work_it = works.begin(); work_it != works.end(); work_it++) {
+      const auto &task = (*work_it)->task;
+      if (task.GetTaskSpecification().TaskId() == task_id) {
+        RAY_LOG(DEBUG) << "Canceling task " << task_id << " from gang "
+                       << gang_it->first;
+        ReplyCancelled(*(*work_it), failure_type, scheduling_failure_message);
+        works.erase(work_it);
+        gang_it->second.unschedulable_version.reset();
+        if (works.empty()) {
+          gangs_to_schedule_.erase(gang_it);
+        }
+        return true;
+      }
+    }
+  }
+
   return local_task_manager_->CancelTask(
       task_id, failure_type, scheduling_failure_message);
 }
@@ -302,7 +556,8 @@ std::string ClusterTaskManager::DebugStr() const {
 }
 
 void ClusterTaskManager::ScheduleOnNode(const NodeID &spillback_to,
-                                        const std::shared_ptr<internal::Work> &work) {
+                                        const std::shared_ptr<internal::Work> &work,
+                                        bool resources_reserved) {
   if (spillback_to == self_node_id_ && local_task_manager_) {
     local_task_manager_->QueueAndScheduleTask(work);
     return;
@@ -322,7 +577,8 @@ void ClusterTaskManager::ScheduleOnNode(const NodeID &spillback_to,
   const auto &task_spec = task.GetTaskSpecification();
   RAY_LOG(DEBUG) << "Spilling task " << task_spec.TaskId() << " to node " << spillback_to;
 
-  if (!cluster_resource_scheduler_->AllocateRemoteTaskResources(
+  if (!resources_reserved &&
+      !cluster_resource_scheduler_->AllocateRemoteTaskResources(
           scheduling::NodeID(spillback_to.Binary()),
           task_spec.GetRequiredResources().GetResourceMap())) {
     RAY_LOG(DEBUG) << "Tried to allocate resources for request " << task_spec.TaskId()
@@ -360,6 +616,9 @@ size_t ClusterTaskManager::GetPendingQueueSize() const {
   for (const auto &cls_entry : tasks_to_schedule_) {
     count += cls_entry.second.size();
   }
+  for (const auto &gang_entry : gangs_to_schedule_) {
+    count += gang_entry.second.works.size();
+  }
   return count;
 }
 
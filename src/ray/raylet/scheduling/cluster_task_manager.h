@@ -141,9 +141,31 @@ class ClusterTaskManager : public ClusterTaskManagerInterface {
  private:
   void TryScheduleInfeasibleTask();
 
+  /// Grant a lease request to an idle worker of the local node without queueing it,
+  /// if `worker_lease_fast_path_enabled` is set and the scheduling policy would have
+  /// kept the task local anyway.
+  ///
+  /// \return True if the request was handed to the local task manager.
+  bool TryGrantToIdleWorker(const std::shared_ptr<internal::Work> &work);
+
+  /// Place the gangs whose tasks are all queued, each all at once or not at all.
+  void ScheduleGangs();
+
+  /// Reserve the resources of every task of a gang on its selected node, so that no
+  /// task is dispatched before the whole gang fits.
+  ///
+  /// \param works: The tasks of the gang.
+  /// \param selected_nodes: The node selected for each of the tasks.
+  /// \return True if all the resources were reserved. Otherwise nothing is reserved.
+  bool ReserveGangResources(const std::vector<std::shared_ptr<internal::Work>> &works,
+                            const std::vector<scheduling::NodeID> &selected_nodes);
+
   // Schedule the task onto a node (which could be either remote or local).
+  // If `resources_reserved` is set, the resources of a task spilled to a remote node
+  // were already subtracted from the view of that node.
   void ScheduleOnNode(const NodeID &node_to_schedule,
-                      const std::shared_ptr<internal::Work> &work);
+                      const std::shared_ptr<internal::Work> &work,
+                      bool resources_reserved = false);
 
   /// Recompute the debug stats.
   /// It is needed because updating the debug state is expensive for cluster_task_manager.
@@ -174,6 +196,26 @@ class ClusterTaskManager : public ClusterTaskManagerInterface {
   absl::flat_hash_map<SchedulingClass, std::deque<std::shared_ptr<internal::Work>>>
       infeasible_tasks_;
 
+  /// A scheduling decision that found no node for the head of a class in
+  /// `tasks_to_schedule_`, without the class being infeasible.
+  struct UnschedulableVerdict {
+    /// The version of the cluster resource view when the decision was made.
+    uint64_t resource_view_version;
+    /// The head of the queue of the class at that time.
+    const internal::Work *head;
+  };
+
+  /// The classes in `tasks_to_schedule_` whose head couldn't be scheduled. They are
+  /// not scheduled again until the resource view or their head changes.
+  absl::flat_hash_map<SchedulingClass, UnschedulableVerdict> unschedulable_classes_;
+
+  /// The version of the cluster resource view when `infeasible_tasks_` were last
+  /// checked.
+  uint64_t infeasible_tasks_checked_version_ = 0;
+
+  /// Gangs of tasks waiting to be scheduled, by gang id.
+  absl::flat_hash_map<std::string, internal::Gang> gangs_to_schedule_;
+
   const SchedulerResourceReporter scheduler_resource_reporter_;
   mutable SchedulerStats internal_stats_;
 
@@ -183,6 +225,7 @@ class ClusterTaskManager : public ClusterTaskManagerInterface {
   friend class SchedulerStats;
   friend class ClusterTaskManagerTest;
   FRIEND_TEST(ClusterTaskManagerTest, FeasibleToNonFeasible);
+  FRIEND_TEST(ClusterTaskManagerLeaseFastPathTest, LeaseFastPathTest);
 };
 }  // namespace raylet
 }  // namespace ray
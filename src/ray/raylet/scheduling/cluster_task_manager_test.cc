@@ -57,6 +57,15 @@ class MockWorkerPool : public WorkerPoolInterface {
     callbacks[runtime_env_hash].push_back(callback);
   }
 
+  bool HasIdleWorker(const TaskSpecification &task_spec) const {
+    for (const auto &worker : workers) {
+      if (worker->GetRuntimeEnvHash() == task_spec.GetRuntimeEnvHash()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   void PushWorker(const std::shared_ptr<WorkerInterface> &worker) {
     workers.push_front(worker);
   }
@@ -223,7 +232,9 @@ class FeatureFlagEnvironment : public ::testing::Environment {
   ~FeatureFlagEnvironment() override {}
 
   // Override this to define how to set up the environment.
-  void SetUp() override { RayConfig::instance().worker_cap_enabled() = true; }
+  void SetUp() override {
+    RayConfig::instance().worker_cap_enabled() = true;
+  }
 
   // Override this to define how to tear down the environment.
   void TearDown() override {}
@@ -272,6 +283,9 @@ class ClusterTaskManagerTest : public ::testing::Test {
               }
               return true;
             },
+            /* preempt_worker= */
+            [this](const std::shared_ptr<WorkerInterface> &worker,
+                   const std::string &message) { preempted_workers_.push_back(worker); },
             /*max_pinned_task_arguments_bytes=*/1000,
             /*get_time=*/[this]() { return current_time_ms_; })),
         task_manager_(
@@ -322,6 +336,7 @@ class ClusterTaskManagerTest : public ::testing::Test {
 
   void AssertNoLeaks() {
     ASSERT_TRUE(task_manager_.tasks_to_schedule_.empty());
+    ASSERT_TRUE(task_manager_.gangs_to_schedule_.empty());
     ASSERT_TRUE(local_task_manager_->tasks_to_dispatch_.empty());
     ASSERT_TRUE(local_task_manager_->waiting_tasks_index_.empty());
     ASSERT_TRUE(local_task_manager_->waiting_task_queue_.empty());
@@ -369,6 +384,7 @@ class ClusterTaskManagerTest : public ::testing::Test {
   std::shared_ptr<ClusterResourceScheduler> scheduler_;
   MockWorkerPool pool_;
   absl::flat_hash_map<WorkerID, std::shared_ptr<WorkerInterface>> leased_workers_;
+  std::vector<std::shared_ptr<WorkerInterface>> preempted_workers_;
   std::unordered_set<ObjectID> missing_objects_;
 
   bool is_owner_alive_;
@@ -391,6 +407,30 @@ class ClusterTaskManagerTestWithGPUsAtHead : public ClusterTaskManagerTest {
       : ClusterTaskManagerTest(/*num_cpus_at_head=*/8.0, /*num_gpus_at_head=*/4.0) {}
 };
 
+/// Turns worker preemption on for the lifetime of a test. It is a base of the fixture
+/// below so that the flag is set before the local task manager reads it.
+struct PreemptionEnabled {
+  PreemptionEnabled() { RayConfig::instance().scheduler_preemption_enabled() = true; }
+  ~PreemptionEnabled() { RayConfig::instance().scheduler_preemption_enabled() = false; }
+};
+
+// Same as ClusterTaskManagerTest, but workers can be preempted.
+class ClusterTaskManagerPreemptionTest : private PreemptionEnabled,
+                                         public ClusterTaskManagerTest {};
+
+// Same as ClusterTaskManagerTest, but lease requests can skip the scheduling queues.
+class ClusterTaskManagerLeaseFastPathTest : public ClusterTaskManagerTest {
+ public:
+  void SetUp() override {
+    ClusterTaskManagerTest::SetUp();
+    RayConfig::instance().worker_lease_fast_path_enabled() = true;
+  }
+
+  void TearDown() override {
+    RayConfig::instance().worker_lease_fast_path_enabled() = false;
+  }
+};
+
 // Same as ClusterTaskManagerTest, but the head node starts with 0.0 num cpus.
 class ClusterTaskManagerTestWithoutCPUsAtHead : public ClusterTaskManagerTest {
  public:
@@ -864,6 +904,87 @@ TEST_F(ClusterTaskManagerTest, TestGrantOrReject) {
   AssertNoLeaks();
 }
 
+TEST_F(ClusterTaskManagerTest, TestAdditionalLeases) {
+  /*
+    Test the lease requests NodeManager::HandleRequestWorkerLease queues for the
+    workers a request asks for in addition to the first one: copies of the request
+    with random task ids that are granted or rejected here, and canceled if they
+    still wait for a worker when the request is replied.
+   */
+  for (int i = 0; i < 2; i++) {
+    pool_.PushWorker(std::static_pointer_cast<WorkerInterface>(
+        std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234 + i)));
+  }
+  int num_callbacks = 0;
+  auto callback = [&](Status, std::function<void()>, std::function<void()>) {
+    num_callbacks++;
+  };
+  auto task = CreateTask({{ray::kCPU_ResourceLabel, 2}});
+  auto create_additional_lease = [&task]() {
+    rpc::Task message;
+    message.mutable_task_spec()->CopyFrom(task.GetTaskSpecification().GetMessage());
+    message.mutable_task_spec()->set_task_id(
+        TaskID::FromRandom(task.GetTaskSpecification().JobId()).Binary());
+    return RayTask(message);
+  };
+
+  rpc::RequestWorkerLeaseReply reply;
+  task_manager_.QueueAndScheduleTask(task, false, false, &reply, callback);
+  std::vector<RayTask> additional_tasks;
+  std::vector<rpc::RequestWorkerLeaseReply> additional_replies(4);
+  for (int i = 0; i < 3; i++) {
+    additional_tasks.push_back(create_additional_lease());
+    task_manager_.QueueAndScheduleTask(additional_tasks.back(),
+                                       /*grant_or_reject=*/true,
+                                       false,
+                                       &additional_replies[i],
+                                       callback);
+  }
+  pool_.TriggerCallbacks();
+  // The request and one additional lease got the two workers, the other two hold
+  // their resources while they wait for a worker.
+  ASSERT_EQ(num_callbacks, 2);
+  ASSERT_EQ(leased_workers_.size(), 2);
+  ASSERT_FALSE(additional_replies[0].worker_address().raylet_id().empty());
+  ASSERT_EQ(scheduler_->GetLocalResourceManager().GetLocalAvailableCpus(), 0.0);
+
+  // An additional lease that doesn't fit on this node is rejected instead of being
+  // spilled back to a node with room, the owner leases that worker on its own.
+  auto remote_node_id = NodeID::FromRandom();
+  AddNode(remote_node_id, 8);
+  task_manager_.QueueAndScheduleTask(create_additional_lease(),
+                                     /*grant_or_reject=*/true,
+                                     false,
+                                     &additional_replies[3],
+                                     callback);
+  pool_.TriggerCallbacks();
+  ASSERT_EQ(num_callbacks, 3);
+  ASSERT_TRUE(additional_replies[3].rejected());
+  ASSERT_TRUE(additional_replies[3].retry_at_raylet_address().raylet_id().empty());
+
+  // The request is replied. The additional leases still waiting are canceled and
+  // give their resources back, they don't get a worker later.
+  for (int i = 1; i < 3; i++) {
+    ASSERT_TRUE(
+        task_manager_.CancelTask(additional_tasks[i].GetTaskSpecification().TaskId()));
+    ASSERT_TRUE(additional_replies[i].canceled());
+  }
+  ASSERT_EQ(num_callbacks, 5);
+  ASSERT_EQ(scheduler_->GetLocalResourceManager().GetLocalAvailableCpus(), 4.0);
+  pool_.PushWorker(std::static_pointer_cast<WorkerInterface>(
+      std::make_shared<MockWorker>(WorkerID::FromRandom(), 1236)));
+  task_manager_.ScheduleAndDispatchTasks();
+  pool_.TriggerCallbacks();
+  ASSERT_EQ(leased_workers_.size(), 2);
+
+  while (!leased_workers_.empty()) {
+    RayTask finished_task;
+    local_task_manager_->TaskFinished(leased_workers_.begin()->second, &finished_task);
+    leased_workers_.erase(leased_workers_.begin());
+  }
+  AssertNoLeaks();
+}
+
 TEST_F(ClusterTaskManagerTest, TestSpillAfterAssigned) {
   /*
     Test the race condition in which a task is assigned to the local node, but
@@ -934,6 +1055,348 @@ TEST_F(ClusterTaskManagerTest, TestSpillAfterAssigned) {
   AssertNoLeaks();
 }
 
+TEST_F(ClusterTaskManagerTest, GangSchedulingTest) {
+  /*
+    Test that the tasks of a gang are placed only once all of them are queued, and
+    all at once.
+   */
+  auto create_gang_task = [](double num_cpus, const std::string &gang_id) {
+    TaskSpecification spec =
+        CreateTask({{ray::kCPU_ResourceLabel, num_cpus}}).GetTaskSpecification();
+    spec.GetMutableMessage().set_gang_id(gang_id);
+    spec.GetMutableMessage().set_gang_size(2);
+    return RayTask(spec);
+  };
+  int num_callbacks = 0;
+  auto callback = [&](Status, std::function<void()>, std::function<void()>) {
+    num_callbacks++;
+  };
+  for (int i = 0; i < 2; i++) {
+    pool_.PushWorker(std::static_pointer_cast<WorkerInterface>(
+        std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234)));
+  }
+
+  // The gang fits on the local node.
+  std::vector<rpc::RequestWorkerLeaseReply> replies(4);
+  task_manager_.QueueAndScheduleTask(
+      create_gang_task(4, "local"), false, false, &replies[0], callback);
+  pool_.TriggerCallbacks();
+  ASSERT_EQ(num_callbacks, 0);
+  ASSERT_EQ(task_manager_.GetPendingQueueSize(), 1);
+  task_manager_.QueueAndScheduleTask(
+      create_gang_task(4, "local"), false, false, &replies[1], callback);
+  pool_.TriggerCallbacks();
+  ASSERT_EQ(num_callbacks, 2);
+  ASSERT_EQ(leased_workers_.size(), 2);
+
+  // The gang doesn't fit anywhere, so no task is placed even though one of them
+  // would fit on the remote node.
+  auto remote_node_id = NodeID::FromRandom();
+  AddNode(remote_node_id, 8);
+  task_manager_.QueueAndScheduleTask(
+      create_gang_task(8, "remote"), false, false, &replies[2], callback);
+  task_manager_.QueueAndScheduleTask(
+      create_gang_task(8, "remote"), false, false, &replies[3], callback);
+  pool_.TriggerCallbacks();
+  ASSERT_EQ(num_callbacks, 2);
+  ASSERT_EQ(task_manager_.GetPendingQueueSize(), 2);
+
+  // Once there is room for the whole gang, it is spilled back.
+  AddNode(remote_node_id, 16);
+  task_manager_.ScheduleAndDispatchTasks();
+  pool_.TriggerCallbacks();
+  ASSERT_EQ(num_callbacks, 4);
+  ASSERT_EQ(replies[2].retry_at_raylet_address().raylet_id(), remote_node_id.Binary());
+  ASSERT_EQ(replies[3].retry_at_raylet_address().raylet_id(), remote_node_id.Binary());
+
+  for (auto &entry : leased_workers_) {
+    RayTask finished_task;
+    local_task_manager_->TaskFinished(entry.second, &finished_task);
+  }
+  AssertNoLeaks();
+}
+
+TEST_F(ClusterTaskManagerTest, GangReservationTest) {
+  /*
+    Test that waiting gangs are reported as load, that the tasks of a gang hold their
+    resources from the time the gang is placed, and that a task spilled here by the
+    raylet that placed its gang doesn't wait for the gang again.
+   */
+  auto create_gang_task = [](const std::string &gang_id, int num_args) {
+    TaskSpecification spec =
+        CreateTask({{ray::kCPU_ResourceLabel, 4}}, num_args).GetTaskSpecification();
+    spec.GetMutableMessage().set_gang_id(gang_id);
+    spec.GetMutableMessage().set_gang_size(2);
+    return RayTask(spec);
+  };
+  int num_callbacks = 0;
+  auto callback = [&](Status, std::function<void()>, std::function<void()>) {
+    num_callbacks++;
+  };
+  pool_.PushWorker(std::static_pointer_cast<WorkerInterface>(
+      std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234)));
+
+  std::vector<rpc::RequestWorkerLeaseReply> replies(3);
+  auto blocked_task = create_gang_task("local", 1);
+  missing_objects_.insert(blocked_task.GetTaskSpecification().GetDependencyIds()[0]);
+  task_manager_.QueueAndScheduleTask(blocked_task, false, false, &replies[0], callback);
+  pool_.TriggerCallbacks();
+  ASSERT_EQ(num_callbacks, 0);
+  {
+    rpc::ResourcesData data;
+    task_manager_.FillResourceUsage(data);
+    auto resource_load_by_shape = data.resource_load_by_shape();
+    ASSERT_EQ(resource_load_by_shape.resource_demands().size(), 1);
+    auto demand = resource_load_by_shape.resource_demands()[0];
+    ASSERT_EQ(demand.num_ready_requests_queued(), 1);
+    ASSERT_EQ(demand.shape().at("CPU"), 4);
+  }
+
+  // The task blocked on its argument keeps its share of the gang's resources.
+  task_manager_.QueueAndScheduleTask(
+      create_gang_task("local", 0), false, false, &replies[1], callback);
+  pool_.TriggerCallbacks();
+  ASSERT_EQ(num_callbacks, 1);
+  ASSERT_EQ(leased_workers_.size(), 1);
+  ASSERT_EQ(scheduler_->GetLocalResourceManager().GetLocalAvailableCpus(), 0.0);
+
+  // Canceling it releases them.
+  ASSERT_TRUE(task_manager_.CancelTask(blocked_task.GetTaskSpecification().TaskId()));
+  ASSERT_EQ(num_callbacks, 2);
+  ASSERT_EQ(scheduler_->GetLocalResourceManager().GetLocalAvailableCpus(), 4.0);
+
+  pool_.PushWorker(std::static_pointer_cast<WorkerInterface>(
+      std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234)));
+  task_manager_.QueueAndScheduleTask(
+      create_gang_task("spilled", 0), true, false, &replies[2], callback);
+  pool_.TriggerCallbacks();
+  ASSERT_EQ(num_callbacks, 3);
+  ASSERT_EQ(leased_workers_.size(), 2);
+  ASSERT_FALSE(replies[2].rejected());
+
+  for (auto &entry : leased_workers_) {
+    RayTask finished_task;
+    local_task_manager_->TaskFinished(entry.second, &finished_task);
+  }
+  missing_objects_.clear();
+  AssertNoLeaks();
+  ASSERT_EQ(scheduler_->GetLocalResourceManager().GetLocalAvailableCpus(), 8.0);
+}
+
+TEST_F(ClusterTaskManagerPreemptionTest, TaskPriorityTest) {
+  /*
+    Test that higher priority tasks are dispatched first, and that the workers of
+    lower priority tasks are preempted to make room for them, unless they have no
+    retries left.
+   */
+  auto create_task = [](double num_cpus, int32_t priority, int32_t max_retries = 3) {
+    rpc::TaskSpec message = CreateTask({{ray::kCPU_ResourceLabel, num_cpus}})
+                                .GetTaskSpecification()
+                                .GetMessage();
+    message.set_priority(priority);
+    message.set_max_retries(max_retries);
+    // Rebuild the spec so that the priority is part of the scheduling class.
+    return RayTask(TaskSpecification(message));
+  };
+  std::vector<bool> callback_occurred(3, false);
+  std::vector<rpc::RequestWorkerLeaseReply> replies(3);
+  auto make_callback = [&callback_occurred](size_t i) {
+    return [&callback_occurred, i](Status, std::function<void()>, std::function<void()>) {
+      callback_occurred[i] = true;
+    };
+  };
+  for (int i = 0; i < 3; i++) {
+    pool_.PushWorker(std::static_pointer_cast<WorkerInterface>(
+        std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234)));
+  }
+
+  task_manager_.QueueAndScheduleTask(
+      create_task(8, 0), false, false, &replies[0], make_callback(0));
+  pool_.TriggerCallbacks();
+  ASSERT_TRUE(callback_occurred[0]);
+  ASSERT_EQ(leased_workers_.size(), 1);
+  auto low_priority_worker = leased_workers_.begin()->second;
+
+  // A task of the same priority waits for the running one.
+  task_manager_.QueueAndScheduleTask(
+      create_task(8, 0), false, false, &replies[1], make_callback(1));
+  pool_.TriggerCallbacks();
+  ASSERT_FALSE(callback_occurred[1]);
+  ASSERT_TRUE(preempted_workers_.empty());
+
+  // A higher priority task preempts the running one, and only once.
+  task_manager_.QueueAndScheduleTask(
+      create_task(8, 1), false, false, &replies[2], make_callback(2));
+  pool_.TriggerCallbacks();
+  ASSERT_FALSE(callback_occurred[2]);
+  ASSERT_EQ(preempted_workers_.size(), 1);
+  ASSERT_EQ(preempted_workers_[0], low_priority_worker);
+  task_manager_.ScheduleAndDispatchTasks();
+  ASSERT_EQ(preempted_workers_.size(), 1);
+
+  // The preempted worker dies and returns its resources. The higher priority task
+  // is dispatched first, even though it was queued last.
+  RayTask finished_task;
+  local_task_manager_->TaskFinished(low_priority_worker, &finished_task);
+  leased_workers_.clear();
+  task_manager_.ScheduleAndDispatchTasks();
+  pool_.TriggerCallbacks();
+  ASSERT_TRUE(callback_occurred[2]);
+  ASSERT_FALSE(callback_occurred[1]);
+
+  // The task of the lower priority doesn't preempt it.
+  task_manager_.ScheduleAndDispatchTasks();
+  ASSERT_EQ(preempted_workers_.size(), 1);
+
+  local_task_manager_->TaskFinished(leased_workers_.begin()->second, &finished_task);
+  leased_workers_.clear();
+  task_manager_.ScheduleAndDispatchTasks();
+  pool_.TriggerCallbacks();
+  ASSERT_TRUE(callback_occurred[1]);
+
+  local_task_manager_->TaskFinished(leased_workers_.begin()->second, &finished_task);
+  leased_workers_.clear();
+
+  // Tasks that would fail if preempted keep running.
+  preempted_workers_.clear();
+  std::vector<bool> last_callback_occurred(3, false);
+  std::vector<rpc::RequestWorkerLeaseReply> last_replies(3);
+  auto last_callback = [&last_callback_occurred](size_t i) {
+    return [&last_callback_occurred, i](
+               Status, std::function<void()>, std::function<void()>) {
+      last_callback_occurred[i] = true;
+    };
+  };
+  for (int i = 0; i < 2; i++) {
+    pool_.PushWorker(std::static_pointer_cast<WorkerInterface>(
+        std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234)));
+  }
+  task_manager_.QueueAndScheduleTask(create_task(4, 0, /*max_retries=*/0),
+                                     false,
+                                     false,
+                                     &last_replies[0],
+                                     last_callback(0));
+  rpc::TaskSpec retried_message =
+      create_task(4, 0, /*max_retries=*/1).GetTaskSpecification().GetMessage();
+  retried_message.set_attempt_number(1);
+  task_manager_.QueueAndScheduleTask(RayTask(TaskSpecification(retried_message)),
+                                     false,
+                                     false,
+                                     &last_replies[1],
+                                     last_callback(1));
+  pool_.TriggerCallbacks();
+  ASSERT_TRUE(last_callback_occurred[0]);
+  ASSERT_TRUE(last_callback_occurred[1]);
+  task_manager_.QueueAndScheduleTask(
+      create_task(8, 1), false, false, &last_replies[2], last_callback(2));
+  pool_.TriggerCallbacks();
+  ASSERT_FALSE(last_callback_occurred[2]);
+  ASSERT_TRUE(preempted_workers_.empty());
+
+  for (auto &entry : leased_workers_) {
+    local_task_manager_->TaskFinished(entry.second, &finished_task);
+  }
+  leased_workers_.clear();
+  task_manager_.ScheduleAndDispatchTasks();
+  pool_.TriggerCallbacks();
+  ASSERT_TRUE(last_callback_occurred[2]);
+  local_task_manager_->TaskFinished(leased_workers_.begin()->second, &finished_task);
+  AssertNoLeaks();
+}
+
+TEST_F(ClusterTaskManagerTest, WorkStealingTest) {
+  /*
+    Test that an idle node can steal the queued tasks that wait for local
+    resources, as long as they fit in the resources it offers.
+   */
+  int num_callbacks = 0;
+  auto callback = [&](Status, std::function<void()>, std::function<void()>) {
+    num_callbacks++;
+  };
+  pool_.PushWorker(std::static_pointer_cast<WorkerInterface>(
+      std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234)));
+
+  rpc::RequestWorkerLeaseReply running_reply;
+  task_manager_.QueueAndScheduleTask(
+      CreateTask({{ray::kCPU_ResourceLabel, 8}}), false, false, &running_reply, callback);
+  pool_.TriggerCallbacks();
+  ASSERT_EQ(num_callbacks, 1);
+
+  rpc::RequestWorkerLeaseReply queued_reply;
+  task_manager_.QueueAndScheduleTask(
+      CreateTask({{ray::kCPU_ResourceLabel, 8}}), false, false, &queued_reply, callback);
+  pool_.TriggerCallbacks();
+  ASSERT_EQ(num_callbacks, 1);
+
+  auto remote_node_id = NodeID::FromRandom();
+  AddNode(remote_node_id, 8);
+  // The task doesn't fit in the resources offered.
+  ASSERT_EQ(local_task_manager_->StealTasks(
+                remote_node_id, {{ray::kCPU_ResourceLabel, 4}}, /*max_tasks=*/10),
+            0);
+  ASSERT_EQ(num_callbacks, 1);
+  ASSERT_EQ(local_task_manager_->StealTasks(
+                remote_node_id, {{ray::kCPU_ResourceLabel, 8}}, /*max_tasks=*/10),
+            1);
+  ASSERT_EQ(num_callbacks, 2);
+  ASSERT_EQ(queued_reply.retry_at_raylet_address().raylet_id(), remote_node_id.Binary());
+
+  RayTask finished_task;
+  local_task_manager_->TaskFinished(leased_workers_.begin()->second, &finished_task);
+  AssertNoLeaks();
+}
+
+TEST_F(ClusterTaskManagerLeaseFastPathTest, LeaseFastPathTest) {
+  /*
+    Test that a lease request is granted to an idle worker without being queued, and
+    that it is queued as usual when there is no idle worker for it.
+   */
+  std::vector<bool> callback_occurred(2, false);
+  std::vector<rpc::RequestWorkerLeaseReply> replies(2);
+  auto make_callback = [&callback_occurred](size_t i) {
+    return [&callback_occurred, i](Status, std::function<void()>, std::function<void()>) {
+      callback_occurred[i] = true;
+    };
+  };
+  pool_.PushWorker(std::static_pointer_cast<WorkerInterface>(
+      std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234)));
+
+  task_manager_.QueueAndScheduleTask(CreateTask({{ray::kCPU_ResourceLabel, 1}}),
+                                     false,
+                                     false,
+                                     &replies[0],
+                                     make_callback(0));
+  ASSERT_TRUE(task_manager_.tasks_to_schedule_.empty());
+  ASSERT_EQ(pool_.num_pops, 1);
+  pool_.TriggerCallbacks();
+  ASSERT_TRUE(callback_occurred[0]);
+  ASSERT_EQ(leased_workers_.size(), 1);
+
+  // No idle worker is left, so the next request goes through the scheduling queues.
+  task_manager_.QueueAndScheduleTask(CreateTask({{ray::kCPU_ResourceLabel, 1}}),
+                                     false,
+                                     false,
+                                     &replies[1],
+                                     make_callback(1));
+  ASSERT_FALSE(callback_occurred[1]);
+  ASSERT_EQ(pool_.num_pops, 2);
+  pool_.PushWorker(std::static_pointer_cast<WorkerInterface>(
+      std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234)));
+  pool_.TriggerCallbacks();
+  ASSERT_TRUE(callback_occurred[1]);
+  ASSERT_EQ(leased_workers_.size(), 2);
+
+  const std::string debug_str = task_manager_.DebugStr();
+  ASSERT_NE(debug_str.find("num_lease_fast_path_hits: 1\n"), std::string::npos);
+  ASSERT_NE(debug_str.find("num_lease_fast_path_misses: 1\n"), std::string::npos);
+
+  RayTask finished_task;
+  for (const auto &entry : leased_workers_) {
+    local_task_manager_->TaskFinished(entry.second, &finished_task);
+  }
+  AssertNoLeaks();
+}
+
 TEST_F(ClusterTaskManagerTest, NotOKPopWorkerTest) {
   RayTask task1 = CreateTask({{ray::kCPU_ResourceLabel, 1}});
   rpc::RequestWorkerLeaseReply reply;
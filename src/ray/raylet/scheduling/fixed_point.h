@@ -17,22 +17,68 @@
 #include <cmath>
 #include <cstdint>
 #include <iostream>
+#include <limits>
 #include <vector>
 
 #define RESOURCE_UNIT_SCALING 10000
 
 /// Fixed point data type.
+///
+/// Values are stored as an integer number of 1/RESOURCE_UNIT_SCALING units.
+/// Integers are converted without going through floating point, and additions
+/// and subtractions saturate at the bounds of the representation instead of
+/// overflowing. None of the arithmetic or comparison operators branch.
 class FixedPoint {
  private:
   int64_t i_ = 0;
 
+  /// Add two raw values, saturating on overflow.
+  static constexpr int64_t SaturatingAdd(int64_t a, int64_t b) {
+    int64_t res = 0;
+    bool overflow = __builtin_add_overflow(a, b, &res);
+    // Overflow only happens when both operands have the sign of `a`, and then the
+    // result saturates to the bound of that sign.
+    int64_t bound = (a >> 63) ^ std::numeric_limits<int64_t>::max();
+    return overflow ? bound : res;
+  }
+
+  /// Subtract two raw values, saturating on overflow.
+  static constexpr int64_t SaturatingSub(int64_t a, int64_t b) {
+    int64_t res = 0;
+    bool overflow = __builtin_sub_overflow(a, b, &res);
+    int64_t bound = (a >> 63) ^ std::numeric_limits<int64_t>::max();
+    return overflow ? bound : res;
+  }
+
+  /// Scale an integer to a raw value, saturating on overflow.
+  static constexpr int64_t SaturatingScale(int64_t i) {
+    int64_t res = 0;
+    bool overflow = __builtin_mul_overflow(i, int64_t{RESOURCE_UNIT_SCALING}, &res);
+    int64_t bound = (i >> 63) ^ std::numeric_limits<int64_t>::max();
+    return overflow ? bound : res;
+  }
+
  public:
-  FixedPoint() : FixedPoint(0.0) {}
-  FixedPoint(double d) { i_ = (int64_t)(d * RESOURCE_UNIT_SCALING); }  // NOLINT
+  constexpr FixedPoint() = default;
+  constexpr FixedPoint(double d)  // NOLINT
+      : i_(static_cast<int64_t>(d * RESOURCE_UNIT_SCALING)) {}
 
-  FixedPoint(int i) { i_ = (i * RESOURCE_UNIT_SCALING); }  // NOLINT
+  constexpr FixedPoint(int i)  // NOLINT
+      : i_(static_cast<int64_t>(i) * RESOURCE_UNIT_SCALING) {}
 
-  FixedPoint(int64_t i) : FixedPoint((double)i) {}  // NOLINT
+  constexpr FixedPoint(int64_t i) : i_(SaturatingScale(i)) {}  // NOLINT
+
+  /// Construct a FixedPoint from its raw representation, i.e. the number of
+  /// 1/RESOURCE_UNIT_SCALING units.
+  static constexpr FixedPoint FromRaw(int64_t raw) {
+    FixedPoint res;
+    res.i_ = raw;
+    return res;
+  }
+
+  /// Return the raw representation, i.e. the number of 1/RESOURCE_UNIT_SCALING
+  /// units.
+  [[nodiscard]] constexpr int64_t Raw() const { return i_; }
 
   static FixedPoint Sum(const std::vector<FixedPoint> &list) {
     FixedPoint sum;
@@ -42,69 +88,58 @@ class FixedPoint {
     return sum;
   }
 
-  FixedPoint operator+(FixedPoint const &ru) const {
-    FixedPoint res;
-    res.i_ = i_ + ru.i_;
-    return res;
+  constexpr FixedPoint operator+(FixedPoint const &ru) const {
+    return FromRaw(SaturatingAdd(i_, ru.i_));
   }
 
-  FixedPoint &operator+=(FixedPoint const &ru) {
-    i_ += ru.i_;
+  constexpr FixedPoint &operator+=(FixedPoint const &ru) {
+    i_ = SaturatingAdd(i_, ru.i_);
     return *this;
   }
 
-  FixedPoint operator-(FixedPoint const &ru) const {
-    FixedPoint res;
-    res.i_ = i_ - ru.i_;
-    return res;
+  constexpr FixedPoint operator-(FixedPoint const &ru) const {
+    return FromRaw(SaturatingSub(i_, ru.i_));
   }
 
-  FixedPoint &operator-=(FixedPoint const &ru) {
-    i_ -= ru.i_;
+  constexpr FixedPoint &operator-=(FixedPoint const &ru) {
+    i_ = SaturatingSub(i_, ru.i_);
     return *this;
   }
 
-  FixedPoint operator-() const {
-    FixedPoint res;
-    res.i_ = -i_;
-    return res;
-  }
+  constexpr FixedPoint operator-() const { return FromRaw(SaturatingSub(0, i_)); }
 
-  FixedPoint operator+(double const d) const {
-    FixedPoint res;
-    res.i_ = i_ + static_cast<int64_t>(d * RESOURCE_UNIT_SCALING);
-    return res;
-  }
+  constexpr FixedPoint operator+(double const d) const { return *this + FixedPoint(d); }
 
-  FixedPoint operator-(double const d) const {
-    FixedPoint res;
-    res.i_ = i_ - static_cast<int64_t>(d * RESOURCE_UNIT_SCALING);
-    return res;
-  }
+  constexpr FixedPoint operator-(double const d) const { return *this - FixedPoint(d); }
 
-  FixedPoint operator=(double const d) {
-    i_ = static_cast<int64_t>(d * RESOURCE_UNIT_SCALING);
+  constexpr FixedPoint operator=(double const d) {
+    i_ = FixedPoint(d).i_;
     return *this;
   }
 
-  FixedPoint operator+=(double const d) {
-    i_ += static_cast<int64_t>(d * RESOURCE_UNIT_SCALING);
+  constexpr FixedPoint operator+=(double const d) {
+    *this += FixedPoint(d);
     return *this;
   }
 
-  FixedPoint operator+=(int64_t const ru) {
-    *this += static_cast<double>(ru);
+  constexpr FixedPoint operator+=(int64_t const ru) {
+    *this += FixedPoint(ru);
     return *this;
   }
 
-  bool operator<(FixedPoint const &ru1) const { return (i_ < ru1.i_); };
-  bool operator>(FixedPoint const &ru1) const { return (i_ > ru1.i_); };
-  bool operator<=(FixedPoint const &ru1) const { return (i_ <= ru1.i_); };
-  bool operator>=(FixedPoint const &ru1) const { return (i_ >= ru1.i_); };
-  bool operator==(FixedPoint const &ru1) const { return (i_ == ru1.i_); };
-  bool operator!=(FixedPoint const &ru1) const { return (i_ != ru1.i_); };
+  constexpr bool operator<(FixedPoint const &ru1) const { return (i_ < ru1.i_); };
+  constexpr bool operator>(FixedPoint const &ru1) const { return (i_ > ru1.i_); };
+  constexpr bool operator<=(FixedPoint const &ru1) const { return (i_ <= ru1.i_); };
+  constexpr bool operator>=(FixedPoint const &ru1) const { return (i_ >= ru1.i_); };
+  constexpr bool operator==(FixedPoint const &ru1) const { return (i_ == ru1.i_); };
+  constexpr bool operator!=(FixedPoint const &ru1) const { return (i_ != ru1.i_); };
+
+  /// Return the integer part, rounded toward zero.
+  [[nodiscard]] constexpr int64_t Truncate() const { return i_ / RESOURCE_UNIT_SCALING; }
 
-  [[nodiscard]] double Double() const { return round(i_) / RESOURCE_UNIT_SCALING; };
+  [[nodiscard]] constexpr double Double() const {
+    return static_cast<double>(i_) / RESOURCE_UNIT_SCALING;
+  };
 
   friend std::ostream &operator<<(std::ostream &out, FixedPoint const &ru1);
 };
@@ -0,0 +1,110 @@
+// Copyright 2023 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Microbenchmark of the FixedPoint conversions and arithmetic the scheduler runs
+// when it updates and compares node resources.
+//
+// Usage: fixed_point_bench [num_values] [num_rounds]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ray/raylet/scheduling/fixed_point.h"
+
+namespace ray {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// The integer conversion FixedPoint used to do through floating point, kept as a
+/// baseline.
+int64_t LegacyFromInt64(int64_t i) {
+  return static_cast<int64_t>(static_cast<double>(i) * RESOURCE_UNIT_SCALING);
+}
+
+template <typename Fn>
+void Report(const std::string &name, size_t num_ops, Fn fn) {
+  auto start = Clock::now();
+  int64_t checksum = fn();
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start)
+                .count();
+  std::cout << name << ": " << static_cast<double>(ns) / num_ops << " ns/op, checksum "
+            << checksum << std::endl;
+}
+
+void Run(size_t num_values, size_t num_rounds) {
+  std::mt19937_64 gen(0);
+  std::uniform_int_distribution<int64_t> ints(0, 1 << 20);
+  std::vector<int64_t> values;
+  std::vector<FixedPoint> fixed_points;
+  for (size_t i = 0; i < num_values; i++) {
+    values.push_back(ints(gen));
+    fixed_points.push_back(FixedPoint::FromRaw(ints(gen)));
+  }
+
+  const size_t num_ops = num_rounds * num_values;
+  std::cout << num_ops << " ops" << std::endl;
+  Report("int64 conversion through double (baseline)", num_ops, [&]() {
+    int64_t sum = 0;
+    for (size_t round = 0; round < num_rounds; round++) {
+      for (auto value : values) {
+        sum += LegacyFromInt64(value + round);
+      }
+    }
+    return sum;
+  });
+  Report("FixedPoint(int64_t)", num_ops, [&]() {
+    int64_t sum = 0;
+    for (size_t round = 0; round < num_rounds; round++) {
+      for (auto value : values) {
+        sum += FixedPoint(static_cast<int64_t>(value + round)).Raw();
+      }
+    }
+    return sum;
+  });
+  Report("FixedPoint saturating add/sub", num_ops, [&]() {
+    FixedPoint available;
+    for (size_t round = 0; round < num_rounds; round++) {
+      for (const auto &value : fixed_points) {
+        available += value;
+        available -= FixedPoint::FromRaw(value.Raw() / 2);
+      }
+    }
+    return available.Raw();
+  });
+  Report("FixedPoint comparison", num_ops, [&]() {
+    int64_t matches = 0;
+    auto threshold = FixedPoint::FromRaw(1 << 19);
+    for (size_t round = 0; round < num_rounds; round++) {
+      for (const auto &value : fixed_points) {
+        matches += value <= threshold;
+      }
+    }
+    return matches;
+  });
+}
+
+}  // namespace
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  size_t num_values = argc > 1 ? std::atoi(argv[1]) : 10000;
+  size_t num_rounds = argc > 2 ? std::atoi(argv[2]) : 1000;
+  ray::Run(num_values, num_rounds);
+  return 0;
+}
@@ -0,0 +1,104 @@
+// Copyright 2023 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/scheduling/fixed_point.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+namespace {
+
+/// The conversions FixedPoint used to do through floating point.
+int64_t LegacyFromDouble(double d) { return (int64_t)(d * RESOURCE_UNIT_SCALING); }
+int64_t LegacyFromInt64(int64_t i) { return LegacyFromDouble((double)i); }
+double LegacyToDouble(int64_t raw) { return round(raw) / RESOURCE_UNIT_SCALING; }
+
+constexpr int64_t kMax = std::numeric_limits<int64_t>::max();
+constexpr int64_t kMin = std::numeric_limits<int64_t>::min();
+
+}  // namespace
+
+static_assert(FixedPoint(2).Raw() == 2 * RESOURCE_UNIT_SCALING);
+static_assert(FixedPoint(int64_t{3}).Raw() == 3 * RESOURCE_UNIT_SCALING);
+static_assert(FixedPoint(0.5).Raw() == RESOURCE_UNIT_SCALING / 2);
+static_assert(FixedPoint(1) + FixedPoint(0.5) == FixedPoint(1.5));
+static_assert(FixedPoint::FromRaw(25000).Truncate() == 2);
+
+TEST(FixedPointTest, ConversionsMatchLegacyBehavior) {
+  std::mt19937_64 gen(0);
+  // Integers whose scaled value is exactly representable as a double.
+  std::uniform_int_distribution<int64_t> ints(-(int64_t{1} << 39), int64_t{1} << 39);
+  std::uniform_real_distribution<double> doubles(-1e6, 1e6);
+  for (int i = 0; i < 100000; i++) {
+    int64_t value = ints(gen);
+    ASSERT_EQ(FixedPoint(value).Raw(), LegacyFromInt64(value)) << value;
+    ASSERT_EQ(FixedPoint(value).Double(), LegacyToDouble(FixedPoint(value).Raw()));
+
+    double d = doubles(gen);
+    ASSERT_EQ(FixedPoint(d).Raw(), LegacyFromDouble(d)) << d;
+    ASSERT_EQ(FixedPoint(d).Double(), LegacyToDouble(LegacyFromDouble(d))) << d;
+  }
+  for (int value : {0, 1, -1, std::numeric_limits<int>::max(),
+                    std::numeric_limits<int>::min()}) {
+    ASSERT_EQ(FixedPoint(value).Raw(), LegacyFromInt64(value)) << value;
+  }
+  for (double d : {0.0, 0.0001, 0.00015, 0.1, 0.3, 1.0 / 3, 2.9999, -0.7}) {
+    ASSERT_EQ(FixedPoint(d).Raw(), LegacyFromDouble(d)) << d;
+  }
+}
+
+TEST(FixedPointTest, ArithmeticMatchesLegacyBehavior) {
+  std::mt19937_64 gen(0);
+  std::uniform_real_distribution<double> doubles(-1e6, 1e6);
+  for (int i = 0; i < 100000; i++) {
+    double a = doubles(gen);
+    double b = doubles(gen);
+    int64_t raw_a = LegacyFromDouble(a);
+    int64_t raw_b = LegacyFromDouble(b);
+    ASSERT_EQ((FixedPoint(a) + FixedPoint(b)).Raw(), raw_a + raw_b);
+    ASSERT_EQ((FixedPoint(a) - FixedPoint(b)).Raw(), raw_a - raw_b);
+    ASSERT_EQ((FixedPoint(a) + b).Raw(), raw_a + LegacyFromDouble(b));
+    ASSERT_EQ((FixedPoint(a) - b).Raw(), raw_a - LegacyFromDouble(b));
+    ASSERT_EQ((-FixedPoint(a)).Raw(), -raw_a);
+    ASSERT_EQ(FixedPoint(a) < FixedPoint(b), raw_a < raw_b);
+  }
+}
+
+TEST(FixedPointTest, Saturation) {
+  auto max = FixedPoint::FromRaw(kMax);
+  auto min = FixedPoint::FromRaw(kMin);
+  ASSERT_EQ((max + FixedPoint(1)).Raw(), kMax);
+  ASSERT_EQ((max - FixedPoint(-1)).Raw(), kMax);
+  ASSERT_EQ((min - FixedPoint(1)).Raw(), kMin);
+  ASSERT_EQ((min + FixedPoint(-1)).Raw(), kMin);
+  ASSERT_EQ((-min).Raw(), kMax);
+  ASSERT_EQ((max + min).Raw(), -1);
+
+  FixedPoint sum = max;
+  sum += FixedPoint(1);
+  ASSERT_EQ(sum.Raw(), kMax);
+  sum -= max;
+  ASSERT_EQ(sum.Raw(), 0);
+
+  ASSERT_EQ(FixedPoint(kMax).Raw(), kMax);
+  ASSERT_EQ(FixedPoint(kMin).Raw(), kMin);
+  ASSERT_EQ(FixedPoint::Sum({max, max, FixedPoint(1)}).Raw(), kMax);
+}
+
+}  // namespace ray
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <optional>
+
 #include "ray/common/ray_object.h"
 #include "ray/common/task/task.h"
 #include "ray/common/task/task_common.h"
@@ -103,6 +105,17 @@ class Work {
       UnscheduledWorkCause::WAITING_FOR_RESOURCE_ACQUISITION;
 };
 
+/// The tasks of a gang, queued until all of them arrived and there are resources
+/// for all of them.
+struct Gang {
+  std::vector<std::shared_ptr<Work>> works;
+  /// The version of the cluster resource view when the gang last couldn't be
+  /// placed, unset if its tasks changed since then.
+  std::optional<uint64_t> unschedulable_version;
+  /// Whether the gang was announced as infeasible.
+  bool announced_infeasible = false;
+};
+
 typedef std::function<const rpc::GcsNodeInfo *(const NodeID &node_id)> NodeInfoGetter;
 
 }  // namespace internal
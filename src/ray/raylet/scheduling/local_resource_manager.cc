@@ -61,7 +61,7 @@ std::string LocalResourceManager::DebugString(void) const {
 }
 
 uint64_t LocalResourceManager::GetNumCpus() const {
-  return static_cast<uint64_t>(local_resources_.total.Sum(ResourceID::CPU()).Double());
+  return static_cast<uint64_t>(local_resources_.total.Sum(ResourceID::CPU()).Truncate());
 }
 
 std::vector<FixedPoint> LocalResourceManager::AddAvailableResourceInstances(
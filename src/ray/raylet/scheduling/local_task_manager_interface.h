@@ -37,6 +37,15 @@ class ILocalTaskManager {
   // Schedule and dispatch tasks.
   virtual void ScheduleAndDispatchTasks() = 0;
 
+  /// Grant the lease of a task without arguments to an idle worker right away, if
+  /// one can run it and the local node has the resources for it.
+  ///
+  /// \param work: The lease request of the task.
+  ///
+  /// \return True if the task was given to the worker pool. Otherwise the task
+  /// was left untouched and must be queued.
+  virtual bool TryDispatchToIdleWorker(std::shared_ptr<internal::Work> work) = 0;
+
   /// Attempt to cancel an already queued task.
   ///
   /// \param task_id: The id of the task to remove.
@@ -88,6 +97,10 @@ class NoopLocalTaskManager : public ILocalTaskManager {
   // Schedule and dispatch tasks.
   void ScheduleAndDispatchTasks() override {}
 
+  bool TryDispatchToIdleWorker(std::shared_ptr<internal::Work> work) override {
+    return false;
+  }
+
   /// Attempt to cancel an already queued task.
   ///
   /// \param task_id: The id of the task to remove.
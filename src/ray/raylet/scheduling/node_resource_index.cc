@@ -0,0 +1,185 @@
+// Copyright 2023 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/scheduling/node_resource_index.h"
+
+#include <algorithm>
+
+namespace ray {
+
+namespace {
+
+/// CPU, memory and object store memory are on almost every node, so the lists of
+/// nodes having them wouldn't narrow down the candidates.
+bool IsIndexedResource(scheduling::ResourceID resource_id) {
+  return resource_id != ResourceID::CPU() && resource_id != ResourceID::Memory() &&
+         resource_id != ResourceID::ObjectStoreMemory();
+}
+
+}  // namespace
+
+int NodeResourceIndex::CpuBucket(const FixedPoint &cpus) {
+  if (cpus < 1) {
+    return 0;
+  }
+  // 1 + floor(log2(cpus)), computed on the integer part of cpus.
+  uint64_t whole_cpus = static_cast<uint64_t>(cpus.Truncate());
+  int bucket = 64 - __builtin_clzll(whole_cpus);
+  return std::min(bucket, kNumCpuBuckets - 1);
+}
+
+void NodeResourceIndex::AddOrUpdateNode(scheduling::NodeID node_id,
+                                        const NodeResources &resources) {
+  IndexedNode indexed;
+  for (auto &resource_id : resources.total.ResourceIds()) {
+    if (IsIndexedResource(resource_id) && resources.total.Get(resource_id) > 0) {
+      indexed.resources.push_back(resource_id);
+    }
+  }
+  indexed.cpu_bucket = CpuBucket(resources.available.Get(ResourceID::CPU()));
+
+  auto it = nodes_.find(node_id);
+  if (it == nodes_.end()) {
+    for (auto &resource_id : indexed.resources) {
+      nodes_by_resource_[resource_id].insert(node_id);
+    }
+    nodes_by_available_cpu_[indexed.cpu_bucket].insert(node_id);
+    nodes_.emplace(node_id, std::move(indexed));
+    sorted_nodes_dirty_ = true;
+    return;
+  }
+
+  // Most updates only change the available resources, so the lists of nodes by
+  // resource are only touched when the set of resources changes.
+  auto &current = it->second;
+  if (current.resources != indexed.resources) {
+    for (auto &resource_id : current.resources) {
+      auto resource_it = nodes_by_resource_.find(resource_id);
+      resource_it->second.erase(node_id);
+      if (resource_it->second.empty()) {
+        nodes_by_resource_.erase(resource_it);
+      }
+    }
+    for (auto &resource_id : indexed.resources) {
+      nodes_by_resource_[resource_id].insert(node_id);
+    }
+    current.resources = std::move(indexed.resources);
+  }
+  if (current.cpu_bucket != indexed.cpu_bucket) {
+    nodes_by_available_cpu_[current.cpu_bucket].erase(node_id);
+    nodes_by_available_cpu_[indexed.cpu_bucket].insert(node_id);
+    current.cpu_bucket = indexed.cpu_bucket;
+  }
+}
+
+void NodeResourceIndex::RemoveNode(scheduling::NodeID node_id) {
+  auto it = nodes_.find(node_id);
+  if (it == nodes_.end()) {
+    return;
+  }
+  for (auto &resource_id : it->second.resources) {
+    auto resource_it = nodes_by_resource_.find(resource_id);
+    resource_it->second.erase(node_id);
+    if (resource_it->second.empty()) {
+      nodes_by_resource_.erase(resource_it);
+    }
+  }
+  nodes_by_available_cpu_[it->second.cpu_bucket].erase(node_id);
+  nodes_.erase(it);
+  sorted_nodes_dirty_ = true;
+}
+
+const std::vector<scheduling::NodeID> &NodeResourceIndex::GetSortedNodes() const {
+  if (sorted_nodes_dirty_) {
+    sorted_nodes_.clear();
+    sorted_nodes_.reserve(nodes_.size());
+    for (const auto &entry : nodes_) {
+      sorted_nodes_.push_back(entry.first);
+    }
+    std::sort(sorted_nodes_.begin(), sorted_nodes_.end());
+    sorted_nodes_dirty_ = false;
+  }
+  return sorted_nodes_;
+}
+
+void NodeResourceIndex::GetCandidateNodes(
+    const ResourceRequest &resource_request,
+    bool require_available,
+    std::vector<scheduling::NodeID> *candidates) const {
+  candidates->clear();
+
+  // The nodes having each of the GPU and custom resources of the request.
+  std::vector<const absl::flat_hash_set<scheduling::NodeID> *> required;
+  for (auto &resource_id : resource_request.ResourceIds()) {
+    if (!IsIndexedResource(resource_id) || resource_request.Get(resource_id) <= 0) {
+      continue;
+    }
+    auto it = nodes_by_resource_.find(resource_id);
+    if (it == nodes_by_resource_.end()) {
+      // No node has the resource.
+      return;
+    }
+    required.push_back(&it->second);
+  }
+
+  int min_cpu_bucket = 0;
+  size_t num_cpu_candidates = nodes_.size();
+  if (require_available) {
+    min_cpu_bucket = CpuBucket(resource_request.Get(ResourceID::CPU()));
+    num_cpu_candidates = 0;
+    for (int bucket = min_cpu_bucket; bucket < kNumCpuBuckets; bucket++) {
+      num_cpu_candidates += nodes_by_available_cpu_[bucket].size();
+    }
+  }
+
+  if (required.empty() && min_cpu_bucket == 0) {
+    *candidates = GetSortedNodes();
+    return;
+  }
+
+  // Walk the smallest of the lists and check the nodes against the other ones.
+  const absl::flat_hash_set<scheduling::NodeID> *smallest = nullptr;
+  for (const auto *nodes : required) {
+    if (smallest == nullptr || nodes->size() < smallest->size()) {
+      smallest = nodes;
+    }
+  }
+  auto matches = [this, &required, min_cpu_bucket](scheduling::NodeID node_id) {
+    for (const auto *nodes : required) {
+      if (!nodes->contains(node_id)) {
+        return false;
+      }
+    }
+    return min_cpu_bucket == 0 || nodes_.at(node_id).cpu_bucket >= min_cpu_bucket;
+  };
+
+  if (smallest == nullptr || num_cpu_candidates < smallest->size()) {
+    for (int bucket = min_cpu_bucket; bucket < kNumCpuBuckets; bucket++) {
+      for (const auto &node_id : nodes_by_available_cpu_[bucket]) {
+        if (matches(node_id)) {
+          candidates->push_back(node_id);
+        }
+      }
+    }
+  } else {
+    for (const auto &node_id : *smallest) {
+      if (matches(node_id)) {
+        candidates->push_back(node_id);
+      }
+    }
+  }
+  std::sort(candidates->begin(), candidates->end());
+}
+
+}  // namespace ray
@@ -0,0 +1,94 @@
+// Copyright 2023 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "ray/raylet/scheduling/cluster_resource_data.h"
+#include "ray/raylet/scheduling/scheduling_ids.h"
+
+namespace ray {
+
+/// Index of the nodes of the cluster resource view, used by the scheduling policies
+/// to find the candidate nodes of a request without checking every node of a large
+/// cluster.
+///
+/// The index keeps
+///   * the ids of all the nodes, sorted,
+///   * for the GPU and every custom resource, the nodes with a positive total of it,
+///   * the nodes bucketed by the log2 of their available CPUs.
+/// It is updated incrementally by ClusterResourceManager whenever the resources of
+/// a node change, including the updates received from the other raylets.
+///
+/// The candidates of a request are a superset of the nodes where the request is
+/// feasible (or available), so the policies still run the exact checks on them.
+/// This class is not thread safe.
+class NodeResourceIndex {
+ public:
+  /// Index a new node or re-index an existing one after its resources changed.
+  void AddOrUpdateNode(scheduling::NodeID node_id, const NodeResources &resources);
+
+  /// Remove a node from the index. Does nothing if the node is not indexed.
+  void RemoveNode(scheduling::NodeID node_id);
+
+  /// The ids of all the indexed nodes in ascending order.
+  const std::vector<scheduling::NodeID> &GetSortedNodes() const;
+
+  /// Find the candidate nodes of a request.
+  ///
+  /// \param resource_request The resource request to schedule.
+  /// \param require_available Whether only the nodes where the request may be
+  /// available right now are needed. Otherwise the feasible nodes are returned.
+  /// \param candidates[out] In ascending order, a superset of the nodes where the
+  /// request is available (or feasible).
+  void GetCandidateNodes(const ResourceRequest &resource_request,
+                         bool require_available,
+                         std::vector<scheduling::NodeID> *candidates) const;
+
+  /// The number of indexed nodes.
+  size_t NumNodes() const { return nodes_.size(); }
+
+ private:
+  /// The number of available CPU buckets. The last bucket holds the nodes with at
+  /// least 2^(kNumCpuBuckets - 2) available CPUs.
+  static constexpr int kNumCpuBuckets = 16;
+
+  /// The bucket of a number of available CPUs. Bucket 0 holds the nodes with less
+  /// than 1 CPU, bucket b > 0 the nodes with [2^(b-1), 2^b) CPUs.
+  static int CpuBucket(const FixedPoint &cpus);
+
+  /// What is indexed for a node, to un-index it on the next update.
+  struct IndexedNode {
+    /// The GPU and custom resources with a positive total.
+    std::vector<scheduling::ResourceID> resources;
+    int cpu_bucket = 0;
+  };
+
+  absl::flat_hash_map<scheduling::NodeID, IndexedNode> nodes_;
+  absl::flat_hash_map<scheduling::ResourceID, absl::flat_hash_set<scheduling::NodeID>>
+      nodes_by_resource_;
+  std::array<absl::flat_hash_set<scheduling::NodeID>, kNumCpuBuckets>
+      nodes_by_available_cpu_;
+
+  /// Sorted lazily, since nodes are added in bursts and the order is read on every
+  /// scheduling decision.
+  mutable std::vector<scheduling::NodeID> sorted_nodes_;
+  mutable bool sorted_nodes_dirty_ = false;
+};
+
+}  // namespace ray
@@ -0,0 +1,161 @@
+// Copyright 2023 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/scheduling/node_resource_index.h"
+
+#include <algorithm>
+#include <random>
+
+#include "gtest/gtest.h"
+#include "ray/raylet/scheduling/cluster_resource_manager.h"
+
+namespace ray {
+
+using scheduling::NodeID;
+
+NodeResources CreateNodeResources(double available_cpu,
+                                  double total_cpu,
+                                  double available_gpu = 0,
+                                  double total_gpu = 0) {
+  NodeResources resources;
+  resources.available.Set(ResourceID::CPU(), available_cpu)
+      .Set(ResourceID::GPU(), available_gpu);
+  resources.total.Set(ResourceID::CPU(), total_cpu).Set(ResourceID::GPU(), total_gpu);
+  return resources;
+}
+
+TEST(NodeResourceIndexTest, TestCandidates) {
+  NodeResourceIndex index;
+  index.AddOrUpdateNode(NodeID(3), CreateNodeResources(8, 8));
+  index.AddOrUpdateNode(NodeID(1), CreateNodeResources(0, 8, 1, 1));
+  index.AddOrUpdateNode(NodeID(2), CreateNodeResources(2, 2));
+  ASSERT_EQ(index.GetSortedNodes(),
+            std::vector<NodeID>({NodeID(1), NodeID(2), NodeID(3)}));
+
+  std::vector<NodeID> candidates;
+  auto cpu_request = ResourceRequest({{ResourceID::CPU(), 4}});
+  index.GetCandidateNodes(cpu_request, /*require_available=*/false, &candidates);
+  ASSERT_EQ(candidates, index.GetSortedNodes());
+  // Only the node with 8 CPUs available can have 4 of them.
+  index.GetCandidateNodes(cpu_request, /*require_available=*/true, &candidates);
+  ASSERT_EQ(candidates, std::vector<NodeID>({NodeID(3)}));
+
+  auto gpu_request = ResourceRequest({{ResourceID::GPU(), 1}});
+  index.GetCandidateNodes(gpu_request, /*require_available=*/false, &candidates);
+  ASSERT_EQ(candidates, std::vector<NodeID>({NodeID(1)}));
+  auto gpu_and_cpu_request =
+      ResourceRequest({{ResourceID::CPU(), 1}, {ResourceID::GPU(), 1}});
+  index.GetCandidateNodes(gpu_and_cpu_request, /*require_available=*/true, &candidates);
+  ASSERT_TRUE(candidates.empty());
+
+  auto custom_request = ResourceRequest({{ResourceID("custom"), 1}});
+  index.GetCandidateNodes(custom_request, /*require_available=*/false, &candidates);
+  ASSERT_TRUE(candidates.empty());
+
+  // Resources are added and removed.
+  auto resources = CreateNodeResources(1, 2);
+  resources.total.Set(ResourceID("custom"), 1);
+  resources.available.Set(ResourceID("custom"), 1);
+  index.AddOrUpdateNode(NodeID(2), resources);
+  index.AddOrUpdateNode(NodeID(1), CreateNodeResources(8, 8));
+  index.GetCandidateNodes(custom_request, /*require_available=*/false, &candidates);
+  ASSERT_EQ(candidates, std::vector<NodeID>({NodeID(2)}));
+  index.GetCandidateNodes(gpu_request, /*require_available=*/false, &candidates);
+  ASSERT_TRUE(candidates.empty());
+  index.GetCandidateNodes(cpu_request, /*require_available=*/true, &candidates);
+  ASSERT_EQ(candidates, std::vector<NodeID>({NodeID(1), NodeID(3)}));
+
+  index.RemoveNode(NodeID(2));
+  index.RemoveNode(NodeID(2));
+  ASSERT_EQ(index.NumNodes(), 2);
+  ASSERT_EQ(index.GetSortedNodes(), std::vector<NodeID>({NodeID(1), NodeID(3)}));
+  index.GetCandidateNodes(custom_request, /*require_available=*/false, &candidates);
+  ASSERT_TRUE(candidates.empty());
+}
+
+// The candidates must stay a superset of the feasible and available nodes while the
+// cluster resource view is updated.
+TEST(NodeResourceIndexTest, TestConsistentWithResourceView) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> cpus(0, 64);
+  std::uniform_int_distribution<int> gpus(0, 2);
+  std::uniform_int_distribution<int> node_ids(0, 99);
+  std::uniform_int_distribution<int> ops(0, 5);
+  const std::vector<ResourceID> custom = {ResourceID("custom1"), ResourceID("custom2")};
+  std::vector<ResourceRequest> requests = {
+      ResourceRequest({{ResourceID::CPU(), 0.5}}),
+      ResourceRequest({{ResourceID::CPU(), 3}}),
+      ResourceRequest({{ResourceID::CPU(), 32}}),
+      ResourceRequest({{ResourceID::CPU(), 1}, {ResourceID::GPU(), 1}}),
+      ResourceRequest({{ResourceID::CPU(), 2}, {custom[0], 1}}),
+      ResourceRequest({{custom[0], 1}, {custom[1], 0.5}}),
+  };
+
+  ClusterResourceManager manager;
+  for (int i = 0; i < 2000; i++) {
+    NodeID node_id(node_ids(gen));
+    switch (ops(gen)) {
+    case 0:
+      // Adds the node if it doesn't exist.
+      manager.UpdateResourceCapacity(node_id, ResourceID::CPU(), cpus(gen));
+      manager.UpdateResourceCapacity(node_id, ResourceID::GPU(), gpus(gen));
+      manager.UpdateResourceCapacity(node_id, custom[i % 2], 1);
+      break;
+    case 1:
+      manager.RemoveNode(node_id);
+      break;
+    case 2:
+      manager.SubtractNodeAvailableResources(node_id, requests[i % requests.size()]);
+      break;
+    case 3:
+      manager.AddNodeAvailableResources(node_id, requests[i % requests.size()]);
+      break;
+    case 4:
+      manager.UpdateResourceCapacity(node_id, custom[i % 2], cpus(gen) % 2);
+      break;
+    default:
+      manager.DeleteResources(node_id, {ResourceID::GPU()});
+      break;
+    }
+
+    const auto &index = manager.GetNodeResourceIndex();
+    ASSERT_EQ(index.NumNodes(), manager.NumNodes());
+    std::vector<NodeID> candidates;
+    for (const auto &request : requests) {
+      for (bool require_available : {false, true}) {
+        index.GetCandidateNodes(request, require_available, &candidates);
+        ASSERT_TRUE(std::is_sorted(candidates.begin(), candidates.end()));
+        for (const auto &entry : manager.GetResourceView()) {
+          const auto &view = entry.second.GetLocalView();
+          bool expected = require_available
+                              ? view.IsAvailable(request, /*ignore_at_capacity=*/true)
+                              : view.IsFeasible(request);
+          if (expected) {
+            ASSERT_TRUE(std::binary_search(
+                candidates.begin(), candidates.end(), entry.first))
+                << "Node " << entry.first << " is missing for "
+                << request.DebugString();
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
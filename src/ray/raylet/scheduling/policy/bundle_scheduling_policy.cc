@@ -211,6 +211,7 @@ std::pair<scheduling::NodeID, const Node *> BundleSchedulingPolicy::GetBestNode(
   const Node *best_node = nullptr;
 
   // Score the nodes.
+  NodeScorer &node_scorer = options.node_scorer ? *options.node_scorer : *node_scorer_;
   for (const auto &[node_id, node] : candidate_nodes) {
     const auto &node_resources = node->GetLocalView();
     if (AllocationWillExceedMaxCpuFraction(
@@ -221,7 +222,7 @@ std::pair<scheduling::NodeID, const Node *> BundleSchedulingPolicy::GetBestNode(
       continue;
     }
 
-    double node_score = node_scorer_->Score(required_resources, node_resources);
+    double node_score = node_scorer.Score(required_resources, node_id, node_resources);
     if (best_node_id.IsNil() || best_node_score < node_score) {
       best_node_id = node_id;
       best_node_score = node_score;
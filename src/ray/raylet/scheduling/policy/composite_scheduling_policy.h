@@ -34,14 +34,18 @@ class CompositeSchedulingPolicy : public ISchedulingPolicy {
   CompositeSchedulingPolicy(scheduling::NodeID local_node_id,
                             ClusterResourceManager &cluster_resource_manager,
                             std::function<bool(scheduling::NodeID)> is_node_available)
-      : hybrid_policy_(
-            local_node_id, cluster_resource_manager.GetResourceView(), is_node_available),
+      : hybrid_policy_(local_node_id,
+                       cluster_resource_manager.GetResourceView(),
+                       cluster_resource_manager.GetNodeResourceIndex(),
+                       is_node_available),
         random_policy_(
             local_node_id, cluster_resource_manager.GetResourceView(), is_node_available),
         spread_policy_(
             local_node_id, cluster_resource_manager.GetResourceView(), is_node_available),
-        node_affinity_policy_(
-            local_node_id, cluster_resource_manager.GetResourceView(), is_node_available),
+        node_affinity_policy_(local_node_id,
+                              cluster_resource_manager.GetResourceView(),
+                              cluster_resource_manager.GetNodeResourceIndex(),
+                              is_node_available),
         affinity_with_bundle_policy_(local_node_id,
                                      cluster_resource_manager.GetResourceView(),
                                      is_node_available,
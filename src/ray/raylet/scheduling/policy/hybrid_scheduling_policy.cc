@@ -14,6 +14,7 @@
 
 #include "ray/raylet/scheduling/policy/hybrid_scheduling_policy.h"
 
+#include <algorithm>
 #include <functional>
 
 #include "ray/util/container_util.h"
@@ -28,12 +29,50 @@ scheduling::NodeID HybridSchedulingPolicy::HybridPolicyWithFilter(
     float spread_threshold,
     bool force_spillback,
     bool require_node_available,
-    NodeFilter node_filter) {
+    NodeFilter node_filter,
+    NodeScorer *node_scorer) {
+  // Available nodes are always preferred over the nodes where the task must be queued
+  // first, so try the nodes where the request may be available first, and fall back to
+  // all the feasible nodes only if none of them is.
+  std::vector<scheduling::NodeID> candidates;
+  node_index_.GetCandidateNodes(
+      resource_request, /*require_available=*/true, &candidates);
+  bool chosen_is_available = false;
+  auto best_node_id = HybridPolicyOnCandidates(candidates,
+                                               resource_request,
+                                               spread_threshold,
+                                               force_spillback,
+                                               require_node_available,
+                                               node_filter,
+                                               node_scorer,
+                                               &chosen_is_available);
+  if (chosen_is_available || require_node_available) {
+    return best_node_id;
+  }
+  node_index_.GetCandidateNodes(
+      resource_request, /*require_available=*/false, &candidates);
+  return HybridPolicyOnCandidates(candidates,
+                                  resource_request,
+                                  spread_threshold,
+                                  force_spillback,
+                                  require_node_available,
+                                  node_filter,
+                                  node_scorer,
+                                  &chosen_is_available);
+}
+
+scheduling::NodeID HybridSchedulingPolicy::HybridPolicyOnCandidates(
+    const std::vector<scheduling::NodeID> &candidates,
+    const ResourceRequest &resource_request,
+    float spread_threshold,
+    bool force_spillback,
+    bool require_node_available,
+    NodeFilter node_filter,
+    NodeScorer *node_scorer,
+    bool *chosen_is_available) {
   // Step 1: Generate the traversal order. We guarantee that the first node is local, to
   // encourage local scheduling. The rest of the traversal order should be globally
-  // consistent, to encourage using "warm" workers.
-  std::vector<scheduling::NodeID> round;
-  round.reserve(nodes_.size());
+  // consistent, to encourage using "warm" workers. The candidates are already sorted.
   const auto local_it = nodes_.find(local_node_id_);
   RAY_CHECK(local_it != nodes_.end());
   auto predicate = [this, node_filter](scheduling::NodeID node_id,
@@ -52,39 +91,14 @@ scheduling::NodeID HybridSchedulingPolicy::HybridPolicyWithFilter(
     return !has_gpu;
   };
 
-  const auto &local_node_view = local_it->second.GetLocalView();
-  // If we should include local node at all, make sure it is at the front of the list
-  // so that
-  // 1. It's first in traversal order.
-  // 2. It's easy to avoid sorting it.
-  if (predicate(local_node_id_, local_node_view) && !force_spillback) {
-    round.push_back(local_node_id_);
-  }
-
-  const auto start_index = round.size();
-  for (const auto &pair : nodes_) {
-    if (pair.first != local_node_id_ &&
-        predicate(pair.first, pair.second.GetLocalView())) {
-      round.push_back(pair.first);
-    }
-  }
-  // Sort all the nodes, making sure that if we added the local node in front, it stays in
-  // place.
-  std::sort(round.begin() + start_index, round.end());
-
   scheduling::NodeID best_node_id = scheduling::NodeID::Nil();
   float best_utilization_score = INFINITY;
   bool best_is_available = false;
 
   // Step 2: Perform the round robin.
-  auto round_it = round.begin();
-  for (; round_it != round.end(); round_it++) {
-    const auto &node_id = *round_it;
-    const auto &it = nodes_.find(node_id);
-    RAY_CHECK(it != nodes_.end());
-    const auto &node = it->second;
+  auto visit = [&](scheduling::NodeID node_id, const Node &node) {
     if (!node.GetLocalView().IsFeasible(resource_request)) {
-      continue;
+      return;
     }
 
     bool ignore_pull_manager_at_capacity = false;
@@ -108,6 +122,11 @@ scheduling::NodeID HybridSchedulingPolicy::HybridPolicyWithFilter(
     if (critical_resource_utilization < spread_threshold) {
       critical_resource_utilization = 0;
     }
+    if (node_scorer != nullptr && is_available) {
+      // Rank the available nodes by their score instead, the best score first.
+      critical_resource_utilization =
+          -node_scorer->Score(resource_request, node_id, node.GetLocalView());
+    }
 
     bool update_best_node = false;
 
@@ -131,8 +150,28 @@ scheduling::NodeID HybridSchedulingPolicy::HybridPolicyWithFilter(
       best_utilization_score = critical_resource_utilization;
       best_is_available = is_available;
     }
+  };
+
+  // If we should include local node at all, make sure it is first in traversal order.
+  const bool include_local = !force_spillback &&
+                             std::binary_search(
+                                 candidates.begin(), candidates.end(), local_node_id_) &&
+                             predicate(local_node_id_, local_it->second.GetLocalView());
+  if (include_local) {
+    visit(local_node_id_, local_it->second);
+  }
+  for (const auto &node_id : candidates) {
+    if (node_id == local_node_id_) {
+      continue;
+    }
+    const auto &it = nodes_.find(node_id);
+    RAY_CHECK(it != nodes_.end());
+    if (predicate(node_id, it->second.GetLocalView())) {
+      visit(node_id, it->second);
+    }
   }
 
+  *chosen_is_available = best_is_available;
   return best_node_id;
 }
 
@@ -140,11 +179,23 @@ scheduling::NodeID HybridSchedulingPolicy::Schedule(
     const ResourceRequest &resource_request, SchedulingOptions options) {
   RAY_CHECK(options.scheduling_type == SchedulingType::HYBRID)
       << "HybridPolicy policy requires type = HYBRID";
+  std::shared_ptr<NodeScorer> node_scorer = options.node_scorer;
+  if (options.data_locality_weight > 0 && !options.arg_bytes_by_node.empty()) {
+    // Rank the nodes by the weighted sum of the node score and the data locality.
+    auto weighted_scorer = std::make_shared<WeightedScorer>();
+    weighted_scorer
+        ->Add(node_scorer ? node_scorer : std::make_shared<LeastResourceScorer>(), 1)
+        .Add(std::make_shared<DataLocalityScorer>(options.arg_bytes_by_node),
+             options.data_locality_weight);
+    node_scorer = std::move(weighted_scorer);
+  }
   if (!options.avoid_gpu_nodes || resource_request.Has(ResourceID::GPU())) {
     return HybridPolicyWithFilter(resource_request,
                                   options.spread_threshold,
                                   options.avoid_local_node,
-                                  options.require_node_available);
+                                  options.require_node_available,
+                                  NodeFilter::kAny,
+                                  node_scorer.get());
   }
 
   // Try schedule on non-GPU nodes.
@@ -152,7 +203,8 @@ scheduling::NodeID HybridSchedulingPolicy::Schedule(
                                              options.spread_threshold,
                                              options.avoid_local_node,
                                              /*require_node_available*/ true,
-                                             NodeFilter::kNonGpu);
+                                             NodeFilter::kNonGpu,
+                                             node_scorer.get());
   if (!best_node_id.IsNil()) {
     return best_node_id;
   }
@@ -162,7 +214,9 @@ scheduling::NodeID HybridSchedulingPolicy::Schedule(
   return HybridPolicyWithFilter(resource_request,
                                 options.spread_threshold,
                                 options.avoid_local_node,
-                                options.require_node_available);
+                                options.require_node_available,
+                                NodeFilter::kAny,
+                                node_scorer.get());
 }
 
 }  // namespace raylet_scheduling_policy
@@ -16,6 +16,7 @@
 
 #include <vector>
 
+#include "ray/raylet/scheduling/node_resource_index.h"
 #include "ray/raylet/scheduling/policy/scheduling_policy.h"
 
 namespace ray {
@@ -45,13 +46,19 @@ namespace raylet_scheduling_policy {
 /// We call this a hybrid policy because below the threshold, the traversal and
 /// truncation properties will lead to packing of nodes. Above the threshold, the policy
 /// will act like a traditional weighted round robin.
+///
+/// Only the candidate nodes found by the NodeResourceIndex are traversed, so the nodes
+/// where the request is infeasible (or unavailable, in the first pass) are skipped
+/// without being looked at.
 class HybridSchedulingPolicy : public ISchedulingPolicy {
  public:
   HybridSchedulingPolicy(scheduling::NodeID local_node_id,
                          const absl::flat_hash_map<scheduling::NodeID, Node> &nodes,
+                         const NodeResourceIndex &node_index,
                          std::function<bool(scheduling::NodeID)> is_node_available)
       : local_node_id_(local_node_id),
         nodes_(nodes),
+        node_index_(node_index),
         is_node_available_(is_node_available) {}
 
   scheduling::NodeID Schedule(const ResourceRequest &resource_request,
@@ -63,6 +70,8 @@ class HybridSchedulingPolicy : public ISchedulingPolicy {
   /// List of nodes in the clusters and their resources organized as a map.
   /// The key of the map is the node ID.
   const absl::flat_hash_map<scheduling::NodeID, Node> &nodes_;
+  /// Index of `nodes_`, to find the candidate nodes of a request.
+  const NodeResourceIndex &node_index_;
 
   /// Function Checks if node is alive.
   std::function<bool(scheduling::NodeID)> is_node_available_;
@@ -82,6 +91,8 @@ class HybridSchedulingPolicy : public ISchedulingPolicy {
   /// \param node_filter: defines the subset of nodes were are allowed to schedule on.
   /// can be one of kAny (can schedule on all nodes), kGPU (can only schedule on kGPU
   /// nodes), kNonGpu (can only schedule on non-GPU nodes.
+  /// \param node_scorer: if set, ranks the available nodes instead of their critical
+  /// resource utilization.
   ///
   /// \return -1 if the task is unfeasible, otherwise the node id (key in `nodes`) to
   /// schedule on.
@@ -89,7 +100,25 @@ class HybridSchedulingPolicy : public ISchedulingPolicy {
                                             float spread_threshold,
                                             bool force_spillback,
                                             bool require_available,
-                                            NodeFilter node_filter = NodeFilter::kAny);
+                                            NodeFilter node_filter = NodeFilter::kAny,
+                                            NodeScorer *node_scorer = nullptr);
+
+  /// Run the priority scheduler over the given candidate nodes, in ascending id order
+  /// with the local node first.
+  ///
+  /// \param candidates: The candidate nodes, sorted by id.
+  /// \param chosen_is_available[out]: Whether the request is available on the chosen
+  /// node.
+  /// \return NodeID::Nil() if the request is infeasible on all the candidates.
+  scheduling::NodeID HybridPolicyOnCandidates(
+      const std::vector<scheduling::NodeID> &candidates,
+      const ResourceRequest &resource_request,
+      float spread_threshold,
+      bool force_spillback,
+      bool require_available,
+      NodeFilter node_filter,
+      NodeScorer *node_scorer,
+      bool *chosen_is_available);
 };
 }  // namespace raylet_scheduling_policy
 }  // namespace ray
@@ -30,11 +30,12 @@ class NodeAffinitySchedulingPolicy : public ISchedulingPolicy {
  public:
   NodeAffinitySchedulingPolicy(scheduling::NodeID local_node_id,
                                const absl::flat_hash_map<scheduling::NodeID, Node> &nodes,
+                               const NodeResourceIndex &node_index,
                                std::function<bool(scheduling::NodeID)> is_node_alive)
       : local_node_id_(local_node_id),
         nodes_(nodes),
         is_node_alive_(is_node_alive),
-        hybrid_policy_(local_node_id_, nodes_, is_node_alive_) {}
+        hybrid_policy_(local_node_id_, nodes_, node_index, is_node_alive_) {}
 
   scheduling::NodeID Schedule(const ResourceRequest &resource_request,
                               SchedulingOptions options) override;
@@ -16,6 +16,7 @@
 
 #include "ray/common/ray_config.h"
 #include "ray/raylet/scheduling/policy/scheduling_context.h"
+#include "ray/raylet/scheduling/policy/scorer.h"
 
 namespace ray {
 namespace raylet {
@@ -151,6 +152,17 @@ struct SchedulingOptions {
   std::shared_ptr<SchedulingContext> scheduling_context;
   std::string node_affinity_node_id;
   bool node_affinity_soft = false;
+  // The scorer the hybrid and bundle scheduling policies rank the available nodes
+  // with. If it is not set, the hybrid policy ranks them by critical resource
+  // utilization and the bundle policies use the LeastResourceScorer.
+  std::shared_ptr<NodeScorer> node_scorer;
+  // The bytes of the arguments of the task already on each node, as known to the
+  // owner of the task.
+  absl::flat_hash_map<scheduling::NodeID, int64_t> arg_bytes_by_node;
+  // The weight of the data locality of the arguments when the hybrid policy ranks
+  // the available nodes, against a weight of 1 for the node scorer. Data locality is
+  // ignored if it is 0.
+  double data_locality_weight = 0;
 
  private:
   SchedulingOptions(SchedulingType type,
@@ -62,7 +62,10 @@ class SchedulingPolicyTest : public ::testing::Test {
   ClusterResourceManager MockClusterResourceManager(
       const absl::flat_hash_map<scheduling::NodeID, Node> &nodes) {
     ClusterResourceManager cluster_resource_manager;
-    cluster_resource_manager.nodes_ = nodes;
+    for (const auto &entry : nodes) {
+      cluster_resource_manager.AddOrUpdateNode(entry.first,
+                                               entry.second.GetLocalView());
+    }
     return cluster_resource_manager;
   }
 };
@@ -275,6 +278,39 @@ TEST_F(SchedulingPolicyTest, AvailableTieBreakTest) {
   ASSERT_EQ(to_schedule, remote_node);
 }
 
+TEST_F(SchedulingPolicyTest, DataLocalityTest) {
+  // In this test, both nodes are available and idle, but the remote node holds the
+  // arguments of the task, so we pick it once data locality is weighed.
+  ResourceRequest req = ResourceMapToResourceRequest({{"CPU", 1}}, false);
+  nodes.emplace(local_node, CreateNodeResources(2, 2, 0, 0, 0, 0));
+  nodes.emplace(remote_node, CreateNodeResources(2, 2, 0, 0, 0, 0));
+
+  auto cluster_resource_manager = MockClusterResourceManager(nodes);
+  auto policy = raylet_scheduling_policy::CompositeSchedulingPolicy(
+      local_node, cluster_resource_manager, [](auto) { return true; });
+  auto options = HybridOptions(0.50, false, false);
+  options.arg_bytes_by_node = {{remote_node, 100}};
+  ASSERT_EQ(policy.Schedule(req, options), local_node);
+  options.data_locality_weight = 1;
+  ASSERT_EQ(policy.Schedule(req, options), remote_node);
+}
+
+TEST_F(SchedulingPolicyTest, NodeScorerOnGpuFallbackTest) {
+  // In this test, there are only GPU nodes, so a CPU request that avoids them falls
+  // back to all the nodes. The node scorer still ranks them on that path.
+  ResourceRequest req = ResourceMapToResourceRequest({{"CPU", 1}}, false);
+  nodes.emplace(local_node, CreateNodeResources(1, 2, 0, 0, 1, 1));
+  nodes.emplace(remote_node, CreateNodeResources(2, 2, 0, 0, 1, 1));
+
+  auto cluster_resource_manager = MockClusterResourceManager(nodes);
+  auto policy = raylet_scheduling_policy::CompositeSchedulingPolicy(
+      local_node, cluster_resource_manager, [](auto) { return true; });
+  auto options = HybridOptions(0.50, false, false, /*avoid_gpu_nodes*/ true);
+  ASSERT_EQ(policy.Schedule(req, options), remote_node);
+  options.node_scorer = std::make_shared<MostAllocatedScorer>();
+  ASSERT_EQ(policy.Schedule(req, options), local_node);
+}
+
 TEST_F(SchedulingPolicyTest, AvailableOverFeasibleTest) {
   // In this test, the local node is feasible and has a lower critical resource
   // utilization, but the remote node can run the task immediately, so we pick the remote
@@ -607,6 +643,83 @@ TEST_F(SchedulingPolicyTest, BundleSchedulingMaxFractionWorkingWhenNormalResourc
   ASSERT_TRUE(to_schedule.status.IsSuccess());
 }
 
+TEST_F(SchedulingPolicyTest, NodeScorersTest) {
+  ResourceRequest req = ResourceMapToResourceRequest({{"CPU", 1}}, false);
+  auto busy = CreateNodeResources(1, 4, 0, 0, 0, 0);
+  auto idle = CreateNodeResources(4, 4, 0, 0, 0, 0);
+  auto full = CreateNodeResources(0, 4, 0, 0, 0, 0);
+
+  // The least resource scorer favors idle nodes, the most allocated one busy nodes.
+  LeastResourceScorer least_resource;
+  ASSERT_GT(least_resource.Score(req, local_node, idle),
+            least_resource.Score(req, local_node, busy));
+  MostAllocatedScorer most_allocated;
+  ASSERT_GT(most_allocated.Score(req, local_node, busy),
+            most_allocated.Score(req, local_node, idle));
+  ASSERT_LT(most_allocated.Score(req, local_node, full), 0);
+
+  DataLocalityScorer data_locality({{remote_node, 100}, {remote_node_2, 50}});
+  ASSERT_EQ(data_locality.Score(req, remote_node, idle), 1);
+  ASSERT_EQ(data_locality.Score(req, remote_node_2, idle), 0.5);
+  ASSERT_EQ(data_locality.Score(req, local_node, idle), 0);
+  ASSERT_LT(data_locality.Score(req, remote_node, full), 0);
+
+  LabelSpreadScorer label_spread({{local_node, "zone-a"}, {remote_node, "zone-b"}},
+                                 {{"zone-a", 3}});
+  ASSERT_GT(label_spread.Score(req, remote_node, idle),
+            label_spread.Score(req, local_node, idle));
+  ASSERT_EQ(label_spread.Score(req, remote_node, idle),
+            label_spread.Score(req, remote_node_2, idle));
+
+  // A node is ranked by the weighted sum of the scores, unless it can't be used.
+  WeightedScorer weighted;
+  weighted.Add(std::make_shared<MostAllocatedScorer>(), 1)
+      .Add(std::make_shared<DataLocalityScorer>(
+               absl::flat_hash_map<scheduling::NodeID, int64_t>{{local_node, 100}}),
+           2);
+  ASSERT_EQ(weighted.Score(req, local_node, idle),
+            most_allocated.Score(req, local_node, idle) + 2);
+  ASSERT_LT(weighted.Score(req, local_node, full), 0);
+
+  // The scorers are created by their config name, the empty name keeps the default.
+  ASSERT_EQ(CreateNodeScorer(""), nullptr);
+  ASSERT_NE(dynamic_cast<LeastResourceScorer *>(CreateNodeScorer("least_resource").get()),
+            nullptr);
+  ASSERT_NE(dynamic_cast<MostAllocatedScorer *>(CreateNodeScorer("most_allocated").get()),
+            nullptr);
+  ASSERT_EQ(CreateNodeScorer("unknown"), nullptr);
+}
+
+TEST_F(SchedulingPolicyTest, BundleSchedulingWithNodeScorerTest) {
+  /*
+   * Test the bundle scheduling policies rank the nodes with the scorer of the options.
+   */
+
+  ResourceRequest req = ResourceMapToResourceRequest({{"CPU", 1}}, false);
+  std::vector<const ResourceRequest *> req_list;
+  req_list.push_back(&req);
+
+  nodes.emplace(local_node, CreateNodeResources(4, 4, 0, 0, 0, 0));
+  nodes.emplace(remote_node, CreateNodeResources(1, 4, 0, 0, 0, 0));
+  auto cluster_resource_manager = MockClusterResourceManager(nodes);
+
+  // By default, the least allocated node is picked.
+  auto result = raylet_scheduling_policy::BundlePackSchedulingPolicy(
+                    cluster_resource_manager, [](auto) { return true; })
+                    .Schedule(req_list, SchedulingOptions::BundlePack());
+  ASSERT_TRUE(result.status.IsSuccess());
+  ASSERT_EQ(result.selected_nodes[0], local_node);
+
+  // Bin packing picks the most allocated one.
+  auto pack_op = SchedulingOptions::BundlePack();
+  pack_op.node_scorer = std::make_shared<MostAllocatedScorer>();
+  result = raylet_scheduling_policy::BundlePackSchedulingPolicy(
+               cluster_resource_manager, [](auto) { return true; })
+               .Schedule(req_list, pack_op);
+  ASSERT_TRUE(result.status.IsSuccess());
+  ASSERT_EQ(result.selected_nodes[0], remote_node);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
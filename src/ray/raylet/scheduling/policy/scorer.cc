@@ -14,30 +14,58 @@
 
 #include "ray/raylet/scheduling/policy/scorer.h"
 
+#include <algorithm>
 #include <numeric>
 
+#include "ray/util/logging.h"
+
 namespace ray {
 namespace raylet_scheduling_policy {
 
+namespace {
+/// Get the resources of the node to score.
+///
+/// In GCS-based actor scheduling, the `NodeResources` are only acquired or released by
+/// actor scheduling, instead of being updated by resource reports from raylets. So we
+/// have to subtract normal task resources (if exist) from the current available
+/// resources.
+///
+/// \param new_node_resources Storage for the resources, if they must be copied.
+const NodeResources &GetResourcesToScore(const NodeResources &node_resources,
+                                         NodeResources *new_node_resources) {
+  if (node_resources.normal_task_resources.IsEmpty()) {
+    return node_resources;
+  }
+  *new_node_resources = node_resources;
+  new_node_resources->available -= node_resources.normal_task_resources;
+  new_node_resources->available.RemoveNegative();
+  return *new_node_resources;
+}
+
+/// Whether the required resources are available on the node.
+bool IsAvailableToScore(const ResourceRequest &required_resources,
+                        const NodeResources &node_resources) {
+  NodeResources new_node_resources;
+  const auto &resources = GetResourcesToScore(node_resources, &new_node_resources);
+  for (auto &resource_id : required_resources.ResourceIds()) {
+    if (required_resources.Get(resource_id) > resources.available.Get(resource_id)) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
 double LeastResourceScorer::Score(const ResourceRequest &required_resources,
+                                  scheduling::NodeID node_id,
                                   const NodeResources &node_resources) {
-  // In GCS-based actor scheduling, the `NodeResources` are only acquired or released by
-  // actor scheduling, instead of being updated by resource reports from raylets. So we
-  // have to subtract normal task resources (if exist) from the current available
-  // resources.
-  const NodeResources *node_resources_ptr = &node_resources;
   NodeResources new_node_resources;
-  if (!node_resources.normal_task_resources.IsEmpty()) {
-    new_node_resources = node_resources;
-    new_node_resources.available -= node_resources.normal_task_resources;
-    new_node_resources.available.RemoveNegative();
-    node_resources_ptr = &new_node_resources;
-  }
+  const auto &resources = GetResourcesToScore(node_resources, &new_node_resources);
 
   double node_score = 0.;
   for (auto &resource_id : required_resources.ResourceIds()) {
     const auto &request_resource = required_resources.Get(resource_id);
-    const auto &node_available_resource = node_resources_ptr->available.Get(resource_id);
+    const auto &node_available_resource = resources.available.Get(resource_id);
     auto score = Calculate(request_resource, node_available_resource);
     if (score < 0.) {
       return -1.;
@@ -62,5 +90,103 @@ double LeastResourceScorer::Calculate(const FixedPoint &requested,
   return (available - requested).Double() / available.Double();
 }
 
+double MostAllocatedScorer::Score(const ResourceRequest &required_resources,
+                                  scheduling::NodeID node_id,
+                                  const NodeResources &node_resources) {
+  NodeResources new_node_resources;
+  const auto &resources = GetResourcesToScore(node_resources, &new_node_resources);
+
+  double node_score = 0.;
+  for (auto &resource_id : required_resources.ResourceIds()) {
+    const auto &requested = required_resources.Get(resource_id);
+    const auto &available = resources.available.Get(resource_id);
+    if (requested > available) {
+      return -1.;
+    }
+    const auto &total = resources.total.Get(resource_id);
+    if (total == 0) {
+      continue;
+    }
+    // The fraction of the resource allocated once the request is placed.
+    node_score += (total - available + requested).Double() / total.Double();
+  }
+  return node_score;
+}
+
+DataLocalityScorer::DataLocalityScorer(
+    absl::flat_hash_map<scheduling::NodeID, int64_t> local_bytes)
+    : local_bytes_(std::move(local_bytes)) {
+  for (const auto &entry : local_bytes_) {
+    max_local_bytes_ = std::max(max_local_bytes_, entry.second);
+  }
+}
+
+double DataLocalityScorer::Score(const ResourceRequest &required_resources,
+                                 scheduling::NodeID node_id,
+                                 const NodeResources &node_resources) {
+  if (!IsAvailableToScore(required_resources, node_resources)) {
+    return -1.;
+  }
+  auto it = local_bytes_.find(node_id);
+  if (it == local_bytes_.end() || max_local_bytes_ == 0) {
+    return 0.;
+  }
+  return static_cast<double>(it->second) / max_local_bytes_;
+}
+
+LabelSpreadScorer::LabelSpreadScorer(
+    absl::flat_hash_map<scheduling::NodeID, std::string> node_labels,
+    absl::flat_hash_map<std::string, int64_t> placements_per_label)
+    : node_labels_(std::move(node_labels)),
+      placements_per_label_(std::move(placements_per_label)) {}
+
+double LabelSpreadScorer::Score(const ResourceRequest &required_resources,
+                                scheduling::NodeID node_id,
+                                const NodeResources &node_resources) {
+  if (!IsAvailableToScore(required_resources, node_resources)) {
+    return -1.;
+  }
+  auto label_it = node_labels_.find(node_id);
+  const std::string &label = label_it == node_labels_.end() ? "" : label_it->second;
+  auto placements_it = placements_per_label_.find(label);
+  int64_t placements =
+      placements_it == placements_per_label_.end() ? 0 : placements_it->second;
+  return 1. / (1 + placements);
+}
+
+WeightedScorer &WeightedScorer::Add(std::shared_ptr<NodeScorer> scorer, double weight) {
+  scorers_.emplace_back(std::move(scorer), weight);
+  return *this;
+}
+
+double WeightedScorer::Score(const ResourceRequest &required_resources,
+                             scheduling::NodeID node_id,
+                             const NodeResources &node_resources) {
+  double node_score = 0.;
+  for (auto &[scorer, weight] : scorers_) {
+    auto score = scorer->Score(required_resources, node_id, node_resources);
+    if (score < 0.) {
+      return -1.;
+    }
+    node_score += weight * score;
+  }
+  return node_score;
+}
+
+std::shared_ptr<NodeScorer> CreateNodeScorer(const std::string &name) {
+  if (name.empty()) {
+    return nullptr;
+  }
+  if (name == "least_resource") {
+    return std::make_shared<LeastResourceScorer>();
+  }
+  if (name == "most_allocated") {
+    return std::make_shared<MostAllocatedScorer>();
+  }
+  RAY_LOG(WARNING) << "Unknown node scorer " << name
+                   << ", the scheduling policies will use their default ranking.";
+  return nullptr;
+}
+
 }  // namespace raylet_scheduling_policy
 }  // namespace ray
@@ -13,8 +13,13 @@
 // limitations under the License.
 
 #pragma once
+#include <memory>
 #include <optional>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "ray/raylet/scheduling/cluster_resource_data.h"
 
 namespace ray {
@@ -29,10 +34,13 @@ class NodeScorer {
   /// \brief Score according to node resources.
   ///
   /// \param required_resources The required resources.
+  /// \param node_id The id of the node.
   /// \param node_resources The node resources which contains available and total
   /// resources.
-  /// \return Score of the node.
+  /// \return Score of the node, negative if the required resources are not available
+  /// on the node.
   virtual double Score(const ResourceRequest &required_resources,
+                       scheduling::NodeID node_id,
                        const NodeResources &node_resources) = 0;
 };
 
@@ -41,6 +49,7 @@ class NodeScorer {
 class LeastResourceScorer : public NodeScorer {
  public:
   double Score(const ResourceRequest &required_resources,
+               scheduling::NodeID node_id,
                const NodeResources &node_resources) override;
 
  private:
@@ -52,5 +61,72 @@ class LeastResourceScorer : public NodeScorer {
   double Calculate(const FixedPoint &requested, const FixedPoint &available);
 };
 
+/// MostAllocatedScorer is a score plugin that favors nodes with more allocated
+/// resources, to pack the requests and leave whole nodes free.
+class MostAllocatedScorer : public NodeScorer {
+ public:
+  double Score(const ResourceRequest &required_resources,
+               scheduling::NodeID node_id,
+               const NodeResources &node_resources) override;
+};
+
+/// DataLocalityScorer is a score plugin that favors nodes holding more bytes of the
+/// arguments of the task, to reduce object transfers.
+class DataLocalityScorer : public NodeScorer {
+ public:
+  /// \param local_bytes The bytes of the arguments already on each node, e.g. from
+  /// the object locations known to the lease policy.
+  explicit DataLocalityScorer(
+      absl::flat_hash_map<scheduling::NodeID, int64_t> local_bytes);
+
+  double Score(const ResourceRequest &required_resources,
+               scheduling::NodeID node_id,
+               const NodeResources &node_resources) override;
+
+ private:
+  absl::flat_hash_map<scheduling::NodeID, int64_t> local_bytes_;
+  /// The most bytes on a single node, scored 1.
+  int64_t max_local_bytes_ = 0;
+};
+
+/// LabelSpreadScorer is a score plugin that favors nodes whose label (e.g. their
+/// zone) has the fewest requests placed, to spread the requests across labels.
+class LabelSpreadScorer : public NodeScorer {
+ public:
+  /// \param node_labels The label of each node. The nodes without one share the
+  /// empty label.
+  /// \param placements_per_label The number of requests already placed per label.
+  LabelSpreadScorer(absl::flat_hash_map<scheduling::NodeID, std::string> node_labels,
+                    absl::flat_hash_map<std::string, int64_t> placements_per_label);
+
+  double Score(const ResourceRequest &required_resources,
+               scheduling::NodeID node_id,
+               const NodeResources &node_resources) override;
+
+ private:
+  absl::flat_hash_map<scheduling::NodeID, std::string> node_labels_;
+  absl::flat_hash_map<std::string, int64_t> placements_per_label_;
+};
+
+/// WeightedScorer combines scorers into the weighted sum of their scores. A node is
+/// scored negative if any of the scorers scores it negative.
+class WeightedScorer : public NodeScorer {
+ public:
+  /// Add a scorer whose score is multiplied by the given weight.
+  WeightedScorer &Add(std::shared_ptr<NodeScorer> scorer, double weight);
+
+  double Score(const ResourceRequest &required_resources,
+               scheduling::NodeID node_id,
+               const NodeResources &node_resources) override;
+
+ private:
+  std::vector<std::pair<std::shared_ptr<NodeScorer>, double>> scorers_;
+};
+
+/// Create the scorer with the given name, as set in the scheduler_node_scorer config:
+/// "least_resource" or "most_allocated". Returns nullptr for the empty name, in which
+/// case each scheduling policy ranks the nodes its own way.
+std::shared_ptr<NodeScorer> CreateNodeScorer(const std::string &name);
+
 }  // namespace raylet_scheduling_policy
 }  // namespace ray
@@ -0,0 +1,144 @@
+// Copyright 2023 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Microbenchmark of the resource checks the scheduler runs against every node of a
+// large cluster.
+//
+// Usage: resource_request_bench [num_nodes] [num_rounds]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "ray/raylet/scheduling/cluster_resource_data.h"
+
+namespace ray {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// The subset check of the hash map based ResourceRequest, kept as a baseline.
+bool HashMapIsSubset(const absl::flat_hash_map<ResourceID, FixedPoint> &request,
+                     const absl::flat_hash_map<ResourceID, FixedPoint> &available) {
+  for (auto &entry : request) {
+    auto it = available.find(entry.first);
+    auto value = it == available.end() ? FixedPoint(0) : it->second;
+    if (entry.second > value) {
+      return false;
+    }
+  }
+  for (auto &entry : available) {
+    if (!request.contains(entry.first) && entry.second < 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename Fn>
+void Report(const std::string &name, size_t num_checks, Fn fn) {
+  auto start = Clock::now();
+  size_t matches = fn();
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start)
+                .count();
+  std::cout << name << ": " << static_cast<double>(ns) / num_checks
+            << " ns/check, " << matches << " matches" << std::endl;
+}
+
+void Run(size_t num_nodes, size_t num_rounds) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> cpus(0, 64);
+  std::uniform_int_distribution<int> gpus(0, 8);
+  const std::vector<ResourceID> custom = {ResourceID("accelerator_type:A100"),
+                                          ResourceID("node:10.0.0.1"),
+                                          ResourceID("custom_label")};
+
+  std::vector<NodeResources> nodes;
+  std::vector<absl::flat_hash_map<ResourceID, FixedPoint>> hash_nodes;
+  for (size_t i = 0; i < num_nodes; i++) {
+    ResourceRequest available;
+    available.Set(ResourceID::CPU(), cpus(gen))
+        .Set(ResourceID::GPU(), gpus(gen))
+        .Set(ResourceID::Memory(), 64.0 * 1024 * 1024 * 1024)
+        .Set(ResourceID::ObjectStoreMemory(), 16.0 * 1024 * 1024 * 1024);
+    for (size_t j = 0; j < i % (custom.size() + 1); j++) {
+      available.Set(custom[j], 1);
+    }
+    nodes.emplace_back(available);
+    hash_nodes.push_back(available.ToMap());
+  }
+
+  std::vector<ResourceRequest> requests = {
+      ResourceRequest({{ResourceID::CPU(), 1}}),
+      ResourceRequest({{ResourceID::CPU(), 8}, {ResourceID::GPU(), 1}}),
+      ResourceRequest({{ResourceID::CPU(), 1}, {custom[0], 1}}),
+      ResourceRequest({{ResourceID::CPU(), 4},
+                       {ResourceID::Memory(), 1024.0 * 1024 * 1024},
+                       {custom[1], 0.01}}),
+  };
+  std::vector<absl::flat_hash_map<ResourceID, FixedPoint>> hash_requests;
+  for (const auto &request : requests) {
+    hash_requests.push_back(request.ToMap());
+  }
+
+  const size_t num_checks = num_rounds * requests.size() * num_nodes;
+  std::cout << num_nodes << " nodes, " << num_checks << " checks" << std::endl;
+  Report("hash map subset (baseline)", num_checks, [&]() {
+    size_t matches = 0;
+    for (size_t round = 0; round < num_rounds; round++) {
+      for (const auto &request : hash_requests) {
+        for (const auto &node : hash_nodes) {
+          matches += HashMapIsSubset(request, node);
+        }
+      }
+    }
+    return matches;
+  });
+  Report("NodeResources::IsAvailable", num_checks, [&]() {
+    size_t matches = 0;
+    for (size_t round = 0; round < num_rounds; round++) {
+      for (const auto &request : requests) {
+        for (const auto &node : nodes) {
+          matches += node.IsAvailable(request);
+        }
+      }
+    }
+    return matches;
+  });
+  Report("NodeResources::IsFeasible", num_checks, [&]() {
+    size_t matches = 0;
+    for (size_t round = 0; round < num_rounds; round++) {
+      for (const auto &request : requests) {
+        for (const auto &node : nodes) {
+          matches += node.IsFeasible(request);
+        }
+      }
+    }
+    return matches;
+  });
+}
+
+}  // namespace
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  size_t num_nodes = argc > 1 ? std::atoi(argv[1]) : 5000;
+  size_t num_rounds = argc > 2 ? std::atoi(argv[2]) : 100;
+  ray::Run(num_nodes, num_rounds);
+  return 0;
+}
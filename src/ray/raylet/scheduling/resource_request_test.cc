@@ -152,6 +152,44 @@ TEST_F(ResourceRequestTest, TestOperators) {
   ASSERT_EQ(r1.ToMap(), expected);
 }
 
+TEST_F(ResourceRequestTest, TestManyCustomResources) {
+  // Custom resources are kept sorted, check the merge in the comparisons.
+  std::vector<ResourceID> custom_ids;
+  for (int i = 0; i < 10; i++) {
+    custom_ids.push_back(ResourceID("many_custom" + std::to_string(i)));
+  }
+  ResourceRequest request, available;
+  available.Set(ResourceID::CPU(), 4);
+  for (size_t i = 0; i < custom_ids.size(); i++) {
+    available.Set(custom_ids[i], 1);
+    if (i % 3 == 0) {
+      request.Set(custom_ids[i], 1);
+    }
+  }
+  ASSERT_EQ(available.Size(), 11);
+  ASSERT_TRUE(request <= available);
+  ASSERT_FALSE(available <= request);
+
+  // The predefined resources are iterated first.
+  std::vector<ResourceID> resource_ids;
+  for (auto &resource_id : available.ResourceIds()) {
+    resource_ids.push_back(resource_id);
+  }
+  ASSERT_EQ(resource_ids.size(), 11);
+  ASSERT_EQ(resource_ids[0], ResourceID::CPU());
+  ASSERT_TRUE(std::is_sorted(resource_ids.begin() + 1, resource_ids.end()));
+
+  request.Set(custom_ids[9], 2);
+  ASSERT_FALSE(request <= available);
+  available.Set(custom_ids[9], 0);
+  available.Set(custom_ids[5], -1);
+  ASSERT_EQ(available.Size(), 10);
+  request.Set(custom_ids[9], 0);
+  ASSERT_FALSE(request <= available);
+  request.Set(custom_ids[5], -1);
+  ASSERT_TRUE(request <= available);
+}
+
 class TaskResourceInstancesTest : public ::testing::Test {};
 
 TEST_F(TaskResourceInstancesTest, TestBasic) {
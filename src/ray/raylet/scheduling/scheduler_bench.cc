@@ -0,0 +1,546 @@
+// Copyright 2023 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Replays a trace of cluster events through the ClusterTaskManager and the
+// ClusterResourceScheduler of one raylet, with mocked workers, and reports how fast
+// and how well the tasks were placed.
+//
+// A trace has one event per line. Node 0 is the raylet under test, the other nodes
+// are its remote view of the cluster. Empty lines and lines starting with '#' are
+// skipped.
+//
+//   node <node> <num_cpus> <num_gpus>  A node joins the cluster.
+//   update <node> [<available_cpus>]  A node reports its available resources. If
+//                                     the value is omitted, the node reports the
+//                                     resources left by the tasks placed on it.
+//   submit <task> <num_cpus> <num_gpus>  A task is submitted to the raylet.
+//   finish <task>                     A task finishes and frees its resources.
+//
+// Usage: scheduler_bench [num_nodes] [num_tasks]
+//        scheduler_bench --trace <file>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "ray/common/task/task_util.h"
+#include "ray/raylet/local_task_manager.h"
+#include "ray/raylet/scheduling/cluster_resource_scheduler.h"
+#include "ray/raylet/scheduling/cluster_task_manager.h"
+#include "ray/raylet/test/util.h"
+
+namespace ray {
+namespace raylet {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Event {
+  enum class Type { kNode, kUpdate, kSubmit, kFinish };
+  Type type;
+  /// The node of node and update events, the task of submit and finish events.
+  int64_t id;
+  double num_cpus = 0;
+  double num_gpus = 0;
+  /// Whether num_cpus was given for an update event.
+  bool has_value = false;
+};
+
+bool ParseTrace(std::istream &input, std::vector<Event> *events) {
+  std::string line;
+  int line_number = 0;
+  while (std::getline(input, line)) {
+    line_number++;
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::string type;
+    Event event;
+    if (!(fields >> type >> event.id)) {
+      std::cerr << "Malformed event on line " << line_number << ": " << line
+                << std::endl;
+      return false;
+    }
+    if (type == "node" || type == "submit") {
+      event.type = type == "node" ? Event::Type::kNode : Event::Type::kSubmit;
+      fields >> event.num_cpus >> event.num_gpus;
+    } else if (type == "update") {
+      event.type = Event::Type::kUpdate;
+      event.has_value = static_cast<bool>(fields >> event.num_cpus);
+      fields.clear();
+    } else if (type == "finish") {
+      event.type = Event::Type::kFinish;
+    } else {
+      std::cerr << "Unknown event on line " << line_number << ": " << line << std::endl;
+      return false;
+    }
+    if (fields.fail()) {
+      std::cerr << "Malformed event on line " << line_number << ": " << line
+                << std::endl;
+      return false;
+    }
+    events->push_back(event);
+  }
+  return true;
+}
+
+/// Generate a trace where most nodes are there from the start and the rest join
+/// while tasks are running. Every task runs for a random number of events.
+std::vector<Event> GenerateTrace(int64_t num_nodes, int64_t num_tasks) {
+  std::mt19937 gen(0);
+  const std::vector<double> node_cpus = {8, 16, 32, 64};
+  const std::vector<double> task_cpus = {1, 1, 1, 2, 4};
+  std::uniform_int_distribution<size_t> node_cpus_index(0, node_cpus.size() - 1);
+  std::uniform_int_distribution<size_t> task_cpus_index(0, task_cpus.size() - 1);
+  std::uniform_int_distribution<int64_t> duration(1, 4 * num_nodes);
+  std::uniform_int_distribution<int> percent(0, 99);
+
+  std::vector<Event> events;
+  auto add_node = [&](int64_t node) {
+    double gpus = node % 8 == 0 ? 4 : 0;
+    events.push_back({Event::Type::kNode, node, node_cpus[node_cpus_index(gen)], gpus});
+  };
+  int64_t num_initial_nodes = std::max<int64_t>(1, num_nodes * 9 / 10);
+  for (int64_t node = 1; node < num_initial_nodes; node++) {
+    add_node(node);
+  }
+
+  using Finish = std::pair<int64_t, int64_t>;
+  std::priority_queue<Finish, std::vector<Finish>, std::greater<Finish>> finishes;
+  int64_t next_node = num_initial_nodes;
+  for (int64_t task = 0; task < num_tasks; task++) {
+    while (!finishes.empty() && finishes.top().first <= task) {
+      events.push_back({Event::Type::kFinish, finishes.top().second});
+      finishes.pop();
+    }
+    if (next_node < num_nodes && task % 10 == 0) {
+      add_node(next_node++);
+    }
+    if (num_nodes > 1 && task % 5 == 0) {
+      std::uniform_int_distribution<int64_t> node(1, next_node - 1);
+      events.push_back({Event::Type::kUpdate, node(gen)});
+    }
+    double gpus = percent(gen) < 5 ? 1 : 0;
+    events.push_back({Event::Type::kSubmit, task, task_cpus[task_cpus_index(gen)], gpus});
+    finishes.emplace(task + duration(gen), task);
+  }
+  while (!finishes.empty()) {
+    events.push_back({Event::Type::kFinish, finishes.top().second});
+    finishes.pop();
+  }
+  return events;
+}
+
+/// Hands out a new mocked worker for every request, once the replay flushes it.
+class BenchWorkerPool : public WorkerPoolInterface {
+ public:
+  void PopWorker(const TaskSpecification &task_spec,
+                 const PopWorkerCallback &callback,
+                 const std::string &allocated_instances_serialized_json) override {
+    callbacks_.push_back(callback);
+  }
+
+  bool HasIdleWorker(const TaskSpecification &task_spec) const override { return false; }
+
+  void PushWorker(const std::shared_ptr<WorkerInterface> &worker) override {}
+
+  const std::vector<std::shared_ptr<WorkerInterface>> GetAllRegisteredWorkers(
+      bool filter_dead_workers, bool filter_io_workers) const override {
+    return {};
+  }
+
+  void Flush() {
+    while (!callbacks_.empty()) {
+      std::vector<PopWorkerCallback> callbacks;
+      callbacks.swap(callbacks_);
+      for (const auto &callback : callbacks) {
+        auto worker = std::make_shared<MockWorker>(WorkerID::FromRandom(), next_port_++);
+        callback(worker, PopWorkerStatus::OK, "");
+      }
+    }
+  }
+
+ private:
+  std::vector<PopWorkerCallback> callbacks_;
+  int next_port_ = 1;
+};
+
+class NoDependencyManager : public TaskDependencyManagerInterface {
+ public:
+  bool RequestTaskDependencies(
+      const TaskID &task_id,
+      const std::vector<rpc::ObjectReference> &required_objects) override {
+    return true;
+  }
+  void RemoveTaskDependencies(const TaskID &task_id) override {}
+  bool TaskDependenciesBlocked(const TaskID &task_id) const override { return false; }
+  bool CheckObjectLocal(const ObjectID &object_id) const override { return true; }
+};
+
+RayTask CreateTask(double num_cpus, double num_gpus) {
+  std::unordered_map<std::string, double> required_resources = {
+      {kCPU_ResourceLabel, num_cpus}};
+  if (num_gpus > 0) {
+    required_resources[kGPU_ResourceLabel] = num_gpus;
+  }
+  const JobID job_id = JobID::FromInt(1);
+  TaskSpecBuilder spec_builder;
+  spec_builder.SetCommonTaskSpec(TaskID::FromRandom(job_id),
+                                 "bench_task",
+                                 Language::PYTHON,
+                                 FunctionDescriptorBuilder::BuildPython("", "", "", ""),
+                                 job_id,
+                                 TaskID::Nil(),
+                                 0,
+                                 TaskID::Nil(),
+                                 rpc::Address(),
+                                 0,
+                                 /*returns_dynamic=*/false,
+                                 required_resources,
+                                 {},
+                                 "",
+                                 0);
+  spec_builder.SetNormalTaskSpec(0, false, "", rpc::SchedulingStrategy());
+  return RayTask(spec_builder.Build());
+}
+
+class SchedulerReplay {
+ public:
+  SchedulerReplay()
+      : local_node_id_(NodeID::FromRandom()),
+        scheduler_(std::make_shared<ClusterResourceScheduler>(
+            scheduling::NodeID(local_node_id_.Binary()),
+            absl::flat_hash_map<std::string, double>{{kCPU_ResourceLabel, 16},
+                                                     {kMemory_ResourceLabel, 128}},
+            /*is_node_available_fn=*/[](scheduling::NodeID node_id) { return true; })),
+        local_task_manager_(std::make_shared<LocalTaskManager>(
+            local_node_id_,
+            scheduler_,
+            dependency_manager_,
+            /*is_owner_alive=*/
+            [](const WorkerID &worker_id, const NodeID &node_id) { return true; },
+            /*get_node_info=*/
+            [this](const NodeID &node_id) { return &node_info_; },
+            pool_,
+            leased_workers_,
+            /*get_task_arguments=*/
+            [](const std::vector<ObjectID> &object_ids,
+               std::vector<std::unique_ptr<RayObject>> *results) { return true; },
+            /*preempt_worker=*/
+            [](const std::shared_ptr<WorkerInterface> &worker,
+               const std::string &message) {},
+            /*max_pinned_task_arguments_bytes=*/1000)),
+        task_manager_(
+            local_node_id_,
+            scheduler_,
+            /*get_node_info=*/
+            [this](const NodeID &node_id) { return &node_info_; },
+            /*announce_infeasible_task=*/
+            [this](const RayTask &task) { num_infeasible_++; },
+            local_task_manager_) {
+    nodes_.push_back({local_node_id_, 16, 0, 0});
+    node_index_[local_node_id_] = 0;
+  }
+
+  void Replay(const std::vector<Event> &events) {
+    for (size_t i = 0; i < events.size(); i++) {
+      const auto &event = events[i];
+      switch (event.type) {
+      case Event::Type::kNode:
+        AddNode(event);
+        break;
+      case Event::Type::kUpdate:
+        UpdateNode(event);
+        break;
+      case Event::Type::kSubmit:
+        SubmitTask(event);
+        break;
+      case Event::Type::kFinish:
+        FinishTask(event);
+        break;
+      }
+      if (i % 1000 == 0) {
+        SampleUtilization();
+      }
+    }
+  }
+
+  void Report() {
+    size_t num_running = 0;
+    size_t num_pending = 0;
+    for (const auto &task : tasks_) {
+      num_running += task.node >= 0 && !task.finished;
+      num_pending += task.node < 0 && !task.finished;
+    }
+    std::sort(latencies_ns_.begin(), latencies_ns_.end());
+    auto percentile = [this](double p) {
+      if (latencies_ns_.empty()) {
+        return 0.0;
+      }
+      size_t index = std::min(latencies_ns_.size() - 1,
+                              static_cast<size_t>(p * latencies_ns_.size()));
+      return latencies_ns_[index] / 1e3;
+    };
+    double total_s = total_ns_ / 1e9;
+
+    std::cout << nodes_.size() << " nodes, " << tasks_.size() << " tasks" << std::endl;
+    std::cout << "decisions: " << num_decisions_ << " (" << num_local_ << " local, "
+              << num_decisions_ - num_local_ << " spilled), " << num_infeasible_
+              << " infeasible announcements, " << num_pending << " still pending, "
+              << num_running << " still running" << std::endl;
+    std::cout << "decisions/sec: " << (total_s > 0 ? num_decisions_ / total_s : 0)
+              << std::endl;
+    std::cout << "scheduling pass latency: p50 " << percentile(0.5) << " us, p99 "
+              << percentile(0.99) << " us, max " << percentile(1.0) << " us"
+              << std::endl;
+    std::cout << "placement at peak load: " << peak_.running_cpus << " CPUs in use, "
+              << "mean node utilization " << peak_.mean << ", stddev " << peak_.stddev
+              << ", " << peak_.num_overcommitted << " overcommitted nodes"
+              << std::endl;
+  }
+
+ private:
+  struct BenchNode {
+    NodeID id;
+    double num_cpus;
+    double num_gpus;
+    /// The CPUs of the tasks placed on the node.
+    double used_cpus;
+  };
+
+  struct BenchTask {
+    RayTask task;
+    std::unique_ptr<rpc::RequestWorkerLeaseReply> reply;
+    /// Where the task was placed, or -1 if it is still queued.
+    int64_t node = -1;
+    std::shared_ptr<WorkerInterface> worker;
+    bool finished = false;
+  };
+
+  struct Utilization {
+    double running_cpus = 0;
+    double mean = 0;
+    double stddev = 0;
+    int64_t num_overcommitted = 0;
+  };
+
+  absl::flat_hash_map<std::string, double> Resources(double num_cpus,
+                                                     double num_gpus) const {
+    return {{kCPU_ResourceLabel, num_cpus},
+            {kGPU_ResourceLabel, num_gpus},
+            {kMemory_ResourceLabel, 128}};
+  }
+
+  static double TaskCpus(const BenchTask &task) {
+    return task.task.GetTaskSpecification()
+        .GetRequiredResources()
+        .GetResource(kCPU_ResourceLabel)
+        .Double();
+  }
+
+  void AddNode(const Event &event) {
+    if (event.id >= static_cast<int64_t>(nodes_.size())) {
+      nodes_.resize(event.id + 1, {NodeID::Nil(), 0, 0, 0});
+    }
+    auto &node = nodes_[event.id];
+    node = {NodeID::FromRandom(), event.num_cpus, event.num_gpus, 0};
+    node_index_[node.id] = event.id;
+    auto resources = Resources(event.num_cpus, event.num_gpus);
+    Timed([&]() {
+      scheduler_->GetClusterResourceManager().AddOrUpdateNode(
+          scheduling::NodeID(node.id.Binary()), resources, resources);
+      task_manager_.ScheduleAndDispatchTasks();
+    });
+  }
+
+  void UpdateNode(const Event &event) {
+    if (event.id <= 0 || event.id >= static_cast<int64_t>(nodes_.size()) ||
+        nodes_[event.id].id.IsNil()) {
+      return;
+    }
+    const auto &node = nodes_[event.id];
+    double available_cpus =
+        event.has_value ? event.num_cpus : std::max(0.0, node.num_cpus - node.used_cpus);
+    rpc::ResourcesData data;
+    (*data.mutable_resources_available())[kCPU_ResourceLabel] = available_cpus;
+    (*data.mutable_resources_available())[kGPU_ResourceLabel] = node.num_gpus;
+    (*data.mutable_resources_available())[kMemory_ResourceLabel] = 128;
+    data.set_resources_available_changed(true);
+    Timed([&]() {
+      scheduler_->GetClusterResourceManager().UpdateNodeAvailableResourcesIfExist(
+          scheduling::NodeID(node.id.Binary()), data);
+      task_manager_.ScheduleAndDispatchTasks();
+    });
+  }
+
+  void SubmitTask(const Event &event) {
+    if (event.id >= static_cast<int64_t>(tasks_.size())) {
+      tasks_.resize(event.id + 1);
+    }
+    auto &task = tasks_[event.id];
+    task.task = CreateTask(event.num_cpus, event.num_gpus);
+    task.reply = std::make_unique<rpc::RequestWorkerLeaseReply>();
+    int64_t index = event.id;
+    Timed([&]() {
+      task_manager_.QueueAndScheduleTask(
+          task.task,
+          /*grant_or_reject=*/false,
+          /*is_selected_based_on_locality=*/false,
+          task.reply.get(),
+          [this, index](Status, std::function<void()>, std::function<void()>) {
+            OnReply(index);
+          });
+    });
+  }
+
+  void FinishTask(const Event &event) {
+    if (event.id >= static_cast<int64_t>(tasks_.size())) {
+      return;
+    }
+    auto &task = tasks_[event.id];
+    if (task.finished || task.node < 0) {
+      // Tasks that are still queued are cancelled.
+      if (!task.finished && task.reply) {
+        task_manager_.CancelTask(task.task.GetTaskSpecification().TaskId());
+      }
+      task.finished = true;
+      return;
+    }
+    task.finished = true;
+    const auto &spec = task.task.GetTaskSpecification();
+    auto &node = nodes_[task.node];
+    node.used_cpus -= TaskCpus(task);
+    Timed([&]() {
+      if (task.node == 0) {
+        RayTask finished_task;
+        local_task_manager_->TaskFinished(task.worker, &finished_task);
+        leased_workers_.erase(task.worker->WorkerId());
+      } else {
+        scheduler_->GetClusterResourceManager().AddNodeAvailableResources(
+            scheduling::NodeID(node.id.Binary()),
+            ResourceMapToResourceRequest(spec.GetRequiredResources().GetResourceMap(),
+                                         /*requires_object_store_memory=*/false));
+      }
+      task_manager_.ScheduleAndDispatchTasks();
+    });
+    task.worker.reset();
+  }
+
+  void OnReply(int64_t index) {
+    auto &task = tasks_[index];
+    const auto &reply = *task.reply;
+    const auto &spillback_node = reply.retry_at_raylet_address().raylet_id();
+    if (!spillback_node.empty()) {
+      task.node = node_index_[NodeID::FromBinary(spillback_node)];
+    } else if (!reply.worker_address().worker_id().empty()) {
+      task.node = 0;
+      auto worker_id = WorkerID::FromBinary(reply.worker_address().worker_id());
+      task.worker = leased_workers_[worker_id];
+      num_local_++;
+    } else {
+      // Cancelled or rejected.
+      return;
+    }
+    nodes_[task.node].used_cpus += TaskCpus(task);
+    num_decisions_++;
+  }
+
+  template <typename Fn>
+  void Timed(Fn fn) {
+    auto start = Clock::now();
+    fn();
+    pool_.Flush();
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start)
+                  .count();
+    latencies_ns_.push_back(ns);
+    total_ns_ += ns;
+  }
+
+  void SampleUtilization() {
+    Utilization sample;
+    int64_t num_nodes = 0;
+    double sum_squares = 0;
+    for (const auto &node : nodes_) {
+      if (node.id.IsNil() || node.num_cpus <= 0) {
+        continue;
+      }
+      double utilization = node.used_cpus / node.num_cpus;
+      sample.running_cpus += node.used_cpus;
+      sample.mean += utilization;
+      sum_squares += utilization * utilization;
+      sample.num_overcommitted += node.used_cpus > node.num_cpus;
+      num_nodes++;
+    }
+    if (num_nodes == 0 || sample.running_cpus <= peak_.running_cpus) {
+      return;
+    }
+    sample.mean /= num_nodes;
+    sample.stddev =
+        std::sqrt(std::max(0.0, sum_squares / num_nodes - sample.mean * sample.mean));
+    peak_ = sample;
+  }
+
+  NodeID local_node_id_;
+  rpc::GcsNodeInfo node_info_;
+  std::shared_ptr<ClusterResourceScheduler> scheduler_;
+  BenchWorkerPool pool_;
+  NoDependencyManager dependency_manager_;
+  absl::flat_hash_map<WorkerID, std::shared_ptr<WorkerInterface>> leased_workers_;
+  std::shared_ptr<LocalTaskManager> local_task_manager_;
+  ClusterTaskManager task_manager_;
+
+  std::vector<BenchNode> nodes_;
+  absl::flat_hash_map<NodeID, int64_t> node_index_;
+  std::vector<BenchTask> tasks_;
+
+  std::vector<int64_t> latencies_ns_;
+  int64_t total_ns_ = 0;
+  int64_t num_decisions_ = 0;
+  int64_t num_local_ = 0;
+  int64_t num_infeasible_ = 0;
+  Utilization peak_;
+};
+
+}  // namespace
+}  // namespace raylet
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  std::vector<ray::raylet::Event> events;
+  if (argc > 2 && std::string(argv[1]) == "--trace") {
+    std::ifstream input(argv[2]);
+    if (!input || !ray::raylet::ParseTrace(input, &events)) {
+      std::cerr << "Failed to read trace " << argv[2] << std::endl;
+      return 1;
+    }
+  } else {
+    int64_t num_nodes = argc > 1 ? std::atoll(argv[1]) : 1000;
+    int64_t num_tasks = argc > 2 ? std::atoll(argv[2]) : 100000;
+    events = ray::raylet::GenerateTrace(num_nodes, num_tasks);
+  }
+  ray::raylet::SchedulerReplay replay;
+  replay.Replay(events);
+  replay.Report();
+  return 0;
+}
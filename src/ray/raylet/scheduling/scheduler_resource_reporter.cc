@@ -34,12 +34,14 @@ SchedulerResourceReporter::SchedulerResourceReporter(
     const absl::flat_hash_map<SchedulingClass,
                               std::deque<std::shared_ptr<internal::Work>>>
         &infeasible_tasks,
+    const absl::flat_hash_map<std::string, internal::Gang> &gangs_to_schedule,
     const ILocalTaskManager &local_task_manager)
     : max_resource_shapes_per_load_report_(
           RayConfig::instance().max_resource_shapes_per_load_report()),
       tasks_to_schedule_(tasks_to_schedule),
       tasks_to_dispatch_(local_task_manager.GetTaskToDispatch()),
       infeasible_tasks_(infeasible_tasks),
+      gangs_to_schedule_(gangs_to_schedule),
       backlog_tracker_(local_task_manager.GetBackLogTracker()) {}
 
 int64_t SchedulerResourceReporter::TotalBacklogSize(
@@ -138,6 +140,18 @@ void SchedulerResourceReporter::FillResourceUsage(
       tasks_to_dispatch_ | boost::adaptors::transformed(transform_func), false);
   fill_resource_usage_helper(
       infeasible_tasks_ | boost::adaptors::transformed(transform_func), true);
+
+  // The tasks of the gangs waiting to be placed, counted by scheduling class.
+  absl::flat_hash_map<SchedulingClass, size_t> gang_tasks;
+  absl::flat_hash_map<SchedulingClass, size_t> infeasible_gang_tasks;
+  for (const auto &[gang_id, gang] : gangs_to_schedule_) {
+    auto &counts = gang.announced_infeasible ? infeasible_gang_tasks : gang_tasks;
+    for (const auto &work : gang.works) {
+      counts[work->task.GetTaskSpecification().GetSchedulingClass()]++;
+    }
+  }
+  fill_resource_usage_helper(gang_tasks, false);
+  fill_resource_usage_helper(infeasible_gang_tasks, true);
   auto backlog_tracker_range = backlog_tracker_ |
                                boost::adaptors::transformed([](const auto &pair) {
                                  return std::make_pair(pair.first, 0);
@@ -33,6 +33,7 @@ class SchedulerResourceReporter {
       const absl::flat_hash_map<SchedulingClass,
                                 std::deque<std::shared_ptr<internal::Work>>>
           &infeasible_tasks,
+      const absl::flat_hash_map<std::string, internal::Gang> &gangs_to_schedule,
       const ILocalTaskManager &local_task_manager);
 
   /// Populate the relevant parts of the heartbeat table. This is intended for
@@ -73,6 +74,8 @@ class SchedulerResourceReporter {
   const absl::flat_hash_map<SchedulingClass, std::deque<std::shared_ptr<internal::Work>>>
       &infeasible_tasks_;
 
+  const absl::flat_hash_map<std::string, internal::Gang> &gangs_to_schedule_;
+
   const absl::flat_hash_map<SchedulingClass, absl::flat_hash_map<WorkerID, int64_t>>
       &backlog_tracker_;
 };
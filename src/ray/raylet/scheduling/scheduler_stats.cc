@@ -147,6 +147,11 @@ void SchedulerStats::RecordMetrics() const {
       num_waiting_for_remote_node_resources_, "WaitingForRemoteResources");
   ray::stats::STATS_scheduler_unscheduleable_tasks.Record(num_tasks_waiting_for_workers_,
                                                           "WaitingForWorkers");
+
+  /// Lease fast path.
+  ray::stats::STATS_scheduler_lease_fast_path.Record(num_lease_fast_path_hits_, "Hit");
+  ray::stats::STATS_scheduler_lease_fast_path.Record(num_lease_fast_path_misses_,
+                                                     "Miss");
 }
 
 std::string SchedulerStats::ComputeAndReportDebugStr() {
@@ -172,6 +177,8 @@ std::string SchedulerStats::ComputeAndReportDebugStr() {
          << num_worker_not_started_by_registration_timeout_ << "\n";
   buffer << "num_tasks_waiting_for_workers: " << num_tasks_waiting_for_workers_ << "\n";
   buffer << "num_cancelled_tasks: " << num_cancelled_tasks_ << "\n";
+  buffer << "num_lease_fast_path_hits: " << num_lease_fast_path_hits_ << "\n";
+  buffer << "num_lease_fast_path_misses: " << num_lease_fast_path_misses_ << "\n";
   buffer << "cluster_resource_scheduler state: "
          << cluster_task_manager_.cluster_resource_scheduler_->DebugString() << "\n";
   local_task_manager_.DebugStr(buffer);
@@ -182,5 +189,9 @@ std::string SchedulerStats::ComputeAndReportDebugStr() {
 
 void SchedulerStats::TaskSpilled() { metric_tasks_spilled_++; }
 
+void SchedulerStats::LeaseFastPathHit() { num_lease_fast_path_hits_++; }
+
+void SchedulerStats::LeaseFastPathMiss() { num_lease_fast_path_misses_++; }
+
 }  // namespace raylet
 }  // namespace ray
@@ -40,6 +40,10 @@ class SchedulerStats {
   // increase the task spilled counter.
   void TaskSpilled();
 
+  // increase the counter of lease requests granted or not by the fast path.
+  void LeaseFastPathHit();
+  void LeaseFastPathMiss();
+
  private:
   // recompute the metrics.
   void ComputeStats();
@@ -50,6 +54,10 @@ class SchedulerStats {
   /// Number of tasks that are spilled to other
   /// nodes because it cannot be scheduled locally.
   int64_t metric_tasks_spilled_ = 0;
+  /// Number of lease requests granted to an idle worker without being queued.
+  int64_t num_lease_fast_path_hits_ = 0;
+  /// Number of lease requests that tried the fast path and were queued.
+  int64_t num_lease_fast_path_misses_ = 0;
   /// Number of tasks that are waiting for
   /// resources to be available locally.
   int64_t num_waiting_for_resource_ = 0;
@@ -14,6 +14,13 @@
 
 #include "ray/raylet/local_object_manager.h"
 
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "ray/common/asio/instrumented_io_context.h"
@@ -25,6 +32,7 @@
 #include "ray/rpc/grpc_client.h"
 #include "ray/rpc/worker/core_worker_client.h"
 #include "ray/rpc/worker/core_worker_client_pool.h"
+#include "ray/util/crc32.h"
 #include "src/ray/object_manager/ownership_based_object_directory.h"
 #include "src/ray/protobuf/core_worker.grpc.pb.h"
 #include "src/ray/protobuf/core_worker.pb.h"
@@ -419,6 +427,8 @@ TEST_F(LocalObjectManagerTest, TestPin) {
   }
   std::unordered_set<ObjectID> expected(object_ids.begin(), object_ids.end());
   ASSERT_EQ(freed, expected);
+  // The spill order doesn't keep the freed objects, even though nothing was spilled.
+  ASSERT_TRUE(manager.pinned_objects_order_.empty());
 }
 
 TEST_F(LocalObjectManagerTest, TestRestoreSpilledObject) {
@@ -1594,6 +1604,156 @@ TEST_F(LocalObjectManagerTest, TestConcurrentSpillAndDelete2) {
   AssertNoLeaks();
 }
 
+namespace {
+void AppendUINT64(std::string &s, uint64_t value) {
+  for (int i = 0; i < 8; i++) {
+    s.push_back(static_cast<char>(value >> (8 * i)));
+  }
+}
+
+/// Write a spill file in the indexed format, as IO workers do.
+void WriteSpillFile(const std::filesystem::path &path,
+                    const std::vector<ObjectID> &object_ids,
+                    const rpc::Address &owner_address) {
+  std::string file("RAYSPIL2");
+  std::string index;
+  std::string address;
+  owner_address.SerializeToString(&address);
+  for (const auto &object_id : object_ids) {
+    std::string record;
+    AppendUINT64(record, address.size());
+    AppendUINT64(record, /*metadata_size=*/0);
+    AppendUINT64(record, /*data_size=*/4);
+    record.append(address);
+    record.append("data");
+    uint32_t checksum = Crc32(record.data(), record.size());
+    index.append(object_id.Binary());
+    AppendUINT64(index, file.size());
+    AppendUINT64(index, record.size());
+    index.append(reinterpret_cast<const char *>(&checksum), 4);
+    file.append(record);
+  }
+  const uint64_t index_offset = file.size();
+  const uint32_t index_checksum = Crc32(index.data(), index.size());
+  file.append(index);
+  AppendUINT64(file, index_offset);
+  AppendUINT64(file, object_ids.size());
+  file.append(reinterpret_cast<const char *>(&index_checksum), 4);
+  file.append(4, '\0');
+  file.append("RAYSPIL2");
+  std::ofstream f(path, std::ios::binary);
+  f.write(file.data(), file.size());
+}
+}  // namespace
+
+TEST_F(LocalObjectManagerTest, TestRecoverSpilledObjects) {
+  const auto spill_dir =
+      std::filesystem::temp_directory_path() / ("spill_" + ObjectID::FromRandom().Hex());
+  const auto objects_dir = spill_dir / "ray_spilled_objects";
+  std::filesystem::create_directories(objects_dir);
+
+  rpc::Address owner_address;
+  owner_address.set_worker_id(WorkerID::FromRandom().Binary());
+  std::vector<ObjectID> object_ids = {ObjectID::FromRandom(), ObjectID::FromRandom()};
+
+  // A dead raylet left a lock file and a spill file behind.
+  const auto dead_node_id = NodeID::FromRandom();
+  std::ofstream(objects_dir / (dead_node_id.Hex() + ".lock")).close();
+  WriteSpillFile(
+      objects_dir / (dead_node_id.Hex() + "-file-multi-2"), object_ids, owner_address);
+  // A live raylet still holds its lock, its files must not be touched.
+  const auto alive_node_id = NodeID::FromRandom();
+  const auto alive_lock_path = objects_dir / (alive_node_id.Hex() + ".lock");
+  int alive_lock_fd = open(alive_lock_path.c_str(), O_RDWR | O_CREAT, 0644);
+  ASSERT_EQ(flock(alive_lock_fd, LOCK_EX | LOCK_NB), 0);
+  const auto alive_file_path = objects_dir / (alive_node_id.Hex() + "-file-multi-1");
+  WriteSpillFile(alive_file_path, {ObjectID::FromRandom()}, owner_address);
+
+  ASSERT_EQ(manager.RecoverSpilledObjects({spill_dir.string()}), 2);
+  ASSERT_FALSE(std::filesystem::exists(objects_dir / (dead_node_id.Hex() + ".lock")));
+  ASSERT_TRUE(std::filesystem::exists(objects_dir / (manager_node_id_.Hex() + ".lock")));
+  ASSERT_TRUE(std::filesystem::exists(alive_lock_path));
+  ASSERT_TRUE(std::filesystem::exists(alive_file_path));
+  const auto recovered_path = objects_dir / (manager_node_id_.Hex() + "-file-multi-2");
+  ASSERT_TRUE(std::filesystem::exists(recovered_path));
+
+  // The new locations are reported to the owner.
+  for (size_t i = 0; i < 2; i++) {
+    ASSERT_TRUE(owner_client->ReplyUpdateObjectLocationBatch());
+  }
+  for (const auto &object_id : object_ids) {
+    const auto url = manager.GetLocalSpilledObjectURL(object_id);
+    ASSERT_EQ(url.find(recovered_path.string() + "?offset="), 0);
+    ASSERT_EQ(owner_client->object_urls[object_id], url);
+  }
+  ASSERT_TRUE(manager.HasLocallySpilledObjects());
+
+  // The file is deleted once the owner frees both objects.
+  for (const auto &object_id : object_ids) {
+    EXPECT_CALL(*subscriber_, Unsubscribe(_, _, object_id.Binary()));
+    ASSERT_TRUE(subscriber_->PublishObjectEviction());
+  }
+  EXPECT_CALL(worker_pool, PushDeleteWorker(_));
+  manager.ProcessSpilledObjectsDeleteQueue(/* max_batch_size */ 30);
+  ASSERT_EQ(worker_pool.io_worker_client->ReplyDeleteSpilledObjects(), 1);
+  AssertNoLeaks();
+
+  close(alive_lock_fd);
+  std::filesystem::remove_all(spill_dir);
+}
+
+TEST_F(LocalObjectManagerTest, TestSpillObjectsToMaintainHeadroom) {
+  rpc::Address owner_address;
+  owner_address.set_worker_id(WorkerID::FromRandom().Binary());
+
+  std::vector<ObjectID> object_ids;
+  std::vector<std::unique_ptr<RayObject>> objects;
+  int64_t object_size = 1000;
+  for (size_t i = 0; i < 9; i++) {
+    ObjectID object_id = ObjectID::FromRandom();
+    object_ids.push_back(object_id);
+    auto data_buffer = std::make_shared<MockObjectBuffer>(object_size, object_id, unpins);
+    auto object = std::make_unique<RayObject>(
+        data_buffer, nullptr, std::vector<rpc::ObjectReference>());
+    objects.push_back(std::move(object));
+  }
+  manager.PinObjectsAndWaitForFree(object_ids, std::move(objects), owner_address);
+
+  // Enough headroom, nothing to spill.
+  ASSERT_EQ(manager.SpillObjectsToMaintainHeadroom(20000, false), 0);
+  ASSERT_FALSE(manager.IsSpillingInProgress());
+
+  // 20% of the capacity should be kept free, spill the oldest object.
+  ASSERT_EQ(manager.SpillObjectsToMaintainHeadroom(10000, false), object_size);
+  ASSERT_EQ(NumBytesPendingSpill(), object_size);
+  // The bytes pending spill count toward the headroom.
+  ASSERT_EQ(manager.SpillObjectsToMaintainHeadroom(10000, false), 0);
+
+  // Under memory pressure the headroom is doubled, but only one more spill worker
+  // is available.
+  ASSERT_EQ(manager.SpillObjectsToMaintainHeadroom(10000, true), object_size);
+  ASSERT_EQ(manager.proactive_spilling_saturated_total_, 1);
+  ASSERT_EQ(manager.proactively_spilled_bytes_total_, 2 * object_size);
+
+  ASSERT_TRUE(worker_pool.FlushPopSpillWorkerCallbacks());
+  ASSERT_TRUE(worker_pool.FlushPopSpillWorkerCallbacks());
+  std::vector<std::string> urls;
+  for (size_t i = 0; i < 2; i++) {
+    urls.push_back(BuildURL("url" + std::to_string(i)));
+    ASSERT_TRUE(worker_pool.io_worker_client->ReplySpillObjects({urls[i]}));
+    ASSERT_TRUE(owner_client->ReplyUpdateObjectLocationBatch());
+  }
+  // The objects were spilled in the order they were pinned.
+  for (size_t i = 0; i < 2; i++) {
+    ASSERT_EQ(owner_client->object_urls[object_ids[i]], urls[i]);
+    ASSERT_EQ((*unpins)[object_ids[i]], 1);
+  }
+  for (size_t i = 2; i < object_ids.size(); i++) {
+    ASSERT_EQ((*unpins)[object_ids[i]], 0);
+  }
+  ASSERT_FALSE(manager.IsSpillingInProgress());
+}
+
 }  // namespace raylet
 
 }  // namespace ray
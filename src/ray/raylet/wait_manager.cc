@@ -36,21 +36,32 @@ void WaitManager::Wait(const std::vector<ObjectID> &object_ids,
       wait_id, WaitRequest(timeout_ms, callback, object_ids, num_required_objects));
 
   auto &wait_request = wait_requests_.at(wait_id);
-  for (const auto &object_id : object_ids) {
-    if (is_object_local_(object_id)) {
-      wait_request.ready.emplace(object_id);
+  // Only the first num_required_objects local objects are returned as ready, so
+  // stop looking once they are found.
+  for (size_t i = 0;
+       i < object_ids.size() && wait_request.num_ready < num_required_objects;
+       i++) {
+    if (is_object_local_(object_ids[i])) {
+      wait_request.ready[i] = true;
+      wait_request.num_ready++;
     }
   }
 
-  for (const auto &object_id : wait_request.object_ids) {
-    object_to_wait_requests_[object_id].emplace(wait_id);
-  }
-
-  if (wait_request.ready.size() >= wait_request.num_required_objects ||
+  if (wait_request.num_ready >= wait_request.num_required_objects ||
       wait_request.timeout_ms == 0) {
     // Requirements already satisfied.
     WaitComplete(wait_id);
-  } else if (wait_request.timeout_ms != -1) {
+    return;
+  }
+
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    if (!wait_request.ready[i]) {
+      object_to_wait_requests_[object_ids[i]].emplace(wait_id, i);
+    }
+  }
+  wait_request.indexed = true;
+
+  if (wait_request.timeout_ms != -1) {
     // If a timeout was provided, then set a timer. If there are no
     // enough locally available objects by the time the timer expires,
     // then we will return from the Wait.
@@ -70,23 +81,31 @@ void WaitManager::Wait(const std::vector<ObjectID> &object_ids,
 void WaitManager::WaitComplete(uint64_t wait_id) {
   auto &wait_request = map_find_or_die(wait_requests_, wait_id);
 
-  for (const auto &object_id : wait_request.object_ids) {
-    auto &requests = object_to_wait_requests_.at(object_id);
-    requests.erase(wait_id);
-    if (requests.empty()) {
-      object_to_wait_requests_.erase(object_id);
+  if (wait_request.indexed) {
+    for (size_t i = 0; i < wait_request.object_ids.size(); i++) {
+      if (wait_request.ready[i]) {
+        continue;
+      }
+      auto it = object_to_wait_requests_.find(wait_request.object_ids[i]);
+      RAY_CHECK(it != object_to_wait_requests_.end());
+      it->second.erase(wait_id);
+      if (it->second.empty()) {
+        object_to_wait_requests_.erase(it);
+      }
     }
   }
 
-  // Order objects according to input order.
+  // Order objects according to input order. A request completes as soon as it has
+  // num_required_objects ready objects, so it never has more.
   std::vector<ObjectID> ready;
   std::vector<ObjectID> remaining;
-  for (const auto &object_id : wait_request.object_ids) {
-    if (ready.size() < wait_request.num_required_objects &&
-        wait_request.ready.count(object_id) > 0) {
-      ready.push_back(object_id);
+  ready.reserve(wait_request.num_ready);
+  remaining.reserve(wait_request.object_ids.size() - wait_request.num_ready);
+  for (size_t i = 0; i < wait_request.object_ids.size(); i++) {
+    if (wait_request.ready[i]) {
+      ready.push_back(wait_request.object_ids[i]);
     } else {
-      remaining.push_back(object_id);
+      remaining.push_back(wait_request.object_ids[i]);
     }
   }
   wait_request.callback(ready, remaining);
@@ -96,16 +115,21 @@ void WaitManager::WaitComplete(uint64_t wait_id) {
 }
 
 void WaitManager::HandleObjectLocal(const ray::ObjectID &object_id) {
-  if (object_to_wait_requests_.find(object_id) == object_to_wait_requests_.end()) {
+  auto it = object_to_wait_requests_.find(object_id);
+  if (it == object_to_wait_requests_.end()) {
     return;
   }
+  // The requests stop waiting for this object, whether or not they complete.
+  const auto waiting_requests = std::move(it->second);
+  object_to_wait_requests_.erase(it);
 
   std::vector<uint64_t> complete_waits;
-  for (const auto &wait_id : object_to_wait_requests_.at(object_id)) {
-    auto &wait_request = map_find_or_die(wait_requests_, wait_id);
-    wait_request.ready.emplace(object_id);
-    if (wait_request.ready.size() >= wait_request.num_required_objects) {
-      complete_waits.emplace_back(wait_id);
+  for (const auto &entry : waiting_requests) {
+    auto &wait_request = map_find_or_die(wait_requests_, entry.first);
+    wait_request.ready[entry.second] = true;
+    wait_request.num_ready++;
+    if (wait_request.num_ready >= wait_request.num_required_objects) {
+      complete_waits.emplace_back(entry.first);
     }
   }
   for (const auto &wait_id : complete_waits) {
@@ -117,6 +141,7 @@ std::string WaitManager::DebugString() const {
   std::stringstream ss;
   ss << "WaitManager:";
   ss << "\n- num active wait requests: " << wait_requests_.size();
+  ss << "\n- num objects waited on: " << object_to_wait_requests_.size();
   return ss.str();
 }
 
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include "absl/container/flat_hash_map.h"
 #include "ray/common/id.h"
 
 namespace ray {
@@ -64,7 +65,8 @@ class WaitManager {
         : timeout_ms(timeout_ms),
           callback(callback),
           object_ids(object_ids),
-          num_required_objects(num_required_objects) {}
+          num_required_objects(num_required_objects),
+          ready(object_ids.size(), false) {}
     /// The period of time to wait before invoking the callback.
     const int64_t timeout_ms;
     /// The callback invoked when Wait is complete.
@@ -73,8 +75,12 @@ class WaitManager {
     const std::vector<ObjectID> object_ids;
     /// The number of required objects.
     const uint64_t num_required_objects;
-    /// The objects that have been locally available.
-    std::unordered_set<ObjectID> ready;
+    /// Whether each of object_ids has been locally available.
+    std::vector<bool> ready;
+    /// The number of objects that have been locally available.
+    uint64_t num_ready = 0;
+    /// Whether the objects that are not ready are in object_to_wait_requests_.
+    bool indexed = false;
   };
 
   /// Completion handler for Wait.
@@ -93,8 +99,11 @@ class WaitManager {
   /// A set of active wait requests.
   std::unordered_map<uint64_t, WaitRequest> wait_requests_;
 
-  /// Map from object to wait requests that are waiting for this object.
-  std::unordered_map<ObjectID, std::unordered_set<uint64_t>> object_to_wait_requests_;
+  /// Map from object to wait requests that are waiting for this object, and the
+  /// index of the object in each request. An object that becomes local is removed
+  /// with its requests, so that each request is only updated once per object.
+  absl::flat_hash_map<ObjectID, absl::flat_hash_map<uint64_t, size_t>>
+      object_to_wait_requests_;
 
   uint64_t next_wait_id_;
 
@@ -36,6 +36,10 @@ class WaitManagerTest : public ::testing::Test {
     ASSERT_TRUE(wait_manager.object_to_wait_requests_.empty());
   }
 
+  size_t NumObjectsWaitedOn() const {
+    return wait_manager.object_to_wait_requests_.size();
+  }
+
   std::unordered_set<ObjectID> local_objects;
   std::function<void()> delay_fn;
   int64_t delay_ms = -1;
@@ -136,6 +140,49 @@ TEST_F(WaitManagerTest, TestWaitTimeout) {
   AssertNoLeaks();
 }
 
+TEST_F(WaitManagerTest, TestWaitOnManyObjects) {
+  std::vector<ObjectID> objects;
+  for (int i = 0; i < 5; i++) {
+    objects.push_back(ObjectID::FromRandom());
+  }
+  local_objects.emplace(objects[3]);
+  std::vector<ObjectID> ready1;
+  std::vector<ObjectID> remaining1;
+  std::vector<ObjectID> ready2;
+  std::vector<ObjectID> remaining2;
+  wait_manager.Wait(objects,
+                    -1,
+                    3,
+                    [&](std::vector<ObjectID> _ready, std::vector<ObjectID> _remaining) {
+                      ready1 = _ready;
+                      remaining1 = _remaining;
+                    });
+  wait_manager.Wait(std::vector<ObjectID>{objects[4], objects[0]},
+                    10,
+                    2,
+                    [&](std::vector<ObjectID> _ready, std::vector<ObjectID> _remaining) {
+                      ready2 = _ready;
+                      remaining2 = _remaining;
+                    });
+  // Only the objects that are not local yet are waited on.
+  ASSERT_EQ(NumObjectsWaitedOn(), 4);
+
+  wait_manager.HandleObjectLocal(objects[4]);
+  ASSERT_TRUE(ready1.empty());
+  wait_manager.HandleObjectLocal(objects[1]);
+  // The ready objects are in the order of the request.
+  ASSERT_EQ(ready1, (std::vector<ObjectID>{objects[1], objects[3], objects[4]}));
+  ASSERT_EQ(remaining1, (std::vector<ObjectID>{objects[0], objects[2]}));
+  ASSERT_EQ(NumObjectsWaitedOn(), 1);
+
+  // Fire the timer of the second request.
+  delay_fn();
+  ASSERT_EQ(ready2, std::vector<ObjectID>{objects[4]});
+  ASSERT_EQ(remaining2, std::vector<ObjectID>{objects[0]});
+
+  AssertNoLeaks();
+}
+
 }  // namespace raylet
 }  // namespace ray
 
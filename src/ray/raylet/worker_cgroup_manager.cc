@@ -0,0 +1,204 @@
+// Copyright 2023 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/worker_cgroup_manager.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "absl/strings/match.h"
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace raylet {
+
+namespace {
+
+/// The period of the CPU quota, in microseconds. This is the kernel's default.
+constexpr int64_t kCpuPeriodMicros = 100000;
+
+/// The smallest CPU quota the kernel accepts, in microseconds.
+constexpr int64_t kMinCpuQuotaMicros = 1000;
+
+constexpr int64_t kNull = -1;
+
+bool WriteCgroupFile(const std::string &path, const std::string &value) {
+  std::ofstream file(path);
+  file << value;
+  file.close();
+  return !file.fail();
+}
+
+bool ReadCgroupFile(const std::string &path, std::string *value) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return false;
+  }
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  *value = buffer.str();
+  return true;
+}
+
+/// Whether a group has no processes left.
+bool IsGroupEmpty(const std::string &group_path) {
+  std::string procs;
+  if (!ReadCgroupFile(group_path + "/cgroup.procs", &procs)) {
+    return false;
+  }
+  return procs.find_first_not_of(" \n") == std::string::npos;
+}
+
+}  // namespace
+
+WorkerCgroupManager::WorkerCgroupManager(std::string root_path)
+    : root_path_(std::move(root_path)) {
+#ifdef __linux__
+  std::string controllers;
+  if (!ReadCgroupFile(root_path_ + "/cgroup.controllers", &controllers)) {
+    RAY_LOG(WARNING) << root_path_ << " is not a cgroup-v2 group, worker processes "
+                     << "will not be put in cgroups.";
+    return;
+  }
+  std::string subtree_control;
+  ReadCgroupFile(root_path_ + "/cgroup.subtree_control", &subtree_control);
+  for (const auto &controller : {"memory", "cpu"}) {
+    if (absl::StrContains(subtree_control, controller)) {
+      continue;
+    }
+    if (!WriteCgroupFile(root_path_ + "/cgroup.subtree_control",
+                         std::string("+") + controller)) {
+      // The group's files will be missing, and the usage of the workers unknown.
+      RAY_LOG(WARNING) << "Failed to enable the " << controller << " controller in "
+                       << root_path_ << ": " << strerror(errno);
+    }
+  }
+  enabled_ = true;
+  RAY_LOG(INFO) << "Worker processes will be put in cgroups under " << root_path_;
+#endif
+}
+
+WorkerCgroupManager::~WorkerCgroupManager() {
+  std::error_code ec;
+  for (const auto &group : released_groups_) {
+    std::filesystem::remove(group, ec);
+  }
+  for (const auto &entry : group_by_pid_) {
+    std::filesystem::remove(entry.second, ec);
+  }
+}
+
+std::string WorkerCgroupManager::AcquireGroup() {
+  for (auto it = released_groups_.begin(); it != released_groups_.end(); it++) {
+    if (IsGroupEmpty(*it)) {
+      std::string group = std::move(*it);
+      released_groups_.erase(it);
+      return group;
+    }
+  }
+  std::string group = root_path_ + "/worker-" + std::to_string(num_groups_created_);
+  std::error_code ec;
+  if (!std::filesystem::create_directory(group, ec) && ec) {
+    RAY_LOG(WARNING) << "Failed to create cgroup " << group << ": " << ec.message();
+    return "";
+  }
+  num_groups_created_++;
+  return group;
+}
+
+void WorkerCgroupManager::AddProcess(pid_t pid) {
+  if (!enabled_ || group_by_pid_.contains(pid)) {
+    return;
+  }
+  std::string group = AcquireGroup();
+  if (group.empty()) {
+    return;
+  }
+  if (!WriteCgroupFile(group + "/cgroup.procs", std::to_string(pid))) {
+    RAY_LOG(WARNING) << "Failed to move process " << pid << " to cgroup " << group
+                     << ": " << strerror(errno);
+    released_groups_.push_back(std::move(group));
+    return;
+  }
+  RAY_LOG(DEBUG) << "Moved process " << pid << " to cgroup " << group;
+  group_by_pid_.emplace(pid, std::move(group));
+}
+
+void WorkerCgroupManager::RemoveProcess(pid_t pid) {
+  auto it = group_by_pid_.find(pid);
+  if (it == group_by_pid_.end()) {
+    return;
+  }
+  // The next process in the group starts without a cap.
+  WriteCgroupFile(it->second + "/cpu.max", "max " + std::to_string(kCpuPeriodMicros));
+  released_groups_.push_back(std::move(it->second));
+  group_by_pid_.erase(it);
+}
+
+void WorkerCgroupManager::SetCpuQuota(pid_t pid, double num_cpus) {
+  auto it = group_by_pid_.find(pid);
+  if (it == group_by_pid_.end()) {
+    return;
+  }
+  std::string quota = "max";
+  if (num_cpus > 0) {
+    auto quota_micros = static_cast<int64_t>(std::ceil(num_cpus * kCpuPeriodMicros));
+    quota = std::to_string(std::max(kMinCpuQuotaMicros, quota_micros));
+  }
+  if (!WriteCgroupFile(it->second + "/cpu.max",
+                       quota + " " + std::to_string(kCpuPeriodMicros))) {
+    RAY_LOG(WARNING) << "Failed to set the CPU quota of cgroup " << it->second << ": "
+                     << strerror(errno);
+  }
+}
+
+int64_t WorkerCgroupManager::GetMemoryBytes(pid_t pid) const {
+  auto it = group_by_pid_.find(pid);
+  std::string value;
+  if (it == group_by_pid_.end() ||
+      !ReadCgroupFile(it->second + "/memory.current", &value)) {
+    return kNull;
+  }
+  std::istringstream stream(value);
+  int64_t bytes = kNull;
+  stream >> bytes;
+  return stream.fail() ? kNull : bytes;
+}
+
+int64_t WorkerCgroupManager::GetCpuUsageMicros(pid_t pid) const {
+  auto it = group_by_pid_.find(pid);
+  std::string value;
+  if (it == group_by_pid_.end() || !ReadCgroupFile(it->second + "/cpu.stat", &value)) {
+    return kNull;
+  }
+  std::istringstream stream(value);
+  std::string key;
+  int64_t micros;
+  while (stream >> key >> micros) {
+    if (key == "usage_usec") {
+      return micros;
+    }
+  }
+  return kNull;
+}
+
+}  // namespace raylet
+
+}  // namespace ray
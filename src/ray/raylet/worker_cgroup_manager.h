@@ -0,0 +1,90 @@
+// Copyright 2023 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <deque>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// \class WorkerCgroupManager
+///
+/// Puts each worker process in its own cgroup-v2 leaf group, under a directory of the
+/// cgroup hierarchy delegated to the raylet. The kernel then accounts the memory and
+/// the CPU time of each worker, which are read from the group's files instead of from
+/// /proc, and the CPU time of a worker can be capped.
+///
+/// The leaf groups are created on demand and reused: the group of a worker that exited
+/// is given to a later worker once it has no processes left.
+class WorkerCgroupManager {
+ public:
+  /// \param root_path A cgroup-v2 directory the raylet can create groups in. The memory
+  /// and cpu controllers are enabled for its children if they aren't already.
+  explicit WorkerCgroupManager(std::string root_path);
+
+  /// Removes the leaf groups that have no processes left.
+  ~WorkerCgroupManager();
+
+  /// Whether the root directory is a usable cgroup-v2 group. If not, the other methods
+  /// do nothing.
+  bool IsEnabled() const { return enabled_; }
+
+  /// Move a process into a leaf group of its own.
+  void AddProcess(pid_t pid);
+
+  /// Stop tracking a process that exited or is being killed. Its group is reused
+  /// once it has no processes left.
+  void RemoveProcess(pid_t pid);
+
+  /// Cap the CPU time of a process to the given number of CPUs.
+  ///
+  /// \param num_cpus The number of CPUs. 0 removes the cap.
+  void SetCpuQuota(pid_t pid, double num_cpus);
+
+  /// \return The memory used by a process and its children, in bytes, or -1 if the
+  /// process isn't tracked.
+  int64_t GetMemoryBytes(pid_t pid) const;
+
+  /// \return The CPU time used by a process and its children, in microseconds, or -1
+  /// if the process isn't tracked.
+  int64_t GetCpuUsageMicros(pid_t pid) const;
+
+ private:
+  /// Get a leaf group without processes, reusing a released one if possible.
+  /// \return The path of the group, or an empty string if none could be created.
+  std::string AcquireGroup();
+
+  /// The directory the leaf groups are created in.
+  const std::string root_path_;
+  /// Whether root_path_ is a cgroup-v2 group.
+  bool enabled_ = false;
+  /// The number of leaf groups created so far, used to name them.
+  int64_t num_groups_created_ = 0;
+  /// The leaf group of each tracked process.
+  absl::flat_hash_map<pid_t, std::string> group_by_pid_;
+  /// The groups of processes that are no longer tracked, oldest first. A group is
+  /// reused only once its processes have exited.
+  std::deque<std::string> released_groups_;
+};
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -0,0 +1,96 @@
+// Copyright 2023 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/worker_cgroup_manager.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "ray/common/id.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// Stands in for cgroupfs with plain files: the groups are directories, and the files
+/// the kernel would provide are written by the test.
+class WorkerCgroupManagerTest : public ::testing::Test {
+ public:
+  WorkerCgroupManagerTest()
+      : root_path_("/tmp/worker_cgroup_manager_test_" + NodeID::FromRandom().Hex()) {
+    std::filesystem::create_directory(root_path_);
+  }
+
+  ~WorkerCgroupManagerTest() { std::filesystem::remove_all(root_path_); }
+
+ protected:
+  void WriteFile(const std::string &path, const std::string &value) {
+    std::ofstream file(root_path_ + "/" + path);
+    file << value;
+  }
+
+  std::string ReadFile(const std::string &path) {
+    std::ifstream file(root_path_ + "/" + path);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+  }
+
+  std::string root_path_;
+};
+
+TEST_F(WorkerCgroupManagerTest, DisabledWithoutCgroupV2) {
+  WorkerCgroupManager manager(root_path_);
+  ASSERT_FALSE(manager.IsEnabled());
+  manager.AddProcess(100);
+  ASSERT_FALSE(std::filesystem::exists(root_path_ + "/worker-0"));
+  ASSERT_EQ(manager.GetMemoryBytes(100), -1);
+}
+
+TEST_F(WorkerCgroupManagerTest, AccountsAndCapsWorkers) {
+  WriteFile("cgroup.controllers", "cpuset cpu io memory pids\n");
+  WriteFile("cgroup.subtree_control", "memory\n");
+  WorkerCgroupManager manager(root_path_);
+  ASSERT_TRUE(manager.IsEnabled());
+  // Only the missing controller is enabled.
+  ASSERT_EQ(ReadFile("cgroup.subtree_control"), "+cpu");
+
+  manager.AddProcess(100);
+  ASSERT_EQ(ReadFile("worker-0/cgroup.procs"), "100");
+  manager.SetCpuQuota(100, 1.5);
+  ASSERT_EQ(ReadFile("worker-0/cpu.max"), "150000 100000");
+
+  WriteFile("worker-0/memory.current", "4096\n");
+  WriteFile("worker-0/cpu.stat", "usage_usec 2500\nuser_usec 2000\nsystem_usec 500\n");
+  ASSERT_EQ(manager.GetMemoryBytes(100), 4096);
+  ASSERT_EQ(manager.GetCpuUsageMicros(100), 2500);
+  ASSERT_EQ(manager.GetMemoryBytes(101), -1);
+
+  // The group of a removed process is uncapped, and only reused once it is empty.
+  manager.RemoveProcess(100);
+  ASSERT_EQ(ReadFile("worker-0/cpu.max"), "max 100000");
+  ASSERT_EQ(manager.GetMemoryBytes(100), -1);
+  manager.AddProcess(101);
+  ASSERT_EQ(ReadFile("worker-1/cgroup.procs"), "101");
+  WriteFile("worker-0/cgroup.procs", "");
+  manager.AddProcess(102);
+  ASSERT_EQ(ReadFile("worker-0/cgroup.procs"), "102");
+  ASSERT_FALSE(std::filesystem::exists(root_path_ + "/worker-2"));
+}
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -0,0 +1,67 @@
+// Copyright 2023 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/worker_demand_forecaster.h"
+
+#include <algorithm>
+
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace raylet {
+
+namespace {
+
+/// Forecasts below this are dropped, so that kinds of workers that are not used any
+/// more are forgotten.
+constexpr double kMinForecast = 0.01;
+
+}  // namespace
+
+WorkerDemandForecaster::WorkerDemandForecaster(double decay) : decay_(decay) {
+  RAY_CHECK(decay_ > 0 && decay_ <= 1) << "Invalid worker demand decay " << decay_;
+}
+
+void WorkerDemandForecaster::Update(
+    const absl::flat_hash_map<WorkerDemandKey, int64_t> &demand) {
+  for (auto it = forecasts_.begin(); it != forecasts_.end();) {
+    auto demand_it = demand.find(it->first);
+    double observed = demand_it == demand.end() ? 0 : demand_it->second;
+    if (observed < it->second) {
+      it->second -= decay_ * (it->second - observed);
+    }
+    if (it->second < kMinForecast) {
+      forecasts_.erase(it++);
+    } else {
+      it++;
+    }
+  }
+  for (const auto &entry : demand) {
+    if (entry.second <= 0) {
+      continue;
+    }
+    auto &forecast = forecasts_[entry.first];
+    forecast = std::max(forecast, static_cast<double>(entry.second));
+  }
+}
+
+double WorkerDemandForecaster::GetForecast(const WorkerDemandKey &key) const {
+  auto it = forecasts_.find(key);
+  return it == forecasts_.end() ? 0 : it->second;
+}
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -0,0 +1,81 @@
+// Copyright 2023 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "absl/container/flat_hash_map.h"
+#include "ray/common/id.h"
+#include "ray/common/task/task_common.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// The workers that can run a task: a worker only runs tasks of one job, and of one
+/// runtime env.
+struct WorkerDemandKey {
+  Language language;
+  int runtime_env_hash;
+  JobID job_id;
+
+  bool operator==(const WorkerDemandKey &other) const {
+    return language == other.language && runtime_env_hash == other.runtime_env_hash &&
+           job_id == other.job_id;
+  }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const WorkerDemandKey &key) {
+    return H::combine(std::move(h),
+                      static_cast<int>(key.language),
+                      key.runtime_env_hash,
+                      key.job_id.Hash());
+  }
+};
+
+/// \class WorkerDemandForecaster
+///
+/// Predicts how many idle workers of each kind the worker pool should keep, from the
+/// history of the number of tasks queued for them.
+///
+/// The forecast follows the demand up immediately and down slowly: each sample closes
+/// only a fraction of the gap to a lower demand. So a worker that was needed a moment
+/// ago is kept warm for a while instead of being killed and started again.
+class WorkerDemandForecaster {
+ public:
+  /// \param decay The fraction of the gap between the forecast and a lower demand that
+  /// is closed by each sample, in (0, 1].
+  explicit WorkerDemandForecaster(double decay);
+
+  /// Record the demand at one point in time.
+  ///
+  /// \param demand The number of tasks waiting for a worker, by kind of worker. Kinds
+  /// that are absent have no demand.
+  void Update(const absl::flat_hash_map<WorkerDemandKey, int64_t> &demand);
+
+  /// Get the predicted number of workers needed, as a fractional value.
+  double GetForecast(const WorkerDemandKey &key) const;
+
+  /// Get the predicted demand of every kind of worker that has some.
+  const absl::flat_hash_map<WorkerDemandKey, double> &GetForecasts() const {
+    return forecasts_;
+  }
+
+ private:
+  const double decay_;
+  absl::flat_hash_map<WorkerDemandKey, double> forecasts_;
+};
+
+}  // namespace raylet
+
+}  // namespace ray
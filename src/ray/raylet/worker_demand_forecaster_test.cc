@@ -0,0 +1,61 @@
+// Copyright 2023 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/worker_demand_forecaster.h"
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+namespace raylet {
+
+class WorkerDemandForecasterTest : public ::testing::Test {
+ protected:
+  const WorkerDemandKey key_{Language::PYTHON, 0, JobID::FromInt(1)};
+  const WorkerDemandKey other_key_{Language::PYTHON, 42, JobID::FromInt(1)};
+  WorkerDemandForecaster forecaster_{/*decay=*/0.5};
+};
+
+TEST_F(WorkerDemandForecasterTest, FollowsDemandUpImmediately) {
+  ASSERT_EQ(forecaster_.GetForecast(key_), 0);
+  forecaster_.Update({{key_, 4}});
+  ASSERT_EQ(forecaster_.GetForecast(key_), 4);
+  forecaster_.Update({{key_, 10}});
+  ASSERT_EQ(forecaster_.GetForecast(key_), 10);
+  // Kinds of workers are forecast separately.
+  ASSERT_EQ(forecaster_.GetForecast(other_key_), 0);
+}
+
+TEST_F(WorkerDemandForecasterTest, FollowsDemandDownSlowly) {
+  forecaster_.Update({{key_, 8}, {other_key_, 8}});
+  forecaster_.Update({{other_key_, 4}});
+  ASSERT_EQ(forecaster_.GetForecast(key_), 4);
+  ASSERT_EQ(forecaster_.GetForecast(other_key_), 6);
+  forecaster_.Update({});
+  ASSERT_EQ(forecaster_.GetForecast(key_), 2);
+  ASSERT_EQ(forecaster_.GetForecast(other_key_), 3);
+}
+
+TEST_F(WorkerDemandForecasterTest, ForgetsUnusedWorkers) {
+  forecaster_.Update({{key_, 1}, {other_key_, 0}});
+  ASSERT_EQ(forecaster_.GetForecasts().size(), 1);
+  for (int i = 0; i < 10; i++) {
+    forecaster_.Update({});
+  }
+  ASSERT_TRUE(forecaster_.GetForecasts().empty());
+}
+
+}  // namespace raylet
+
+}  // namespace ray
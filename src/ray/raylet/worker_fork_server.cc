@@ -0,0 +1,218 @@
+// Copyright 2023 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/worker_fork_server.h"
+
+#ifndef _WIN32
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+#include <cstring>
+#include <istream>
+#include <memory>
+
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "nlohmann/json.hpp"
+#include "ray/common/client_connection.h"
+#include "ray/common/constants.h"
+#include "ray/util/logging.h"
+#include "ray/util/util.h"
+
+namespace ray {
+
+namespace raylet {
+
+namespace {
+
+/// The number of times the zygote is started before workers are started without it,
+/// e.g. because it keeps crashing while importing the worker modules.
+constexpr int kMaxZygoteStarts = 3;
+
+/// How long to wait for the zygote to accept a fork request and reply to it.
+constexpr int kForkRequestTimeoutSeconds = 2;
+
+/// The state of a fork request in flight.
+struct ForkRequest {
+  explicit ForkRequest(instrumented_io_context &io_service)
+      : socket(io_service), timer(io_service) {}
+
+  local_stream_socket socket;
+  boost::asio::deadline_timer timer;
+  std::string request;
+  boost::asio::streambuf reply;
+  std::function<void(pid_t)> callback;
+  bool done = false;
+};
+
+/// Finish the request with the given pid, unless it already finished. Closing the
+/// socket aborts the operations still pending on it.
+void FinishForkRequest(const std::shared_ptr<ForkRequest> &state, pid_t pid) {
+  if (state->done) {
+    return;
+  }
+  state->done = true;
+  state->timer.cancel();
+  boost::system::error_code ec;
+  state->socket.close(ec);
+  state->callback(pid);
+}
+
+}  // namespace
+
+WorkerForkServer::WorkerForkServer(instrumented_io_context &io_service,
+                                   std::string socket_path,
+                                   StartProcessFn start_process)
+    : io_service_(io_service),
+      socket_path_(std::move(socket_path)),
+      start_process_(std::move(start_process)) {}
+
+WorkerForkServer::~WorkerForkServer() {
+  if (zygote_.IsValid()) {
+    zygote_.Kill();
+  }
+}
+
+bool WorkerForkServer::CanForkWorker(
+    const std::vector<std::string> &worker_command_args) {
+#ifdef _WIN32
+  return false;
+#else
+  // Workers with a runtime env are started through setup_worker.py, which may exec
+  // another interpreter, so they can't be forked from the zygote.
+  if (worker_command_args.size() < 2 ||
+      !absl::EndsWith(worker_command_args[1], kDefaultWorkerFilename)) {
+    return false;
+  }
+  if (socket_path_.size() >= sizeof(sockaddr_un::sun_path)) {
+    RAY_LOG_EVERY_N(WARNING, 100)
+        << "The worker fork server socket path " << socket_path_ << " is too long.";
+    return false;
+  }
+  MaybeStartZygote(worker_command_args);
+  return zygote_.IsValid();
+#endif
+}
+
+void WorkerForkServer::ForkWorker(const std::vector<std::string> &worker_command_args,
+                                  const ProcessEnvironment &env,
+                                  std::function<void(Process)> callback) {
+  nlohmann::json request;
+  request["args"] = std::vector<std::string>(worker_command_args.begin() + 1,
+                                             worker_command_args.end());
+  request["env"] = nlohmann::json::object();
+  for (const auto &entry : env) {
+    request["env"][entry.first] = entry.second;
+  }
+  SendForkRequest(request.dump() + "\n", [callback = std::move(callback)](pid_t pid) {
+    callback(pid > 0 ? Process::FromPid(pid) : Process());
+  });
+}
+
+void WorkerForkServer::MaybeStartZygote(
+    const std::vector<std::string> &worker_command_args) {
+  if (zygote_.IsValid() && zygote_.IsAlive()) {
+    return;
+  }
+  if (num_zygote_starts_ >= kMaxZygoteStarts) {
+    if (zygote_.IsValid()) {
+      RAY_LOG(WARNING) << "The worker fork server exited " << num_zygote_starts_
+                       << " times, workers will be started without it.";
+      zygote_ = Process();
+    }
+    return;
+  }
+#ifndef _WIN32
+  // Remove the socket of a previous zygote, so that no request is sent before the new
+  // one listens.
+  unlink(socket_path_.c_str());
+#endif
+  const auto &worker_path = worker_command_args[1];
+  std::vector<std::string> zygote_command_args = {
+      worker_command_args[0],
+      worker_path.substr(0, worker_path.size() - strlen(kDefaultWorkerFilename)) +
+          kWorkerForkServerFilename,
+      "--socket-path=" + socket_path_};
+  zygote_ = start_process_(zygote_command_args, {});
+  num_zygote_starts_++;
+  RAY_LOG(INFO) << "Started worker fork server with pid " << zygote_.GetId()
+                << ", listening on " << socket_path_;
+}
+
+void WorkerForkServer::SendForkRequest(std::string request,
+                                       std::function<void(pid_t)> callback) {
+  auto state = std::make_shared<ForkRequest>(io_service_);
+  state->request = std::move(request);
+  state->callback = std::move(callback);
+
+  state->timer.expires_from_now(boost::posix_time::seconds(kForkRequestTimeoutSeconds));
+  state->timer.async_wait([state](const boost::system::error_code &ec) {
+    if (ec == boost::asio::error::operation_aborted || state->done) {
+      return;
+    }
+    RAY_LOG(WARNING) << "The worker fork server didn't reply within "
+                     << kForkRequestTimeoutSeconds << " seconds.";
+    FinishForkRequest(state, -1);
+  });
+
+  state->socket.async_connect(
+      ParseUrlEndpoint("unix://" + socket_path_),
+      [state](const boost::system::error_code &ec) {
+        if (ec) {
+          // The zygote is still importing the worker modules.
+          RAY_LOG(DEBUG) << "The worker fork server isn't ready yet: " << ec.message();
+          FinishForkRequest(state, -1);
+          return;
+        }
+        boost::asio::async_write(
+            state->socket,
+            boost::asio::buffer(state->request),
+            [state](const boost::system::error_code &write_ec, size_t) {
+              if (write_ec) {
+                FinishForkRequest(state, -1);
+                return;
+              }
+              boost::asio::async_read_until(
+                  state->socket,
+                  state->reply,
+                  '\n',
+                  [state](const boost::system::error_code &read_ec, size_t) {
+                    std::string reply;
+                    if (!read_ec) {
+                      std::istream is(&state->reply);
+                      std::getline(is, reply);
+                    }
+                    pid_t pid = -1;
+                    if (!absl::SimpleAtoi(reply, &pid) || pid <= 0) {
+                      if (!state->done) {
+                        RAY_LOG(WARNING)
+                            << "The worker fork server failed to fork a worker, reply: \""
+                            << reply << "\"";
+                      }
+                      pid = -1;
+                    }
+                    FinishForkRequest(state, pid);
+                  });
+            });
+      });
+}
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -0,0 +1,97 @@
+// Copyright 2023 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "ray/common/asio/instrumented_io_context.h"
+#include "ray/util/process.h"
+
+namespace ray {
+
+namespace raylet {
+
+using StartProcessFn = std::function<Process(
+    const std::vector<std::string> &command_args, const ProcessEnvironment &env)>;
+
+/// \class WorkerForkServer
+///
+/// Starts Python workers by forking them from a zygote, a long-lived process that has
+/// already imported the worker modules, instead of starting a new interpreter for
+/// each of them.
+///
+/// The zygote listens on a Unix domain socket. A request is one line of JSON with the
+/// arguments and the environment variables of the worker, and the reply is the pid of
+/// the forked worker. The zygote reaps the workers it forks, so they are not children
+/// of the raylet. Requests are sent asynchronously on the raylet's event loop.
+class WorkerForkServer {
+ public:
+  /// Create a fork server. The zygote is started by the first CanForkWorker call.
+  ///
+  /// \param io_service The event loop the fork requests run on.
+  /// \param socket_path The path of the socket the zygote listens on.
+  /// \param start_process Starts the zygote process.
+  WorkerForkServer(instrumented_io_context &io_service,
+                   std::string socket_path,
+                   StartProcessFn start_process);
+
+  /// Kills the zygote. The workers it forked keep running.
+  ~WorkerForkServer();
+
+  /// Whether the worker can be forked from the zygote, i.e. whether it is a plain
+  /// Python worker. Starts the zygote if needed.
+  ///
+  /// \param worker_command_args The command of the worker, i.e. the python executable
+  /// and the path of default_worker.py followed by the worker's arguments.
+  bool CanForkWorker(const std::vector<std::string> &worker_command_args);
+
+  /// Fork a worker from the zygote, without blocking the event loop. CanForkWorker
+  /// must have returned true for the command.
+  ///
+  /// \param worker_command_args The command of the worker.
+  /// \param env The environment variables to add to the worker's environment.
+  /// \param callback Called on the event loop with the worker process. It is null if
+  /// the zygote isn't ready yet, or if it failed to fork or didn't reply in time. The
+  /// caller should start the worker itself in that case.
+  void ForkWorker(const std::vector<std::string> &worker_command_args,
+                  const ProcessEnvironment &env,
+                  std::function<void(Process)> callback);
+
+ private:
+  /// Start the zygote with the interpreter of the given worker command, or restart it
+  /// if it died. Gives up after too many restarts.
+  void MaybeStartZygote(const std::vector<std::string> &worker_command_args);
+
+  /// Send a fork request to the zygote, and call the callback with the pid of the
+  /// forked worker, or -1 on failure.
+  void SendForkRequest(std::string request, std::function<void(pid_t)> callback);
+
+  /// The event loop the fork requests run on.
+  instrumented_io_context &io_service_;
+  /// The path of the socket the zygote listens on.
+  const std::string socket_path_;
+  /// Starts the zygote process.
+  StartProcessFn start_process_;
+  /// The zygote process, null until the first CanForkWorker call.
+  Process zygote_;
+  /// The number of times the zygote was started.
+  int num_zygote_starts_ = 0;
+};
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -0,0 +1,168 @@
+// Copyright 2023 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/worker_fork_server.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "nlohmann/json.hpp"
+#include "ray/common/id.h"
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace raylet {
+
+using json = nlohmann::json;
+
+/// Stands in for the Python zygote: answers one fork request with a fixed pid.
+class FakeZygote {
+ public:
+  explicit FakeZygote(const std::string &socket_path) {
+    fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+    RAY_CHECK(bind(fd_, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == 0);
+    RAY_CHECK(listen(fd_, 1) == 0);
+    thread_ = std::thread([this]() {
+      int conn = accept(fd_, nullptr, nullptr);
+      char c;
+      while (read(conn, &c, 1) == 1 && c != '\n') {
+        request_.push_back(c);
+      }
+      std::string reply = "4242\n";
+      RAY_CHECK(write(conn, reply.data(), reply.size()) ==
+                static_cast<ssize_t>(reply.size()));
+      close(conn);
+    });
+  }
+
+  ~FakeZygote() {
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    close(fd_);
+  }
+
+  std::string WaitForRequest() {
+    thread_.join();
+    return request_;
+  }
+
+ private:
+  int fd_;
+  std::thread thread_;
+  std::string request_;
+};
+
+class WorkerForkServerTest : public ::testing::Test {
+ public:
+  WorkerForkServerTest()
+      : socket_path_("/tmp/worker_fork_server_test_" + NodeID::FromRandom().Hex()),
+        fork_server_(io_service_,
+                     socket_path_,
+                     [this](const std::vector<std::string> &command_args,
+                            const ProcessEnvironment &env) {
+                       zygote_command_args_.push_back(command_args);
+                       if (zygote_ready_) {
+                         fake_zygote_ = std::make_unique<FakeZygote>(socket_path_);
+                       }
+                       // Something alive that can be killed in place of the zygote.
+                       return Process::Spawn({"sleep", "60"}, /*decouple=*/false).first;
+                     }) {}
+
+  ~WorkerForkServerTest() { unlink(socket_path_.c_str()); }
+
+ protected:
+  /// Send a fork request and run the event loop until it completes.
+  Process ForkWorker(const ProcessEnvironment &env) {
+    Process result;
+    bool done = false;
+    fork_server_.ForkWorker(worker_command_args_, env, [&](Process proc) {
+      result = proc;
+      done = true;
+    });
+    while (!done) {
+      io_service_.run_one();
+    }
+    io_service_.restart();
+    return result;
+  }
+
+  instrumented_io_context io_service_;
+  const std::vector<std::string> worker_command_args_ = {
+      "/usr/bin/python3",
+      "/ray/_private/workers/default_worker.py",
+      "--node-ip-address=127.0.0.1",
+      "--startup-token=0"};
+  std::string socket_path_;
+  bool zygote_ready_ = true;
+  std::vector<std::vector<std::string>> zygote_command_args_;
+  std::unique_ptr<FakeZygote> fake_zygote_;
+  WorkerForkServer fork_server_;
+};
+
+TEST_F(WorkerForkServerTest, ForksWorkerFromZygote) {
+  ProcessEnvironment env;
+  env.emplace("RAY_JOB_ID", "01000000");
+  ASSERT_TRUE(fork_server_.CanForkWorker(worker_command_args_));
+  auto proc = ForkWorker(env);
+  ASSERT_EQ(proc.GetId(), 4242);
+
+  // The zygote runs with the worker's interpreter, next to default_worker.py.
+  ASSERT_EQ(zygote_command_args_.size(), 1);
+  ASSERT_EQ(zygote_command_args_[0],
+            std::vector<std::string>({"/usr/bin/python3",
+                                      "/ray/_private/workers/worker_fork_server.py",
+                                      "--socket-path=" + socket_path_}));
+
+  auto request = json::parse(fake_zygote_->WaitForRequest());
+  ASSERT_EQ(request["args"].get<std::vector<std::string>>(),
+            std::vector<std::string>(worker_command_args_.begin() + 1,
+                                     worker_command_args_.end()));
+  ASSERT_EQ(request["env"]["RAY_JOB_ID"], "01000000");
+}
+
+TEST_F(WorkerForkServerTest, FallsBackWhileZygoteIsNotReady) {
+  zygote_ready_ = false;
+  ASSERT_TRUE(fork_server_.CanForkWorker(worker_command_args_));
+  auto proc = ForkWorker({});
+  ASSERT_TRUE(proc.IsNull());
+  // The zygote is only started once.
+  ASSERT_TRUE(fork_server_.CanForkWorker(worker_command_args_));
+  proc = ForkWorker({});
+  ASSERT_TRUE(proc.IsNull());
+  ASSERT_EQ(zygote_command_args_.size(), 1);
+}
+
+TEST_F(WorkerForkServerTest, DoesNotForkWorkersWithRuntimeEnv) {
+  ASSERT_FALSE(
+      fork_server_.CanForkWorker({"/usr/bin/python3",
+                                  "/ray/_private/workers/setup_worker.py",
+                                  "/ray/_private/workers/default_worker.py",
+                                  "--serialized-runtime-env-context={}"}));
+  ASSERT_TRUE(zygote_command_args_.empty());
+}
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -16,8 +16,10 @@
 
 #include <algorithm>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <cmath>
 #include <fstream>
 
+#include "absl/strings/match.h"
 #include "ray/common/constants.h"
 #include "ray/common/network_util.h"
 #include "ray/common/ray_config.h"
@@ -88,6 +90,7 @@ WorkerPool::WorkerPool(instrumented_io_context &io_service,
       node_address_(node_address),
       num_workers_soft_limit_(num_workers_soft_limit),
       maximum_startup_concurrency_(maximum_startup_concurrency),
+      demand_forecaster_(RayConfig::instance().worker_demand_forecast_decay()),
       gcs_client_(std::move(gcs_client)),
       native_library_path_(native_library_path),
       starting_worker_timeout_callback_(starting_worker_timeout_callback),
@@ -133,6 +136,30 @@ WorkerPool::WorkerPool(instrumented_io_context &io_service,
       free_ports_->push(port);
     }
   }
+  auto python_state = states_by_lang_.find(Language::PYTHON);
+  if (RayConfig::instance().worker_fork_server_enabled() &&
+      python_state != states_by_lang_.end()) {
+    // The zygote's socket sits next to the raylet's socket.
+    static const std::string kRayletNameOption = "--raylet-name=";
+    for (const auto &token : python_state->second.worker_command) {
+      if (absl::StartsWith(token, kRayletNameOption)) {
+        fork_server_ = std::make_unique<WorkerForkServer>(
+            *io_service_,
+            token.substr(kRayletNameOption.size()) + ".fork_server",
+            [this](const std::vector<std::string> &command_args,
+                   const ProcessEnvironment &env) {
+              return StartProcess(command_args, env);
+            });
+      }
+    }
+  }
+  if (!RayConfig::instance().worker_cgroup_root().empty()) {
+    cgroup_manager_ = std::make_unique<WorkerCgroupManager>(
+        RayConfig::instance().worker_cgroup_root());
+    if (!cgroup_manager_->IsEnabled()) {
+      cgroup_manager_.reset();
+    }
+  }
   if (RayConfig::instance().kill_idle_workers_interval_ms() > 0) {
     periodical_runner_.RunFnPeriodically(
         [this] { TryKillingIdleWorkers(); },
@@ -200,18 +227,26 @@ void WorkerPool::AddWorkerProcess(
     const rpc::WorkerType worker_type,
     const Process &proc,
     const std::chrono::high_resolution_clock::time_point &start,
-    const rpc::RuntimeEnvInfo &runtime_env_info) {
+    const rpc::RuntimeEnvInfo &runtime_env_info,
+    const JobID &job_id,
+    int runtime_env_hash) {
   state.worker_processes.emplace(worker_startup_token_counter_,
                                  WorkerProcessInfo{/*is_pending_registration=*/true,
                                                    {},
                                                    worker_type,
                                                    proc,
                                                    start,
-                                                   runtime_env_info});
+                                                   runtime_env_info,
+                                                   job_id,
+                                                   runtime_env_hash});
 }
 
 void WorkerPool::RemoveWorkerProcess(State &state,
                                      const StartupToken &proc_startup_token) {
+  auto it = state.worker_processes.find(proc_startup_token);
+  if (cgroup_manager_ && it != state.worker_processes.end()) {
+    cgroup_manager_->RemoveProcess(it->second.proc.GetId());
+  }
   state.worker_processes.erase(proc_startup_token);
 }
 
@@ -439,19 +474,44 @@ std::tuple<Process, StartupToken> WorkerPool::StartWorkerProcess(
 
   // Start a process and measure the startup time.
   auto start = std::chrono::high_resolution_clock::now();
-  Process proc = StartProcess(worker_command_args, env);
-  auto end = std::chrono::high_resolution_clock::now();
-  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-  stats::ProcessStartupTimeMs.Record(duration.count());
-  stats::NumWorkersStarted.Record(1);
-  RAY_LOG(INFO) << "Started worker process with pid " << proc.GetId() << ", the token is "
-                << worker_startup_token_counter_;
-  if (!IsIOWorkerType(worker_type)) {
-    AdjustWorkerOomScore(proc.GetId());
+  Process proc;
+  const bool fork = fork_server_ && worker_type == rpc::WorkerType::WORKER &&
+                    language == Language::PYTHON &&
+                    fork_server_->CanForkWorker(worker_command_args);
+  if (fork) {
+    // The pid of the worker is only known once the zygote replies, until then the
+    // process is a placeholder.
+    proc = Process::CreateNewDummy();
+    fork_server_->ForkWorker(
+        worker_command_args,
+        env,
+        [this,
+         language,
+         worker_command_args,
+         env,
+         worker_startup_token = worker_startup_token_counter_](Process forked) {
+          OnWorkerForked(
+              language, worker_startup_token, worker_command_args, env, forked);
+        });
+  } else {
+    proc = StartProcess(worker_command_args, env);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    stats::ProcessStartupTimeMs.Record(duration.count());
+    RAY_LOG(INFO) << "Started worker process with pid " << proc.GetId()
+                  << ", the token is " << worker_startup_token_counter_;
+    if (!IsIOWorkerType(worker_type)) {
+      AdjustWorkerOomScore(proc.GetId());
+    }
+    if (cgroup_manager_) {
+      cgroup_manager_->AddProcess(proc.GetId());
+    }
   }
+  stats::NumWorkersStarted.Record(1);
   MonitorStartingWorkerProcess(
       proc, worker_startup_token_counter_, language, worker_type);
-  AddWorkerProcess(state, worker_type, proc, start, runtime_env_info);
+  AddWorkerProcess(
+      state, worker_type, proc, start, runtime_env_info, job_id, runtime_env_hash);
   StartupToken worker_startup_token = worker_startup_token_counter_;
   update_worker_startup_token_counter();
   if (IsIOWorkerType(worker_type)) {
@@ -461,6 +521,45 @@ std::tuple<Process, StartupToken> WorkerPool::StartWorkerProcess(
   return {proc, worker_startup_token};
 }
 
+void WorkerPool::OnWorkerForked(const Language &language,
+                                StartupToken worker_startup_token,
+                                const std::vector<std::string> &worker_command_args,
+                                const ProcessEnvironment &env,
+                                Process proc) {
+  auto &state = GetStateForLanguage(language);
+  auto it = state.worker_processes.find(worker_startup_token);
+  if (it == state.worker_processes.end()) {
+    // The worker timed out while the zygote was forking it.
+    if (proc.IsValid()) {
+      proc.Kill();
+    }
+    return;
+  }
+  if (!proc.IsValid()) {
+    // The zygote isn't ready or failed to fork, start the worker the regular way.
+    proc = StartProcess(worker_command_args, env);
+  }
+  stats::ProcessStartupTimeMs.Record(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::high_resolution_clock::now() - it->second.start_time)
+          .count());
+  RAY_LOG(INFO) << "Started worker process with pid " << proc.GetId() << ", the token is "
+                << worker_startup_token;
+  AdjustWorkerOomScore(proc.GetId());
+  if (cgroup_manager_) {
+    cgroup_manager_->AddProcess(proc.GetId());
+  }
+  it->second.proc = proc;
+}
+
+int64_t WorkerPool::GetWorkerMemoryBytes(pid_t pid) const {
+  return cgroup_manager_ ? cgroup_manager_->GetMemoryBytes(pid) : -1;
+}
+
+int64_t WorkerPool::GetWorkerCpuUsageMicros(pid_t pid) const {
+  return cgroup_manager_ ? cgroup_manager_->GetCpuUsageMicros(pid) : -1;
+}
+
 void WorkerPool::AdjustWorkerOomScore(pid_t pid) const {
 #ifdef __linux__
   std::ofstream oom_score_file;
@@ -499,6 +598,8 @@ void WorkerPool::MonitorStartingWorkerProcess(const Process &proc,
     // to avoid the zombie worker.
     auto it = state.worker_processes.find(proc_startup_token);
     if (it != state.worker_processes.end() && it->second.is_pending_registration) {
+      // A forked worker's pid is only known once the zygote replied.
+      proc = it->second.proc;
       RAY_LOG(ERROR)
           << "Some workers of the worker process(" << proc.GetId()
           << ") have not registered within the timeout. "
@@ -953,6 +1054,10 @@ void WorkerPool::PushWorker(const std::shared_ptr<WorkerInterface> &worker) {
   // Since the worker is now idle, unset its assigned task ID.
   RAY_CHECK(worker->GetAssignedTaskId().IsNil())
       << "Idle workers cannot have an assigned task ID";
+  if (cgroup_manager_) {
+    // The worker may be given a task with fewer CPUs next.
+    cgroup_manager_->SetCpuQuota(worker->GetProcess().GetId(), 0);
+  }
   auto &state = GetStateForLanguage(worker->GetLanguage());
   bool found;
   bool used;
@@ -1013,6 +1118,11 @@ void WorkerPool::TryKillingIdleWorkers() {
   // idle workers that it needs to.
   RAY_CHECK(running_size >= pending_exit_idle_workers_.size());
   running_size -= pending_exit_idle_workers_.size();
+  // The number of idle workers of each kind to keep for the forecast demand.
+  absl::flat_hash_map<WorkerDemandKey, int64_t> num_idle_to_keep;
+  for (const auto &entry : demand_forecaster_.GetForecasts()) {
+    num_idle_to_keep[entry.first] = static_cast<int64_t>(std::ceil(entry.second));
+  }
   // Kill idle workers in FIFO order.
   for (const auto &idle_pair : idle_of_all_languages_) {
     const auto &idle_worker = idle_pair.first;
@@ -1035,6 +1145,16 @@ void WorkerPool::TryKillingIdleWorkers() {
       // This is possible because a Java worker process may hold multiple workers.
       continue;
     }
+
+    if (!finished_jobs_.count(job_id)) {
+      auto keep_it = num_idle_to_keep.find(WorkerDemandKey{
+          idle_worker->GetLanguage(), idle_worker->GetRuntimeEnvHash(), job_id});
+      if (keep_it != num_idle_to_keep.end() && keep_it->second > 0) {
+        // This worker is forecast to be needed soon.
+        keep_it->second--;
+        continue;
+      }
+    }
     auto worker_startup_token = idle_worker->GetStartupToken();
     auto &worker_state = GetStateForLanguage(idle_worker->GetLanguage());
 
@@ -1165,10 +1285,25 @@ void WorkerPool::TryKillingIdleWorkers() {
 }
 
 void WorkerPool::PopWorker(const TaskSpecification &task_spec,
-                           const PopWorkerCallback &callback,
+                           const PopWorkerCallback &pop_callback,
                            const std::string &allocated_instances_serialized_json) {
   RAY_LOG(DEBUG) << "Pop worker for task " << task_spec.TaskId() << " task name "
                  << task_spec.FunctionDescriptor()->ToString();
+  PopWorkerCallback callback = pop_callback;
+  if (cgroup_manager_ && RayConfig::instance().worker_cgroup_cpu_quota()) {
+    // Cap the worker to the CPUs of the task, once the task is given to it.
+    const double num_cpus = task_spec.GetRequiredResources().GetNumCpusAsDouble();
+    callback = [this, pop_callback, num_cpus](
+                   const std::shared_ptr<WorkerInterface> worker,
+                   PopWorkerStatus status,
+                   const std::string &runtime_env_setup_error_message) {
+      bool used = pop_callback(worker, status, runtime_env_setup_error_message);
+      if (used && worker) {
+        cgroup_manager_->SetCpuQuota(worker->GetProcess().GetId(), num_cpus);
+      }
+      return used;
+    };
+  }
   auto &state = GetStateForLanguage(task_spec.GetLanguage());
 
   std::shared_ptr<WorkerInterface> worker = nullptr;
@@ -1265,21 +1400,9 @@ void WorkerPool::PopWorker(const TaskSpecification &task_spec,
     // Find an available worker which is already assigned to this job and which has
     // the specified runtime env.
     // Try to pop the most recently pushed worker.
-    const int runtime_env_hash = task_spec.GetRuntimeEnvHash();
     for (auto it = idle_of_all_languages_.rbegin(); it != idle_of_all_languages_.rend();
          it++) {
-      if (task_spec.GetLanguage() != it->first->GetLanguage() ||
-          it->first->GetAssignedJobId() != task_spec.JobId() ||
-          state.pending_disconnection_workers.count(it->first) > 0 ||
-          it->first->IsDead()) {
-        continue;
-      }
-      // These workers are exiting. So skip them.
-      if (pending_exit_idle_workers_.count(it->first->WorkerId())) {
-        continue;
-      }
-      // Skip if the runtime env doesn't match.
-      if (runtime_env_hash != it->first->GetRuntimeEnvHash()) {
+      if (!IsIdleWorkerUsable(it->first, task_spec, state)) {
         continue;
       }
 
@@ -1337,6 +1460,39 @@ void WorkerPool::PopWorker(const TaskSpecification &task_spec,
   }
 }
 
+bool WorkerPool::IsIdleWorkerUsable(const std::shared_ptr<WorkerInterface> &worker,
+                                    const TaskSpecification &task_spec,
+                                    const State &state) const {
+  if (task_spec.GetLanguage() != worker->GetLanguage() ||
+      worker->GetAssignedJobId() != task_spec.JobId() ||
+      state.pending_disconnection_workers.count(worker) > 0 || worker->IsDead()) {
+    return false;
+  }
+  // These workers are exiting. So skip them.
+  if (pending_exit_idle_workers_.count(worker->WorkerId())) {
+    return false;
+  }
+  // Skip if the runtime env doesn't match.
+  return task_spec.GetRuntimeEnvHash() == worker->GetRuntimeEnvHash();
+}
+
+bool WorkerPool::HasIdleWorker(const TaskSpecification &task_spec) const {
+  if (task_spec.IsActorTask() ||
+      (task_spec.IsActorCreationTask() && !task_spec.DynamicWorkerOptions().empty())) {
+    return false;
+  }
+  auto state_it = states_by_lang_.find(task_spec.GetLanguage());
+  if (state_it == states_by_lang_.end()) {
+    return false;
+  }
+  for (const auto &idle_pair : idle_of_all_languages_) {
+    if (IsIdleWorkerUsable(idle_pair.first, task_spec, state_it->second)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void WorkerPool::PrestartWorkers(const TaskSpecification &task_spec,
                                  int64_t backlog_size,
                                  int64_t num_available_cpus) {
@@ -1370,6 +1526,71 @@ void WorkerPool::PrestartWorkers(const TaskSpecification &task_spec,
   }
 }
 
+void WorkerPool::UpdateWorkerDemand(
+    const absl::flat_hash_map<WorkerDemandKey, int64_t> &demand) {
+  demand_forecaster_.Update(demand);
+  PrestartForecastedWorkers();
+}
+
+void WorkerPool::PrestartForecastedWorkers() {
+  // The workers that count towards the soft limit, registered or starting.
+  int64_t num_workers = GetAllRegisteredWorkers(/*filter_dead_workers=*/true,
+                                                /*filter_io_workers=*/true)
+                            .size();
+  for (const auto &entry : states_by_lang_) {
+    for (const auto &process : entry.second.worker_processes) {
+      if (process.second.is_pending_registration &&
+          process.second.worker_type == rpc::WorkerType::WORKER) {
+        num_workers++;
+      }
+    }
+  }
+
+  for (const auto &entry : demand_forecaster_.GetForecasts()) {
+    const auto &key = entry.first;
+    if (key.runtime_env_hash != 0 || !states_by_lang_.contains(key.language) ||
+        !all_jobs_.contains(key.job_id) || finished_jobs_.contains(key.job_id)) {
+      continue;
+    }
+    int64_t num_needed = static_cast<int64_t>(entry.second) - NumWarmWorkers(key);
+    if (num_needed <= 0) {
+      continue;
+    }
+    RAY_LOG(DEBUG) << "Prestarting " << num_needed << " workers for job " << key.job_id
+                   << " given forecast demand " << entry.second;
+    for (; num_needed > 0 && num_workers < num_workers_soft_limit_; num_needed--) {
+      PopWorkerStatus status;
+      auto [proc, startup_token] =
+          StartWorkerProcess(key.language, rpc::WorkerType::WORKER, key.job_id, &status);
+      if (!proc.IsValid()) {
+        // Too many workers are starting, try again at the next sample.
+        break;
+      }
+      num_workers++;
+    }
+  }
+}
+
+int64_t WorkerPool::NumWarmWorkers(const WorkerDemandKey &key) {
+  auto &state = GetStateForLanguage(key.language);
+  int64_t num_warm = 0;
+  for (const auto &worker : state.idle) {
+    if (worker->GetAssignedJobId() == key.job_id &&
+        worker->GetRuntimeEnvHash() == key.runtime_env_hash) {
+      num_warm++;
+    }
+  }
+  for (const auto &entry : state.worker_processes) {
+    const auto &process = entry.second;
+    if (process.is_pending_registration &&
+        process.worker_type == rpc::WorkerType::WORKER && process.job_id == key.job_id &&
+        process.runtime_env_hash == key.runtime_env_hash) {
+      num_warm++;
+    }
+  }
+  return num_warm;
+}
+
 void WorkerPool::DisconnectWorker(const std::shared_ptr<WorkerInterface> &worker,
                                   rpc::WorkerExitType disconnect_type) {
   MarkPortAsFree(worker->AssignedPort());
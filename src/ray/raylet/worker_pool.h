@@ -34,6 +34,9 @@
 #include "ray/gcs/gcs_client/gcs_client.h"
 #include "ray/raylet/agent_manager.h"
 #include "ray/raylet/worker.h"
+#include "ray/raylet/worker_cgroup_manager.h"
+#include "ray/raylet/worker_demand_forecaster.h"
+#include "ray/raylet/worker_fork_server.h"
 
 namespace ray {
 
@@ -105,6 +108,14 @@ class WorkerPoolInterface {
       const TaskSpecification &task_spec,
       const PopWorkerCallback &callback,
       const std::string &allocated_instances_serialized_json = "{}") = 0;
+
+  /// Whether `PopWorker` would hand an idle worker to this task right away, without
+  /// starting a worker process.
+  ///
+  /// \param task_spec The task to check.
+  /// \return True if an idle worker can execute the task.
+  virtual bool HasIdleWorker(const TaskSpecification &task_spec) const = 0;
+
   /// Add an idle worker to the pool.
   ///
   /// \param The idle worker to add.
@@ -338,6 +349,9 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
                  const PopWorkerCallback &callback,
                  const std::string &allocated_instances_serialized_json = "{}");
 
+  /// See interface.
+  bool HasIdleWorker(const TaskSpecification &task_spec) const;
+
   /// Try to prestart a number of workers suitable the given task spec. Prestarting
   /// is needed since core workers request one lease at a time, if starting is slow,
   /// then it means it takes a long time to scale up.
@@ -350,6 +364,13 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
                        int64_t backlog_size,
                        int64_t num_available_cpus);
 
+  /// Record the number of queued tasks of each kind of worker, and prestart the
+  /// workers that the demand forecast says will be needed soon. Idle workers within
+  /// the forecast are kept from being killed, see `TryKillingIdleWorkers`.
+  ///
+  /// \param demand The number of queued tasks that need a worker, by kind of worker.
+  void UpdateWorkerDemand(const absl::flat_hash_map<WorkerDemandKey, int64_t> &demand);
+
   /// Return the current size of the worker pool for the requested language. Counts only
   /// idle workers.
   ///
@@ -371,6 +392,18 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   const std::vector<std::shared_ptr<WorkerInterface>> GetAllRegisteredDrivers(
       bool filter_dead_drivers = false) const;
 
+  /// Get the memory used by a worker process and its children, as accounted by its
+  /// cgroup.
+  ///
+  /// \return The number of bytes, or -1 if the worker is not in a cgroup.
+  int64_t GetWorkerMemoryBytes(pid_t pid) const;
+
+  /// Get the CPU time used by a worker process and its children, as accounted by its
+  /// cgroup.
+  ///
+  /// \return The number of microseconds, or -1 if the worker is not in a cgroup.
+  int64_t GetWorkerCpuUsageMicros(pid_t pid) const;
+
   /// Returns debug string for class.
   ///
   /// \return string.
@@ -462,6 +495,10 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
     std::chrono::high_resolution_clock::time_point start_time;
     /// The runtime env Info.
     rpc::RuntimeEnvInfo runtime_env_info;
+    /// The job the worker is started for, nil for IO workers.
+    JobID job_id;
+    /// The hash of the runtime env of the worker.
+    int runtime_env_hash = 0;
   };
 
   struct TaskWaitingForWorkerInfo {
@@ -570,6 +607,12 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   /// worker.
   void TryStartIOWorkers(const Language &language, const rpc::WorkerType &worker_type);
 
+  /// Whether an idle worker can be given to a task that doesn't need a dedicated
+  /// worker: it belongs to the task's job, has its runtime env, and isn't exiting.
+  bool IsIdleWorkerUsable(const std::shared_ptr<WorkerInterface> &worker,
+                          const TaskSpecification &task_spec,
+                          const State &state) const;
+
   /// Try to fulfill pending PopWorker requests.
   /// This happens when we have more room to start workers or an idle worker is pushed.
   /// \param language The language of the PopWorker requests.
@@ -676,14 +719,38 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
                         const rpc::WorkerType worker_type,
                         const Process &proc,
                         const std::chrono::high_resolution_clock::time_point &start,
-                        const rpc::RuntimeEnvInfo &runtime_env_info);
+                        const rpc::RuntimeEnvInfo &runtime_env_info,
+                        const JobID &job_id,
+                        int runtime_env_hash);
 
   void RemoveWorkerProcess(State &state, const StartupToken &proc_startup_token);
 
+  /// Record the process of a worker forked from the zygote, or start the worker with
+  /// exec if the zygote failed to fork it.
+  ///
+  /// \param language The language of the worker.
+  /// \param worker_startup_token The startup token of the worker process.
+  /// \param worker_command_args The command to start the worker with exec.
+  /// \param env The environment variables of the worker.
+  /// \param proc The forked process, null if the fork failed.
+  void OnWorkerForked(const Language &language,
+                      StartupToken worker_startup_token,
+                      const std::vector<std::string> &worker_command_args,
+                      const ProcessEnvironment &env,
+                      Process proc);
+
   /// Increase worker OOM scores to avoid raylet crashes from heap memory
   /// pressure.
   void AdjustWorkerOomScore(pid_t pid) const;
 
+  /// Start workers for the kinds of workers that are forecast to be needed, up to the
+  /// forecast and within the soft limit. Workers with a runtime env are not
+  /// prestarted, since their env is created for a task.
+  void PrestartForecastedWorkers();
+
+  /// Get the number of workers of a kind that are idle or starting.
+  int64_t NumWarmWorkers(const WorkerDemandKey &key);
+
   /// For Process class for managing subprocesses (e.g. reaping zombies).
   instrumented_io_context *io_service_;
   /// Node ID of the current node.
@@ -697,6 +764,12 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   /// Keeps track of unused ports that newly-created workers can bind on.
   /// If null, workers will not be passed ports and will choose them randomly.
   std::unique_ptr<std::queue<int>> free_ports_;
+  /// Forks Python workers from a zygote. Null if the fork server is disabled.
+  std::unique_ptr<WorkerForkServer> fork_server_;
+  /// Puts worker processes in cgroups. Null if workers are not put in cgroups.
+  std::unique_ptr<WorkerCgroupManager> cgroup_manager_;
+  /// Predicts the number of workers of each kind needed from the queued tasks.
+  WorkerDemandForecaster demand_forecaster_;
   /// The port Raylet uses for listening to incoming connections.
   int node_manager_port_ = 0;
   /// A client connection to the GCS.
@@ -1352,6 +1352,45 @@ TEST_F(WorkerPoolTest, TestWorkerCappingLaterNWorkersNotOwningObjects) {
   ASSERT_EQ(worker_pool_->GetIdleWorkerSize(), num_workers / 2);
 }
 
+TEST_F(WorkerPoolTest, TestWorkerCappingKeepsForecastWorkers) {
+  auto job_id = JOB_ID;
+  RegisterDriver(Language::PYTHON, job_id);
+
+  ///
+  /// Register 7 workers (2 more than soft limit).
+  ///
+  std::vector<std::shared_ptr<WorkerInterface>> workers;
+  int num_workers = POOL_SIZE_SOFT_LIMIT + 2;
+  for (int i = 0; i < num_workers; i++) {
+    PopWorkerStatus status;
+    auto [proc, token] = worker_pool_->StartWorkerProcess(
+        Language::PYTHON, rpc::WorkerType::WORKER, job_id, &status);
+    auto worker = worker_pool_->CreateWorker(Process(), Language::PYTHON, job_id);
+    worker->SetStartupToken(worker_pool_->GetStartupToken(proc));
+    workers.push_back(worker);
+    RAY_CHECK_OK(worker_pool_->RegisterWorker(
+        worker, proc.GetId(), worker_pool_->GetStartupToken(proc), [](Status, int) {}));
+    worker_pool_->OnWorkerStarted(worker);
+    worker_pool_->PushWorker(worker);
+  }
+
+  // Two workers are forecast to be needed. No worker is prestarted since the pool is
+  // above the soft limit.
+  worker_pool_->UpdateWorkerDemand({{{Language::PYTHON, 0, job_id}, 2}});
+  ASSERT_EQ(worker_pool_->NumWorkersStarting(), 0);
+
+  // The first two idle workers are kept, the next ones are killed down to the soft
+  // limit.
+  worker_pool_->SetCurrentTimeMs(2000);
+  worker_pool_->TryKillingIdleWorkers();
+  for (int i = 0; i < num_workers; i++) {
+    auto mock_rpc_client_it = mock_worker_rpc_clients_.find(workers[i]->WorkerId());
+    ASSERT_EQ(mock_rpc_client_it->second->ExitReplySucceed(), i == 2 || i == 3) << i;
+  }
+  worker_pool_->TryKillingIdleWorkers();
+  ASSERT_EQ(worker_pool_->GetIdleWorkerSize(), POOL_SIZE_SOFT_LIMIT);
+}
+
 TEST_F(WorkerPoolTest, TestWorkerCappingWithExitDelay) {
   ///
   /// When there are multiple workers in a worker process, and the worker process's Exit
@@ -340,7 +340,8 @@ void raylet::RayletClient::RequestWorkerLease(
     bool grant_or_reject,
     const rpc::ClientCallback<rpc::RequestWorkerLeaseReply> &callback,
     const int64_t backlog_size,
-    const bool is_selected_based_on_locality) {
+    const bool is_selected_based_on_locality,
+    const int64_t max_leases) {
   google::protobuf::Arena arena;
   auto request =
       google::protobuf::Arena::CreateMessage<rpc::RequestWorkerLeaseRequest>(&arena);
@@ -353,6 +354,7 @@ void raylet::RayletClient::RequestWorkerLease(
   request->set_grant_or_reject(grant_or_reject);
   request->set_backlog_size(backlog_size);
   request->set_is_selected_based_on_locality(is_selected_based_on_locality);
+  request->set_max_leases(max_leases);
   grpc_client_->RequestWorkerLease(*request, callback);
 }
 
@@ -68,12 +68,17 @@ class WorkerLeaseInterface {
   ///                         but no spillback.
   /// \param callback: The callback to call when the request finishes.
   /// \param backlog_size The queue length for the given shape on the CoreWorker.
+  /// \param is_selected_based_on_locality Whether the raylet was selected for the
+  ///                                      locality of the task arguments.
+  /// \param max_leases The maximum number of workers to lease, the workers other than
+  ///                   the first one are in the `additional_leases` of the reply.
   virtual void RequestWorkerLease(
       const rpc::TaskSpec &task_spec,
       bool grant_or_reject,
       const ray::rpc::ClientCallback<ray::rpc::RequestWorkerLeaseReply> &callback,
       const int64_t backlog_size = -1,
-      const bool is_selected_based_on_locality = false) = 0;
+      const bool is_selected_based_on_locality = false,
+      const int64_t max_leases = 1) = 0;
 
   /// Returns a worker to the raylet.
   /// \param worker_port The local port of the worker on the raylet node.
@@ -401,7 +406,8 @@ class RayletClient : public RayletClientInterface {
       bool grant_or_reject,
       const ray::rpc::ClientCallback<ray::rpc::RequestWorkerLeaseReply> &callback,
       const int64_t backlog_size,
-      const bool is_selected_based_on_locality) override;
+      const bool is_selected_based_on_locality,
+      const int64_t max_leases) override;
 
   /// Implements WorkerLeaseInterface.
   ray::Status ReturnWorker(int worker_port,
@@ -53,6 +53,12 @@ class NodeManagerClient {
     GetNodeStats(request, callback);
   }
 
+  /// Ask the node for queued tasks that this node can run.
+  VOID_RPC_CLIENT_METHOD(NodeManagerService,
+                         StealTasks,
+                         grpc_client_,
+                         /*method_timeout_ms*/ -1, )
+
   std::shared_ptr<grpc::Channel> Channel() const { return grpc_client_->Channel(); }
 
  private:
@@ -46,7 +46,8 @@ namespace rpc {
   RPC_SERVICE_HANDLER(NodeManagerService, GetSystemConfig, -1)        \
   RPC_SERVICE_HANDLER(NodeManagerService, ShutdownRaylet, -1)         \
   RPC_SERVICE_HANDLER(NodeManagerService, GetTasksInfo, -1)           \
-  RPC_SERVICE_HANDLER(NodeManagerService, GetObjectsInfo, -1)
+  RPC_SERVICE_HANDLER(NodeManagerService, GetObjectsInfo, -1)         \
+  RPC_SERVICE_HANDLER(NodeManagerService, StealTasks, -1)
 
 /// Interface of the `NodeManagerService`, see `src/ray/protobuf/node_manager.proto`.
 class NodeManagerServiceHandler {
@@ -153,6 +154,10 @@ class NodeManagerServiceHandler {
   virtual void HandleGetObjectsInfo(const GetObjectsInfoRequest &request,
                                     GetObjectsInfoReply *reply,
                                     SendReplyCallback send_reply_callback) = 0;
+
+  virtual void HandleStealTasks(const StealTasksRequest &request,
+                                StealTasksReply *reply,
+                                SendReplyCallback send_reply_callback) = 0;
 };
 
 /// The `GrpcService` for `NodeManagerService`.
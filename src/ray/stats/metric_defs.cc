@@ -160,6 +160,19 @@ DEFINE_stats(scheduler_failed_worker_startup_total,
              ("Reason"),
              (),
              ray::stats::GAUGE);
+DEFINE_stats(scheduler_admission_decisions,
+             "Number of admission decisions the local scheduler made for tasks ready to "
+             "be dispatched, broken per decision {Admitted, Deferred, Preempted}. "
+             "Preempted counts the workers killed to admit higher priority tasks.",
+             ("Decision"),
+             (),
+             ray::stats::COUNT);
+DEFINE_stats(scheduler_lease_fast_path,
+             "Number of lease requests that tried to get an idle worker without going "
+             "through the scheduling queues, broken per result {Hit, Miss}.",
+             ("Result"),
+             (),
+             ray::stats::GAUGE);
 
 /// Local Object Manager
 DEFINE_stats(
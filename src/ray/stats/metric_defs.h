@@ -80,6 +80,8 @@ DECLARE_stats(push_manager_chunks);
 DECLARE_stats(scheduler_failed_worker_startup_total);
 DECLARE_stats(scheduler_tasks);
 DECLARE_stats(scheduler_unscheduleable_tasks);
+DECLARE_stats(scheduler_admission_decisions);
+DECLARE_stats(scheduler_lease_fast_path);
 
 /// Local Object Manager
 DECLARE_stats(spill_manager_objects);
@@ -0,0 +1,86 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/util/crc32.h"
+
+#include <array>
+#include <cstring>
+
+namespace ray {
+
+namespace {
+constexpr uint32_t kCrc32Polynomial = 0xEDB88320;
+
+// Tables for the slice-by-8 algorithm. table[0] is the classic byte-wise table,
+// table[k][b] is the CRC of byte b followed by k zero bytes.
+using Crc32Tables = std::array<std::array<uint32_t, 256>, 8>;
+
+Crc32Tables MakeCrc32Tables() {
+  Crc32Tables tables{};
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t crc = i;
+    for (int j = 0; j < 8; j++) {
+      crc = (crc >> 1) ^ ((crc & 1) ? kCrc32Polynomial : 0);
+    }
+    tables[0][i] = crc;
+  }
+  for (uint32_t i = 0; i < 256; i++) {
+    for (size_t k = 1; k < tables.size(); k++) {
+      tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+    }
+  }
+  return tables;
+}
+
+const Crc32Tables &GetCrc32Tables() {
+  static const Crc32Tables tables = MakeCrc32Tables();
+  return tables;
+}
+
+bool IsLittleEndian() {
+  const uint16_t value = 1;
+  uint8_t first_byte;
+  std::memcpy(&first_byte, &value, 1);
+  return first_byte == 1;
+}
+}  // namespace
+
+uint32_t Crc32(const void *data, size_t size, uint32_t crc) {
+  const auto &tables = GetCrc32Tables();
+  const uint8_t *p = static_cast<const uint8_t *>(data);
+  crc = ~crc;
+  // Process 8 bytes at a time. The word loads assume little endian byte order.
+  static const bool little_endian = IsLittleEndian();
+  if (little_endian) {
+    while (size >= 8) {
+      uint32_t lo;
+      uint32_t hi;
+      std::memcpy(&lo, p, 4);
+      std::memcpy(&hi, p + 4, 4);
+      lo ^= crc;
+      crc = tables[7][lo & 0xFF] ^ tables[6][(lo >> 8) & 0xFF] ^
+            tables[5][(lo >> 16) & 0xFF] ^ tables[4][lo >> 24] ^
+            tables[3][hi & 0xFF] ^ tables[2][(hi >> 8) & 0xFF] ^
+            tables[1][(hi >> 16) & 0xFF] ^ tables[0][hi >> 24];
+      p += 8;
+      size -= 8;
+    }
+  }
+  while (size-- > 0) {
+    crc = (crc >> 8) ^ tables[0][(crc ^ *p++) & 0xFF];
+  }
+  return ~crc;
+}
+
+}  // namespace ray
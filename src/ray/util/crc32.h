@@ -0,0 +1,28 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ray {
+
+// Compute the CRC-32 (IEEE 802.3, the polynomial used by zlib) of a buffer.
+// The result is identical to Python's zlib.crc32, so checksums can be produced
+// by Python workers and verified in C++ and vice versa. Pass the previous
+// result as `crc` to checksum data incrementally.
+uint32_t Crc32(const void *data, size_t size, uint32_t crc = 0);
+
+}  // namespace ray
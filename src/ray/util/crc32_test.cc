@@ -0,0 +1,46 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/util/crc32.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+TEST(Crc32Test, KnownValues) {
+  ASSERT_EQ(0u, Crc32("", 0));
+  // Check values from zlib.crc32.
+  std::string digits("123456789");
+  ASSERT_EQ(0xCBF43926u, Crc32(digits.data(), digits.size()));
+  std::string fox("The quick brown fox jumps over the lazy dog");
+  ASSERT_EQ(0x414FA339u, Crc32(fox.data(), fox.size()));
+}
+
+TEST(Crc32Test, Incremental) {
+  std::string data(10007, '\0');
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<char>(i * 31 + 7);
+  }
+  const uint32_t expected = Crc32(data.data(), data.size());
+  // Split at every alignment so both the word and the byte loops are covered.
+  for (size_t split = 0; split < 17; split++) {
+    uint32_t crc = Crc32(data.data(), split);
+    crc = Crc32(data.data() + split, data.size() - split, crc);
+    ASSERT_EQ(expected, crc) << split;
+  }
+}
+
+}  // namespace ray